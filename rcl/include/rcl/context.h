@@ -28,6 +28,7 @@ extern "C"
 #include "rcl/arguments.h"
 #include "rcl/init_options.h"
 #include "rcl/macros.h"
+#include "rcl/time.h"
 #include "rcl/types.h"
 #include "rcl/visibility_control.h"
 
@@ -314,6 +315,36 @@ RCL_WARN_UNUSED
 rmw_context_t *
 rcl_context_get_rmw_context(rcl_context_t * context);
 
+/// Return the ROS time source shared by the clocks of the given context.
+/**
+ * Every initialized context owns one ROS time source.
+ * Binding the #RCL_ROS_TIME clocks of the nodes of a context to it, with
+ * rcl_clock_bind_ros_time_source(), lets a single /clock subscription advance
+ * all of them with one call to rcl_ros_time_source_set_override().
+ *
+ * The source stays valid until the context is finalized, which unbinds the
+ * clocks still bound to it.
+ *
+ * If context is `NULL`, then `NULL` is returned.
+ * If context is zero-initialized, then `NULL` is returned.
+ * If context is uninitialized, then it is undefined behavior.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] context object from which the ROS time source should be retrieved.
+ * \return pointer to the ROS time source, or `NULL` if an error occurred.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ros_time_source_t *
+rcl_context_get_ros_time_source(rcl_context_t * context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,8 @@ extern "C"
 #include "rcl/visibility_control.h"
 #include "rcl/time.h"
 
+#include "rmw/message_sequence.h"
+
 /// Internal rcl publisher implementation struct.
 typedef struct rcl_publisher_impl_s rcl_publisher_impl_t;
 
@@ -49,8 +51,32 @@ typedef struct rcl_publisher_options_s
   rcl_allocator_t allocator;
   /// rmw specific publisher options, e.g. the rmw implementation specific payload.
   rmw_publisher_options_t rmw_publisher_options;
+  /// Deliver to the subscriptions of the same context without the middleware.
+  /** See "Intra context delivery" in rcl_publisher_init(). */
+  bool intra_context;
+  /// Minimum steady time in nanoseconds between two messages of rcl_publish(), 0 not to throttle.
+  /** See "Throttling" in rcl_publisher_init(). */
+  rcl_duration_value_t throttle_period;
+  /// Keep the latest throttled message for rcl_publisher_flush() instead of dropping it.
+  bool conflate;
 } rcl_publisher_options_t;
 
+/// Snapshot of the traffic counted by a publisher, see rcl_publisher_get_traffic_counters().
+typedef struct rcl_publisher_traffic_counters_s
+{
+  /// Number of messages published, including serialized and loaned messages.
+  uint64_t message_count;
+  /// Number of bytes published as serialized messages.
+  uint64_t serialized_byte_count;
+  /// Number of messages borrowed from the middleware.
+  uint64_t loaned_message_count;
+  /// Number of messages the middleware failed to publish.
+  uint64_t error_count;
+  /// Steady time at which a message was last published, or 0 if none was or it is not stamped.
+  /** See rcl_publisher_get_traffic_counters(). */
+  rcl_time_point_value_t last_publish_time;
+} rcl_publisher_traffic_counters_t;
+
 /// Return a rcl_publisher_t struct with members set to `NULL`.
 /**
  * Should be called to get a null rcl_publisher_t before passing to
@@ -127,6 +153,41 @@ rcl_get_zero_initialized_publisher(void);
  * // ... error handling for rcl_deinitialize_node()
  * ```
  *
+ * <b>Intra context delivery</b>
+ *
+ * With `intra_context` set in the options, the publisher hands its messages
+ * directly to the subscriptions of the same context which also set it, on the
+ * same topic, with the same type and a compatible reliability.
+ * Both ends must use a keep last history with a non zero depth and a volatile
+ * durability, and the type must have a C introspection type support,
+ * otherwise the publisher silently keeps to the middleware.
+ *
+ * Messages obtained from rcl_borrow_loaned_message() are then owned by rcl and
+ * reach every local subscription without being copied, while rcl_publish()
+ * copies the message once, whatever the number of local subscriptions.
+ * The middleware is skipped only when it reports no matched subscription.
+ * Otherwise it publishes as well, since it may have matched a remote
+ * subscription before the local ones. Local subscriptions drop the copies
+ * the middleware delivers for messages they already got.
+ *
+ * <b>Throttling</b>
+ *
+ * With a non zero `throttle_period` in the options, rcl_publish(),
+ * rcl_publish_sequence() and rcl_publish_loaned_message() publish a message
+ * only if the previous one went out at least that long ago, which caps the
+ * rate of the topic for every subscription, local or not.
+ * Messages published sooner are dropped, unless `conflate` is set, in which
+ * case rcl keeps a copy of the latest one, replacing the one it held, and
+ * rcl_publisher_flush() publishes it once the period is over.
+ * The flush is meant to be called by a timer, e.g. one with the throttle period,
+ * so that the last value of a burst is not held indefinitely.
+ * Conflation copies messages with the C introspection type support, without
+ * it the publisher fails to initialize with #RCL_RET_UNSUPPORTED.
+ * Loaned messages which are not published right away go back to where they
+ * were borrowed from.
+ * Serialized messages cannot be conflated, throttled publishers reject them
+ * with #RCL_RET_UNSUPPORTED.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
@@ -146,6 +207,7 @@ rcl_get_zero_initialized_publisher(void);
  * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
  * \return #RCL_RET_BAD_ALLOC if allocating memory fails, or
  * \return #RCL_RET_TOPIC_NAME_INVALID if the given topic name is invalid, or
+ * \return #RCL_RET_UNSUPPORTED if conflation is requested for a type without introspection, or
  * \return #RCL_RET_ERROR if an unspecified error occurs.
  */
 RCL_PUBLIC
@@ -194,6 +256,9 @@ rcl_publisher_fini(rcl_publisher_t * publisher, rcl_node_t * node);
  * - qos = rmw_qos_profile_default
  * - allocator = rcl_get_default_allocator()
  * - rmw_publisher_options = rmw_get_default_publisher_options()
+ * - intra_context = false
+ * - throttle_period = 0
+ * - conflate = false
  *
  * \return A structure with the default publisher options.
  */
@@ -207,6 +272,15 @@ rcl_publisher_get_default_options(void);
  * The memory allocated for the ros message belongs to the middleware and must not be deallocated
  * other than by a call to \sa rcl_return_loaned_message_from_publisher.
  *
+ * Publishers delivering within their context, see rcl_publisher_init(), loan
+ * messages allocated by rcl instead, which their local subscriptions share.
+ *
+ * When the middleware cannot loan, rcl loans messages from a pool of the
+ * publisher instead, as long as the type has a C introspection type support.
+ * The pool keeps returned messages initialized for the next borrow, with their
+ * previous content, so borrowing only allocates while the number of messages
+ * loaned at once grows.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
@@ -240,6 +314,7 @@ rcl_borrow_loaned_message(
  * The ownership of the passed in ros message will be transferred back to the middleware.
  * The middleware might deallocate and destroy the message so that the pointer is no longer
  * guaranteed to be valid after that call.
+ * Messages loaned by rcl go back to their pool or are released instead.
  *
  * <hr>
  * Attribute          | Adherence
@@ -304,14 +379,18 @@ rcl_return_loaned_message_from_publisher(
  * rcl_publish() simultaneously, even if the publishers differ.
  * The `ros_message` is unmodified by rcl_publish().
  *
+ * A throttled publisher may hold the message back or drop it, and still
+ * return #RCL_RET_OK, see "Throttling" in rcl_publisher_init().
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | No
+ * Allocates Memory   | Maybe [2]
  * Thread-Safe        | Yes [1]
- * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Uses Atomics       | Maybe [2]
+ * Lock-Free          | Maybe [2]
  * <i>[1] for unique pairs of publishers and messages, see above for more</i>
+ * <i>[2] when throttled, conflating copies the message and a spinlock guards the kept one</i>
  *
  * \param[in] publisher handle to the publisher which will do the publishing
  * \param[in] ros_message type-erased pointer to the ROS message
@@ -329,6 +408,32 @@ rcl_publish(
   const void * ros_message,
   rmw_publisher_allocation_t * allocation);
 
+/// Publish the message a conflating publisher holds back, if its throttle period is over.
+/**
+ * Does nothing if the publisher is not throttled, holds no message or
+ * published one less than a throttle period ago.
+ * See "Throttling" in rcl_publisher_init().
+ *
+ * This function can be called concurrently with rcl_publish() and itself.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] publisher handle to the publisher to flush
+ * \return #RCL_RET_OK if nothing was due or the message was published, or
+ * \return #RCL_RET_PUBLISHER_INVALID if the publisher is invalid, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_publisher_flush(const rcl_publisher_t * publisher);
+
 /// Publish a serialized message on a topic using a publisher.
 /**
  * It is the job of the caller to ensure that the type of the serialized message
@@ -343,6 +448,8 @@ rcl_publish(
  * Apart from this, the `publish_serialized` function has the same behavior as rcl_publish()
  * expect that no serialization step is done.
  *
+ * Throttled publishers, see rcl_publisher_init(), do not publish serialized messages.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
@@ -359,6 +466,7 @@ rcl_publish(
  * \return #RCL_RET_BAD_ALLOC if allocating memory failed, or
  * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
  * \return #RCL_RET_PUBLISHER_INVALID if the publisher is invalid, or
+ * \return #RCL_RET_UNSUPPORTED if the publisher is throttled, or
  * \return #RCL_RET_ERROR if an unspecified error occurs.
  */
 RCL_PUBLIC
@@ -369,6 +477,84 @@ rcl_publish_serialized_message(
   const rcl_serialized_message_t * serialized_message,
   rmw_publisher_allocation_t * allocation);
 
+/// Publish a sequence of ROS messages on a topic using a publisher.
+/**
+ * This is the publishing counterpart of rcl_take_sequence(): the first
+ * `message_sequence->size` messages of the sequence are published in order,
+ * as if by consecutive calls to rcl_publish(), but the publisher and the
+ * messages are validated once for the whole batch, before anything is
+ * published.
+ *
+ * Publishing stops at the first message the middleware fails to publish.
+ * The number of messages published before that is stored in
+ * `published_count`, if given, so the caller can retry the rest.
+ * Messages a throttled publisher kept or dropped, see rcl_publisher_init(),
+ * count as published.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [2]
+ * Thread-Safe        | Yes [1]
+ * Uses Atomics       | Maybe [2]
+ * Lock-Free          | Maybe [2]
+ * <i>[1] for unique pairs of publishers and messages, see rcl_publish()</i>
+ * <i>[2] when throttled, see rcl_publish()</i>
+ *
+ * \param[in] publisher handle to the publisher which will do the publishing
+ * \param[in] message_sequence type-erased pointers to the ROS messages
+ * \param[out] published_count number of messages published, may be NULL
+ * \param[in] allocation structure pointer, used for memory preallocation (may be NULL)
+ * \return #RCL_RET_OK if all messages were published successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_PUBLISHER_INVALID if the publisher is invalid, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_publish_sequence(
+  const rcl_publisher_t * publisher,
+  const rmw_message_sequence_t * message_sequence,
+  size_t * published_count,
+  rmw_publisher_allocation_t * allocation);
+
+/// Publish an array of serialized messages on a topic using a publisher.
+/**
+ * Behaves like rcl_publish_sequence(), with each message published as if
+ * by rcl_publish_serialized_message().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes [1]
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ * <i>[1] for unique pairs of publishers and messages, see rcl_publish()</i>
+ *
+ * \param[in] publisher handle to the publisher which will do the publishing
+ * \param[in] serialized_messages array of `count` already serialized messages
+ * \param[in] count number of messages in the array
+ * \param[out] published_count number of messages published, may be NULL
+ * \param[in] allocation structure pointer, used for memory preallocation (may be NULL)
+ * \return #RCL_RET_OK if all messages were published successfully, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_PUBLISHER_INVALID if the publisher is invalid, or
+ * \return #RCL_RET_UNSUPPORTED if the publisher is throttled, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_publish_serialized_message_sequence(
+  const rcl_publisher_t * publisher,
+  const rcl_serialized_message_t * serialized_messages,
+  size_t count,
+  size_t * published_count,
+  rmw_publisher_allocation_t * allocation);
+
 /// Publish a loaned message on a topic using a publisher.
 /**
  * A previously borrowed loaned message can be sent via this call to rcl_publish_loaned_message().
@@ -382,16 +568,23 @@ rcl_publish_serialized_message(
  * Apart from this, the `publish_loaned_message` function has the same behavior as rcl_publish()
  * except that no serialization step is done.
  *
+ * Messages loaned from the pool of the publisher, see rcl_borrow_loaned_message(),
+ * are published with rmw_publish() and go back to the pool.
+ *
+ * A throttled publisher, see rcl_publisher_init(), returns the loan instead of
+ * publishing it when the message is kept or dropped.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | No [0]
  * Thread-Safe        | Yes [1]
- * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Uses Atomics       | Maybe [2]
+ * Lock-Free          | Maybe [2]
  * <i>[0] the middleware might deallocate the loaned message.
- * The RCL function however does not allocate any memory.</i>
+ * The RCL function however does not allocate any memory, unless it conflates it.</i>
  * <i>[1] for unique pairs of publishers and messages, see above for more</i>
+ * <i>[2] when throttled, see rcl_publish()</i>
  *
  * \param[in] publisher handle to the publisher which will do the publishing
  * \param[in] ros_message  pointer to the previously borrow loaned message
@@ -682,11 +875,52 @@ rcl_publisher_get_actual_qos(const rcl_publisher_t * publisher);
 /**
  * Depending on the middleware and the message type, this will return true if the middleware
  * can allocate a ROS message instance.
+ * Publishers delivering within their context can always loan messages, and so
+ * can publishers whose type has a C introspection type support, from a pool
+ * of rcl when the middleware cannot.
  */
 RCL_PUBLIC
 bool
 rcl_publisher_can_loan_messages(const rcl_publisher_t * publisher);
 
+/// Get a snapshot of the traffic counted by a publisher.
+/**
+ * Every publisher counts the messages published through rcl_publish() and its
+ * serialized, loaned and batched variants, so hot topics can be found without
+ * attaching a tracer.
+ * The counters are updated with relaxed atomics.
+ * They can be compiled out of rcl by turning off the `RCL_ENABLE_TRAFFIC_COUNTERS`
+ * CMake option, in which case this function returns #RCL_RET_UNSUPPORTED.
+ * The time of the last message published is only recorded with the
+ * `RCL_ENABLE_TRAFFIC_TIMESTAMPS` CMake option turned on, as it costs a
+ * steady clock read per publish call.
+ *
+ * Each counter is read atomically, but messages being published concurrently
+ * may be reflected in some counters and not yet in others.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_uint_least64_t`</i>
+ *
+ * \param[in] publisher the publisher which is being queried
+ * \param[out] counters the snapshot
+ * \return #RCL_RET_OK if successful, or
+ * \return #RCL_RET_PUBLISHER_INVALID if the publisher is invalid, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_UNSUPPORTED if rcl was built without traffic counters.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_publisher_get_traffic_counters(
+  const rcl_publisher_t * publisher,
+  rcl_publisher_traffic_counters_t * counters);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,322 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCL__READINESS_QUEUE_H_
+#define RCL__READINESS_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcl/allocator.h"
+#include "rcl/client.h"
+#include "rcl/context.h"
+#include "rcl/event.h"
+#include "rcl/macros.h"
+#include "rcl/service.h"
+#include "rcl/subscription.h"
+#include "rcl/timer.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+#include "rcl/wait.h"
+
+/// Internal rcl readiness queue implementation struct.
+typedef struct rcl_readiness_queue_impl_s rcl_readiness_queue_impl_t;
+
+/// Queue of readiness notifications for a set of entities.
+/**
+ * Instead of rebuilding a wait set and scanning it after every wake-up, the
+ * readiness queue registers the new item callbacks of its entities with the
+ * middleware and turns every notification into a record which names the
+ * entity that has new items.
+ */
+typedef struct rcl_readiness_queue_s
+{
+  /// Pointer to the readiness queue implementation
+  rcl_readiness_queue_impl_t * impl;
+} rcl_readiness_queue_t;
+
+/// Notification that an entity of a readiness queue has new items.
+typedef struct rcl_readiness_record_s
+{
+  /// Type of the entity, never #RCL_WAIT_SET_GUARD_CONDITION.
+  rcl_wait_set_entity_type_t entity_type;
+  /// The entity, e.g. a `const rcl_subscription_t *` for subscriptions.
+  const void * entity;
+  /// Number of new items, e.g. messages, since the entity was last reported.
+  /**
+   * Always 1 for timers, which are reported for as long as they are ready.
+   */
+  size_t count;
+} rcl_readiness_record_t;
+
+/// Return a rcl_readiness_queue_t struct with members set to `NULL`.
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_readiness_queue_t
+rcl_get_zero_initialized_readiness_queue(void);
+
+/// Initialize a readiness queue.
+/**
+ * The capacity of the queue is fixed at initialization: up to
+ * `max_entities` subscriptions, clients, services and events, plus up to
+ * `max_timers` timers can be added.
+ * Notifications for an entity which has already been reported, but not yet
+ * taken from the queue, are coalesced into its pending record, so the queue
+ * never overflows.
+ *
+ * Expected usage:
+ *
+ * ```c
+ * #include <rcl/rcl.h>
+ * #include <rcl/readiness_queue.h>
+ *
+ * rcl_readiness_queue_t queue = rcl_get_zero_initialized_readiness_queue();
+ * rcl_ret_t ret = rcl_readiness_queue_init(&queue, 2, 1, context, rcl_get_default_allocator());
+ * // ... error handling
+ * ret = rcl_readiness_queue_add_subscription(&queue, &subscription);
+ * // ... error handling, add more entities
+ * rcl_readiness_record_t records[8];
+ * size_t records_count = 0;
+ * ret = rcl_readiness_queue_wait(&queue, RCL_MS_TO_NS(100), records, 8, &records_count);
+ * for (size_t i = 0; i < records_count; ++i) {
+ *   // take records[i].count items from records[i].entity
+ * }
+ * // ... on shutdown
+ * ret = rcl_readiness_queue_fini(&queue);
+ * // ... error handling
+ * ```
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the readiness queue to be initialized
+ * \param[in] max_entities maximum number of subscriptions, clients, services and events
+ * \param[in] max_timers maximum number of timers
+ * \param[in] context the context in which the queue's guard condition is created
+ * \param[in] allocator the allocator to use for internal allocations
+ * \return #RCL_RET_OK if the queue was initialized successfully, or
+ * \return #RCL_RET_ALREADY_INIT if the queue is already initialized, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_NOT_INIT if the given context is invalid, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_readiness_queue_init(
+  rcl_readiness_queue_t * queue,
+  size_t max_entities,
+  size_t max_timers,
+  rcl_context_t * context,
+  rcl_allocator_t allocator);
+
+/// Finalize a readiness queue.
+/**
+ * The callbacks registered for the entities of the queue are unset, so the
+ * entities must still be valid when the queue is finalized.
+ * Calling this function on a zero initialized queue does nothing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the readiness queue to be finalized
+ * \return #RCL_RET_OK if the queue was finalized successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_readiness_queue_fini(rcl_readiness_queue_t * queue);
+
+/// Register the on new message callback of a subscription with the queue.
+/**
+ * The subscription stays registered until the queue is finalized and must
+ * not have its callback changed by anyone else in the meantime.
+ * Messages which arrived before the subscription was added are reported as
+ * well if the middleware reports them when the callback is set.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Maybe [1]
+ * <i>[1] rmw implementation defined</i>
+ *
+ * \param[inout] queue the readiness queue
+ * \param[in] subscription the subscription to be registered
+ * \return #RCL_RET_OK if the subscription was registered successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_FULL if `max_entities` entities are already registered, or
+ * \return #RCL_RET_UNSUPPORTED if the rmw implementation does not support callbacks, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_readiness_queue_add_subscription(
+  rcl_readiness_queue_t * queue,
+  const rcl_subscription_t * subscription);
+
+/// Register the on new response callback of a client with the queue.
+/**
+ * This function behaves exactly the same as for subscriptions.
+ * \see rcl_readiness_queue_add_subscription
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_readiness_queue_add_client(
+  rcl_readiness_queue_t * queue,
+  const rcl_client_t * client);
+
+/// Register the on new request callback of a service with the queue.
+/**
+ * This function behaves exactly the same as for subscriptions.
+ * \see rcl_readiness_queue_add_subscription
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_readiness_queue_add_service(
+  rcl_readiness_queue_t * queue,
+  const rcl_service_t * service);
+
+/// Register the callback of an event with the queue.
+/**
+ * This function behaves exactly the same as for subscriptions.
+ * \see rcl_readiness_queue_add_subscription
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_readiness_queue_add_event(
+  rcl_readiness_queue_t * queue,
+  const rcl_event_t * event);
+
+/// Add a timer to the queue.
+/**
+ * Timers have no new item callback; instead rcl_readiness_queue_wait() wakes
+ * up at the earliest timer deadline and reports every timer which is ready.
+ * A timer is reported until it is called, see rcl_timer_call().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the readiness queue
+ * \param[in] timer the timer to be added
+ * \return #RCL_RET_OK if the timer was added successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_FULL if `max_timers` timers are already added, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_readiness_queue_add_timer(
+  rcl_readiness_queue_t * queue,
+  const rcl_timer_t * timer);
+
+/// Wait until the queue has records, then take them.
+/**
+ * Records which are already queued and timers which are already ready are
+ * returned without blocking.
+ * Otherwise this function blocks on a single guard condition, which the
+ * entity callbacks trigger, until a record is queued, a timer becomes ready
+ * or the timeout expires.
+ * The timeout follows the semantics of rcl_wait().
+ *
+ * At most `records_capacity` records are returned, the remaining ones stay
+ * queued for the next call.
+ * Each record reports the number of items which arrived for its entity since
+ * it was last reported.
+ * Spurious wake-ups are possible, in which case #RCL_RET_OK is returned with
+ * `records_count` set to 0.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Maybe [1]
+ * <i>[1] blocks in rmw_wait() if no records are queued</i>
+ *
+ * \param[inout] queue the readiness queue
+ * \param[in] timeout the duration to wait, in nanoseconds
+ * \param[out] records storage for the records taken from the queue
+ * \param[in] records_capacity number of records which fit in `records`
+ * \param[out] records_count number of records taken from the queue
+ * \return #RCL_RET_OK if records were taken or the wait was woken up, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMEOUT if the timeout expired before something was ready, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_readiness_queue_wait(
+  rcl_readiness_queue_t * queue,
+  int64_t timeout,
+  rcl_readiness_record_t * records,
+  size_t records_capacity,
+  size_t * records_count);
+
+/// Return `true` if the readiness queue is valid, else `false`.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] queue the readiness queue to be validated
+ * \return `true` if the queue is valid, otherwise `false`.
+ */
+RCL_PUBLIC
+bool
+rcl_readiness_queue_is_valid(const rcl_readiness_queue_t * queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__READINESS_QUEUE_H_
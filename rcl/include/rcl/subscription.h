@@ -25,8 +25,10 @@ extern "C"
 #include "rosidl_runtime_c/message_type_support_struct.h"
 
 #include "rcl/event_callback.h"
+#include "rcl/guard_condition.h"
 #include "rcl/macros.h"
 #include "rcl/node.h"
+#include "rcl/time.h"
 #include "rcl/visibility_control.h"
 
 #include "rmw/message_sequence.h"
@@ -51,8 +53,29 @@ typedef struct rcl_subscription_options_s
   rcl_allocator_t allocator;
   /// rmw specific subscription options, e.g. the rmw implementation specific payload.
   rmw_subscription_options_t rmw_subscription_options;
+  /// Receive from the publishers of the same context without the middleware.
+  /** See "Intra context delivery" in rcl_subscription_init(). */
+  bool intra_context;
 } rcl_subscription_options_t;
 
+/// Snapshot of the traffic counted by a subscription, see rcl_subscription_get_traffic_counters().
+typedef struct rcl_subscription_traffic_counters_s
+{
+  /// Number of messages taken, including serialized and loaned messages.
+  uint64_t message_count;
+  /// Number of bytes taken as serialized messages.
+  uint64_t serialized_byte_count;
+  /// Number of messages taken as loans from the middleware.
+  uint64_t loaned_message_count;
+  /// Number of takes which found no message, i.e. returned #RCL_RET_SUBSCRIPTION_TAKE_FAILED.
+  uint64_t take_failed_count;
+  /// Number of takes the middleware failed.
+  uint64_t error_count;
+  /// Steady time at which a message was last taken, or 0 if none was or it is not stamped.
+  /** See rcl_subscription_get_traffic_counters(). */
+  rcl_time_point_value_t last_take_time;
+} rcl_subscription_traffic_counters_t;
+
 typedef struct rcl_subscription_content_filter_options_s
 {
   rmw_subscription_content_filter_options_t rmw_subscription_content_filter_options;
@@ -136,6 +159,25 @@ rcl_get_zero_initialized_subscription(void);
  * // ... error handling for rcl_node_fini()
  * ```
  *
+ * <b>Intra context delivery</b>
+ *
+ * With `intra_context` set in the options, the subscription receives the
+ * messages of the publishers of the same context which also set it directly
+ * from them, under the conditions listed in rcl_publisher_init().
+ * rcl evaluates the content filter of those messages, see
+ * rcl_subscription_set_content_filter(); a subscription whose filter rcl cannot
+ * evaluate keeps to the middleware.
+ * Those messages are queued in a keep last history of the subscription's
+ * depth, and their copies sent through the middleware are dropped.
+ * Their arrival does not wake up the middleware, wait sets also wait on the
+ * guard condition returned by rcl_subscription_get_intra_context_guard_condition()
+ * of the subscriptions added to them, and report a subscription as ready as
+ * long as such messages are queued.
+ *
+ * Messages taken with rcl_take_loaned_message() are then owned by rcl, and
+ * messages delivered within the context are shared with the publisher and the
+ * other local subscriptions: they must not be modified.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
@@ -206,6 +248,7 @@ rcl_subscription_fini(rcl_subscription_t * subscription, rcl_node_t * node);
  * - qos = rmw_qos_profile_default
  * - allocator = rcl_get_default_allocator()
  * - rmw_subscription_options = rmw_get_default_subscription_options();
+ * - intra_context = false
  *
  * \return A structure containing the default options for a subscription.
  */
@@ -364,7 +407,9 @@ rcl_subscription_content_filter_options_fini(
 
 /// Check if the content filtered topic feature is enabled in the subscription.
 /**
- * Depending on the middleware and whether cft is enabled in the subscription.
+ * Depending on the middleware and whether cft is enabled in the subscription,
+ * or on rcl evaluating the filter where the middleware does not, see
+ * rcl_subscription_set_content_filter().
  *
  * \return `true` if the content filtered topic of `subscription` is enabled, otherwise `false`
  */
@@ -378,10 +423,20 @@ rcl_subscription_is_cft_enabled(const rcl_subscription_t * subscription);
  * This function will set a filter expression and an array of expression parameters
  * for the given subscription.
  *
+ * If the middleware does not support content filtered topics, rcl compiles the
+ * filter once here and evaluates it on every message taken, dropping the ones
+ * which do not match, provided the type has a C introspection.
+ * rcl also filters the messages delivered within the context, see
+ * rcl_subscription_init(), whatever the middleware.
+ * rcl understands the DDS-SQL subset of comparisons (=, <>, !=, <, <=, >, >=),
+ * BETWEEN and LIKE of fields and literals or "%n" parameters, combined with
+ * AND, OR, NOT and parentheses, fields being dotted paths with "[n]" indexes.
+ * Serialized messages taken from the middleware are not filtered by rcl.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | No
+ * Allocates Memory   | Yes
  * Thread-Safe        | No
  * Uses Atomics       | Maybe [1]
  * Lock-Free          | Maybe [1]
@@ -391,7 +446,8 @@ rcl_subscription_is_cft_enabled(const rcl_subscription_t * subscription);
  * \return `RCL_RET_OK` if the query was successful, or
  * \return `RCL_RET_INVALID_ARGUMENT` if `subscription` is NULL, or
  * \return `RCL_RET_INVALID_ARGUMENT` if `options` is NULL, or
- * \return `RCL_RET_UNSUPPORTED` if the implementation does not support content filter topic, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if rcl evaluates the filter and cannot compile it, or
+ * \return `RCL_RET_UNSUPPORTED` if neither the implementation nor rcl can filter content, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
  */
 RCL_PUBLIC
@@ -422,7 +478,7 @@ rcl_subscription_set_content_filter(
  * \return `RCL_RET_INVALID_ARGUMENT` if `subscription` is NULL, or
  * \return `RCL_RET_INVALID_ARGUMENT` if `options` is NULL, or
  * \return `RCL_RET_BAD_ALLOC` if memory allocation fails, or
- * \return `RCL_RET_UNSUPPORTED` if the implementation does not support content filter topic, or
+ * \return `RCL_RET_UNSUPPORTED` if neither the implementation nor rcl filters content, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
  */
 RCL_PUBLIC
@@ -451,10 +507,19 @@ rcl_subscription_get_content_filter(
  * if one is available.
  * If taken is false after calling, then the ROS message will be unmodified.
  *
+ * Messages delivered within the context, see rcl_subscription_init(), are not
+ * zero-copy on this path: rcl_publish() deep copies the message into a block
+ * shared by the local subscriptions and this function deep copies it again
+ * into ros_message, while the middleware copy still goes out.
+ * Loaned messages, see rcl_borrow_loaned_message() and
+ * rcl_take_loaned_message(), are handed over without any copy.
+ *
  * The taken boolean may be false even if a wait set reports that the
  * subscription was ready to be taken from in some cases, e.g. when the
  * state of the subscription changes it may cause the wait set to wake up
  * but subsequent takes to fail to take anything.
+ * That is also the case of messages dropped by the content filter rcl
+ * evaluates, see rcl_subscription_set_content_filter().
  *
  * If allocation is required when taking the message, e.g. if space needs to
  * be allocated for a dynamically sized array in the target message, then the
@@ -563,6 +628,8 @@ rcl_take_sequence(
  * If not, the function will dynamically allocate enough memory for the message.
  * Passing a different type to rcl_take produces undefined behavior and cannot
  * be checked by this function and therefore no deliberate error will occur.
+ * The content filter rcl evaluates only applies to the messages delivered
+ * within the context, the ones of the middleware are not deserialized for it.
  *
  * Apart from the differences above, this function behaves like rcl_take().
  *
@@ -596,6 +663,80 @@ rcl_take_serialized_message(
   rmw_message_info_t * message_info,
   rmw_subscription_allocation_t * allocation);
 
+/// Take a serialized raw message into a buffer of the subscription.
+/**
+ * Like rcl_take_serialized_message(), but the message is taken into a buffer
+ * from a pool of the subscription, which must be given back with
+ * rcl_return_pooled_serialized_message() once done with.
+ * The buffer is owned by the subscription: it must not be finalized, but it
+ * may be passed to rcl_publish_serialized_message() before being given back.
+ *
+ * Buffers are recycled by size classes, powers of two from 256 bytes to 8 MiB.
+ * A buffer is taken from the class fitting the size of the recent messages,
+ * and the middleware grows it if a message is larger.
+ * Given back, it joins the class fitting its capacity, unless that class
+ * already keeps as many free buffers as it ever had in use at once, or the
+ * buffer is larger than all classes: it is then freed.
+ * Taking so only allocates while the sizes or the number of buffers held at
+ * once reach new highs.
+ *
+ * All buffers must be given back before the subscription is finalized.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [1]
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ * <i>[1] only if no free buffer fits the message</i>
+ *
+ * \param[in] subscription the handle to the subscription from which to take
+ * \param[inout] serialized_message pointer set to the taken buffer, must point to `NULL`
+ * \param[out] message_info rmw struct which contains meta-data for the message
+ * \param[in] allocation structure pointer used for memory preallocation (may be NULL)
+ * \return #RCL_RET_OK if the message was taken, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_SUBSCRIPTION_INVALID if the subscription is invalid, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCL_RET_SUBSCRIPTION_TAKE_FAILED if take failed but no error
+ *         occurred in the middleware, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_take_pooled_serialized_message(
+  const rcl_subscription_t * subscription,
+  rcl_serialized_message_t ** serialized_message,
+  rmw_message_info_t * message_info,
+  rmw_subscription_allocation_t * allocation);
+
+/// Give back a buffer taken with rcl_take_pooled_serialized_message().
+/**
+ * The buffer may be given back from another thread than the one taking.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] subscription the handle to the subscription the buffer was taken from
+ * \param[in] serialized_message the buffer to give back
+ * \return #RCL_RET_OK if the buffer was given back, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_SUBSCRIPTION_INVALID if the subscription is invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_return_pooled_serialized_message(
+  const rcl_subscription_t * subscription,
+  rcl_serialized_message_t * serialized_message);
+
 /// Take a loaned message from a topic using a rcl subscription.
 /**
  * Depending on the middleware, incoming messages can be loaned to the user's callback
@@ -604,6 +745,16 @@ rcl_take_serialized_message(
  * The user must not destroy the message, but rather has to return it with a call to
  * \sa rcl_return_loaned_message to the middleware.
  *
+ * Subscriptions receiving within their context, see rcl_subscription_init(),
+ * loan messages allocated by rcl instead, and hand out the messages delivered
+ * within the context as is.
+ *
+ * When the middleware cannot loan, the message is taken with rmw_take_with_info()
+ * into a message of a pool of the subscription instead, as long as the type has
+ * a C introspection type support.
+ * The pool keeps returned messages initialized for the next take, so taking only
+ * allocates while the number of messages loaned at once grows.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
@@ -828,6 +979,9 @@ rcl_subscription_get_actual_qos(const rcl_subscription_t * subscription);
 /**
  * Depending on the middleware and the message type, this will return true if the middleware
  * can allocate a ROS message instance.
+ * Subscriptions receiving within their context can always loan messages, and so
+ * can subscriptions whose type has a C introspection type support, from a pool
+ * of rcl when the middleware cannot.
  *
  * \param[in] subscription The subscription instance to check for the ability to loan messages
  * \return `true` if the subscription instance can loan messages, `false` otherwise.
@@ -836,6 +990,71 @@ RCL_PUBLIC
 bool
 rcl_subscription_can_loan_messages(const rcl_subscription_t * subscription);
 
+/// Get a snapshot of the traffic counted by a subscription.
+/**
+ * Every subscription counts the messages taken through rcl_take() and its
+ * serialized, loaned and sequence variants, and the takes which found nothing.
+ * The counters are updated with relaxed atomics.
+ * They can be compiled out of rcl by turning off the `RCL_ENABLE_TRAFFIC_COUNTERS`
+ * CMake option, in which case this function returns #RCL_RET_UNSUPPORTED.
+ * The time of the last message taken is only recorded with the
+ * `RCL_ENABLE_TRAFFIC_TIMESTAMPS` CMake option turned on, as it costs a
+ * steady clock read per successful take.
+ *
+ * Each counter is read atomically, but messages being taken concurrently may
+ * be reflected in some counters and not yet in others.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_uint_least64_t`</i>
+ *
+ * \param[in] subscription the subscription which is being queried
+ * \param[out] counters the snapshot
+ * \return #RCL_RET_OK if successful, or
+ * \return #RCL_RET_SUBSCRIPTION_INVALID if the subscription is invalid, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_UNSUPPORTED if rcl was built without traffic counters.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_subscription_get_traffic_counters(
+  const rcl_subscription_t * subscription,
+  rcl_subscription_traffic_counters_t * counters);
+
+/// Get the guard condition triggered by messages delivered within the subscription's context.
+/**
+ * Subscriptions created with `intra_context` set receive messages from the
+ * publishers of their context without the middleware knowing.
+ * rcl_wait_set_add_subscription() adds this guard condition to the wait set,
+ * it is only needed to wait for those messages by other means.
+ *
+ * The guard condition is owned by the subscription and is valid until
+ * rcl_subscription_fini() is called.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] subscription the subscription which is being queried
+ * \return the guard condition, or
+ * \return `NULL` if the subscription is invalid or does not receive within
+ *   its context, e.g. because its QoS does not allow it.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+const rcl_guard_condition_t *
+rcl_subscription_get_intra_context_guard_condition(const rcl_subscription_t * subscription);
+
 /// Set the on new message callback function for the subscription.
 /**
  * This API sets the callback function to be called whenever the
@@ -133,15 +133,23 @@ typedef struct rcl_jump_callback_info_s
   void * user_data;
 } rcl_jump_callback_info_t;
 
+/// Index of the jump callbacks of a clock, internal to rcl.
+typedef struct rcl_jump_callback_registry_s rcl_jump_callback_registry_t;
+
+/// ROS time shared by the #RCL_ROS_TIME clocks bound to it, see rcl_context_get_ros_time_source().
+typedef struct rcl_ros_time_source_s rcl_ros_time_source_t;
+
 /// Encapsulation of a time source.
 typedef struct rcl_clock_s
 {
   /// Clock type
   rcl_clock_type_t type;
-  /// An array of added jump callbacks.
+  /// An array of added jump callbacks, in no particular order.
   rcl_jump_callback_info_t * jump_callbacks;
   /// Number of callbacks in jump_callbacks.
   size_t num_jump_callbacks;
+  /// Index of jump_callbacks by callback and by threshold.
+  rcl_jump_callback_registry_t * jump_callback_registry;
   /// Pointer to get_now function
   rcl_ret_t (* get_now)(void * data, rcl_time_point_value_t * now);
   // void (*set_now) (rcl_time_point_value_t);
@@ -423,6 +431,73 @@ rcl_ret_t
 rcl_steady_clock_fini(
   rcl_clock_t * clock);
 
+/// Initialize a clock as a #RCL_STEADY_TIME time source reading the CPU timestamp counter.
+/**
+ * Reading the steady clock goes through the operating system, e.g.
+ * `clock_gettime()`, on every call.
+ * Where the CPU has a timestamp counter running at a constant rate, i.e. an
+ * invariant TSC on x86 or the generic timer on aarch64, this clock reads the
+ * counter instead and converts it to steady time, which costs a few
+ * nanoseconds.
+ * Elsewhere, or if the operating system found the counter unreliable, the
+ * clock falls back to reading the steady clock like rcl_steady_clock_init(),
+ * see rcl_fast_steady_clock_is_supported().
+ *
+ * The counter is calibrated against the steady clock once per process, on
+ * first use, which takes about 20 milliseconds on x86.
+ * Its readings are in the same epoch as the steady clock, and are re-anchored
+ * to it every 500 milliseconds by the first read, which keeps them within a
+ * few microseconds of it.
+ * Re-anchoring never steps them back, so a thread never reads them going
+ * backwards as long as the counters of the cores are in step.
+ * Timers of this clock which wait on a kernel timer, see
+ * rcl_wait_set_set_timerfd_wakeup(), have their deadline translated to the
+ * steady clock.
+ * The clock is finalized with rcl_steady_clock_fini() or rcl_clock_fini().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No [1]
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * <i>[1] Function is reentrant, but concurrent calls on the same `clock` object are not safe.</i>
+ *
+ * \param[in] clock the handle to the clock which is being initialized
+ * \param[in] allocator The allocator to use for allocations
+ * \return #RCL_RET_OK if the time source was successfully initialized, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_ERROR an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_fast_steady_clock_init(
+  rcl_clock_t * clock,
+  rcl_allocator_t * allocator);
+
+/// Check whether clocks from rcl_fast_steady_clock_init() read the CPU timestamp counter.
+/**
+ * The first call calibrates the counter if it is usable.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No [1]
+ *
+ * <i>[1] Calls concurrent with the calibration wait for it.</i>
+ *
+ * \return `true` if the timestamp counter is used, `false` if the steady clock is read.
+ */
+RCL_PUBLIC
+bool
+rcl_fast_steady_clock_is_supported(void);
+
 /// Initialize a clock as a #RCL_SYSTEM_TIME time source.
 /**
  * Initialize the clock as a #RCL_SYSTEM_TIME time source.
@@ -673,6 +748,155 @@ rcl_ret_t
 rcl_set_ros_time_override(
   rcl_clock_t * clock, rcl_time_point_value_t time_value);
 
+/// Bind an #RCL_ROS_TIME clock to a shared ROS time source.
+/**
+ * A bound clock reads the time and the override state of the source instead
+ * of its own, so one call to rcl_ros_time_source_set_override() advances all
+ * the clocks bound to the source at once, with a single atomic store, and
+ * runs their jump callbacks.
+ * Calling rcl_enable_ros_time_override(), rcl_disable_ros_time_override() or
+ * rcl_set_ros_time_override() on a bound clock acts on the source, and so on
+ * all the clocks bound to it.
+ *
+ * Binding a clock whose time differs from the time of the source is a time
+ * jump for that clock, and its jump callbacks are called accordingly.
+ * Binding a clock to the source it is already bound to does nothing, while
+ * binding it to another source is an error.
+ * The clock is unbound by rcl_clock_unbind_ros_time_source(), when the clock
+ * is finalized, or when the source is finalized with its context.
+ *
+ * This function is not thread-safe with the other functions changing or
+ * using the ROS time of the source or of any clock bound to it, nor with
+ * rcl_clock_add_jump_callback() and rcl_clock_remove_jump_callback().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] clock The #RCL_ROS_TIME clock to bind.
+ * \param[inout] source The source to bind the clock to.
+ * \return #RCL_RET_OK if the clock was bound successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_BAD_ALLOC if a memory allocation failed, or
+ * \return #RCL_RET_ERROR if the clock is not of type #RCL_ROS_TIME or already bound
+ *   to another source.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_clock_bind_ros_time_source(rcl_clock_t * clock, rcl_ros_time_source_t * source);
+
+/// Unbind an #RCL_ROS_TIME clock from its shared ROS time source.
+/**
+ * The clock keeps the time and override state the source had, so unbinding
+ * is not a time jump.
+ * Unbinding a clock which is not bound does nothing.
+ *
+ * This function has the same thread-safety as rcl_clock_bind_ros_time_source().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] clock The #RCL_ROS_TIME clock to unbind.
+ * \return #RCL_RET_OK if the clock was unbound successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_ERROR if the clock is not of type #RCL_ROS_TIME.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_clock_unbind_ros_time_source(rcl_clock_t * clock);
+
+/// Enable the ROS time override of a shared ROS time source.
+/**
+ * The jump callbacks of every bound clock with a clock change threshold are
+ * called, as by rcl_enable_ros_time_override().
+ *
+ * This function has the same thread-safety as rcl_clock_bind_ros_time_source().
+ *
+ * <hr>
+ * Attribute          | Adherence [1]
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * <i>[1] Only applies to the function itself, as jump callbacks may not abide to it.</i>
+ *
+ * \param[inout] source The source to enable the override of.
+ * \return #RCL_RET_OK if the override was enabled successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_ros_time_source_enable_override(rcl_ros_time_source_t * source);
+
+/// Disable the ROS time override of a shared ROS time source.
+/**
+ * The jump callbacks of every bound clock with a clock change threshold are
+ * called, as by rcl_disable_ros_time_override().
+ *
+ * This function has the same thread-safety as rcl_clock_bind_ros_time_source().
+ *
+ * <hr>
+ * Attribute          | Adherence [1]
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * <i>[1] Only applies to the function itself, as jump callbacks may not abide to it.</i>
+ *
+ * \param[inout] source The source to disable the override of.
+ * \return #RCL_RET_OK if the override was disabled successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_ros_time_source_disable_override(rcl_ros_time_source_t * source);
+
+/// Set the current time of a shared ROS time source.
+/**
+ * All bound clocks see the new time at once.
+ * While the override is enabled, the delta of the time jump is computed once
+ * and the jump callbacks of every bound clock whose threshold it exceeds are
+ * called, as by rcl_set_ros_time_override().
+ *
+ * This function has the same thread-safety as rcl_clock_bind_ros_time_source().
+ *
+ * <hr>
+ * Attribute          | Adherence [1]
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * <i>[1] Only applies to the function itself, as jump callbacks may not abide to it.</i>
+ *
+ * \param[inout] source The source to update.
+ * \param[in] time_value The new current time.
+ * \return #RCL_RET_OK if the time was set successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_ros_time_source_set_override(rcl_ros_time_source_t * source, rcl_time_point_value_t time_value);
+
 /// Add a callback to be called when a time jump exceeds a threshold.
 /**
  * The callback is called twice when the threshold is exceeded: once before the clock is
@@ -680,6 +904,12 @@ rcl_set_ros_time_override(
  * The user_data pointer is passed to the callback as the last argument.
  * A callback and user_data pair must be unique among the callbacks added to a clock.
  *
+ * Callbacks are indexed by the kind and magnitude of their thresholds, so a
+ * time jump only visits the callbacks whose threshold it can exceed, and
+ * callbacks are not necessarily called in the order they were added.
+ * Adding a callback takes constant time, amortized over the growth of the
+ * storage of the callbacks.
+ *
  * This function is not thread-safe with rcl_clock_remove_jump_callback(),
  * rcl_enable_ros_time_override(), rcl_disable_ros_time_override() nor
  * rcl_set_ros_time_override() functions when used on the same clock object.
@@ -714,6 +944,9 @@ rcl_clock_add_jump_callback(
 
 /// Remove a previously added time jump callback.
 /**
+ * Removing a callback takes constant time and never allocates, the storage of
+ * the callbacks is kept until the clock is finalized.
+ *
  * This function is not thread-safe with rcl_clock_add_jump_callback()
  * rcl_enable_ros_time_override(), rcl_disable_ros_time_override() nor
  * rcl_set_ros_time_override() functions when used on the same clock object.
@@ -721,7 +954,7 @@ rcl_clock_add_jump_callback(
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | Yes
+ * Allocates Memory   | No
  * Thread-Safe        | No [1]
  * Uses Atomics       | No
  * Lock-Free          | Yes
@@ -733,8 +966,7 @@ rcl_clock_add_jump_callback(
  * \param[in] clock The clock to remove a jump callback from.
  * \param[in] callback The callback to call.
  * \param[in] user_data A pointer to be passed to the callback.
- * \return #RCL_RET_OK if the callback was added successfully, or
- * \return #RCL_RET_BAD_ALLOC if a memory allocation failed, or
+ * \return #RCL_RET_OK if the callback was removed successfully, or
  * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
  * \return #RCL_RET_ERROR the callback was not found or an unspecified error occurs.
  */
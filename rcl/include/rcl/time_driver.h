@@ -0,0 +1,173 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCL__TIME_DRIVER_H_
+#define RCL__TIME_DRIVER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rcl/allocator.h"
+#include "rcl/context.h"
+#include "rcl/macros.h"
+#include "rcl/time.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+
+/// Internal rcl time driver implementation struct.
+typedef struct rcl_time_driver_impl_s rcl_time_driver_impl_t;
+
+/// Driver advancing the ROS time of a context as fast as possible.
+/**
+ * The driver owns the override of the ROS time source of a context, see
+ * rcl_context_get_ros_time_source().
+ * Wait sets attached to it with rcl_wait_set_set_time_driver() report
+ * whenever rcl_wait() is about to block, and when every attached wait set
+ * is blocked the driver sets the time straight to the earliest deadline of
+ * their timers, instead of waiting for it to pass.
+ * This turns a set of executors into a discrete event simulation, running
+ * timers in deadline order and faster than real time.
+ */
+typedef struct rcl_time_driver_s
+{
+  /// Pointer to the time driver implementation
+  rcl_time_driver_impl_t * impl;
+} rcl_time_driver_t;
+
+/// Return a rcl_time_driver_t struct with members set to `NULL`.
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_time_driver_t
+rcl_get_zero_initialized_time_driver(void);
+
+/// Initialize a time driver for the ROS time source of a context.
+/**
+ * The override of the ROS time source of the context is enabled and set to
+ * `start_time`.
+ * Only timers whose #RCL_ROS_TIME clock is bound to that source, see
+ * rcl_clock_bind_ros_time_source(), are driven.
+ * Nothing else may set the time of the source while the driver exists, and
+ * only one driver may be initialized per context.
+ *
+ * The driver only knows about deadlines, it does not wait for messages still
+ * in flight in the middleware: a publication which makes a subscription
+ * ready after every wait set went idle may be taken at a later time than it
+ * would with a real clock.
+ *
+ * Expected usage:
+ *
+ * ```c
+ * #include <rcl/rcl.h>
+ * #include <rcl/time_driver.h>
+ *
+ * rcl_time_driver_t driver = rcl_get_zero_initialized_time_driver();
+ * rcl_ret_t ret = rcl_time_driver_init(&driver, &context, 0, rcl_get_default_allocator());
+ * // ... error handling
+ * ret = rcl_wait_set_set_time_driver(&wait_set, &driver);
+ * // ... error handling, spin the wait set as usual
+ * ret = rcl_wait_set_set_time_driver(&wait_set, NULL);
+ * // ... error handling
+ * ret = rcl_time_driver_fini(&driver);
+ * // ... error handling
+ * ```
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] driver the time driver to be initialized
+ * \param[in] context the context whose ROS time source is driven
+ * \param[in] start_time the ROS time to start at, in nanoseconds
+ * \param[in] allocator the allocator to use for internal allocations
+ * \return #RCL_RET_OK if the driver was initialized successfully, or
+ * \return #RCL_RET_ALREADY_INIT if the driver is already initialized, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_time_driver_init(
+  rcl_time_driver_t * driver,
+  rcl_context_t * context,
+  rcl_time_point_value_t start_time,
+  rcl_allocator_t allocator);
+
+/// Finalize a time driver.
+/**
+ * The override of the ROS time source is disabled, so its clocks go back to
+ * system time.
+ * Wait sets must be detached from the driver before it is finalized, and the
+ * driver must be finalized before its context.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] driver the time driver to be finalized
+ * \return #RCL_RET_OK if the driver was finalized successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_ERROR if wait sets are still attached.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_time_driver_fini(rcl_time_driver_t * driver);
+
+/// Return `true` if the time driver is valid, else `false`.
+RCL_PUBLIC
+bool
+rcl_time_driver_is_valid(const rcl_time_driver_t * driver);
+
+/// Get the number of times the driver advanced the time.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] driver the time driver
+ * \param[out] advance_count the number of advances since initialization
+ * \return #RCL_RET_OK if the count was retrieved successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_time_driver_get_advance_count(const rcl_time_driver_t * driver, uint64_t * advance_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__TIME_DRIVER_H_
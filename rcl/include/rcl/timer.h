@@ -56,6 +56,59 @@ typedef struct rcl_timer_s
  */
 typedef void (* rcl_timer_callback_t)(rcl_timer_t *, int64_t);
 
+/// What rcl_timer_call() does when a timer is called more than one period late.
+typedef enum rcl_timer_catch_up_policy_e
+{
+  /// Skip the missed calls and keep the phase: the next call is at the first
+  /// multiple of the period after the current time.
+  RCL_TIMER_CATCH_UP_SKIP,
+  /// Keep every missed call: the timer stays ready and is called once per
+  /// missed period until it caught up.
+  RCL_TIMER_CATCH_UP_BURST,
+  /// Drop the missed calls and the phase: the next call is one period after
+  /// the current time.
+  RCL_TIMER_CATCH_UP_DRIFT,
+  /// Keep the phase and up to a maximum number of missed calls, dropping the
+  /// oldest ones.
+  RCL_TIMER_CATCH_UP_BOUNDED,
+} rcl_timer_catch_up_policy_t;
+
+/// Number of sub-buckets, as a power of two, each power of two range of a histogram is split into.
+#define RCL_TIMER_STATISTICS_SUB_BUCKET_BITS 3
+/// Number of buckets of the histogram in rcl_timer_statistics_t.
+#define RCL_TIMER_STATISTICS_HISTOGRAM_SIZE \
+  ((64 - RCL_TIMER_STATISTICS_SUB_BUCKET_BITS + 1) << RCL_TIMER_STATISTICS_SUB_BUCKET_BITS)
+
+/// Snapshot of the statistics a timer collects about calls to rcl_timer_call().
+/**
+ * The lateness of a call is how long after the scheduled call time the timer
+ * was called, or 0 if it was called early.
+ * The jitter of a call is how much the time since the previous call differs
+ * from the period, in either direction.
+ *
+ * The histogram uses the same buckets as the histograms of wait set
+ * statistics, see rcl_wait_set_statistics_bucket_lower_bound().
+ */
+typedef struct rcl_timer_statistics_s
+{
+  /// Number of calls to rcl_timer_call() which called or would have called the callback.
+  uint64_t call_count;
+  /// Number of calls dropped because a call was more than one period late.
+  uint64_t missed_period_count;
+  /// Total lateness in nanoseconds over all calls.
+  uint64_t total_lateness;
+  /// Largest lateness in nanoseconds of a single call.
+  uint64_t max_lateness;
+  /// Total steady time in nanoseconds spent in the callback.
+  uint64_t total_callback_duration;
+  /// Longest steady time in nanoseconds spent in a single callback.
+  uint64_t max_callback_duration;
+  /// Largest jitter in nanoseconds of a single call.
+  uint64_t max_jitter;
+  /// Histogram of the lateness in nanoseconds of each call.
+  uint64_t lateness_histogram[RCL_TIMER_STATISTICS_HISTOGRAM_SIZE];
+} rcl_timer_statistics_t;
+
 /// Return a zero initialized timer.
 RCL_PUBLIC
 RCL_WARN_UNUSED
@@ -205,6 +258,9 @@ rcl_timer_fini(rcl_timer_t * timer);
  *  - Ensure the timer has not been canceled.
  *  - Get the current time into a temporary rcl_steady_time_point_t.
  *  - Exchange the current time with the last call time of the timer.
+ *  - Advance the next call time by one period, or as the catch-up policy of
+ *    the timer decides if the call is more than one period late, see
+ *    rcl_timer_set_catch_up_policy().
  *  - Call the callback, passing this timer and the time since the last call.
  *  - Return after the callback has completed.
  *
@@ -234,6 +290,41 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_timer_call(rcl_timer_t * timer);
 
+/// Call the timer's callback, using a caller-supplied reading of its clock.
+/**
+ * This function behaves like rcl_timer_call(), except that it does not query
+ * the timer's clock and uses `now` as the current time instead.
+ * This lets a caller that services many timers on the same clock read that
+ * clock once, e.g. once per wait cycle, and share the reading between them.
+ *
+ * `now` must have been read from the clock of this timer, see
+ * rcl_timer_clock(), and should be recent, otherwise the last call time and
+ * the next call time of the timer will be computed from a stale time.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes [1]
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [2]
+ * <i>[1] user callback might not be thread-safe</i>
+ *
+ * <i>[2] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[inout] timer the handle to the timer to call
+ * \param[in] now the current time according to the timer's clock
+ * \return #RCL_RET_OK if the timer was called successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMER_INVALID if the timer->impl is invalid, or
+ * \return #RCL_RET_TIMER_CANCELED if the timer has been canceled, or
+ * \return #RCL_RET_ERROR if `now` is negative.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_call_with_now(rcl_timer_t * timer, rcl_time_point_value_t now);
+
 /// Retrieve the clock of the timer.
 /**
  * This function retrieves the clock pointer and copies it into the given variable.
@@ -289,6 +380,36 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_timer_is_ready(const rcl_timer_t * timer, bool * is_ready);
 
+/// Calculates whether or not the timer should be called at the given time.
+/**
+ * This function behaves like rcl_timer_is_ready(), except that it does not
+ * query the timer's clock and compares against `now` instead.
+ * `now` must have been read from the clock of this timer.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer which is being checked
+ * \param[in] now the current time according to the timer's clock
+ * \param[out] is_ready the bool used to store the result of the calculation
+ * \return #RCL_RET_OK if the readiness was calculated successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMER_INVALID if the timer->impl is invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_is_ready_with_now(
+  const rcl_timer_t * timer,
+  rcl_time_point_value_t now,
+  bool * is_ready);
+
 /// Calculate and retrieve the time until the next call in nanoseconds.
 /**
  * This function calculates the time until the next call by adding the timer's
@@ -325,6 +446,70 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_timer_get_time_until_next_call(const rcl_timer_t * timer, int64_t * time_until_next_call);
 
+/// Calculate the time until the next call relative to the given time.
+/**
+ * This function behaves like rcl_timer_get_time_until_next_call(), except
+ * that it does not query the timer's clock and uses `now` as the current time
+ * instead.
+ * `now` must have been read from the clock of this timer.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer that is being queried
+ * \param[in] now the current time according to the timer's clock
+ * \param[out] time_until_next_call the output variable for the result
+ * \return #RCL_RET_OK if the timer until next call was successfully calculated, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMER_INVALID if the timer->impl is invalid, or
+ * \return #RCL_RET_TIMER_CANCELED if the timer is canceled.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_get_time_until_next_call_with_now(
+  const rcl_timer_t * timer,
+  rcl_time_point_value_t now,
+  int64_t * time_until_next_call);
+
+/// Retrieve the time at which the timer is next due, in nanoseconds.
+/**
+ * This function retrieves the absolute time, according to the timer's clock,
+ * at which the timer will be ready to be called next.
+ * Unlike rcl_timer_get_time_until_next_call() it does not query the clock,
+ * which makes it cheap enough to be called for many timers which share a
+ * clock, comparing the results against a single reading of that clock.
+ *
+ * The `next_call_time` argument must point to an allocated int64_t, as the
+ * time is copied into that instance.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer that is being queried
+ * \param[out] next_call_time the output variable for the result
+ * \return #RCL_RET_OK if the next call time was successfully retrieved, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMER_INVALID if the timer->impl is invalid, or
+ * \return #RCL_RET_TIMER_CANCELED if the timer is canceled.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_get_next_call_time(const rcl_timer_t * timer, int64_t * next_call_time);
+
 /// Retrieve the time since the previous call to rcl_timer_call() occurred.
 /**
  * This function calculates the time since the last call and copies it into
@@ -415,6 +600,200 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_timer_exchange_period(const rcl_timer_t * timer, int64_t new_period, int64_t * old_period);
 
+/// Retrieve the slack of the timer.
+/**
+ * The slack argument must be a pointer to an already allocated int64_t.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer which is being queried
+ * \param[out] slack the int64_t in which the slack is stored
+ * \return #RCL_RET_OK if the slack was retrieved successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMER_INVALID if the timer->impl is invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_get_slack(const rcl_timer_t * timer, int64_t * slack);
+
+/// Set how late, in nanoseconds, the timer tolerates being called.
+/**
+ * By default rcl_wait() wakes up at the earliest timer deadline, so timers
+ * with deadlines close to each other each cause their own wake-up.
+ * A timer with slack may be woken up anywhere between its deadline and its
+ * deadline plus the slack, which lets rcl_wait() wake up once for a group of
+ * timers whose windows overlap, similar to Linux timer slack.
+ * rcl_wait() wakes up at the earliest deadline plus slack of its timers, and
+ * then reports every timer whose deadline has passed as ready.
+ *
+ * The slack only affects when rcl_wait() wakes up: the timer is ready as soon
+ * as its deadline has passed, see rcl_timer_is_ready(), and its next call time
+ * keeps advancing by exactly one period.
+ * The default slack is 0.
+ *
+ * Lowering the slack wakes up wait sets which are waiting on the timer, so
+ * they can recompute their timeout.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer which is being modified
+ * \param[in] slack the non-negative slack in nanoseconds
+ * \return #RCL_RET_OK if the slack was set successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMER_INVALID if the timer->impl is invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_set_slack(rcl_timer_t * timer, int64_t slack);
+
+/// Retrieve the catch-up policy of the timer.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer which is being queried
+ * \param[out] policy the catch-up policy of the timer
+ * \param[out] max_backlog the maximum number of missed calls kept pending
+ * \return #RCL_RET_OK if the policy was retrieved successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMER_INVALID if the timer->impl is invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_get_catch_up_policy(
+  const rcl_timer_t * timer,
+  rcl_timer_catch_up_policy_t * policy,
+  int64_t * max_backlog);
+
+/// Set what rcl_timer_call() does when the timer is called more than one period late.
+/**
+ * A call is on time as long as it happens before the call after it is due,
+ * and then the next call time always advances by exactly one period.
+ * Calls which are later than that missed one or more periods, which are
+ * handled according to the policy:
+ *
+ *  - #RCL_TIMER_CATCH_UP_SKIP drops the missed calls and keeps the phase of
+ *    the timer, this is the default.
+ *  - #RCL_TIMER_CATCH_UP_BURST keeps every missed call pending, so the timer
+ *    remains ready and is called once per period until it caught up, e.g. to
+ *    log samples without gaps.
+ *  - #RCL_TIMER_CATCH_UP_DRIFT drops the missed calls and schedules the next
+ *    call one period after the current time, which bounds the load of
+ *    overloaded control loops.
+ *  - #RCL_TIMER_CATCH_UP_BOUNDED keeps the phase like skip, but keeps up to
+ *    `max_backlog` of the most recent missed calls pending like burst.
+ *
+ * Missed calls which are dropped are counted in the statistics of the timer,
+ * see rcl_timer_get_statistics().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer which is being modified
+ * \param[in] policy the catch-up policy
+ * \param[in] max_backlog the non-negative maximum number of missed calls kept
+ *   pending, only used by #RCL_TIMER_CATCH_UP_BOUNDED
+ * \return #RCL_RET_OK if the policy was set successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMER_INVALID if the timer->impl is invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_set_catch_up_policy(
+  rcl_timer_t * timer,
+  rcl_timer_catch_up_policy_t policy,
+  int64_t max_backlog);
+
+/// Enable or disable the collection of statistics about calls to rcl_timer_call().
+/**
+ * Statistics are disabled by default, and while disabled rcl_timer_call()
+ * does no additional work.
+ * While enabled, each call updates a few counters, and calls with a callback
+ * read the steady clock twice to measure it.
+ * Enabling the statistics resets them to zero, even if they were already
+ * enabled.
+ *
+ * This function must not be called concurrently with rcl_timer_call() or
+ * rcl_timer_get_statistics() on the same timer.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] timer the handle to the timer which is being modified
+ * \param[in] enable `true` to collect statistics, `false` to stop and release them
+ * \return #RCL_RET_OK if the timer was configured successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMER_INVALID if the timer->impl is invalid, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_set_statistics(rcl_timer_t * timer, bool enable);
+
+/// Get a snapshot of the statistics collected by a timer.
+/**
+ * This may be called from any thread while other threads call the timer, it
+ * never blocks them.
+ * Each counter is read atomically, but calls in progress may be reflected in
+ * some counters and not yet in others.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_uint_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer which is being queried
+ * \param[out] statistics the snapshot
+ * \return #RCL_RET_OK if successful, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_TIMER_INVALID if the timer->impl is invalid, or
+ * \return #RCL_RET_ERROR if statistics are not enabled.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_get_statistics(const rcl_timer_t * timer, rcl_timer_statistics_t * statistics);
+
 /// Return the current timer callback.
 /**
  * This function can fail, and therefore return `NULL`, if:
@@ -24,12 +24,14 @@ extern "C"
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "rcl/client.h"
 #include "rcl/guard_condition.h"
 #include "rcl/macros.h"
 #include "rcl/service.h"
 #include "rcl/subscription.h"
+#include "rcl/time_driver.h"
 #include "rcl/timer.h"
 #include "rcl/event.h"
 #include "rcl/types.h"
@@ -68,6 +70,81 @@ typedef struct rcl_wait_set_s
   rcl_wait_set_impl_t * impl;
 } rcl_wait_set_t;
 
+/// Kinds of entities which can be stored in a wait set.
+typedef enum rcl_wait_set_entity_type_e
+{
+  /// Subscriptions, see rcl_wait_set_add_subscription()
+  RCL_WAIT_SET_SUBSCRIPTION,
+  /// Guard conditions, see rcl_wait_set_add_guard_condition()
+  RCL_WAIT_SET_GUARD_CONDITION,
+  /// Timers, see rcl_wait_set_add_timer()
+  RCL_WAIT_SET_TIMER,
+  /// Clients, see rcl_wait_set_add_client()
+  RCL_WAIT_SET_CLIENT,
+  /// Services, see rcl_wait_set_add_service()
+  RCL_WAIT_SET_SERVICE,
+  /// Events, see rcl_wait_set_add_event()
+  RCL_WAIT_SET_EVENT
+} rcl_wait_set_entity_type_t;
+
+/// An entity found ready by rcl_wait(), see rcl_wait_set_get_ready_list().
+typedef struct rcl_wait_set_ready_entry_s
+{
+  /// Type of the entity.
+  rcl_wait_set_entity_type_t entity_type;
+  /// Index of the entity in the storage of its type, e.g. `wait_set->timers`.
+  size_t index;
+  /// Key given to the entity with rcl_wait_set_set_entity_key().
+  int64_t key;
+} rcl_wait_set_ready_entry_t;
+
+/// Number of sub-buckets, as a power of two, each power of two range of a histogram is split into.
+#define RCL_WAIT_SET_STATISTICS_SUB_BUCKET_BITS 3
+/// Number of buckets of each histogram in rcl_wait_set_statistics_t.
+#define RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE \
+  ((64 - RCL_WAIT_SET_STATISTICS_SUB_BUCKET_BITS + 1) << RCL_WAIT_SET_STATISTICS_SUB_BUCKET_BITS)
+
+/// Snapshot of the statistics a wait set collects about calls to rcl_wait().
+/**
+ * Every call to rcl_wait() which did not fail is counted under exactly one
+ * wake reason: a timeout when the timeout given by the caller expired, an
+ * entity wake when any subscription, guard condition, client, service or
+ * event was ready, a timer wake when only timers were ready, and otherwise a
+ * spurious wake.
+ * Spurious wakes happen when the middleware returns early, or for timers
+ * whose deadline was reached but which were not ready, e.g. #RCL_ROS_TIME
+ * timers while ROS time is active.
+ *
+ * The histograms are log-linear like HDR histograms: values below
+ * `2^RCL_WAIT_SET_STATISTICS_SUB_BUCKET_BITS` have a bucket each, and every
+ * larger power of two range is split into that many buckets.
+ * Use rcl_wait_set_statistics_bucket_lower_bound() to get the smallest value
+ * counted by a bucket.
+ */
+typedef struct rcl_wait_set_statistics_s
+{
+  /// Number of calls to rcl_wait() which did not fail.
+  uint64_t wait_count;
+  /// Number of calls which returned because the timeout expired.
+  uint64_t timeout_wake_count;
+  /// Number of calls which returned with entities other than timers ready.
+  uint64_t entity_wake_count;
+  /// Number of calls which returned with only timers ready.
+  uint64_t timer_wake_count;
+  /// Number of calls which returned before the timeout with nothing ready.
+  uint64_t spurious_wake_count;
+  /// Total number of ready entities other than timers over all calls.
+  uint64_t ready_entity_count;
+  /// Total number of ready timers over all calls.
+  uint64_t ready_timer_count;
+  /// Total time in nanoseconds spent blocked in the middleware.
+  uint64_t blocked_time;
+  /// Histogram of the time in nanoseconds each call spent blocked.
+  uint64_t blocked_time_histogram[RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE];
+  /// Histogram of the number of ready entities, including timers, of each call.
+  uint64_t ready_count_histogram[RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE];
+} rcl_wait_set_statistics_t;
+
 /// Return a rcl_wait_set_t struct with members set to `NULL`.
 RCL_PUBLIC
 RCL_WARN_UNUSED
@@ -206,6 +283,10 @@ rcl_wait_set_get_allocator(const rcl_wait_set_t * wait_set, rcl_allocator_t * al
  * Also add the rmw representation to the underlying rmw array and increment
  * the rmw array count.
  *
+ * A subscription receiving within its context also has its guard condition
+ * waited on, see rcl_subscription_get_intra_context_guard_condition(), and
+ * rcl_wait() reports it as ready while messages delivered so are queued.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
@@ -260,21 +341,26 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_wait_set_clear(rcl_wait_set_t * wait_set);
 
-/// Reallocate space for entities in the wait set.
+/// Resize the entity sets of the wait set.
 /**
- * This function will deallocate and reallocate the memory for all entity sets.
- *
- * A size of 0 will just deallocate the memory and assign `NULL` to the array.
+ * The rcl and rmw storage of all entity sets lives in a single block of
+ * memory, which has a capacity for each entity type.
+ * If every requested size fits in the current capacity, no allocation is
+ * done.
+ * Otherwise the block is replaced by one in which each capacity that was too
+ * small has at least doubled, so growing a wait set one entity at a time
+ * reallocates only a logarithmic number of times.
+ * The storage never shrinks here, use rcl_wait_set_shrink_to_fit() to
+ * release unused capacity.
  *
  * Allocation and deallocation is done with the allocator given during the
  * wait set's initialization.
  *
  * After calling this function all values in the set will be set to `NULL`,
  * effectively the same as calling rcl_wait_set_clear().
- * Similarly, the underlying rmw representation is reallocated and reset:
+ * Similarly, the underlying rmw representation is reset:
  * all entries are set to `NULL` and the count is set to zero.
- *
- * If the requested size matches the current size, no allocation will be done.
+ * If allocating memory fails, all sizes are set to zero.
  *
  * This can be called on an uninitialized (zero initialized) wait set.
  *
@@ -310,6 +396,32 @@ rcl_wait_set_resize(
   size_t services_size,
   size_t events_size);
 
+/// Release the capacity of the wait set beyond its current sizes.
+/**
+ * The storage is reallocated to fit the current sizes exactly, or released
+ * if they are all zero.
+ * Like rcl_wait_set_resize() with the current sizes, this removes all
+ * entities from the wait set.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to shrink
+ * \return #RCL_RET_OK if the wait set was shrunk successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_shrink_to_fit(rcl_wait_set_t * wait_set);
+
 /// Store a pointer to the guard condition in the next empty spot in the set.
 /**
  * This function behaves exactly the same as for subscriptions.
@@ -375,6 +487,583 @@ rcl_wait_set_add_event(
   const rcl_event_t * event,
   size_t * index);
 
+/// Make the entities of a wait set stay registered across calls to rcl_wait().
+/**
+ * By default rcl_wait() sets the entries of entities which are not ready to
+ * `NULL`, so callers clear and refill the wait set before every wait.
+ * A persistent wait set instead keeps its storage untouched by rcl_wait():
+ * entities are added once, removed individually with the
+ * `rcl_wait_set_remove_*` functions, and the entities which became ready are
+ * reported through rcl_wait_set_get_ready_indices().
+ *
+ * Removed slots are reused by later additions, so an index returned when
+ * adding an entity stays valid until that entity is removed.
+ * Timers that are canceled stay registered and are simply never ready.
+ *
+ * Changing the mode clears the wait set, see rcl_wait_set_clear().
+ * rcl_wait_set_clear() and rcl_wait_set_resize() also remove every entity
+ * from a persistent wait set.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to configure
+ * \param[in] persistent `true` to make the wait set persistent, `false` to restore the default
+ * \return #RCL_RET_OK if the mode was changed successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_set_persistent(rcl_wait_set_t * wait_set, bool persistent);
+
+/// Return `true` if the wait set is valid and persistent, else `false`.
+/**
+ * \see rcl_wait_set_set_persistent
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to be queried
+ * \return `true` if the wait set is persistent, otherwise `false`.
+ */
+RCL_PUBLIC
+bool
+rcl_wait_set_is_persistent(const rcl_wait_set_t * wait_set);
+
+/// Remove the subscription at the given index from a persistent wait set.
+/**
+ * The entry at `index` is set to `NULL` and its slot is reused by the next
+ * call to rcl_wait_set_add_subscription().
+ * This takes constant time regardless of the number of entities in the set.
+ * Indices reported by rcl_wait_set_get_ready_indices() may be stale after
+ * removing an entity.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set struct in which the subscription is stored
+ * \param[in] index the index of the subscription, as returned when it was added
+ * \return #RCL_RET_OK if removed successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid or no
+ *   subscription is stored at `index`, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_ERROR if the wait set is not persistent.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_remove_subscription(rcl_wait_set_t * wait_set, size_t index);
+
+/// Remove the guard condition at the given index from a persistent wait set.
+/**
+ * This function behaves exactly the same as for subscriptions.
+ * \see rcl_wait_set_remove_subscription
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_remove_guard_condition(rcl_wait_set_t * wait_set, size_t index);
+
+/// Remove the timer at the given index from a persistent wait set.
+/**
+ * This function behaves exactly the same as for subscriptions.
+ * \see rcl_wait_set_remove_subscription
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_remove_timer(rcl_wait_set_t * wait_set, size_t index);
+
+/// Remove the client at the given index from a persistent wait set.
+/**
+ * This function behaves exactly the same as for subscriptions.
+ * \see rcl_wait_set_remove_subscription
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_remove_client(rcl_wait_set_t * wait_set, size_t index);
+
+/// Remove the service at the given index from a persistent wait set.
+/**
+ * This function behaves exactly the same as for subscriptions.
+ * \see rcl_wait_set_remove_subscription
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_remove_service(rcl_wait_set_t * wait_set, size_t index);
+
+/// Remove the event at the given index from a persistent wait set.
+/**
+ * This function behaves exactly the same as for subscriptions.
+ * \see rcl_wait_set_remove_subscription
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_remove_event(rcl_wait_set_t * wait_set, size_t index);
+
+/// Get the indices of the entities found ready by the last call to rcl_wait().
+/**
+ * Only persistent wait sets track ready indices, see
+ * rcl_wait_set_set_persistent().
+ * The returned array holds `ready_count` indices into the storage of the
+ * requested entity type, e.g. `wait_set->subscriptions`, so callers only visit
+ * the entities which are ready instead of scanning the whole storage.
+ *
+ * The array is owned by the wait set and is overwritten by the next call to
+ * rcl_wait(); it is invalidated by adding or removing entities and by
+ * rcl_wait_set_clear(), rcl_wait_set_resize() and rcl_wait_set_fini().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to be queried
+ * \param[in] entity_type the type of entity to get the ready indices of
+ * \param[out] ready_indices pointer to the array of ready indices
+ * \param[out] ready_count number of ready indices in the array
+ * \return #RCL_RET_OK if successful, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_ERROR if the wait set is not persistent.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_get_ready_indices(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t entity_type,
+  const size_t ** ready_indices,
+  size_t * ready_count);
+
+/// Add a wait set as a child of another wait set.
+/**
+ * A call to rcl_wait() on a wait set with children blocks until an entity of
+ * the wait set itself or of any of its descendants is ready, with a single
+ * call to rmw_wait().
+ * Afterwards every wait set of the hierarchy looks as if rcl_wait() had been
+ * called on it alone: entities which are not ready are set to `NULL` in the
+ * storage of the wait sets which are not persistent, and persistent wait sets
+ * report their ready entities through rcl_wait_set_get_ready_indices().
+ * The children which had ready entities, directly or through their own
+ * children, are reported by rcl_wait_set_get_ready_wait_sets().
+ *
+ * Each wait set keeps managing its own entities, e.g. a callback group can
+ * clear and refill its wait set without touching the parent.
+ * Unlike entities, children are not removed by rcl_wait_set_clear() and
+ * rcl_wait_set_resize(); they stay until rcl_wait_set_remove_wait_set().
+ * Finalizing a wait set removes it from its parent and removes its children.
+ *
+ * A wait set has at most one parent, and only the root of a hierarchy can
+ * wait on its children: rcl_wait() on a wait set with both a parent and
+ * children returns #RCL_RET_ERROR.
+ * The adaptive spin, timer wake-up and statistics settings of the root apply
+ * to the whole hierarchy, those of the children are ignored.
+ *
+ * The root waits on a persistent wait set holding the entities of the whole
+ * hierarchy, which adding and removing entities or children in any wait set of
+ * the hierarchy update right away, so that rcl_wait() only visits the ready
+ * entities and the storage of the wait sets which are not persistent.
+ * That storage is allocated by the first wait and grows geometrically when an
+ * addition does not fit, on the following rcl_wait().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set struct in which the child is to be stored
+ * \param[in] child the wait set to be added, initialized with the same context
+ * \param[out] index the index of the added child, optional
+ * \return #RCL_RET_OK if added successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, the child
+ *   belongs to another context, already has a parent or adding it would create
+ *   a cycle, or
+ * \return #RCL_RET_WAIT_SET_INVALID if either wait set is zero initialized, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_add_wait_set(
+  rcl_wait_set_t * wait_set,
+  rcl_wait_set_t * child,
+  size_t * index);
+
+/// Remove the child wait set at the given index.
+/**
+ * The index of the other children does not change and the index is reused by
+ * the next child added.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set holding the child
+ * \param[in] index the index returned by rcl_wait_set_add_wait_set()
+ * \return #RCL_RET_OK if removed successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if there is no child at the index, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_remove_wait_set(rcl_wait_set_t * wait_set, size_t index);
+
+/// Get the indices of the children found ready by the last call to rcl_wait().
+/**
+ * The returned array holds `ready_count` indices, as returned by
+ * rcl_wait_set_add_wait_set(), of the children which have ready entities,
+ * directly or through their own children.
+ *
+ * The array is owned by the wait set and is overwritten by the next call to
+ * rcl_wait(); it is invalidated by adding or removing children and by
+ * rcl_wait_set_fini().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to be queried
+ * \param[out] ready_indices pointer to the array of ready child indices
+ * \param[out] ready_count number of ready child indices in the array
+ * \return #RCL_RET_OK if successful, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_get_ready_wait_sets(
+  const rcl_wait_set_t * wait_set,
+  const size_t ** ready_indices,
+  size_t * ready_count);
+
+/// Make rcl_wait() report the ready entities in a single list ordered by key.
+/**
+ * Every storage slot of the wait set gets an integer key, 0 unless set with
+ * rcl_wait_set_set_entity_key().
+ * After each call to rcl_wait(), rcl_wait_set_get_ready_list() returns the
+ * ready entities of all types, ordered by ascending key, so an executor can
+ * dispatch the most urgent work first without scanning the storage of each
+ * type.
+ * Entities with equal keys are ordered by type, in the order of
+ * rcl_wait_set_entity_type_t, and then by index.
+ *
+ * The key is up to the caller: a priority, where lower is more urgent, or an
+ * absolute deadline, e.g. the time the entity was last handled plus its
+ * relative deadline, both work.
+ *
+ * Enabling the ready list allocates storage for the keys and the list, sized
+ * by the capacity of the wait set.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to configure
+ * \param[in] enable `true` to order ready entities by key, `false` to release the storage
+ * \return #RCL_RET_OK if the setting was changed successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_set_ready_list(rcl_wait_set_t * wait_set, bool enable);
+
+/// Set the key by which the entity in the given slot is ordered in the ready list.
+/**
+ * The key belongs to the storage slot, given by the index returned when the
+ * entity was added, and is reset to 0 by rcl_wait_set_clear() and
+ * rcl_wait_set_resize().
+ * A persistent wait set keeps the key of a removed entity for the next entity
+ * added in the same slot, unless it is set again.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set holding the entity
+ * \param[in] entity_type the type of the entity
+ * \param[in] index the index of the entity in the storage of its type
+ * \param[in] key the key, lower keys come first in the ready list
+ * \return #RCL_RET_OK if the key was set successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_ERROR if the ready list is not enabled.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_set_entity_key(
+  rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t entity_type,
+  size_t index,
+  int64_t key);
+
+/// Get the entities found ready by the last call to rcl_wait(), ordered by key.
+/**
+ * The array is owned by the wait set and is overwritten by the next call to
+ * rcl_wait(); it is invalidated by rcl_wait_set_clear(),
+ * rcl_wait_set_resize() and rcl_wait_set_fini().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to be queried
+ * \param[out] ready_list pointer to the array of ready entities
+ * \param[out] ready_count number of ready entities in the array
+ * \return #RCL_RET_OK if successful, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_ERROR if the ready list is not enabled.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_get_ready_list(
+  const rcl_wait_set_t * wait_set,
+  const rcl_wait_set_ready_entry_t ** ready_list,
+  size_t * ready_count);
+
+/// Make rcl_wait() wake up for steady and system timers at their absolute deadline.
+/**
+ * By default the earliest timer deadline is turned into a relative timeout
+ * for rmw_wait(), which inherits the error of converting the deadline and the
+ * granularity with which the middleware rounds its timeouts.
+ * When enabled, rmw_wait() is instead given a timeout ending `margin`
+ * nanoseconds before the earliest deadline of a #RCL_STEADY_TIME or
+ * #RCL_SYSTEM_TIME timer, and if it times out the rest of the wait is spent
+ * on a Linux timerfd armed with `TFD_TIMER_ABSTIME` at the deadline itself.
+ *
+ * Entities which become ready during that final stretch are only reported by
+ * the next call to rcl_wait(), so `margin` bounds the extra latency for them
+ * and should cover the wake-up error of the middleware.
+ * The timerfd never sleeps longer than `margin` on the steady clock, and
+ * setting the system clock ends the sleep for a #RCL_SYSTEM_TIME deadline.
+ * #RCL_ROS_TIME timers keep the default behavior.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to configure
+ * \param[in] enable `true` to enable absolute timer wake-ups, `false` to disable them
+ * \param[in] margin time in nanoseconds before a deadline at which rmw_wait() hands over
+ * \return #RCL_RET_OK if the wait set was configured successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_UNSUPPORTED if the platform does not provide timerfd, or
+ * \return #RCL_RET_ERROR if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_set_timerfd_wakeup(rcl_wait_set_t * wait_set, bool enable, int64_t margin);
+
+/// Make rcl_wait() poll without blocking for a while before it blocks.
+/**
+ * Waking up a thread blocked in rmw_wait() costs a futex or condition
+ * variable round trip.
+ * Latency sensitive callers which can spare a core may instead let
+ * rcl_wait() poll the middleware with a zero timeout, and only block once the
+ * spin budget is spent.
+ *
+ * The spin budget adapts to how often polling succeeded recently: it is
+ * `max_spin_budget` while polls keep finding entities ready, and shrinks down
+ * to a sixteenth of it while they keep falling back to blocking.
+ * With `use_pause`, polls are spaced by an exponentially growing number of
+ * CPU pause instructions, easing the load on the middleware and on a sibling
+ * hyper-thread.
+ * The time spent polling counts towards the timeout of rcl_wait(), and
+ * non-blocking calls to rcl_wait() never poll more than once.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to configure
+ * \param[in] max_spin_budget longest time in nanoseconds to poll, 0 disables polling
+ * \param[in] use_pause `true` to back off with pause instructions between polls
+ * \return #RCL_RET_OK if the wait set was configured successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_set_adaptive_spin(rcl_wait_set_t * wait_set, int64_t max_spin_budget, bool use_pause);
+
+/// Attach the wait set to a time driver, or detach it.
+/**
+ * While attached, each call to rcl_wait() which may block tells the driver
+ * the earliest next call time of the timers in the wait set whose clock is
+ * bound to the ROS time source of the driver.
+ * Once every attached wait set is blocked, the driver advances the time to
+ * the earliest of those deadlines, see rcl_time_driver_init().
+ * A wait set which is not blocked, e.g. because it is busy executing
+ * callbacks or never calls rcl_wait(), holds the time still.
+ *
+ * Attaching a wait set which is attached to another driver detaches it first.
+ * Passing `NULL` as the driver detaches the wait set, which
+ * rcl_wait_set_fini() also does.
+ *
+ * This function must not be called concurrently with rcl_wait() on any wait
+ * set attached to the same driver.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to attach or detach
+ * \param[in] driver the time driver to attach to, or `NULL` to detach
+ * \return #RCL_RET_OK if the wait set was attached or detached successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if the driver is invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_set_time_driver(rcl_wait_set_t * wait_set, rcl_time_driver_t * driver);
+
+/// Enable or disable the collection of statistics about calls to rcl_wait().
+/**
+ * Statistics are disabled by default, and while disabled rcl_wait() does no
+ * additional work.
+ * While enabled, each call to rcl_wait() reads the steady clock twice and
+ * updates a few counters.
+ * Enabling the statistics resets them to zero, even if they were already
+ * enabled.
+ *
+ * This function must not be called concurrently with rcl_wait() or
+ * rcl_wait_set_get_statistics() on the same wait set.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to configure
+ * \param[in] enable `true` to collect statistics, `false` to stop and release them
+ * \return #RCL_RET_OK if the wait set was configured successfully, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_set_statistics(rcl_wait_set_t * wait_set, bool enable);
+
+/// Get a snapshot of the statistics collected by a wait set.
+/**
+ * This may be called from any thread while another thread is in rcl_wait(),
+ * it never blocks the waiting thread.
+ * The snapshot is consistent, i.e. it reflects a whole number of calls to
+ * rcl_wait().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to get the statistics of
+ * \param[out] statistics the snapshot
+ * \return #RCL_RET_OK if successful, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_ERROR if statistics are not enabled.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_get_statistics(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_statistics_t * statistics);
+
+/// Get the smallest value counted by a bucket of a histogram in rcl_wait_set_statistics_t.
+/**
+ * A bucket counts the values from its lower bound up to, but excluding, the
+ * lower bound of the next bucket.
+ *
+ * \param[in] bucket index of the bucket
+ * \return the lower bound, or `UINT64_MAX` if the bucket index is out of range.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+uint64_t
+rcl_wait_set_statistics_bucket_lower_bound(size_t bucket);
+
 /// Block until the wait set is ready or until the timeout has been exceeded.
 /**
  * This function will collect the items in the rcl_wait_set_t and pass them
@@ -452,6 +1141,10 @@ rcl_wait_set_add_event(
  * comes first.
  * Passing a timeout struct with uninitialized memory is undefined behavior.
  *
+ * If the wait set is persistent, see rcl_wait_set_set_persistent(), its
+ * storage is left untouched and the entities which are ready are reported by
+ * rcl_wait_set_get_ready_indices() instead.
+ *
  * This function is thread-safe for unique wait sets with unique contents.
  * This function cannot operate on the same wait set in multiple threads, and
  * the wait sets may not share content.
@@ -472,6 +1165,64 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout);
 
+/// Wait like rcl_wait(), then take a batch of messages from every ready subscription.
+/**
+ * After the wait, up to `max_messages_per_subscription` messages are taken
+ * from each ready subscription with a single call to rmw_take_sequence(),
+ * instead of one rcl_take() per message.
+ * Each subscription is validated once per batch rather than once per message.
+ *
+ * `message_sequences` and `message_info_sequences` must have one element for
+ * each subscription slot of the wait set, i.e. `size_of_subscriptions`.
+ * The messages of the subscription at index `i` of the wait set are stored in
+ * `message_sequences[i]`, whose `data` must point to preallocated messages of
+ * the subscription's type, and their meta information in
+ * `message_info_sequences[i]`.
+ * Fewer messages are taken if the capacity of either sequence is smaller than
+ * `max_messages_per_subscription`.
+ * The sizes of the sequences of subscriptions which were not ready are set to
+ * zero.
+ *
+ * Other ready entities are reported in the wait set as by rcl_wait(), and
+ * the ready subscriptions stay in the wait set as well.
+ * Messages which arrive after the wait are only taken up to the limit, the
+ * remaining ones are left for the next call.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [1]
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ * <i>[1] only if storage in the preallocated messages is insufficient</i>
+ *
+ * \param[inout] wait_set the set of things to be waited on and to be pruned if not ready
+ * \param[in] timeout the duration to wait for the wait set to be ready, in nanoseconds
+ * \param[in] max_messages_per_subscription the most messages to take from one subscription
+ * \param[inout] message_sequences a message sequence per subscription slot
+ * \param[inout] message_info_sequences a message info sequence per subscription slot
+ * \param[out] taken_count total number of messages taken
+ * \return #RCL_RET_OK something in the wait set became ready, or
+ * \return #RCL_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCL_RET_WAIT_SET_INVALID if the wait set is zero initialized, or
+ * \return #RCL_RET_WAIT_SET_EMPTY if the wait set contains no items, or
+ * \return #RCL_RET_TIMEOUT if the timeout expired before something was ready, or
+ * \return #RCL_RET_SUBSCRIPTION_INVALID if a ready subscription is invalid, or
+ * \return #RCL_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCL_RET_ERROR an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_and_take(
+  rcl_wait_set_t * wait_set,
+  int64_t timeout,
+  size_t max_messages_per_subscription,
+  rmw_message_sequence_t * message_sequences,
+  rmw_message_info_sequence_t * message_info_sequences,
+  size_t * taken_count);
+
 /// Return `true` if the wait set is valid, else `false`.
 /**
  * A wait set is invalid if:
@@ -0,0 +1,72 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./clock_snapshot.h"
+
+#include <stdint.h>
+
+void
+rcl_clock_snapshot_reset(rcl_clock_snapshot_t * snapshot)
+{
+  snapshot->count = 0u;
+}
+
+rcl_ret_t
+rcl_clock_snapshot_get_now(
+  rcl_clock_snapshot_t * snapshot,
+  rcl_clock_t * clock,
+  rcl_time_point_value_t * now)
+{
+  for (size_t i = 0u; i < snapshot->count; ++i) {
+    if (snapshot->get_now[i] == clock->get_now && snapshot->data[i] == clock->data) {
+      *now = snapshot->now[i];
+      return RCL_RET_OK;
+    }
+  }
+  rcl_ret_t ret = rcl_clock_get_now(clock, now);
+  if (RCL_RET_OK != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  if (snapshot->count < RCL_CLOCK_SNAPSHOT_CAPACITY) {
+    snapshot->get_now[snapshot->count] = clock->get_now;
+    snapshot->data[snapshot->count] = clock->data;
+    snapshot->now[snapshot->count] = *now;
+    ++snapshot->count;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_clock_snapshot_get_timer_now(
+  rcl_clock_snapshot_t * snapshot,
+  const rcl_timer_t * timer,
+  rcl_time_point_value_t * now)
+{
+  rcl_clock_t * clock = NULL;
+  // rcl_timer_clock() does not modify the timer.
+  rcl_ret_t ret = rcl_timer_clock((rcl_timer_t *)(uintptr_t)timer, &clock);
+  if (RCL_RET_OK != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  return rcl_clock_snapshot_get_now(snapshot, clock, now);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,69 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__CLOCK_SNAPSHOT_H_
+#define RCL__CLOCK_SNAPSHOT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "rcl/time.h"
+#include "rcl/timer.h"
+#include "rcl/types.h"
+
+/// Number of distinct time sources remembered by one snapshot.
+#define RCL_CLOCK_SNAPSHOT_CAPACITY 8
+
+/// Readings of the clocks used during one wait cycle, read at most once each.
+/**
+ * Clocks are told apart by their time source rather than by address: every
+ * steady clock reads the same source, and so does every system clock, while
+ * each ROS time clock has its own storage.
+ * Once the snapshot is full, further time sources are read on every call.
+ */
+typedef struct rcl_clock_snapshot_s
+{
+  size_t count;
+  rcl_ret_t (* get_now[RCL_CLOCK_SNAPSHOT_CAPACITY])(void * data, rcl_time_point_value_t * now);
+  void * data[RCL_CLOCK_SNAPSHOT_CAPACITY];
+  rcl_time_point_value_t now[RCL_CLOCK_SNAPSHOT_CAPACITY];
+} rcl_clock_snapshot_t;
+
+/// Forget all readings, so the next lookups read the clocks again.
+void
+rcl_clock_snapshot_reset(rcl_clock_snapshot_t * snapshot);
+
+/// Get the time of the clock, reading it only if its source was not read yet.
+rcl_ret_t
+rcl_clock_snapshot_get_now(
+  rcl_clock_snapshot_t * snapshot,
+  rcl_clock_t * clock,
+  rcl_time_point_value_t * now);
+
+/// Get the time of the timer's clock, see rcl_clock_snapshot_get_now().
+rcl_ret_t
+rcl_clock_snapshot_get_timer_now(
+  rcl_clock_snapshot_t * snapshot,
+  const rcl_timer_t * timer,
+  rcl_time_point_value_t * now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__CLOCK_SNAPSHOT_H_
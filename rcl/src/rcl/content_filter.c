@@ -0,0 +1,1075 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./content_filter.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rcl/error_handling.h"
+#include "rosidl_runtime_c/string.h"
+#include "rosidl_typesupport_introspection_c/field_types.h"
+
+#include "./message_introspection.h"
+
+typedef rosidl_typesupport_introspection_c__MessageMember rcl_message_member_t;
+
+// The boolean stack of a program is the bits of an integer, which bounds both
+// the stack depth and the nesting of the expression.
+#define RCL_CONTENT_FILTER_MAX_DEPTH 64u
+#define RCL_CONTENT_FILTER_MAX_PATH 8u
+#define RCL_CONTENT_FILTER_NO_INDEX SIZE_MAX
+
+typedef enum rcl_content_filter_value_kind_e
+{
+  RCL_CONTENT_FILTER_INT,
+  RCL_CONTENT_FILTER_UINT,
+  RCL_CONTENT_FILTER_FLOAT,
+  RCL_CONTENT_FILTER_STRING,
+} rcl_content_filter_value_kind_t;
+
+typedef struct rcl_content_filter_value_s
+{
+  rcl_content_filter_value_kind_t kind;
+  union
+  {
+    int64_t i;
+    uint64_t u;
+    double f;
+  } number;
+  const char * data;
+  size_t size;
+} rcl_content_filter_value_t;
+
+typedef struct rcl_content_filter_step_s
+{
+  const rcl_message_member_t * member;
+  // element of an array member, RCL_CONTENT_FILTER_NO_INDEX otherwise
+  size_t index;
+} rcl_content_filter_step_t;
+
+// A field of the message or a value known at compile time.
+typedef struct rcl_content_filter_operand_s
+{
+  bool is_field;
+  rcl_content_filter_step_t steps[RCL_CONTENT_FILTER_MAX_PATH];
+  size_t step_count;
+  uint8_t type_id;
+  rcl_content_filter_value_t value;
+  // storage of a string value, owned by the program
+  char * string;
+} rcl_content_filter_operand_t;
+
+typedef enum rcl_content_filter_opcode_e
+{
+  RCL_CONTENT_FILTER_COMPARE,
+  RCL_CONTENT_FILTER_BETWEEN,
+  RCL_CONTENT_FILTER_LIKE,
+  RCL_CONTENT_FILTER_AND,
+  RCL_CONTENT_FILTER_OR,
+  RCL_CONTENT_FILTER_NOT,
+} rcl_content_filter_opcode_t;
+
+typedef enum rcl_content_filter_relation_e
+{
+  RCL_CONTENT_FILTER_EQ,
+  RCL_CONTENT_FILTER_NE,
+  RCL_CONTENT_FILTER_LT,
+  RCL_CONTENT_FILTER_LE,
+  RCL_CONTENT_FILTER_GT,
+  RCL_CONTENT_FILTER_GE,
+} rcl_content_filter_relation_t;
+
+// Predicates push their result on the boolean stack, AND and OR pop two
+// results and push one, NOT flips the top.
+typedef struct rcl_content_filter_instruction_s
+{
+  rcl_content_filter_opcode_t opcode;
+  rcl_content_filter_relation_t relation;
+  // compared operands, the bounds of BETWEEN are the second and the third
+  rcl_content_filter_operand_t operands[3];
+} rcl_content_filter_instruction_t;
+
+struct rcl_content_filter_s
+{
+  rcl_content_filter_instruction_t * program;
+  size_t length;
+  size_t capacity;
+  rcl_allocator_t allocator;
+};
+
+typedef enum rcl_content_filter_token_kind_e
+{
+  RCL_CONTENT_FILTER_TOKEN_END,
+  RCL_CONTENT_FILTER_TOKEN_IDENTIFIER,
+  RCL_CONTENT_FILTER_TOKEN_INTEGER,
+  RCL_CONTENT_FILTER_TOKEN_FLOAT,
+  RCL_CONTENT_FILTER_TOKEN_STRING,
+  RCL_CONTENT_FILTER_TOKEN_PARAMETER,
+  RCL_CONTENT_FILTER_TOKEN_RELATION,
+  RCL_CONTENT_FILTER_TOKEN_LPAREN,
+  RCL_CONTENT_FILTER_TOKEN_RPAREN,
+  RCL_CONTENT_FILTER_TOKEN_LBRACKET,
+  RCL_CONTENT_FILTER_TOKEN_RBRACKET,
+  RCL_CONTENT_FILTER_TOKEN_DOT,
+  RCL_CONTENT_FILTER_TOKEN_AND,
+  RCL_CONTENT_FILTER_TOKEN_OR,
+  RCL_CONTENT_FILTER_TOKEN_NOT,
+  RCL_CONTENT_FILTER_TOKEN_BETWEEN,
+  RCL_CONTENT_FILTER_TOKEN_LIKE,
+  RCL_CONTENT_FILTER_TOKEN_TRUE,
+  RCL_CONTENT_FILTER_TOKEN_FALSE,
+} rcl_content_filter_token_kind_t;
+
+typedef struct rcl_content_filter_token_s
+{
+  rcl_content_filter_token_kind_t kind;
+  rcl_content_filter_relation_t relation;
+  const char * start;
+  size_t length;
+  size_t offset;
+} rcl_content_filter_token_t;
+
+typedef struct rcl_content_filter_parser_s
+{
+  const char * expression;
+  size_t position;
+  rcl_content_filter_token_t token;
+  const rcl_message_members_t * members;
+  size_t argc;
+  const char * const * argv;
+  rcl_content_filter_t * filter;
+  // boolean stack depth of the program so far, and nesting of the expression
+  size_t depth;
+  size_t nesting;
+  rcl_ret_t ret;
+} rcl_content_filter_parser_t;
+
+static const struct
+{
+  const char * word;
+  rcl_content_filter_token_kind_t kind;
+} __keywords[] = {
+  {"and", RCL_CONTENT_FILTER_TOKEN_AND},
+  {"or", RCL_CONTENT_FILTER_TOKEN_OR},
+  {"not", RCL_CONTENT_FILTER_TOKEN_NOT},
+  {"between", RCL_CONTENT_FILTER_TOKEN_BETWEEN},
+  {"like", RCL_CONTENT_FILTER_TOKEN_LIKE},
+  {"true", RCL_CONTENT_FILTER_TOKEN_TRUE},
+  {"false", RCL_CONTENT_FILTER_TOKEN_FALSE},
+};
+
+// Keywords are case insensitive, anything else is a field name.
+static rcl_content_filter_token_kind_t
+__keyword(const char * start, size_t length)
+{
+  for (size_t k = 0u; k < sizeof(__keywords) / sizeof(__keywords[0]); ++k) {
+    const char * word = __keywords[k].word;
+    size_t i = 0u;
+    while (i < length && '\0' != word[i] && tolower((unsigned char)start[i]) == word[i]) {
+      ++i;
+    }
+    if (i == length && '\0' == word[i]) {
+      return __keywords[k].kind;
+    }
+  }
+  return RCL_CONTENT_FILTER_TOKEN_IDENTIFIER;
+}
+
+static size_t
+__lex_number(const char * text, size_t i, rcl_content_filter_token_kind_t * kind)
+{
+  *kind = RCL_CONTENT_FILTER_TOKEN_INTEGER;
+  if ('-' == text[i] || '+' == text[i]) {
+    ++i;
+  }
+  if ('0' == text[i] && ('x' == text[i + 1] || 'X' == text[i + 1])) {
+    i += 2u;
+    while (isxdigit((unsigned char)text[i])) {
+      ++i;
+    }
+    return i;
+  }
+  while (isdigit((unsigned char)text[i])) {
+    ++i;
+  }
+  if ('.' == text[i]) {
+    *kind = RCL_CONTENT_FILTER_TOKEN_FLOAT;
+    ++i;
+    while (isdigit((unsigned char)text[i])) {
+      ++i;
+    }
+  }
+  if ('e' == text[i] || 'E' == text[i]) {
+    *kind = RCL_CONTENT_FILTER_TOKEN_FLOAT;
+    ++i;
+    if ('-' == text[i] || '+' == text[i]) {
+      ++i;
+    }
+    while (isdigit((unsigned char)text[i])) {
+      ++i;
+    }
+  }
+  return i;
+}
+
+// Read the token starting at or after `*position`, false on a character
+// which starts no token or an unterminated string.
+static bool
+__lex(const char * text, size_t * position, rcl_content_filter_token_t * token)
+{
+  size_t i = *position;
+  while (isspace((unsigned char)text[i])) {
+    ++i;
+  }
+  token->start = text + i;
+  token->offset = i;
+  const char c = text[i];
+  const bool signed_number =
+    ('-' == c || '+' == c || '.' == c) && isdigit((unsigned char)text[i + 1]);
+  if ('\0' == c) {
+    token->kind = RCL_CONTENT_FILTER_TOKEN_END;
+  } else if (isalpha((unsigned char)c) || '_' == c) {
+    while (isalnum((unsigned char)text[i]) || '_' == text[i]) {
+      ++i;
+    }
+    token->kind = __keyword(token->start, i - token->offset);
+  } else if (isdigit((unsigned char)c) || signed_number) {
+    i = __lex_number(text, i, &token->kind);
+  } else if ('\'' == c) {
+    do {
+      ++i;
+    } while ('\0' != text[i] && '\'' != text[i]);
+    if ('\0' == text[i]) {
+      return false;
+    }
+    ++i;
+    token->kind = RCL_CONTENT_FILTER_TOKEN_STRING;
+  } else if ('%' == c && isdigit((unsigned char)text[i + 1])) {
+    do {
+      ++i;
+    } while (isdigit((unsigned char)text[i]));
+    token->kind = RCL_CONTENT_FILTER_TOKEN_PARAMETER;
+  } else {
+    const char next = text[i + 1];
+    ++i;
+    token->kind = RCL_CONTENT_FILTER_TOKEN_RELATION;
+    switch (c) {
+      case '(':
+        token->kind = RCL_CONTENT_FILTER_TOKEN_LPAREN;
+        break;
+      case ')':
+        token->kind = RCL_CONTENT_FILTER_TOKEN_RPAREN;
+        break;
+      case '[':
+        token->kind = RCL_CONTENT_FILTER_TOKEN_LBRACKET;
+        break;
+      case ']':
+        token->kind = RCL_CONTENT_FILTER_TOKEN_RBRACKET;
+        break;
+      case '.':
+        token->kind = RCL_CONTENT_FILTER_TOKEN_DOT;
+        break;
+      case '=':
+        token->relation = RCL_CONTENT_FILTER_EQ;
+        break;
+      case '!':
+        if ('=' != next) {
+          return false;
+        }
+        ++i;
+        token->relation = RCL_CONTENT_FILTER_NE;
+        break;
+      case '<':
+        token->relation = RCL_CONTENT_FILTER_LT;
+        if ('=' == next || '>' == next) {
+          ++i;
+          token->relation = '=' == next ? RCL_CONTENT_FILTER_LE : RCL_CONTENT_FILTER_NE;
+        }
+        break;
+      case '>':
+        token->relation = RCL_CONTENT_FILTER_GT;
+        if ('=' == next) {
+          ++i;
+          token->relation = RCL_CONTENT_FILTER_GE;
+        }
+        break;
+      default:
+        return false;
+    }
+  }
+  token->length = i - token->offset;
+  *position = i;
+  return true;
+}
+
+// Record the first error of a compilation, always false.
+static bool
+__fail(rcl_content_filter_parser_t * parser, rcl_ret_t ret, const char * reason)
+{
+  if (RCL_RET_OK == parser->ret) {
+    parser->ret = ret;
+    if (RCL_RET_BAD_ALLOC == ret) {
+      RCL_SET_ERROR_MSG(reason);
+    } else {
+      RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "invalid content filter expression '%s' at offset %zu: %s",
+        parser->expression, parser->token.offset, reason);
+    }
+  }
+  return false;
+}
+
+static bool
+__advance(rcl_content_filter_parser_t * parser)
+{
+  if (!__lex(parser->expression, &parser->position, &parser->token)) {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, "unexpected character");
+  }
+  return true;
+}
+
+static bool
+__expect(
+  rcl_content_filter_parser_t * parser,
+  rcl_content_filter_token_kind_t kind,
+  const char * reason)
+{
+  if (kind != parser->token.kind) {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, reason);
+  }
+  return __advance(parser);
+}
+
+static void
+__operand_fini(rcl_content_filter_operand_t * operand, const rcl_allocator_t * allocator)
+{
+  if (NULL != operand->string) {
+    allocator->deallocate(operand->string, allocator->state);
+    operand->string = NULL;
+  }
+}
+
+static void
+__instruction_fini(
+  rcl_content_filter_instruction_t * instruction,
+  const rcl_allocator_t * allocator)
+{
+  for (size_t i = 0u; i < 3u; ++i) {
+    __operand_fini(&instruction->operands[i], allocator);
+  }
+}
+
+// Turn a literal token, of the expression or of a parameter, into a value.
+static bool
+__parse_literal(
+  rcl_content_filter_parser_t * parser,
+  const rcl_content_filter_token_t * token,
+  rcl_content_filter_operand_t * operand)
+{
+  rcl_content_filter_value_t * value = &operand->value;
+  char buffer[64];
+  switch (token->kind) {
+    case RCL_CONTENT_FILTER_TOKEN_TRUE:
+    case RCL_CONTENT_FILTER_TOKEN_FALSE:
+      value->kind = RCL_CONTENT_FILTER_INT;
+      value->number.i = RCL_CONTENT_FILTER_TOKEN_TRUE == token->kind ? 1 : 0;
+      return true;
+    case RCL_CONTENT_FILTER_TOKEN_STRING:
+      {
+        const size_t size = token->length - 2u;
+        operand->string =
+          (char *)parser->filter->allocator.allocate(size + 1u, parser->filter->allocator.state);
+        if (NULL == operand->string) {
+          return __fail(parser, RCL_RET_BAD_ALLOC, "failed to allocate content filter string");
+        }
+        memcpy(operand->string, token->start + 1, size);
+        operand->string[size] = '\0';
+        value->kind = RCL_CONTENT_FILTER_STRING;
+        value->data = operand->string;
+        value->size = size;
+        return true;
+      }
+    case RCL_CONTENT_FILTER_TOKEN_INTEGER:
+    case RCL_CONTENT_FILTER_TOKEN_FLOAT:
+      break;
+    default:
+      return __fail(parser, RCL_RET_INVALID_ARGUMENT, "expected a field or a value");
+  }
+  if (token->length >= sizeof(buffer)) {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, "number is too long");
+  }
+  memcpy(buffer, token->start, token->length);
+  buffer[token->length] = '\0';
+  errno = 0;
+  if (RCL_CONTENT_FILTER_TOKEN_FLOAT == token->kind) {
+    value->kind = RCL_CONTENT_FILTER_FLOAT;
+    value->number.f = strtod(buffer, NULL);
+  } else {
+    const char * digits = '-' == buffer[0] || '+' == buffer[0] ? buffer + 1 : buffer;
+    const int base = '0' == digits[0] && ('x' == digits[1] || 'X' == digits[1]) ? 16 : 10;
+    if ('-' == buffer[0]) {
+      value->kind = RCL_CONTENT_FILTER_INT;
+      value->number.i = strtoll(buffer, NULL, base);
+    } else {
+      value->number.u = strtoull(buffer, NULL, base);
+      value->kind = value->number.u > INT64_MAX ? RCL_CONTENT_FILTER_UINT : RCL_CONTENT_FILTER_INT;
+    }
+  }
+  if (ERANGE == errno) {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, "number is out of range");
+  }
+  return true;
+}
+
+// A parameter holds exactly one literal, with the same syntax as in the expression.
+static bool
+__parse_parameter(rcl_content_filter_parser_t * parser, rcl_content_filter_operand_t * operand)
+{
+  const unsigned long long index = strtoull(parser->token.start + 1, NULL, 10);  // NOLINT
+  if (index >= parser->argc) {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, "parameter index is out of range");
+  }
+  const char * text = parser->argv[index];
+  if (NULL == text) {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, "parameter is null");
+  }
+  size_t position = 0u;
+  rcl_content_filter_token_t literal;
+  rcl_content_filter_token_t end;
+  if (
+    !__lex(text, &position, &literal) || !__lex(text, &position, &end) ||
+    RCL_CONTENT_FILTER_TOKEN_END != end.kind ||
+    RCL_CONTENT_FILTER_TOKEN_IDENTIFIER == literal.kind ||
+    RCL_CONTENT_FILTER_TOKEN_PARAMETER == literal.kind)
+  {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, "parameter is not a single value");
+  }
+  return __parse_literal(parser, &literal, operand);
+}
+
+static const rcl_message_member_t *
+__find_member(
+  const rcl_message_members_t * members,
+  const rcl_content_filter_token_t * token)
+{
+  for (uint32_t i = 0u; i < members->member_count_; ++i) {
+    const rcl_message_member_t * member = &members->members_[i];
+    if (0 == strncmp(member->name_, token->start, token->length) &&
+      '\0' == member->name_[token->length])
+    {
+      return member;
+    }
+  }
+  return NULL;
+}
+
+// Resolve a dotted path to the member offsets, and array indexes, to read.
+static bool
+__parse_field(rcl_content_filter_parser_t * parser, rcl_content_filter_operand_t * operand)
+{
+  const rcl_message_members_t * members = parser->members;
+  const rcl_message_member_t * member = NULL;
+  operand->is_field = true;
+  for (;;) {
+    if (RCL_CONTENT_FILTER_TOKEN_IDENTIFIER != parser->token.kind) {
+      return __fail(parser, RCL_RET_INVALID_ARGUMENT, "expected a field name");
+    }
+    if (NULL == members) {
+      return __fail(parser, RCL_RET_INVALID_ARGUMENT, "field has no members");
+    }
+    member = __find_member(members, &parser->token);
+    if (NULL == member) {
+      return __fail(parser, RCL_RET_INVALID_ARGUMENT, "unknown field");
+    }
+    if (RCL_CONTENT_FILTER_MAX_PATH == operand->step_count) {
+      return __fail(parser, RCL_RET_INVALID_ARGUMENT, "field path is too long");
+    }
+    rcl_content_filter_step_t * step = &operand->steps[operand->step_count++];
+    step->member = member;
+    step->index = RCL_CONTENT_FILTER_NO_INDEX;
+    if (!__advance(parser)) {
+      return false;
+    }
+    if (member->is_array_) {
+      if (!__expect(parser, RCL_CONTENT_FILTER_TOKEN_LBRACKET, "array field needs an index")) {
+        return false;
+      }
+      rcl_content_filter_operand_t index = {0};
+      if (
+        RCL_CONTENT_FILTER_TOKEN_INTEGER != parser->token.kind ||
+        !__parse_literal(parser, &parser->token, &index) ||
+        (RCL_CONTENT_FILTER_INT == index.value.kind && index.value.number.i < 0))
+      {
+        return __fail(parser, RCL_RET_INVALID_ARGUMENT, "expected an array index");
+      }
+      step->index = (size_t)index.value.number.u;
+      if (
+        !__advance(parser) ||
+        !__expect(parser, RCL_CONTENT_FILTER_TOKEN_RBRACKET, "expected ']'"))
+      {
+        return false;
+      }
+    }
+    members = rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE == member->type_id_ ?
+      (const rcl_message_members_t *)member->members_->data : NULL;
+    if (RCL_CONTENT_FILTER_TOKEN_DOT != parser->token.kind) {
+      break;
+    }
+    if (!__advance(parser)) {
+      return false;
+    }
+  }
+  if (rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE == member->type_id_) {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, "cannot compare a message field");
+  }
+  if (rosidl_typesupport_introspection_c__ROS_TYPE_WSTRING == member->type_id_) {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, "wstring fields are not supported");
+  }
+  operand->type_id = member->type_id_;
+  return true;
+}
+
+static bool
+__parse_operand(rcl_content_filter_parser_t * parser, rcl_content_filter_operand_t * operand)
+{
+  switch (parser->token.kind) {
+    case RCL_CONTENT_FILTER_TOKEN_IDENTIFIER:
+      return __parse_field(parser, operand);
+    case RCL_CONTENT_FILTER_TOKEN_PARAMETER:
+      return __parse_parameter(parser, operand) && __advance(parser);
+    default:
+      return __parse_literal(parser, &parser->token, operand) && __advance(parser);
+  }
+}
+
+static bool
+__is_string(const rcl_content_filter_operand_t * operand)
+{
+  return operand->is_field ?
+         rosidl_typesupport_introspection_c__ROS_TYPE_STRING == operand->type_id :
+         RCL_CONTENT_FILTER_STRING == operand->value.kind;
+}
+
+// Check that the operands of a predicate can be compared, a one character
+// string compared with a number stands for the character code.
+static bool
+__check_predicate(
+  rcl_content_filter_parser_t * parser,
+  rcl_content_filter_instruction_t * instruction)
+{
+  rcl_content_filter_operand_t * operands = instruction->operands;
+  if (RCL_CONTENT_FILTER_LIKE == instruction->opcode) {
+    if (
+      !operands[0].is_field || !__is_string(&operands[0]) ||
+      operands[1].is_field || !__is_string(&operands[1]))
+    {
+      return __fail(
+        parser, RCL_RET_INVALID_ARGUMENT, "LIKE needs a string field and a string pattern");
+    }
+    return true;
+  }
+  const size_t count = RCL_CONTENT_FILTER_BETWEEN == instruction->opcode ? 3u : 2u;
+  const rcl_content_filter_operand_t * field = operands[0].is_field ? &operands[0] :
+    (RCL_CONTENT_FILTER_COMPARE == instruction->opcode && operands[1].is_field ?
+    &operands[1] : NULL);
+  if (NULL == field) {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, "predicate needs a field");
+  }
+  const bool is_string = __is_string(field);
+  for (size_t i = 0u; i < count; ++i) {
+    rcl_content_filter_operand_t * operand = &operands[i];
+    if (__is_string(operand) == is_string) {
+      continue;
+    }
+    if (operand->is_field || 1u != operand->value.size) {
+      return __fail(parser, RCL_RET_INVALID_ARGUMENT, "cannot compare a string with a number");
+    }
+    const unsigned char code = (unsigned char)operand->value.data[0];
+    __operand_fini(operand, &parser->filter->allocator);
+    operand->value.kind = RCL_CONTENT_FILTER_INT;
+    operand->value.number.i = code;
+  }
+  return true;
+}
+
+// Append an instruction, the program owns it even on failure.
+static bool
+__emit(rcl_content_filter_parser_t * parser, rcl_content_filter_instruction_t * instruction)
+{
+  rcl_content_filter_t * filter = parser->filter;
+  if (instruction->opcode <= RCL_CONTENT_FILTER_LIKE) {
+    if (RCL_CONTENT_FILTER_MAX_DEPTH == parser->depth) {
+      __instruction_fini(instruction, &filter->allocator);
+      return __fail(parser, RCL_RET_INVALID_ARGUMENT, "expression has too many terms");
+    }
+    ++parser->depth;
+  } else if (RCL_CONTENT_FILTER_NOT != instruction->opcode) {
+    --parser->depth;
+  }
+  if (filter->length == filter->capacity) {
+    const size_t capacity = 0u == filter->capacity ? 8u : 2u * filter->capacity;
+    rcl_content_filter_instruction_t * program =
+      (rcl_content_filter_instruction_t *)filter->allocator.reallocate(
+      filter->program, capacity * sizeof(rcl_content_filter_instruction_t),
+      filter->allocator.state);
+    if (NULL == program) {
+      __instruction_fini(instruction, &filter->allocator);
+      return __fail(parser, RCL_RET_BAD_ALLOC, "failed to allocate content filter program");
+    }
+    filter->program = program;
+    filter->capacity = capacity;
+  }
+  filter->program[filter->length++] = *instruction;
+  return true;
+}
+
+static bool
+__emit_opcode(rcl_content_filter_parser_t * parser, rcl_content_filter_opcode_t opcode)
+{
+  rcl_content_filter_instruction_t instruction = {0};
+  instruction.opcode = opcode;
+  return __emit(parser, &instruction);
+}
+
+static bool
+__parse_predicate_operands(
+  rcl_content_filter_parser_t * parser,
+  rcl_content_filter_instruction_t * instruction,
+  bool * negate)
+{
+  rcl_content_filter_operand_t * operands = instruction->operands;
+  if (!__parse_operand(parser, &operands[0])) {
+    return false;
+  }
+  if (RCL_CONTENT_FILTER_TOKEN_NOT == parser->token.kind) {
+    *negate = true;
+    if (!__advance(parser)) {
+      return false;
+    }
+  }
+  switch (parser->token.kind) {
+    case RCL_CONTENT_FILTER_TOKEN_RELATION:
+      if (*negate) {
+        break;
+      }
+      instruction->opcode = RCL_CONTENT_FILTER_COMPARE;
+      instruction->relation = parser->token.relation;
+      return __advance(parser) && __parse_operand(parser, &operands[1]);
+    case RCL_CONTENT_FILTER_TOKEN_BETWEEN:
+      instruction->opcode = RCL_CONTENT_FILTER_BETWEEN;
+      return
+        __advance(parser) && __parse_operand(parser, &operands[1]) &&
+        __expect(parser, RCL_CONTENT_FILTER_TOKEN_AND, "expected AND of BETWEEN") &&
+        __parse_operand(parser, &operands[2]);
+    case RCL_CONTENT_FILTER_TOKEN_LIKE:
+      instruction->opcode = RCL_CONTENT_FILTER_LIKE;
+      return __advance(parser) && __parse_operand(parser, &operands[1]);
+    default:
+      break;
+  }
+  return __fail(parser, RCL_RET_INVALID_ARGUMENT, "expected a comparison");
+}
+
+static bool
+__parse_predicate(rcl_content_filter_parser_t * parser)
+{
+  rcl_content_filter_instruction_t instruction = {0};
+  bool negate = false;
+  if (
+    !__parse_predicate_operands(parser, &instruction, &negate) ||
+    !__check_predicate(parser, &instruction))
+  {
+    __instruction_fini(&instruction, &parser->filter->allocator);
+    return false;
+  }
+  return
+    __emit(parser, &instruction) &&
+    (!negate || __emit_opcode(parser, RCL_CONTENT_FILTER_NOT));
+}
+
+static bool
+__parse_condition(rcl_content_filter_parser_t * parser);
+
+static bool
+__parse_primary(rcl_content_filter_parser_t * parser)
+{
+  if (RCL_CONTENT_FILTER_MAX_DEPTH == parser->nesting) {
+    return __fail(parser, RCL_RET_INVALID_ARGUMENT, "expression is nested too deeply");
+  }
+  bool ok = false;
+  ++parser->nesting;
+  if (RCL_CONTENT_FILTER_TOKEN_NOT == parser->token.kind) {
+    ok =
+      __advance(parser) && __parse_primary(parser) &&
+      __emit_opcode(parser, RCL_CONTENT_FILTER_NOT);
+  } else if (RCL_CONTENT_FILTER_TOKEN_LPAREN == parser->token.kind) {
+    ok =
+      __advance(parser) && __parse_condition(parser) &&
+      __expect(parser, RCL_CONTENT_FILTER_TOKEN_RPAREN, "expected ')'");
+  } else {
+    ok = __parse_predicate(parser);
+  }
+  --parser->nesting;
+  return ok;
+}
+
+static bool
+__parse_conjunction(rcl_content_filter_parser_t * parser)
+{
+  if (!__parse_primary(parser)) {
+    return false;
+  }
+  while (RCL_CONTENT_FILTER_TOKEN_AND == parser->token.kind) {
+    if (
+      !__advance(parser) || !__parse_primary(parser) ||
+      !__emit_opcode(parser, RCL_CONTENT_FILTER_AND))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool
+__parse_condition(rcl_content_filter_parser_t * parser)
+{
+  if (!__parse_conjunction(parser)) {
+    return false;
+  }
+  while (RCL_CONTENT_FILTER_TOKEN_OR == parser->token.kind) {
+    if (
+      !__advance(parser) || !__parse_conjunction(parser) ||
+      !__emit_opcode(parser, RCL_CONTENT_FILTER_OR))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+rcl_ret_t
+rcl_content_filter_init(
+  rcl_content_filter_t ** filter,
+  const rosidl_message_type_support_t * type_support,
+  const char * filter_expression,
+  size_t expression_parameters_argc,
+  const char * const * expression_parameters_argv,
+  const rcl_allocator_t * allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(filter, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(filter_expression, RCL_RET_INVALID_ARGUMENT);
+  if (0u != expression_parameters_argc) {
+    RCL_CHECK_ARGUMENT_FOR_NULL(expression_parameters_argv, RCL_RET_INVALID_ARGUMENT);
+  }
+  RCL_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  *filter = NULL;
+  rcl_content_filter_parser_t parser = {0};
+  parser.expression = filter_expression;
+  parser.members = rcl_message_introspection_get_members(type_support);
+  parser.argc = expression_parameters_argc;
+  parser.argv = expression_parameters_argv;
+  parser.ret = RCL_RET_OK;
+  if (NULL == parser.members) {
+    return RCL_RET_OK;
+  }
+  if (!__advance(&parser)) {
+    return parser.ret;
+  }
+  if (RCL_CONTENT_FILTER_TOKEN_END == parser.token.kind) {
+    return RCL_RET_OK;
+  }
+  parser.filter = (rcl_content_filter_t *)allocator->zero_allocate(
+    1u, sizeof(rcl_content_filter_t), allocator->state);
+  if (NULL == parser.filter) {
+    RCL_SET_ERROR_MSG("failed to allocate content filter");
+    return RCL_RET_BAD_ALLOC;
+  }
+  parser.filter->allocator = *allocator;
+  if (__parse_condition(&parser) && RCL_CONTENT_FILTER_TOKEN_END != parser.token.kind) {
+    (void)__fail(&parser, RCL_RET_INVALID_ARGUMENT, "unexpected text after the condition");
+  }
+  if (RCL_RET_OK != parser.ret) {
+    rcl_content_filter_fini(parser.filter);
+    return parser.ret;
+  }
+  *filter = parser.filter;
+  return RCL_RET_OK;
+}
+
+void
+rcl_content_filter_fini(rcl_content_filter_t * filter)
+{
+  if (NULL == filter) {
+    return;
+  }
+  rcl_allocator_t allocator = filter->allocator;
+  for (size_t i = 0u; i < filter->length; ++i) {
+    __instruction_fini(&filter->program[i], &allocator);
+  }
+  if (NULL != filter->program) {
+    allocator.deallocate(filter->program, allocator.state);
+  }
+  allocator.deallocate(filter, allocator.state);
+}
+
+// Address of the field in the message, NULL if an index is past the end of its array.
+static const void *
+__resolve(const rcl_content_filter_operand_t * operand, const void * ros_message)
+{
+  const uint8_t * data = (const uint8_t *)ros_message;
+  for (size_t i = 0u; i < operand->step_count; ++i) {
+    const rcl_content_filter_step_t * step = &operand->steps[i];
+    const rcl_message_member_t * member = step->member;
+    data += member->offset_;
+    if (RCL_CONTENT_FILTER_NO_INDEX != step->index) {
+      size_t size = member->array_size_;
+      if (0u == size || member->is_upper_bound_) {
+        size = member->size_function(data);
+      }
+      if (step->index >= size) {
+        return NULL;
+      }
+      data = (const uint8_t *)member->get_const_function(data, step->index);
+    }
+  }
+  return data;
+}
+
+static bool
+__load(
+  const rcl_content_filter_operand_t * operand,
+  const void * ros_message,
+  rcl_content_filter_value_t * value)
+{
+  if (!operand->is_field) {
+    *value = operand->value;
+    return true;
+  }
+  const void * data = __resolve(operand, ros_message);
+  if (NULL == data) {
+    return false;
+  }
+  value->kind = RCL_CONTENT_FILTER_INT;
+  switch (operand->type_id) {
+    case rosidl_typesupport_introspection_c__ROS_TYPE_FLOAT:
+      value->kind = RCL_CONTENT_FILTER_FLOAT;
+      value->number.f = *(const float *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_DOUBLE:
+      value->kind = RCL_CONTENT_FILTER_FLOAT;
+      value->number.f = *(const double *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_LONG_DOUBLE:
+      value->kind = RCL_CONTENT_FILTER_FLOAT;
+      value->number.f = (double)*(const long double *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_CHAR:
+      value->number.i = *(const signed char *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_BOOLEAN:
+      value->number.i = *(const bool *)data ? 1 : 0;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT8:
+      value->number.i = *(const int8_t *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT16:
+      value->number.i = *(const int16_t *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT32:
+      value->number.i = *(const int32_t *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT64:
+      value->number.i = *(const int64_t *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_OCTET:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT8:
+      value->number.i = *(const uint8_t *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_WCHAR:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT16:
+      value->number.i = *(const uint16_t *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT32:
+      value->number.i = *(const uint32_t *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT64:
+      value->kind = RCL_CONTENT_FILTER_UINT;
+      value->number.u = *(const uint64_t *)data;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_STRING:
+      {
+        const rosidl_runtime_c__String * string = (const rosidl_runtime_c__String *)data;
+        value->kind = RCL_CONTENT_FILTER_STRING;
+        value->data = string->data;
+        value->size = NULL == string->data ? 0u : string->size;
+        break;
+      }
+    default:
+      return false;
+  }
+  return true;
+}
+
+static double
+__to_double(const rcl_content_filter_value_t * value)
+{
+  switch (value->kind) {
+    case RCL_CONTENT_FILTER_INT:
+      return (double)value->number.i;
+    case RCL_CONTENT_FILTER_UINT:
+      return (double)value->number.u;
+    default:
+      return value->number.f;
+  }
+}
+
+// -1, 0 or 1 as `a` is less than, equal to or greater than `b`, 2 if a NaN is involved.
+static int
+__compare(const rcl_content_filter_value_t * a, const rcl_content_filter_value_t * b)
+{
+  if (RCL_CONTENT_FILTER_STRING == a->kind) {
+    const size_t size = a->size < b->size ? a->size : b->size;
+    const int order = 0u == size ? 0 : memcmp(a->data, b->data, size);
+    if (0 != order) {
+      return order < 0 ? -1 : 1;
+    }
+    return (a->size > b->size) - (a->size < b->size);
+  }
+  if (RCL_CONTENT_FILTER_FLOAT == a->kind || RCL_CONTENT_FILTER_FLOAT == b->kind) {
+    const double x = __to_double(a);
+    const double y = __to_double(b);
+    return x < y ? -1 : (x > y ? 1 : (x == y ? 0 : 2));
+  }
+  // Signed values are only ever negative when compared with an unsigned one.
+  if (RCL_CONTENT_FILTER_INT == a->kind && RCL_CONTENT_FILTER_INT == b->kind) {
+    return (a->number.i > b->number.i) - (a->number.i < b->number.i);
+  }
+  if (RCL_CONTENT_FILTER_INT == a->kind && a->number.i < 0) {
+    return -1;
+  }
+  if (RCL_CONTENT_FILTER_INT == b->kind && b->number.i < 0) {
+    return 1;
+  }
+  return (a->number.u > b->number.u) - (a->number.u < b->number.u);
+}
+
+static bool
+__holds(rcl_content_filter_relation_t relation, int order)
+{
+  switch (relation) {
+    case RCL_CONTENT_FILTER_EQ:
+      return 0 == order;
+    case RCL_CONTENT_FILTER_NE:
+      return 0 != order;
+    case RCL_CONTENT_FILTER_LT:
+      return -1 == order;
+    case RCL_CONTENT_FILTER_LE:
+      return -1 == order || 0 == order;
+    case RCL_CONTENT_FILTER_GT:
+      return 1 == order;
+    default:
+      return 1 == order || 0 == order;
+  }
+}
+
+// `%` matches any run of characters and `_` any single character.
+static bool
+__like(const rcl_content_filter_value_t * text, const rcl_content_filter_value_t * pattern)
+{
+  size_t t = 0u;
+  size_t p = 0u;
+  size_t wildcard = SIZE_MAX;
+  size_t resume = 0u;
+  while (t < text->size) {
+    if (p < pattern->size && '%' == pattern->data[p]) {
+      wildcard = p++;
+      resume = t;
+    } else if (
+      p < pattern->size && ('_' == pattern->data[p] || pattern->data[p] == text->data[t]))
+    {
+      ++p;
+      ++t;
+    } else if (SIZE_MAX != wildcard) {
+      p = wildcard + 1u;
+      t = ++resume;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern->size && '%' == pattern->data[p]) {
+    ++p;
+  }
+  return p == pattern->size;
+}
+
+static bool
+__evaluate_predicate(
+  const rcl_content_filter_instruction_t * instruction,
+  const void * ros_message)
+{
+  rcl_content_filter_value_t values[3];
+  const size_t count = RCL_CONTENT_FILTER_BETWEEN == instruction->opcode ? 3u : 2u;
+  for (size_t i = 0u; i < count; ++i) {
+    if (!__load(&instruction->operands[i], ros_message, &values[i])) {
+      return false;
+    }
+  }
+  switch (instruction->opcode) {
+    case RCL_CONTENT_FILTER_COMPARE:
+      return __holds(instruction->relation, __compare(&values[0], &values[1]));
+    case RCL_CONTENT_FILTER_BETWEEN:
+      return
+        __holds(RCL_CONTENT_FILTER_GE, __compare(&values[0], &values[1])) &&
+        __holds(RCL_CONTENT_FILTER_LE, __compare(&values[0], &values[2]));
+    default:
+      return __like(&values[0], &values[1]);
+  }
+}
+
+bool
+rcl_content_filter_evaluate(const rcl_content_filter_t * filter, const void * ros_message)
+{
+  uint64_t stack = 0u;
+  for (size_t i = 0u; i < filter->length; ++i) {
+    const rcl_content_filter_instruction_t * instruction = &filter->program[i];
+    switch (instruction->opcode) {
+      case RCL_CONTENT_FILTER_AND:
+        stack = (stack >> 1u) & (stack | ~(uint64_t)1u);
+        break;
+      case RCL_CONTENT_FILTER_OR:
+        stack = (stack >> 1u) | (stack & 1u);
+        break;
+      case RCL_CONTENT_FILTER_NOT:
+        stack ^= 1u;
+        break;
+      default:
+        stack = (stack << 1u) | (__evaluate_predicate(instruction, ros_message) ? 1u : 0u);
+        break;
+    }
+  }
+  return 0u != (stack & 1u);
+}
+
+#ifdef __cplusplus
+}
+#endif
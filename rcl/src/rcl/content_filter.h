@@ -0,0 +1,75 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__CONTENT_FILTER_H_
+#define RCL__CONTENT_FILTER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcl/allocator.h"
+#include "rcl/types.h"
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+// Content filters evaluated by rcl, for middlewares without content filtered
+// topics and for the messages delivered within a context.
+//
+// The filter expression is the DDS-SQL subset used by ROS 2 filters:
+// predicates `field <op> operand` with the operators =, <>, !=, <, <=, >, >=,
+// `field [NOT] BETWEEN operand AND operand` and `field [NOT] LIKE operand`
+// over strings, with `%` and `_` wildcards, combined with AND, OR, NOT and
+// parentheses.
+// Fields are dotted paths into the message, with `[index]` on array members.
+// Operands are fields, integer, floating point, 'string', TRUE and FALSE
+// literals, or `%n` parameters which hold one such literal.
+//
+// The expression and its parameters are compiled once into a postfix program
+// whose field accesses are resolved to member offsets, evaluating it reads
+// the message in place without allocating.
+typedef struct rcl_content_filter_s rcl_content_filter_t;
+
+/// Compile a filter expression and its parameters for messages of a type.
+/**
+ * `*filter` is left `NULL` without an error if the expression is empty, i.e.
+ * everything matches, or if the type has no C introspection.
+ * A malformed expression, an unknown field or an operand of the wrong type
+ * is reported with RCL_RET_INVALID_ARGUMENT and the error set.
+ */
+rcl_ret_t
+rcl_content_filter_init(
+  rcl_content_filter_t ** filter,
+  const rosidl_message_type_support_t * type_support,
+  const char * filter_expression,
+  size_t expression_parameters_argc,
+  const char * const * expression_parameters_argv,
+  const rcl_allocator_t * allocator);
+
+/// Destroy a compiled filter, `NULL` is ignored.
+void
+rcl_content_filter_fini(rcl_content_filter_t * filter);
+
+/// Whether a message of the type the filter was compiled for matches it.
+bool
+rcl_content_filter_evaluate(const rcl_content_filter_t * filter, const void * ros_message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__CONTENT_FILTER_H_
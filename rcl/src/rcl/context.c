@@ -23,6 +23,8 @@ extern "C"
 
 #include "./common.h"
 #include "./context_impl.h"
+#include "./intra_context.h"
+#include "./ros_time_source.h"
 #include "rcutils/stdatomic_helper.h"
 
 rcl_context_t
@@ -105,6 +107,14 @@ rcl_context_get_rmw_context(rcl_context_t * context)
   return &(context->impl->rmw_context);
 }
 
+rcl_ros_time_source_t *
+rcl_context_get_ros_time_source(rcl_context_t * context)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(context, NULL);
+  RCL_CHECK_FOR_NULL_WITH_MSG(context->impl, "context is zero-initialized", return NULL);
+  return context->impl->ros_time_source;
+}
+
 rcl_ret_t
 __cleanup_context(rcl_context_t * context)
 {
@@ -162,6 +172,14 @@ __cleanup_context(rcl_context_t * context)
       }
     }
 
+    // unbind the remaining clocks and destroy the shared ROS time source
+    if (NULL != context->impl->ros_time_source) {
+      rcl_ros_time_source_fini(context->impl->ros_time_source);
+    }
+
+    // destroy the registry of intra context endpoints, detaching any left
+    rcl_intra_context_fini(context->impl->intra_context);
+
     // clean up copy of argv if valid
     if (NULL != context->impl->argv) {
       int64_t i;
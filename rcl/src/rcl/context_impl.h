@@ -25,6 +25,8 @@ extern "C"
 {
 #endif
 
+struct rcl_intra_context_s;
+
 /// \internal
 struct rcl_context_impl_s
 {
@@ -38,6 +40,10 @@ struct rcl_context_impl_s
   char ** argv;
   /// rmw context.
   rmw_context_t rmw_context;
+  /// ROS time shared by the clocks bound to it.
+  rcl_ros_time_source_t * ros_time_source;
+  /// Publishers and subscriptions exchanging messages without the middleware.
+  struct rcl_intra_context_s * intra_context;
 };
 
 RCL_LOCAL
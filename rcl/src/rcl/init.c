@@ -39,6 +39,8 @@ extern "C"
 #include "./common.h"
 #include "./context_impl.h"
 #include "./init_options_impl.h"
+#include "./intra_context.h"
+#include "./ros_time_source.h"
 
 static atomic_uint_least64_t __rcl_next_unique_id = ATOMIC_VAR_INIT(1);
 
@@ -102,6 +104,20 @@ rcl_init(
     goto fail;
   }
 
+  // Create the ROS time source clocks of this context can share.
+  ret = rcl_ros_time_source_init(&(context->impl->ros_time_source), &allocator);
+  if (RCL_RET_OK != ret) {
+    fail_ret = ret;  // error message already set
+    goto fail;
+  }
+
+  // Create the registry of the publishers and subscriptions delivering within this context.
+  ret = rcl_intra_context_init(&(context->impl->intra_context), &allocator);
+  if (RCL_RET_OK != ret) {
+    fail_ret = ret;  // error message already set
+    goto fail;
+  }
+
   // Copy the argc and argv into the context, if argc >= 0.
   context->impl->argc = argc;
   context->impl->argv = NULL;
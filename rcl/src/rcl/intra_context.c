@@ -0,0 +1,981 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./intra_context.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rcl/error_handling.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/time.h"
+#include "rmw/error_handling.h"
+#include "rosidl_runtime_c/message_initialization.h"
+
+#include "./common.h"
+#include "./message_introspection.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+# include <immintrin.h>
+# define RCL_INTRA_CONTEXT_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+# define RCL_INTRA_CONTEXT_CPU_RELAX() __asm__ __volatile__ ("yield")
+#else
+# define RCL_INTRA_CONTEXT_CPU_RELAX()
+#endif
+
+// Number of subscriptions a delivery collects on the stack, more are collected on the heap.
+#define RCL_INTRA_CONTEXT_DELIVERY_BATCH 16
+
+// Set in the registry lock while a writer holds or waits for it, the lower
+// bits count the readers.
+#define RCL_INTRA_CONTEXT_WRITER ((uint64_t)1 << 63)
+
+typedef struct rcl_intra_context_message_s
+{
+  atomic_uint_least64_t ref_count;
+  const rcl_message_members_t * members;
+  rcl_allocator_t allocator;
+  // filled in by the publisher when delivering the message
+  rmw_gid_t publisher_gid;
+  rmw_time_point_value_t source_timestamp;
+  uint64_t publication_sequence_number;
+  // the message itself, aligned for any member type
+  max_align_t payload[];
+} rcl_intra_context_message_t;
+
+typedef struct rcl_intra_context_list_s
+{
+  void ** items;
+  size_t count;
+  size_t capacity;
+} rcl_intra_context_list_t;
+
+// Part common to publishers and subscriptions.
+typedef struct rcl_intra_context_endpoint_s
+{
+  // registry the endpoint belongs to, NULL once the registry was finalized
+  rcl_intra_context_t * intra_context;
+  // owned by the rmw handle, which outlives the endpoint
+  const char * topic_name;
+  const rosidl_message_type_support_t * type_support;
+  const rcl_message_members_t * members;
+  rmw_qos_reliability_policy_t reliability;
+  // matched endpoints of the other kind, guarded by the registry lock
+  rcl_intra_context_list_t matches;
+  // copy of matches.count, readable without the lock
+  atomic_uint_least64_t match_count;
+  rcl_allocator_t allocator;
+} rcl_intra_context_endpoint_t;
+
+struct rcl_intra_context_publisher_s
+{
+  rcl_intra_context_endpoint_t base;
+  rmw_gid_t gid;
+  atomic_uint_least64_t sequence_number;
+  // number of matched subscriptions listing the publisher as confirmed
+  atomic_uint_least64_t confirmed_count;
+};
+
+struct rcl_intra_context_subscription_s
+{
+  rcl_intra_context_endpoint_t base;
+  // bounded multi-producer multi-consumer ring of messages, see
+  // __subscription_push() and __subscription_pop()
+  atomic_uint_least64_t * sequences;
+  rcl_intra_context_message_t ** ring;
+  uint64_t ring_mask;
+  atomic_uint_least64_t enqueue_position;
+  atomic_uint_least64_t dequeue_position;
+  // history depth, at most the size of the ring
+  uint64_t depth;
+  rcl_guard_condition_t guard_condition;
+  // messages not matching it are not queued, changed under the exclusive lock
+  const rcl_content_filter_t * content_filter;
+  // deliveries collected under the registry lock and not completed yet
+  atomic_uint_least64_t deliveries;
+  // matched publishers the middleware was seen delivering from, guarded by the registry lock
+  rcl_intra_context_list_t confirmed;
+};
+
+// Subscription a delivery serves once the registry lock is released.
+typedef struct rcl_intra_context_delivery_s
+{
+  rcl_intra_context_subscription_t * subscription;
+  const rcl_content_filter_t * content_filter;
+} rcl_intra_context_delivery_t;
+
+struct rcl_intra_context_s
+{
+  atomic_uint_least64_t lock;
+  rcl_intra_context_list_t publishers;
+  rcl_intra_context_list_t subscriptions;
+  rcl_allocator_t allocator;
+};
+
+static void
+__lock_shared(rcl_intra_context_t * intra_context)
+{
+  uint64_t state = rcutils_atomic_load_uint64_t(&intra_context->lock);
+  for (;; ) {
+    if (0u != (state & RCL_INTRA_CONTEXT_WRITER)) {
+      RCL_INTRA_CONTEXT_CPU_RELAX();
+      state = rcutils_atomic_load_uint64_t(&intra_context->lock);
+    } else if (
+      rcutils_atomic_compare_exchange_strong_uint_least64_t(
+        &intra_context->lock, &state, state + 1u))
+    {
+      return;
+    }
+  }
+}
+
+static void
+__unlock_shared(rcl_intra_context_t * intra_context)
+{
+  // There is no atomic subtraction helper, adding the maximum wraps around to a decrement.
+  (void)rcutils_atomic_fetch_add_uint64_t(&intra_context->lock, UINT64_MAX);
+}
+
+static void
+__lock_exclusive(rcl_intra_context_t * intra_context)
+{
+  // Claim the writer bit first, which keeps new readers out, then wait for the current ones.
+  uint64_t state = rcutils_atomic_load_uint64_t(&intra_context->lock);
+  for (;; ) {
+    if (0u != (state & RCL_INTRA_CONTEXT_WRITER)) {
+      RCL_INTRA_CONTEXT_CPU_RELAX();
+      state = rcutils_atomic_load_uint64_t(&intra_context->lock);
+    } else if (
+      rcutils_atomic_compare_exchange_strong_uint_least64_t(
+        &intra_context->lock, &state, state | RCL_INTRA_CONTEXT_WRITER))
+    {
+      break;
+    }
+  }
+  while (RCL_INTRA_CONTEXT_WRITER != rcutils_atomic_load_uint64_t(&intra_context->lock)) {
+    RCL_INTRA_CONTEXT_CPU_RELAX();
+  }
+}
+
+static void
+__unlock_exclusive(rcl_intra_context_t * intra_context)
+{
+  rcutils_atomic_store(&intra_context->lock, (uint64_t)0u);
+}
+
+static rcl_ret_t
+__list_append(rcl_intra_context_list_t * list, void * item, const rcl_allocator_t * allocator)
+{
+  if (list->count == list->capacity) {
+    const size_t capacity = 0u == list->capacity ? 4u : 2u * list->capacity;
+    void ** items = (void **)allocator->reallocate(
+      list->items, capacity * sizeof(void *), allocator->state);
+    RCL_CHECK_FOR_NULL_WITH_MSG(items, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+    list->items = items;
+    list->capacity = capacity;
+  }
+  list->items[list->count++] = item;
+  return RCL_RET_OK;
+}
+
+static bool
+__list_remove(rcl_intra_context_list_t * list, const void * item)
+{
+  for (size_t i = 0u; i < list->count; ++i) {
+    if (list->items[i] == item) {
+      list->items[i] = list->items[--list->count];
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool
+__list_contains(const rcl_intra_context_list_t * list, const void * item)
+{
+  for (size_t i = 0u; i < list->count; ++i) {
+    if (list->items[i] == item) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void
+__list_fini(rcl_intra_context_list_t * list, const rcl_allocator_t * allocator)
+{
+  allocator->deallocate(list->items, allocator->state);
+  list->items = NULL;
+  list->count = 0u;
+  list->capacity = 0u;
+}
+
+static void
+__endpoint_refresh_match_count(rcl_intra_context_endpoint_t * endpoint)
+{
+  rcutils_atomic_store(&endpoint->match_count, (uint64_t)endpoint->matches.count);
+}
+
+static bool
+__qos_is_supported(const rmw_qos_profile_t * qos)
+{
+  // Anything else needs a history the ring does not keep, like late joiners
+  // getting the last messages of transient local publishers.
+  return RMW_QOS_POLICY_HISTORY_KEEP_LAST == qos->history &&
+         0u < qos->depth && qos->depth <= (SIZE_MAX >> 1) &&
+         RMW_QOS_POLICY_DURABILITY_VOLATILE == qos->durability;
+}
+
+static bool
+__endpoints_match(
+  const rcl_intra_context_endpoint_t * publisher,
+  const rcl_intra_context_endpoint_t * subscription)
+{
+  if (
+    RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT == publisher->reliability &&
+    RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT != subscription->reliability)
+  {
+    return false;  // The middleware does not match these either.
+  }
+  return 0 == strcmp(publisher->topic_name, subscription->topic_name) &&
+         (publisher->members == subscription->members || (
+           0 == strcmp(
+             publisher->members->message_namespace_,
+             subscription->members->message_namespace_) &&
+           0 == strcmp(publisher->members->message_name_, subscription->members->message_name_)));
+}
+
+static void
+__endpoint_init(
+  rcl_intra_context_endpoint_t * endpoint,
+  rcl_intra_context_t * intra_context,
+  const char * topic_name,
+  const rosidl_message_type_support_t * type_support,
+  const rcl_message_members_t * members,
+  const rmw_qos_profile_t * qos,
+  const rcl_allocator_t * allocator)
+{
+  endpoint->intra_context = intra_context;
+  endpoint->topic_name = topic_name;
+  endpoint->type_support = type_support;
+  endpoint->members = members;
+  endpoint->reliability = qos->reliability;
+  endpoint->matches.items = NULL;
+  endpoint->matches.count = 0u;
+  endpoint->matches.capacity = 0u;
+  atomic_init(&endpoint->match_count, 0u);
+  endpoint->allocator = *allocator;
+}
+
+// Must be called with the registry locked exclusively.
+static void
+__unregister(rcl_intra_context_list_t * own_list, rcl_intra_context_endpoint_t * endpoint)
+{
+  rcl_intra_context_t * intra_context = endpoint->intra_context;
+  for (size_t i = 0u; i < endpoint->matches.count; ++i) {
+    rcl_intra_context_endpoint_t * other =
+      (rcl_intra_context_endpoint_t *)endpoint->matches.items[i];
+    __list_remove(&other->matches, endpoint);
+    __endpoint_refresh_match_count(other);
+  }
+  __list_fini(&endpoint->matches, &intra_context->allocator);
+  __endpoint_refresh_match_count(endpoint);
+  __list_remove(own_list, endpoint);
+}
+
+// Must be called with the registry locked exclusively.
+static rcl_ret_t
+__register(
+  rcl_intra_context_list_t * own_list,
+  rcl_intra_context_list_t * other_list,
+  rcl_intra_context_endpoint_t * endpoint,
+  bool is_publisher)
+{
+  const rcl_allocator_t * allocator = &endpoint->intra_context->allocator;
+  rcl_ret_t ret = __list_append(own_list, endpoint, allocator);
+  if (RCL_RET_OK != ret) {
+    return ret;
+  }
+  for (size_t i = 0u; i < other_list->count; ++i) {
+    rcl_intra_context_endpoint_t * other = (rcl_intra_context_endpoint_t *)other_list->items[i];
+    const bool match = is_publisher ?
+      __endpoints_match(endpoint, other) : __endpoints_match(other, endpoint);
+    if (!match) {
+      continue;
+    }
+    ret = __list_append(&endpoint->matches, other, allocator);
+    if (RCL_RET_OK == ret) {
+      ret = __list_append(&other->matches, endpoint, allocator);
+      if (RCL_RET_OK != ret) {
+        --endpoint->matches.count;
+      }
+    }
+    if (RCL_RET_OK != ret) {
+      __unregister(own_list, endpoint);
+      return ret;
+    }
+    __endpoint_refresh_match_count(other);
+  }
+  __endpoint_refresh_match_count(endpoint);
+  return RCL_RET_OK;
+}
+
+static rcl_intra_context_message_t *
+__message_header(void * message)
+{
+  return (rcl_intra_context_message_t *)(
+    (uint8_t *)message - offsetof(rcl_intra_context_message_t, payload));
+}
+
+static void *
+__message_create(const rcl_intra_context_endpoint_t * endpoint)
+{
+  const rcl_allocator_t * allocator = &endpoint->allocator;
+  rcl_intra_context_message_t * message = (rcl_intra_context_message_t *)allocator->allocate(
+    sizeof(rcl_intra_context_message_t) + endpoint->members->size_of_, allocator->state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(message, "allocating memory failed", return NULL);
+  atomic_init(&message->ref_count, 1u);
+  message->members = endpoint->members;
+  message->allocator = *allocator;
+  memset(&message->publisher_gid, 0, sizeof(message->publisher_gid));
+  message->source_timestamp = 0;
+  message->publication_sequence_number = 0u;
+  endpoint->members->init_function(message->payload, ROSIDL_RUNTIME_C_MSG_INIT_ALL);
+  return message->payload;
+}
+
+void
+rcl_intra_context_message_release(void * message)
+{
+  rcl_intra_context_message_t * header = __message_header(message);
+  if (1u == rcutils_atomic_fetch_add_uint64_t(&header->ref_count, UINT64_MAX)) {
+    header->members->fini_function(message);
+    rcl_allocator_t allocator = header->allocator;
+    allocator.deallocate(header, allocator.state);
+  }
+}
+
+static bool
+__subscription_push(
+  rcl_intra_context_subscription_t * subscription,
+  rcl_intra_context_message_t * message)
+{
+  uint64_t position = rcutils_atomic_load_uint64_t(&subscription->enqueue_position);
+  for (;; ) {
+    atomic_uint_least64_t * sequence =
+      &subscription->sequences[position & subscription->ring_mask];
+    const uint64_t slot_sequence = rcutils_atomic_load_uint64_t(sequence);
+    const int64_t difference = (int64_t)(slot_sequence - position);
+    if (0 == difference) {
+      // The slot is free, try to claim it; on failure position holds the current value.
+      if (
+        rcutils_atomic_compare_exchange_strong_uint_least64_t(
+          &subscription->enqueue_position, &position, position + 1u))
+      {
+        subscription->ring[position & subscription->ring_mask] = message;
+        rcutils_atomic_store(sequence, position + 1u);
+        return true;
+      }
+    } else if (difference < 0) {
+      return false;
+    } else {
+      position = rcutils_atomic_load_uint64_t(&subscription->enqueue_position);
+    }
+  }
+}
+
+static rcl_intra_context_message_t *
+__subscription_pop(rcl_intra_context_subscription_t * subscription, uint64_t * popped_position)
+{
+  uint64_t position = rcutils_atomic_load_uint64_t(&subscription->dequeue_position);
+  for (;; ) {
+    atomic_uint_least64_t * sequence =
+      &subscription->sequences[position & subscription->ring_mask];
+    const uint64_t slot_sequence = rcutils_atomic_load_uint64_t(sequence);
+    const int64_t difference = (int64_t)(slot_sequence - (position + 1u));
+    if (0 == difference) {
+      // The slot is filled, try to claim it; on failure position holds the current value.
+      if (
+        rcutils_atomic_compare_exchange_strong_uint_least64_t(
+          &subscription->dequeue_position, &position, position + 1u))
+      {
+        rcl_intra_context_message_t * message =
+          subscription->ring[position & subscription->ring_mask];
+        rcutils_atomic_store(sequence, position + subscription->ring_mask + 1u);
+        if (NULL != popped_position) {
+          *popped_position = position;
+        }
+        return message;
+      }
+    } else if (difference < 0) {
+      return NULL;
+    } else {
+      position = rcutils_atomic_load_uint64_t(&subscription->dequeue_position);
+    }
+  }
+}
+
+// Queue a message, dropping the oldest ones beyond the history depth.
+static void
+__subscription_enqueue(
+  rcl_intra_context_subscription_t * subscription,
+  rcl_intra_context_message_t * message)
+{
+  while (!__subscription_push(subscription, message)) {
+    rcl_intra_context_message_t * oldest = __subscription_pop(subscription, NULL);
+    if (NULL != oldest) {
+      rcl_intra_context_message_release(oldest->payload);
+    }
+  }
+  while (
+    rcutils_atomic_load_uint64_t(&subscription->enqueue_position) -
+    rcutils_atomic_load_uint64_t(&subscription->dequeue_position) > subscription->depth)
+  {
+    rcl_intra_context_message_t * oldest = __subscription_pop(subscription, NULL);
+    if (NULL == oldest) {
+      break;  // Another push is still being completed, it trims after itself.
+    }
+    rcl_intra_context_message_release(oldest->payload);
+  }
+}
+
+// Queue a message on a subscription if it matches the filter, and wake the subscription up.
+static void
+__subscription_deliver(
+  rcl_intra_context_subscription_t * subscription,
+  const rcl_content_filter_t * content_filter,
+  rcl_intra_context_message_t * message)
+{
+  if (NULL != content_filter && !rcl_content_filter_evaluate(content_filter, message->payload)) {
+    return;  // Served all the same, the middleware copy is a duplicate to it.
+  }
+  (void)rcutils_atomic_fetch_add_uint64_t(&message->ref_count, 1u);
+  __subscription_enqueue(subscription, message);
+  if (RCL_RET_OK != rcl_trigger_guard_condition(&subscription->guard_condition)) {
+    rcl_reset_error();  // The message is queued, the next wait picks it up.
+  }
+}
+
+// Wait for the deliveries collected before the subscription was last changed
+// under the exclusive lock, those collected afterwards see the change.
+static void
+__subscription_wait_for_deliveries(rcl_intra_context_subscription_t * subscription)
+{
+  while (0u != rcutils_atomic_load_uint64_t(&subscription->deliveries)) {
+    RCL_INTRA_CONTEXT_CPU_RELAX();
+  }
+}
+
+rcl_ret_t
+rcl_intra_context_init(rcl_intra_context_t ** intra_context, const rcl_allocator_t * allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(intra_context, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  rcl_intra_context_t * registry = (rcl_intra_context_t *)allocator->zero_allocate(
+    1u, sizeof(rcl_intra_context_t), allocator->state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(registry, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  atomic_init(&registry->lock, 0u);
+  registry->allocator = *allocator;
+  *intra_context = registry;
+  return RCL_RET_OK;
+}
+
+static void
+__detach_endpoints(rcl_intra_context_t * intra_context, rcl_intra_context_list_t * list)
+{
+  for (size_t i = 0u; i < list->count; ++i) {
+    rcl_intra_context_endpoint_t * endpoint = (rcl_intra_context_endpoint_t *)list->items[i];
+    __list_fini(&endpoint->matches, &intra_context->allocator);
+    __endpoint_refresh_match_count(endpoint);
+    endpoint->intra_context = NULL;
+  }
+  __list_fini(list, &intra_context->allocator);
+}
+
+void
+rcl_intra_context_fini(rcl_intra_context_t * intra_context)
+{
+  if (NULL == intra_context) {
+    return;
+  }
+  for (size_t i = 0u; i < intra_context->subscriptions.count; ++i) {
+    rcl_intra_context_subscription_t * subscription =
+      (rcl_intra_context_subscription_t *)intra_context->subscriptions.items[i];
+    __list_fini(&subscription->confirmed, &intra_context->allocator);
+  }
+  for (size_t i = 0u; i < intra_context->publishers.count; ++i) {
+    rcl_intra_context_publisher_t * publisher =
+      (rcl_intra_context_publisher_t *)intra_context->publishers.items[i];
+    rcutils_atomic_store(&publisher->confirmed_count, (uint64_t)0u);
+  }
+  // Endpoints still registered are detached, so finalizing them later stays safe.
+  __detach_endpoints(intra_context, &intra_context->publishers);
+  __detach_endpoints(intra_context, &intra_context->subscriptions);
+  rcl_allocator_t allocator = intra_context->allocator;
+  allocator.deallocate(intra_context, allocator.state);
+}
+
+rcl_ret_t
+rcl_intra_context_add_publisher(
+  rcl_intra_context_t * intra_context,
+  const rmw_publisher_t * rmw_handle,
+  const rosidl_message_type_support_t * type_support,
+  const rmw_qos_profile_t * qos,
+  const rcl_allocator_t * allocator,
+  rcl_intra_context_publisher_t ** endpoint)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(intra_context, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(rmw_handle, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(qos, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(endpoint, RCL_RET_INVALID_ARGUMENT);
+  *endpoint = NULL;
+  const rcl_message_members_t * members = rcl_message_introspection_get_members(type_support);
+  if (NULL == members || !__qos_is_supported(qos)) {
+    return RCL_RET_OK;
+  }
+  rcl_intra_context_publisher_t * publisher = (rcl_intra_context_publisher_t *)
+    allocator->allocate(sizeof(rcl_intra_context_publisher_t), allocator->state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(publisher, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  __endpoint_init(
+    &publisher->base, intra_context, rmw_handle->topic_name, type_support, members, qos,
+    allocator);
+  atomic_init(&publisher->sequence_number, 0u);
+  atomic_init(&publisher->confirmed_count, 0u);
+  rmw_ret_t rmw_ret = rmw_get_gid_for_publisher(rmw_handle, &publisher->gid);
+  if (RMW_RET_OK != rmw_ret) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    allocator->deallocate(publisher, allocator->state);
+    return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+  }
+  __lock_exclusive(intra_context);
+  rcl_ret_t ret = __register(
+    &intra_context->publishers, &intra_context->subscriptions, &publisher->base, true);
+  __unlock_exclusive(intra_context);
+  if (RCL_RET_OK != ret) {
+    allocator->deallocate(publisher, allocator->state);
+    return ret;
+  }
+  *endpoint = publisher;
+  return RCL_RET_OK;
+}
+
+void
+rcl_intra_context_remove_publisher(rcl_intra_context_publisher_t * endpoint)
+{
+  if (NULL == endpoint) {
+    return;
+  }
+  rcl_intra_context_t * intra_context = endpoint->base.intra_context;
+  if (NULL != intra_context) {
+    __lock_exclusive(intra_context);
+    for (size_t i = 0u; i < endpoint->base.matches.count; ++i) {
+      rcl_intra_context_subscription_t * subscription =
+        (rcl_intra_context_subscription_t *)endpoint->base.matches.items[i];
+      (void)__list_remove(&subscription->confirmed, endpoint);
+    }
+    __unregister(&intra_context->publishers, &endpoint->base);
+    __unlock_exclusive(intra_context);
+  }
+  rcl_allocator_t allocator = endpoint->base.allocator;
+  allocator.deallocate(endpoint, allocator.state);
+}
+
+static void
+__subscription_destroy(rcl_intra_context_subscription_t * subscription)
+{
+  rcl_intra_context_message_t * message;
+  while (NULL != (message = __subscription_pop(subscription, NULL))) {
+    rcl_intra_context_message_release(message->payload);
+  }
+  if (RCL_RET_OK != rcl_guard_condition_fini(&subscription->guard_condition)) {
+    rcl_reset_error();
+  }
+  rcl_allocator_t allocator = subscription->base.allocator;
+  allocator.deallocate(subscription->sequences, allocator.state);
+  allocator.deallocate(subscription, allocator.state);
+}
+
+rcl_ret_t
+rcl_intra_context_add_subscription(
+  rcl_intra_context_t * intra_context,
+  rcl_context_t * context,
+  const rmw_subscription_t * rmw_handle,
+  const rosidl_message_type_support_t * type_support,
+  const rmw_qos_profile_t * qos,
+  const rcl_content_filter_t * content_filter,
+  const rcl_allocator_t * allocator,
+  rcl_intra_context_subscription_t ** endpoint)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(intra_context, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(rmw_handle, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(qos, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(endpoint, RCL_RET_INVALID_ARGUMENT);
+  *endpoint = NULL;
+  const rcl_message_members_t * members = rcl_message_introspection_get_members(type_support);
+  if (NULL == members || !__qos_is_supported(qos)) {
+    return RCL_RET_OK;
+  }
+  size_t ring_size = 1u;
+  while (ring_size < qos->depth) {
+    ring_size <<= 1u;
+  }
+  rcl_intra_context_subscription_t * subscription = (rcl_intra_context_subscription_t *)
+    allocator->allocate(sizeof(rcl_intra_context_subscription_t), allocator->state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(subscription, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  __endpoint_init(
+    &subscription->base, intra_context, rmw_handle->topic_name, type_support, members, qos,
+    allocator);
+  subscription->guard_condition = rcl_get_zero_initialized_guard_condition();
+  // The sequences and the ring share a single block.
+  subscription->sequences = (atomic_uint_least64_t *)allocator->allocate(
+    ring_size * (sizeof(atomic_uint_least64_t) + sizeof(rcl_intra_context_message_t *)),
+    allocator->state);
+  if (NULL == subscription->sequences) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    allocator->deallocate(subscription, allocator->state);
+    return RCL_RET_BAD_ALLOC;
+  }
+  subscription->ring = (rcl_intra_context_message_t **)(subscription->sequences + ring_size);
+  for (size_t i = 0u; i < ring_size; ++i) {
+    atomic_init(&subscription->sequences[i], i);
+  }
+  subscription->ring_mask = ring_size - 1u;
+  atomic_init(&subscription->enqueue_position, 0u);
+  atomic_init(&subscription->dequeue_position, 0u);
+  subscription->depth = qos->depth;
+  subscription->content_filter = content_filter;
+  atomic_init(&subscription->deliveries, 0u);
+  subscription->confirmed.items = NULL;
+  subscription->confirmed.count = 0u;
+  subscription->confirmed.capacity = 0u;
+  rcl_ret_t ret = rcl_guard_condition_init(
+    &subscription->guard_condition, context, rcl_guard_condition_get_default_options());
+  if (RCL_RET_OK != ret) {
+    __subscription_destroy(subscription);
+    return ret;  // error already set
+  }
+  __lock_exclusive(intra_context);
+  ret = __register(
+    &intra_context->subscriptions, &intra_context->publishers, &subscription->base, false);
+  __unlock_exclusive(intra_context);
+  if (RCL_RET_OK != ret) {
+    __subscription_destroy(subscription);
+    return ret;
+  }
+  *endpoint = subscription;
+  return RCL_RET_OK;
+}
+
+void
+rcl_intra_context_remove_subscription(rcl_intra_context_subscription_t * endpoint)
+{
+  if (NULL == endpoint) {
+    return;
+  }
+  rcl_intra_context_t * intra_context = endpoint->base.intra_context;
+  if (NULL != intra_context) {
+    // Once unregistered and the pending deliveries completed no publisher can
+    // push anymore, the ring can be drained.
+    __lock_exclusive(intra_context);
+    for (size_t i = 0u; i < endpoint->confirmed.count; ++i) {
+      rcl_intra_context_publisher_t * publisher =
+        (rcl_intra_context_publisher_t *)endpoint->confirmed.items[i];
+      (void)rcutils_atomic_fetch_add_uint64_t(&publisher->confirmed_count, UINT64_MAX);
+    }
+    __list_fini(&endpoint->confirmed, &intra_context->allocator);
+    __unregister(&intra_context->subscriptions, &endpoint->base);
+    __unlock_exclusive(intra_context);
+    __subscription_wait_for_deliveries(endpoint);
+  }
+  __subscription_destroy(endpoint);
+}
+
+void *
+rcl_intra_context_publisher_borrow(const rcl_intra_context_publisher_t * endpoint)
+{
+  return __message_create(&endpoint->base);
+}
+
+void *
+rcl_intra_context_publisher_borrow_copy(
+  const rcl_intra_context_publisher_t * endpoint,
+  const void * source)
+{
+  void * message = __message_create(&endpoint->base);
+  if (NULL == message) {
+    return NULL;
+  }
+  if (RCL_RET_OK != rcl_message_introspection_copy(endpoint->base.members, source, message)) {
+    rcl_intra_context_message_release(message);
+    return NULL;  // error already set
+  }
+  return message;
+}
+
+void *
+rcl_intra_context_publisher_borrow_deserialized(
+  const rcl_intra_context_publisher_t * endpoint,
+  const rcl_serialized_message_t * serialized_message)
+{
+  void * message = __message_create(&endpoint->base);
+  if (NULL == message) {
+    return NULL;
+  }
+  if (RMW_RET_OK != rmw_deserialize(serialized_message, endpoint->base.type_support, message)) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    rcl_intra_context_message_release(message);
+    return NULL;
+  }
+  return message;
+}
+
+bool
+rcl_intra_context_publisher_has_subscriptions(const rcl_intra_context_publisher_t * endpoint)
+{
+  // The atomic is only read, but the helper wants a mutable pointer.
+  rcl_intra_context_publisher_t * publisher = (rcl_intra_context_publisher_t *)(uintptr_t)endpoint;
+  return 0u != rcutils_atomic_load_uint64_t(&publisher->base.match_count);
+}
+
+size_t
+rcl_intra_context_publisher_count_confirmed(const rcl_intra_context_publisher_t * endpoint)
+{
+  // The atomic is only read, but the helper wants a mutable pointer.
+  rcl_intra_context_publisher_t * publisher = (rcl_intra_context_publisher_t *)(uintptr_t)endpoint;
+  return (size_t)rcutils_atomic_load_uint64_t(&publisher->confirmed_count);
+}
+
+size_t
+rcl_intra_context_publisher_deliver(rcl_intra_context_publisher_t * endpoint, void * message)
+{
+  rcl_intra_context_t * intra_context = endpoint->base.intra_context;
+  if (NULL == intra_context) {
+    return 0u;
+  }
+  rcl_intra_context_message_t * header = __message_header(message);
+  header->publisher_gid = endpoint->gid;
+  rcutils_time_point_value_t now = 0;
+  header->source_timestamp = RCUTILS_RET_OK == rcutils_system_time_now(&now) ? now : 0;
+  header->publication_sequence_number =
+    rcutils_atomic_fetch_add_uint64_t(&endpoint->sequence_number, 1u) + 1u;
+
+  // Only the matches are collected under the lock, the filters, the queues and
+  // the guard conditions are left to after it, so writers are not held up by them.
+  rcl_intra_context_delivery_t batch[RCL_INTRA_CONTEXT_DELIVERY_BATCH];
+  rcl_intra_context_delivery_t * deliveries = batch;
+  size_t capacity = RCL_INTRA_CONTEXT_DELIVERY_BATCH;
+  const rcl_allocator_t * allocator = &endpoint->base.allocator;
+  __lock_shared(intra_context);
+  size_t count = endpoint->base.matches.count;
+  while (count > capacity) {
+    __unlock_shared(intra_context);
+    if (batch != deliveries) {
+      allocator->deallocate(deliveries, allocator->state);
+    }
+    capacity = count;
+    deliveries = (rcl_intra_context_delivery_t *)allocator->allocate(
+      capacity * sizeof(rcl_intra_context_delivery_t), allocator->state);
+    __lock_shared(intra_context);
+    count = endpoint->base.matches.count;
+    if (NULL == deliveries) {
+      // Serve the subscriptions under the lock rather than not at all.
+      for (size_t i = 0u; i < count; ++i) {
+        rcl_intra_context_subscription_t * subscription =
+          (rcl_intra_context_subscription_t *)endpoint->base.matches.items[i];
+        __subscription_deliver(subscription, subscription->content_filter, header);
+      }
+      __unlock_shared(intra_context);
+      return count;
+    }
+  }
+  for (size_t i = 0u; i < count; ++i) {
+    rcl_intra_context_subscription_t * subscription =
+      (rcl_intra_context_subscription_t *)endpoint->base.matches.items[i];
+    deliveries[i].subscription = subscription;
+    deliveries[i].content_filter = subscription->content_filter;
+    (void)rcutils_atomic_fetch_add_uint64_t(&subscription->deliveries, 1u);
+  }
+  __unlock_shared(intra_context);
+
+  for (size_t i = 0u; i < count; ++i) {
+    __subscription_deliver(deliveries[i].subscription, deliveries[i].content_filter, header);
+    // There is no atomic subtraction helper, adding the maximum wraps around to a decrement.
+    (void)rcutils_atomic_fetch_add_uint64_t(&deliveries[i].subscription->deliveries, UINT64_MAX);
+  }
+  if (batch != deliveries) {
+    allocator->deallocate(deliveries, allocator->state);
+  }
+  return count;
+}
+
+void *
+rcl_intra_context_subscription_borrow(const rcl_intra_context_subscription_t * endpoint)
+{
+  return __message_create(&endpoint->base);
+}
+
+bool
+rcl_intra_context_subscription_has_messages(rcl_intra_context_subscription_t * endpoint)
+{
+  // The slot to pop next is filled once its push completed, see __subscription_pop().
+  const uint64_t position = rcutils_atomic_load_uint64_t(&endpoint->dequeue_position);
+  return rcutils_atomic_load_uint64_t(&endpoint->sequences[position & endpoint->ring_mask]) ==
+         position + 1u;
+}
+
+void *
+rcl_intra_context_subscription_pop(
+  rcl_intra_context_subscription_t * endpoint,
+  rmw_message_info_t * message_info)
+{
+  uint64_t position = 0u;
+  rcl_intra_context_message_t * message = __subscription_pop(endpoint, &position);
+  if (NULL == message) {
+    return NULL;
+  }
+  if (NULL != message_info) {
+    rcutils_time_point_value_t now = 0;
+    message_info->source_timestamp = message->source_timestamp;
+    message_info->received_timestamp = RCUTILS_RET_OK == rcutils_system_time_now(&now) ? now : 0;
+    message_info->publication_sequence_number = message->publication_sequence_number;
+    message_info->reception_sequence_number = position + 1u;
+    message_info->publisher_gid = message->publisher_gid;
+    message_info->from_intra_process = true;
+  }
+  return message->payload;
+}
+
+rcl_ret_t
+rcl_intra_context_subscription_take(
+  rcl_intra_context_subscription_t * endpoint,
+  void * ros_message,
+  rmw_message_info_t * message_info,
+  bool * taken)
+{
+  *taken = false;
+  void * message = rcl_intra_context_subscription_pop(endpoint, message_info);
+  if (NULL == message) {
+    return RCL_RET_OK;
+  }
+  rcl_ret_t ret = rcl_message_introspection_copy(endpoint->base.members, message, ros_message);
+  rcl_intra_context_message_release(message);
+  *taken = RCL_RET_OK == ret;
+  return ret;
+}
+
+rcl_ret_t
+rcl_intra_context_subscription_take_serialized(
+  rcl_intra_context_subscription_t * endpoint,
+  rcl_serialized_message_t * serialized_message,
+  rmw_message_info_t * message_info,
+  bool * taken)
+{
+  *taken = false;
+  void * message = rcl_intra_context_subscription_pop(endpoint, message_info);
+  if (NULL == message) {
+    return RCL_RET_OK;
+  }
+  rmw_ret_t rmw_ret = rmw_serialize(message, endpoint->base.type_support, serialized_message);
+  rcl_intra_context_message_release(message);
+  if (RMW_RET_OK != rmw_ret) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+  }
+  *taken = true;
+  return RCL_RET_OK;
+}
+
+// Find the matched publisher with the given gid, must be called with the registry locked.
+static rcl_intra_context_publisher_t *
+__subscription_find_publisher(
+  const rcl_intra_context_subscription_t * subscription,
+  const rmw_gid_t * gid)
+{
+  for (size_t i = 0u; i < subscription->base.matches.count; ++i) {
+    rcl_intra_context_publisher_t * publisher =
+      (rcl_intra_context_publisher_t *)subscription->base.matches.items[i];
+    bool equal = false;
+    if (RMW_RET_OK != rmw_compare_gids_equal(&publisher->gid, gid, &equal)) {
+      rmw_reset_error();
+    } else if (equal) {
+      return publisher;
+    }
+  }
+  return NULL;
+}
+
+bool
+rcl_intra_context_subscription_is_duplicate(
+  rcl_intra_context_subscription_t * endpoint,
+  const rmw_message_info_t * message_info)
+{
+  rcl_intra_context_t * intra_context = endpoint->base.intra_context;
+  if (NULL == intra_context || message_info->from_intra_process) {
+    return false;
+  }
+  __lock_shared(intra_context);
+  const rcl_intra_context_publisher_t * publisher =
+    __subscription_find_publisher(endpoint, &message_info->publisher_gid);
+  const bool confirmed = NULL == publisher || __list_contains(&endpoint->confirmed, publisher);
+  __unlock_shared(intra_context);
+  if (!confirmed) {
+    // The middleware matched this subscription with the publisher, which may
+    // count it as served; look it up again as it may have gone in between.
+    __lock_exclusive(intra_context);
+    rcl_intra_context_publisher_t * matched =
+      __subscription_find_publisher(endpoint, &message_info->publisher_gid);
+    if (NULL != matched && !__list_contains(&endpoint->confirmed, matched)) {
+      if (RCL_RET_OK == __list_append(&endpoint->confirmed, matched, &intra_context->allocator)) {
+        (void)rcutils_atomic_fetch_add_uint64_t(&matched->confirmed_count, 1u);
+      } else {
+        rcl_reset_error();  // Left unconfirmed, the next copy retries.
+      }
+    }
+    __unlock_exclusive(intra_context);
+  }
+  return NULL != publisher;
+}
+
+void
+rcl_intra_context_subscription_set_content_filter(
+  rcl_intra_context_subscription_t * endpoint,
+  const rcl_content_filter_t * content_filter)
+{
+  rcl_intra_context_t * intra_context = endpoint->base.intra_context;
+  if (NULL == intra_context) {
+    endpoint->content_filter = content_filter;
+    return;
+  }
+  __lock_exclusive(intra_context);
+  endpoint->content_filter = content_filter;
+  __unlock_exclusive(intra_context);
+  __subscription_wait_for_deliveries(endpoint);
+}
+
+const rcl_guard_condition_t *
+rcl_intra_context_subscription_get_guard_condition(
+  const rcl_intra_context_subscription_t * endpoint)
+{
+  return &endpoint->guard_condition;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,201 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__INTRA_CONTEXT_H_
+#define RCL__INTRA_CONTEXT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcl/allocator.h"
+#include "rcl/context.h"
+#include "rcl/guard_condition.h"
+#include "rcl/types.h"
+#include "rmw/rmw.h"
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+#include "./content_filter.h"
+
+// Delivery of messages between the publishers and subscriptions of a context
+// without going through the middleware.
+//
+// Messages are reference counted blocks, each subscription holds a bounded
+// lock-free ring of pointers to them which behaves like a keep last history.
+// Publishing hands one reference to every matched subscription, so a loaned
+// message reaches all of them without being copied.
+typedef struct rcl_intra_context_s rcl_intra_context_t;
+typedef struct rcl_intra_context_publisher_s rcl_intra_context_publisher_t;
+typedef struct rcl_intra_context_subscription_s rcl_intra_context_subscription_t;
+
+/// Create the registry of a context, without endpoints.
+rcl_ret_t
+rcl_intra_context_init(rcl_intra_context_t ** intra_context, const rcl_allocator_t * allocator);
+
+/// Destroy the registry, all its endpoints must have been removed.
+void
+rcl_intra_context_fini(rcl_intra_context_t * intra_context);
+
+/// Register a publisher and match it with the subscriptions of its topic.
+/**
+ * `*endpoint` is left `NULL` without an error if the publisher cannot take
+ * part, i.e. its type has no C introspection or its QoS is not a volatile
+ * keep last history.
+ */
+rcl_ret_t
+rcl_intra_context_add_publisher(
+  rcl_intra_context_t * intra_context,
+  const rmw_publisher_t * rmw_handle,
+  const rosidl_message_type_support_t * type_support,
+  const rmw_qos_profile_t * qos,
+  const rcl_allocator_t * allocator,
+  rcl_intra_context_publisher_t ** endpoint);
+
+/// Unmatch and destroy a publisher endpoint, messages it delivered stay queued.
+void
+rcl_intra_context_remove_publisher(rcl_intra_context_publisher_t * endpoint);
+
+/// Register a subscription and match it with the publishers of its topic.
+/**
+ * `*endpoint` is left `NULL` under the same conditions as for publishers.
+ * The ring of the subscription holds `qos->depth` messages.
+ */
+rcl_ret_t
+rcl_intra_context_add_subscription(
+  rcl_intra_context_t * intra_context,
+  rcl_context_t * context,
+  const rmw_subscription_t * rmw_handle,
+  const rosidl_message_type_support_t * type_support,
+  const rmw_qos_profile_t * qos,
+  const rcl_content_filter_t * content_filter,
+  const rcl_allocator_t * allocator,
+  rcl_intra_context_subscription_t ** endpoint);
+
+/// Unmatch and destroy a subscription endpoint, dropping the messages it queued.
+void
+rcl_intra_context_remove_subscription(rcl_intra_context_subscription_t * endpoint);
+
+/// Drop a reference to a message, destroying it with the last one.
+void
+rcl_intra_context_message_release(void * message);
+
+/// Create an initialized message holding one reference, `NULL` with the error set on failure.
+void *
+rcl_intra_context_publisher_borrow(const rcl_intra_context_publisher_t * endpoint);
+
+/// Borrow a message and deep copy `source` into it.
+void *
+rcl_intra_context_publisher_borrow_copy(
+  const rcl_intra_context_publisher_t * endpoint,
+  const void * source);
+
+/// Borrow a message and deserialize `serialized_message` into it.
+void *
+rcl_intra_context_publisher_borrow_deserialized(
+  const rcl_intra_context_publisher_t * endpoint,
+  const rcl_serialized_message_t * serialized_message);
+
+/// Whether any subscription is matched, without taking the registry lock.
+bool
+rcl_intra_context_publisher_has_subscriptions(const rcl_intra_context_publisher_t * endpoint);
+
+/// Number of matched subscriptions the middleware was seen delivering the publisher's messages to.
+/**
+ * Those subscriptions are matched by the middleware too, so when it does not
+ * match more of them every subscription is served through the context.
+ * Other local subscriptions are only counted once a middleware copy reached
+ * them, see rcl_intra_context_subscription_is_duplicate().
+ */
+size_t
+rcl_intra_context_publisher_count_confirmed(const rcl_intra_context_publisher_t * endpoint);
+
+/// Queue a borrowed message on every matched subscription and wake them up.
+/**
+ * Each subscription gets its own reference, the caller keeps its reference.
+ * The message must not be modified afterwards.
+ * The registry lock is only held to collect the matched subscriptions, removing
+ * a subscription waits for the deliveries collected before.
+ *
+ * \return the number of subscriptions the message was queued on.
+ */
+size_t
+rcl_intra_context_publisher_deliver(rcl_intra_context_publisher_t * endpoint, void * message);
+
+/// Create an initialized message holding one reference, like the publisher counterpart.
+void *
+rcl_intra_context_subscription_borrow(const rcl_intra_context_subscription_t * endpoint);
+
+/// Whether a message is queued, without popping it.
+bool
+rcl_intra_context_subscription_has_messages(rcl_intra_context_subscription_t * endpoint);
+
+/// Pop the oldest queued message, `NULL` if there is none.
+/**
+ * The caller gets the reference which was held by the ring and must release it.
+ * The message is shared with the other subscriptions and must not be modified.
+ */
+void *
+rcl_intra_context_subscription_pop(
+  rcl_intra_context_subscription_t * endpoint,
+  rmw_message_info_t * message_info);
+
+/// Pop the oldest queued message and deep copy it into `ros_message`.
+rcl_ret_t
+rcl_intra_context_subscription_take(
+  rcl_intra_context_subscription_t * endpoint,
+  void * ros_message,
+  rmw_message_info_t * message_info,
+  bool * taken);
+
+/// Pop the oldest queued message and serialize it into `serialized_message`.
+rcl_ret_t
+rcl_intra_context_subscription_take_serialized(
+  rcl_intra_context_subscription_t * endpoint,
+  rcl_serialized_message_t * serialized_message,
+  rmw_message_info_t * message_info,
+  bool * taken);
+
+/// Whether a message taken from the middleware was already delivered through the context.
+/**
+ * The first duplicate of each publisher confirms the subscription to it.
+ */
+bool
+rcl_intra_context_subscription_is_duplicate(
+  rcl_intra_context_subscription_t * endpoint,
+  const rmw_message_info_t * message_info);
+
+/// Only queue the messages matching `content_filter` from now on, `NULL` queues all.
+/**
+ * Publishers stop evaluating the previous filter before this returns, so the
+ * caller may destroy it then.
+ */
+void
+rcl_intra_context_subscription_set_content_filter(
+  rcl_intra_context_subscription_t * endpoint,
+  const rcl_content_filter_t * content_filter);
+
+/// Get the guard condition triggered whenever a message is queued on the subscription.
+const rcl_guard_condition_t *
+rcl_intra_context_subscription_get_guard_condition(
+  const rcl_intra_context_subscription_t * endpoint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__INTRA_CONTEXT_H_
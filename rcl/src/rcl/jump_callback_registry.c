@@ -0,0 +1,464 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./jump_callback_registry.h"
+
+#include <stdint.h>
+
+#include "rcl/error_handling.h"
+
+// Marks the end of a list.
+#define NIL SIZE_MAX
+
+// A callback is in up to one list of each kind.
+typedef enum rcl_jump_callback_list_e
+{
+  RCL_JUMP_CALLBACK_LIST_CLOCK_CHANGE,
+  RCL_JUMP_CALLBACK_LIST_FORWARD,
+  RCL_JUMP_CALLBACK_LIST_BACKWARD,
+  RCL_JUMP_CALLBACK_LIST_COUNT,
+} rcl_jump_callback_list_t;
+
+// Links of a callback, parallel to clock->jump_callbacks.
+typedef struct rcl_jump_callback_links_s
+{
+  size_t prev[RCL_JUMP_CALLBACK_LIST_COUNT];
+  size_t next[RCL_JUMP_CALLBACK_LIST_COUNT];
+  // Next callback with the same hash.
+  size_t hash_next;
+  // Removed while callbacks were being called, the slot is freed afterwards.
+  bool removed;
+} rcl_jump_callback_links_t;
+
+// Ends of a list, callbacks are in the order they were added.
+typedef struct rcl_jump_callback_list_ends_s
+{
+  size_t head;
+  size_t tail;
+} rcl_jump_callback_list_ends_t;
+
+struct rcl_jump_callback_registry_s
+{
+  // Number of callbacks clock->jump_callbacks and links have room for, 0 or a power of two.
+  size_t capacity;
+  rcl_jump_callback_links_t * links;
+  // Heads of the hash chains, one per slot of capacity.
+  size_t * hash_heads;
+  // Callbacks with on_clock_change set.
+  rcl_jump_callback_list_ends_t clock_change;
+  // Callbacks with a forward threshold in [2^i, 2^(i+1)) are in the list at index i.
+  rcl_jump_callback_list_ends_t forward[64];
+  // Callbacks with a backward threshold in (-2^(i+1), -2^i] are in the list at index i.
+  rcl_jump_callback_list_ends_t backward[64];
+  // Number of rcl_jump_callback_registry_call() in progress, nested from callbacks.
+  size_t call_depth;
+  // Number of callbacks removed during those calls, whose slots are still taken.
+  size_t removed_count;
+};
+
+static size_t
+__most_significant_bit(uint64_t value)
+{
+  size_t msb = 0u;
+  for (size_t shift = 32u; shift > 0u; shift /= 2u) {
+    if (value >> (msb + shift)) {
+      msb += shift;
+    }
+  }
+  return msb;
+}
+
+static size_t
+__hash(const rcl_jump_callback_registry_t * registry, rcl_jump_callback_t callback, void * data)
+{
+  uint64_t hash = (uint64_t)(uintptr_t)callback * 0x9E3779B97F4A7C15u;
+  hash ^= (uint64_t)(uintptr_t)data * 0xC2B2AE3D27D4EB4Fu;
+  return (size_t)(hash ^ (hash >> 32)) & (registry->capacity - 1u);
+}
+
+// Get the list of the given kind the callback belongs to, NULL if none.
+static rcl_jump_callback_list_ends_t *
+__list_ends(
+  rcl_jump_callback_registry_t * registry,
+  rcl_jump_callback_list_t list,
+  const rcl_jump_threshold_t * threshold)
+{
+  switch (list) {
+    case RCL_JUMP_CALLBACK_LIST_CLOCK_CHANGE:
+      return threshold->on_clock_change ? &registry->clock_change : NULL;
+    case RCL_JUMP_CALLBACK_LIST_FORWARD:
+      if (threshold->min_forward.nanoseconds <= 0) {
+        return NULL;
+      }
+      return &registry->forward[
+        __most_significant_bit((uint64_t)threshold->min_forward.nanoseconds)];
+    case RCL_JUMP_CALLBACK_LIST_BACKWARD:
+      if (threshold->min_backward.nanoseconds >= 0) {
+        return NULL;
+      }
+      return &registry->backward[
+        __most_significant_bit((uint64_t)0 - (uint64_t)threshold->min_backward.nanoseconds)];
+    default:
+      return NULL;
+  }
+}
+
+static void
+__link(rcl_clock_t * clock, size_t index)
+{
+  rcl_jump_callback_registry_t * registry = clock->jump_callback_registry;
+  const rcl_jump_callback_info_t * info = &clock->jump_callbacks[index];
+  rcl_jump_callback_links_t * links = &registry->links[index];
+  for (int list = 0; list < RCL_JUMP_CALLBACK_LIST_COUNT; ++list) {
+    rcl_jump_callback_list_ends_t * ends =
+      __list_ends(registry, (rcl_jump_callback_list_t)list, &info->threshold);
+    if (NULL == ends) {
+      continue;
+    }
+    links->prev[list] = ends->tail;
+    links->next[list] = NIL;
+    if (NIL != ends->tail) {
+      registry->links[ends->tail].next[list] = index;
+    } else {
+      ends->head = index;
+    }
+    ends->tail = index;
+  }
+  size_t * hash_head = &registry->hash_heads[__hash(registry, info->callback, info->user_data)];
+  links->hash_next = *hash_head;
+  links->removed = false;
+  *hash_head = index;
+}
+
+// Get the link of the hash chain pointing to the callback.
+static size_t *
+__hash_link(rcl_clock_t * clock, size_t index)
+{
+  rcl_jump_callback_registry_t * registry = clock->jump_callback_registry;
+  const rcl_jump_callback_info_t * info = &clock->jump_callbacks[index];
+  size_t * hash_link = &registry->hash_heads[__hash(registry, info->callback, info->user_data)];
+  while (*hash_link != index) {
+    hash_link = &registry->links[*hash_link].hash_next;
+  }
+  return hash_link;
+}
+
+// Take the callback out of its lists and its hash chain.
+// Its own links are left as they were, so a call walking the lists can step past it.
+static void
+__unlink(rcl_clock_t * clock, size_t index)
+{
+  rcl_jump_callback_registry_t * registry = clock->jump_callback_registry;
+  const rcl_jump_callback_info_t * info = &clock->jump_callbacks[index];
+  const rcl_jump_callback_links_t * links = &registry->links[index];
+  for (int list = 0; list < RCL_JUMP_CALLBACK_LIST_COUNT; ++list) {
+    rcl_jump_callback_list_ends_t * ends =
+      __list_ends(registry, (rcl_jump_callback_list_t)list, &info->threshold);
+    if (NULL == ends) {
+      continue;
+    }
+    if (NIL != links->prev[list]) {
+      registry->links[links->prev[list]].next[list] = links->next[list];
+    } else {
+      ends->head = links->next[list];
+    }
+    if (NIL != links->next[list]) {
+      registry->links[links->next[list]].prev[list] = links->prev[list];
+    } else {
+      ends->tail = links->prev[list];
+    }
+  }
+  *__hash_link(clock, index) = links->hash_next;
+}
+
+// Move a linked callback to a free slot, keeping its place in its lists.
+static void
+__move(rcl_clock_t * clock, size_t from, size_t to)
+{
+  rcl_jump_callback_registry_t * registry = clock->jump_callback_registry;
+  const rcl_jump_callback_info_t * info = &clock->jump_callbacks[from];
+  const rcl_jump_callback_links_t * links = &registry->links[from];
+  for (int list = 0; list < RCL_JUMP_CALLBACK_LIST_COUNT; ++list) {
+    rcl_jump_callback_list_ends_t * ends =
+      __list_ends(registry, (rcl_jump_callback_list_t)list, &info->threshold);
+    if (NULL == ends) {
+      continue;
+    }
+    if (NIL != links->prev[list]) {
+      registry->links[links->prev[list]].next[list] = to;
+    } else {
+      ends->head = to;
+    }
+    if (NIL != links->next[list]) {
+      registry->links[links->next[list]].prev[list] = to;
+    } else {
+      ends->tail = to;
+    }
+  }
+  *__hash_link(clock, from) = to;
+  clock->jump_callbacks[to] = *info;
+  registry->links[to] = *links;
+}
+
+// Free the slots of the callbacks removed during calls, keeping the others packed.
+static void
+__compact(rcl_clock_t * clock)
+{
+  rcl_jump_callback_registry_t * registry = clock->jump_callback_registry;
+  size_t index = 0u;
+  while (index < clock->num_jump_callbacks) {
+    if (!registry->links[index].removed) {
+      ++index;
+      continue;
+    }
+    const size_t last = --(clock->num_jump_callbacks);
+    if (index != last && !registry->links[last].removed) {
+      __move(clock, last, index);
+      ++index;
+    }
+  }
+  registry->removed_count = 0u;
+}
+
+static size_t
+__find(rcl_clock_t * clock, rcl_jump_callback_t callback, void * user_data)
+{
+  rcl_jump_callback_registry_t * registry = clock->jump_callback_registry;
+  if (NULL == registry || 0u == registry->capacity) {
+    return NIL;
+  }
+  size_t index = registry->hash_heads[__hash(registry, callback, user_data)];
+  while (NIL != index) {
+    const rcl_jump_callback_info_t * info = &clock->jump_callbacks[index];
+    if (info->callback == callback && info->user_data == user_data) {
+      return index;
+    }
+    index = registry->links[index].hash_next;
+  }
+  return NIL;
+}
+
+static rcl_ret_t
+__grow(rcl_clock_t * clock)
+{
+  rcl_allocator_t * allocator = &clock->allocator;
+  rcl_jump_callback_registry_t * registry = clock->jump_callback_registry;
+  if (NULL == registry) {
+    registry = allocator->allocate(sizeof(rcl_jump_callback_registry_t), allocator->state);
+    if (NULL == registry) {
+      RCL_SET_ERROR_MSG("Failed to allocate jump callback registry");
+      return RCL_RET_BAD_ALLOC;
+    }
+    registry->capacity = 0u;
+    registry->links = NULL;
+    registry->hash_heads = NULL;
+    registry->clock_change.head = NIL;
+    registry->clock_change.tail = NIL;
+    for (size_t i = 0u; i < 64u; ++i) {
+      registry->forward[i].head = NIL;
+      registry->forward[i].tail = NIL;
+      registry->backward[i].head = NIL;
+      registry->backward[i].tail = NIL;
+    }
+    registry->call_depth = 0u;
+    registry->removed_count = 0u;
+    clock->jump_callback_registry = registry;
+  }
+  const size_t capacity = registry->capacity > 0u ? registry->capacity * 2u : 1u;
+  // Each array is only used up to registry->capacity until all of them grew.
+  rcl_jump_callback_info_t * callbacks = allocator->reallocate(
+    clock->jump_callbacks, sizeof(rcl_jump_callback_info_t) * capacity, allocator->state);
+  if (NULL == callbacks) {
+    RCL_SET_ERROR_MSG("Failed to realloc jump callbacks");
+    return RCL_RET_BAD_ALLOC;
+  }
+  clock->jump_callbacks = callbacks;
+  rcl_jump_callback_links_t * links = allocator->reallocate(
+    registry->links, sizeof(rcl_jump_callback_links_t) * capacity, allocator->state);
+  if (NULL == links) {
+    RCL_SET_ERROR_MSG("Failed to realloc jump callback links");
+    return RCL_RET_BAD_ALLOC;
+  }
+  registry->links = links;
+  size_t * hash_heads = allocator->reallocate(
+    registry->hash_heads, sizeof(size_t) * capacity, allocator->state);
+  if (NULL == hash_heads) {
+    RCL_SET_ERROR_MSG("Failed to realloc jump callback hash table");
+    return RCL_RET_BAD_ALLOC;
+  }
+  registry->hash_heads = hash_heads;
+
+  // The hash of every callback changes with the capacity.
+  registry->capacity = capacity;
+  for (size_t i = 0u; i < capacity; ++i) {
+    hash_heads[i] = NIL;
+  }
+  for (size_t i = 0u; i < clock->num_jump_callbacks; ++i) {
+    if (links[i].removed) {
+      continue;  // Out of the hash table already.
+    }
+    const rcl_jump_callback_info_t * info = &callbacks[i];
+    size_t * hash_head = &hash_heads[__hash(registry, info->callback, info->user_data)];
+    links[i].hash_next = *hash_head;
+    *hash_head = i;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_jump_callback_registry_add(rcl_clock_t * clock, const rcl_jump_callback_info_t * info)
+{
+  if (NIL != __find(clock, info->callback, info->user_data)) {
+    RCL_SET_ERROR_MSG("callback/user_data are already added to this clock");
+    return RCL_RET_ERROR;
+  }
+  if (NULL == clock->jump_callback_registry ||
+    clock->num_jump_callbacks == clock->jump_callback_registry->capacity)
+  {
+    rcl_ret_t ret = __grow(clock);
+    if (RCL_RET_OK != ret) {
+      return ret;
+    }
+  }
+  const size_t index = clock->num_jump_callbacks++;
+  clock->jump_callbacks[index] = *info;
+  __link(clock, index);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_jump_callback_registry_remove(
+  rcl_clock_t * clock, rcl_jump_callback_t callback, void * user_data)
+{
+  const size_t index = __find(clock, callback, user_data);
+  if (NIL == index) {
+    RCL_SET_ERROR_MSG("jump callback was not found");
+    return RCL_RET_ERROR;
+  }
+  __unlink(clock, index);
+  rcl_jump_callback_registry_t * registry = clock->jump_callback_registry;
+  if (0u != registry->call_depth) {
+    // Moving a callback now could make the calls in progress skip it.
+    registry->links[index].removed = true;
+    ++registry->removed_count;
+    return RCL_RET_OK;
+  }
+  const size_t last = --(clock->num_jump_callbacks);
+  if (index != last) {
+    __move(clock, last, index);
+  }
+  return RCL_RET_OK;
+}
+
+// Call the callbacks of one list whose threshold is exceeded.
+static void
+__call_list(
+  rcl_clock_t * clock,
+  rcl_jump_callback_list_t list,
+  size_t index,
+  const rcl_time_jump_t * time_jump,
+  bool before_jump,
+  bool is_clock_change)
+{
+  const int64_t delta = time_jump->delta.nanoseconds;
+  while (NIL != index) {
+    // The callback may add callbacks, growing the storage, so read what it needs first.
+    const rcl_jump_callback_info_t info = clock->jump_callbacks[index];
+    const rcl_jump_callback_links_t * links = &clock->jump_callback_registry->links[index];
+    const bool removed = links->removed;
+    index = links->next[list];
+    if (removed) {
+      continue;  // Removed by an earlier callback, its links still lead on.
+    }
+    bool exceeded = true;
+    if (RCL_JUMP_CALLBACK_LIST_FORWARD == list) {
+      exceeded = delta >= info.threshold.min_forward.nanoseconds;
+    } else if (RCL_JUMP_CALLBACK_LIST_BACKWARD == list) {
+      exceeded = delta <= info.threshold.min_backward.nanoseconds;
+    }
+    // Callbacks in the clock change list were already called for clock changes.
+    if (list != RCL_JUMP_CALLBACK_LIST_CLOCK_CHANGE && is_clock_change &&
+      info.threshold.on_clock_change)
+    {
+      exceeded = false;
+    }
+    if (exceeded) {
+      info.callback(time_jump, before_jump, info.user_data);
+    }
+  }
+}
+
+void
+rcl_jump_callback_registry_call(
+  rcl_clock_t * clock, const rcl_time_jump_t * time_jump, bool before_jump)
+{
+  rcl_jump_callback_registry_t * registry = clock->jump_callback_registry;
+  if (NULL == registry || 0u == clock->num_jump_callbacks) {
+    return;
+  }
+  const bool is_clock_change = time_jump->clock_change == RCL_ROS_TIME_ACTIVATED ||
+    time_jump->clock_change == RCL_ROS_TIME_DEACTIVATED;
+  ++registry->call_depth;
+  if (is_clock_change) {
+    __call_list(
+      clock, RCL_JUMP_CALLBACK_LIST_CLOCK_CHANGE, registry->clock_change.head,
+      time_jump, before_jump, is_clock_change);
+  }
+  // Lists of thresholds larger than the delta cannot fire, only the last list visited may
+  // hold thresholds which are not exceeded.
+  const int64_t delta = time_jump->delta.nanoseconds;
+  if (delta > 0) {
+    const size_t msb = __most_significant_bit((uint64_t)delta);
+    for (size_t i = 0u; i <= msb; ++i) {
+      __call_list(
+        clock, RCL_JUMP_CALLBACK_LIST_FORWARD, registry->forward[i].head,
+        time_jump, before_jump, is_clock_change);
+    }
+  } else if (delta < 0) {
+    const size_t msb = __most_significant_bit((uint64_t)0 - (uint64_t)delta);
+    for (size_t i = 0u; i <= msb; ++i) {
+      __call_list(
+        clock, RCL_JUMP_CALLBACK_LIST_BACKWARD, registry->backward[i].head,
+        time_jump, before_jump, is_clock_change);
+    }
+  }
+  if (0u == --registry->call_depth && 0u != registry->removed_count) {
+    __compact(clock);
+  }
+}
+
+void
+rcl_jump_callback_registry_fini(rcl_clock_t * clock)
+{
+  rcl_allocator_t * allocator = &clock->allocator;
+  rcl_jump_callback_registry_t * registry = clock->jump_callback_registry;
+  if (NULL != registry) {
+    allocator->deallocate(registry->links, allocator->state);
+    allocator->deallocate(registry->hash_heads, allocator->state);
+    allocator->deallocate(registry, allocator->state);
+    clock->jump_callback_registry = NULL;
+  }
+  allocator->deallocate(clock->jump_callbacks, allocator->state);
+  clock->jump_callbacks = NULL;
+  clock->num_jump_callbacks = 0u;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,76 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__JUMP_CALLBACK_REGISTRY_H_
+#define RCL__JUMP_CALLBACK_REGISTRY_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+
+#include "rcl/time.h"
+#include "rcl/types.h"
+
+/// Add a jump callback to the clock.
+/**
+ * The callbacks stay densely packed in `clock->jump_callbacks`, which grows
+ * by doubling, and are indexed by their callback and user data, and by the
+ * kind and magnitude of their thresholds.
+ *
+ * \return #RCL_RET_OK if the callback was added, or
+ * \return #RCL_RET_ERROR if the callback and user data were already added, or
+ * \return #RCL_RET_BAD_ALLOC if growing the storage failed.
+ */
+rcl_ret_t
+rcl_jump_callback_registry_add(rcl_clock_t * clock, const rcl_jump_callback_info_t * info);
+
+/// Remove a jump callback from the clock in constant time, never allocating.
+/**
+ * The last callback is moved into the slot of the removed one, keeping its
+ * place in the order callbacks are called.
+ * A callback removed from within rcl_jump_callback_registry_call() is only
+ * skipped until that returns, then its slot is freed, so the calls in
+ * progress still reach the callbacks after it.
+ *
+ * \return #RCL_RET_OK if the callback was removed, or
+ * \return #RCL_RET_ERROR if the callback was not found.
+ */
+rcl_ret_t
+rcl_jump_callback_registry_remove(
+  rcl_clock_t * clock, rcl_jump_callback_t callback, void * user_data);
+
+/// Call every callback whose threshold is exceeded by the jump.
+/**
+ * Only the callbacks indexed under thresholds the jump can exceed are
+ * visited: those with clock change thresholds for clock changes, and those
+ * with forward or backward thresholds of at most the magnitude of the delta.
+ * Callbacks indexed under the same threshold are called in the order they
+ * were added.
+ */
+void
+rcl_jump_callback_registry_call(
+  rcl_clock_t * clock, const rcl_time_jump_t * time_jump, bool before_jump);
+
+/// Release the storage of all callbacks.
+void
+rcl_jump_callback_registry_fini(rcl_clock_t * clock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__JUMP_CALLBACK_REGISTRY_H_
@@ -0,0 +1,140 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./loan_pool.h"
+
+#include <stdbool.h>
+
+#include "rcl/error_handling.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rosidl_runtime_c/message_initialization.h"
+
+#include "./message_introspection.h"
+
+struct rcl_loan_pool_s
+{
+  // spinlock guarding the members below, held for a few instructions only
+  atomic_bool lock;
+  // free messages, with room for every message created so returning never allocates
+  void ** free_messages;
+  size_t free_count;
+  size_t created_count;
+  const rcl_message_members_t * members;
+  rcl_allocator_t allocator;
+};
+
+static void
+__lock(rcl_loan_pool_t * pool)
+{
+  while (rcutils_atomic_exchange_bool(&pool->lock, true)) {
+  }
+}
+
+static void
+__unlock(rcl_loan_pool_t * pool)
+{
+  rcutils_atomic_store(&pool->lock, false);
+}
+
+static void
+__message_destroy(rcl_loan_pool_t * pool, void * message)
+{
+  pool->members->fini_function(message);
+  pool->allocator.deallocate(message, pool->allocator.state);
+}
+
+rcl_ret_t
+rcl_loan_pool_init(
+  rcl_loan_pool_t ** pool,
+  const rosidl_message_type_support_t * type_support,
+  const rcl_allocator_t * allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(pool, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(type_support, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  *pool = NULL;
+  const rcl_message_members_t * members = rcl_message_introspection_get_members(type_support);
+  if (NULL == members) {
+    return RCL_RET_OK;
+  }
+  rcl_loan_pool_t * new_pool = (rcl_loan_pool_t *)allocator->zero_allocate(
+    1u, sizeof(rcl_loan_pool_t), allocator->state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(new_pool, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  atomic_init(&new_pool->lock, false);
+  new_pool->members = members;
+  new_pool->allocator = *allocator;
+  *pool = new_pool;
+  return RCL_RET_OK;
+}
+
+void
+rcl_loan_pool_fini(rcl_loan_pool_t * pool)
+{
+  if (NULL == pool) {
+    return;
+  }
+  for (size_t i = 0u; i < pool->free_count; ++i) {
+    __message_destroy(pool, pool->free_messages[i]);
+  }
+  rcl_allocator_t allocator = pool->allocator;
+  allocator.deallocate(pool->free_messages, allocator.state);
+  allocator.deallocate(pool, allocator.state);
+}
+
+void *
+rcl_loan_pool_borrow(rcl_loan_pool_t * pool)
+{
+  __lock(pool);
+  if (0u != pool->free_count) {
+    void * message = pool->free_messages[--pool->free_count];
+    __unlock(pool);
+    return message;
+  }
+  // Reserve the slot the new message takes once returned, while still holding the lock.
+  const size_t created_count = pool->created_count + 1u;
+  void ** free_messages = (void **)pool->allocator.reallocate(
+    pool->free_messages, created_count * sizeof(void *), pool->allocator.state);
+  if (NULL != free_messages) {
+    pool->free_messages = free_messages;
+    pool->created_count = created_count;
+  }
+  __unlock(pool);
+  RCL_CHECK_FOR_NULL_WITH_MSG(free_messages, "allocating memory failed", return NULL);
+
+  void * message = pool->allocator.allocate(pool->members->size_of_, pool->allocator.state);
+  if (NULL == message) {
+    // Keep the reserved slot, the pool only ever grows.
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return NULL;
+  }
+  pool->members->init_function(message, ROSIDL_RUNTIME_C_MSG_INIT_ALL);
+  return message;
+}
+
+void
+rcl_loan_pool_return(rcl_loan_pool_t * pool, void * message)
+{
+  __lock(pool);
+  pool->free_messages[pool->free_count++] = message;
+  __unlock(pool);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,62 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__LOAN_POOL_H_
+#define RCL__LOAN_POOL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "rcl/allocator.h"
+#include "rcl/types.h"
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+// Messages loaned by rcl to publishers and subscriptions whose middleware
+// cannot loan.
+//
+// A message is initialized when the pool first hands it out and is only
+// finalized with the pool, returning it keeps it, with its content, for the
+// next borrow. The pool grows to the largest number of messages loaned at
+// once, after which borrowing and returning do not allocate.
+typedef struct rcl_loan_pool_s rcl_loan_pool_t;
+
+/// Create an empty pool for a message type.
+/**
+ * `*pool` is left `NULL` without an error if the type has no C introspection.
+ */
+rcl_ret_t
+rcl_loan_pool_init(
+  rcl_loan_pool_t ** pool,
+  const rosidl_message_type_support_t * type_support,
+  const rcl_allocator_t * allocator);
+
+/// Destroy the pool and its messages, all loans must have been returned.
+void
+rcl_loan_pool_fini(rcl_loan_pool_t * pool);
+
+/// Get a free message, creating it if there is none, `NULL` with the error set on failure.
+void *
+rcl_loan_pool_borrow(rcl_loan_pool_t * pool);
+
+/// Give back a message obtained from rcl_loan_pool_borrow().
+void
+rcl_loan_pool_return(rcl_loan_pool_t * pool, void * message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__LOAN_POOL_H_
@@ -0,0 +1,183 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./message_introspection.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rcl/error_handling.h"
+#include "rosidl_runtime_c/string.h"
+#include "rosidl_runtime_c/string_functions.h"
+#include "rosidl_runtime_c/u16string.h"
+#include "rosidl_runtime_c/u16string_functions.h"
+#include "rosidl_typesupport_introspection_c/field_types.h"
+#include "rosidl_typesupport_introspection_c/identifier.h"
+
+typedef rosidl_typesupport_introspection_c__MessageMember rcl_message_member_t;
+
+const rcl_message_members_t *
+rcl_message_introspection_get_members(const rosidl_message_type_support_t * type_support)
+{
+  if (NULL == type_support) {
+    return NULL;
+  }
+  const rosidl_message_type_support_t * introspection = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_introspection_c__identifier);
+  if (NULL == introspection) {
+    // Not having an introspection is no error for the callers.
+    rcl_reset_error();
+    return NULL;
+  }
+  return (const rcl_message_members_t *)introspection->data;
+}
+
+// Size of a primitive member, 0 for strings and nested messages.
+static size_t
+__primitive_size(uint8_t type_id)
+{
+  switch (type_id) {
+    case rosidl_typesupport_introspection_c__ROS_TYPE_FLOAT:
+      return sizeof(float);
+    case rosidl_typesupport_introspection_c__ROS_TYPE_DOUBLE:
+      return sizeof(double);
+    case rosidl_typesupport_introspection_c__ROS_TYPE_LONG_DOUBLE:
+      return sizeof(long double);
+    case rosidl_typesupport_introspection_c__ROS_TYPE_CHAR:
+      return sizeof(char);
+    case rosidl_typesupport_introspection_c__ROS_TYPE_WCHAR:
+      return sizeof(uint16_t);
+    case rosidl_typesupport_introspection_c__ROS_TYPE_BOOLEAN:
+      return sizeof(bool);
+    case rosidl_typesupport_introspection_c__ROS_TYPE_OCTET:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT8:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT8:
+      return sizeof(uint8_t);
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT16:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT16:
+      return sizeof(uint16_t);
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT32:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT32:
+      return sizeof(uint32_t);
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT64:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT64:
+      return sizeof(uint64_t);
+    default:
+      return 0u;
+  }
+}
+
+static rcl_ret_t
+__copy_element(const rcl_message_member_t * member, const void * source, void * destination)
+{
+  switch (member->type_id_) {
+    case rosidl_typesupport_introspection_c__ROS_TYPE_STRING:
+      {
+        const rosidl_runtime_c__String * string = (const rosidl_runtime_c__String *)source;
+        if (
+          !rosidl_runtime_c__String__assignn(
+            (rosidl_runtime_c__String *)destination, string->data, string->size))
+        {
+          RCL_SET_ERROR_MSG("failed to copy string member");
+          return RCL_RET_BAD_ALLOC;
+        }
+        return RCL_RET_OK;
+      }
+    case rosidl_typesupport_introspection_c__ROS_TYPE_WSTRING:
+      {
+        const rosidl_runtime_c__U16String * string = (const rosidl_runtime_c__U16String *)source;
+        if (
+          !rosidl_runtime_c__U16String__assignn(
+            (rosidl_runtime_c__U16String *)destination, string->data, string->size))
+        {
+          RCL_SET_ERROR_MSG("failed to copy wstring member");
+          return RCL_RET_BAD_ALLOC;
+        }
+        return RCL_RET_OK;
+      }
+    case rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE:
+      return rcl_message_introspection_copy(
+        (const rcl_message_members_t *)member->members_->data, source, destination);
+    default:
+      memcpy(destination, source, __primitive_size(member->type_id_));
+      return RCL_RET_OK;
+  }
+}
+
+static rcl_ret_t
+__copy_array(const rcl_message_member_t * member, const void * source, void * destination)
+{
+  size_t size = member->array_size_;
+  if (0u == size || member->is_upper_bound_) {
+    // A sequence, resize the destination to the source.
+    size = member->size_function(source);
+    if (!member->resize_function(destination, size)) {
+      RCL_SET_ERROR_MSG("failed to resize sequence member");
+      return RCL_RET_BAD_ALLOC;
+    }
+  }
+  if (0u == size) {
+    return RCL_RET_OK;
+  }
+  const size_t primitive_size = __primitive_size(member->type_id_);
+  if (0u != primitive_size) {
+    // Elements of primitive arrays and sequences are contiguous.
+    memcpy(
+      member->get_function(destination, 0u),
+      member->get_const_function(source, 0u),
+      size * primitive_size);
+    return RCL_RET_OK;
+  }
+  for (size_t i = 0u; i < size; ++i) {
+    rcl_ret_t ret = __copy_element(
+      member, member->get_const_function(source, i), member->get_function(destination, i));
+    if (RCL_RET_OK != ret) {
+      return ret;
+    }
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_message_introspection_copy(
+  const rcl_message_members_t * members,
+  const void * source,
+  void * destination)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(members, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(source, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(destination, RCL_RET_INVALID_ARGUMENT);
+  for (uint32_t i = 0u; i < members->member_count_; ++i) {
+    const rcl_message_member_t * member = &members->members_[i];
+    const void * source_member = (const uint8_t *)source + member->offset_;
+    void * destination_member = (uint8_t *)destination + member->offset_;
+    rcl_ret_t ret = member->is_array_ ?
+      __copy_array(member, source_member, destination_member) :
+      __copy_element(member, source_member, destination_member);
+    if (RCL_RET_OK != ret) {
+      return ret;
+    }
+  }
+  return RCL_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,50 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__MESSAGE_INTROSPECTION_H_
+#define RCL__MESSAGE_INTROSPECTION_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "rcl/types.h"
+#include "rosidl_runtime_c/message_type_support_struct.h"
+#include "rosidl_typesupport_introspection_c/message_introspection.h"
+
+typedef rosidl_typesupport_introspection_c__MessageMembers rcl_message_members_t;
+
+/// Get the C introspection of a message type, `NULL` without an error if the type has none.
+const rcl_message_members_t *
+rcl_message_introspection_get_members(const rosidl_message_type_support_t * type_support);
+
+/// Deep copy an initialized message into another initialized message of the same type.
+/**
+ * Strings and sequences of the destination are reallocated as needed with the
+ * allocator of the type support, the default allocator.
+ * On failure the error is set and the destination is partially copied, but
+ * still safe to finalize.
+ */
+rcl_ret_t
+rcl_message_introspection_copy(
+  const rcl_message_members_t * members,
+  const void * source,
+  void * destination);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__MESSAGE_INTROSPECTION_H_
@@ -33,7 +33,12 @@ extern "C"
 #include "tracetools/tracetools.h"
 
 #include "./common.h"
+#include "./context_impl.h"
+#include "./intra_context.h"
+#include "./loan_pool.h"
 #include "./publisher_impl.h"
+#include "./publisher_throttle.h"
+#include "./traffic_counters.h"
 
 rcl_publisher_t
 rcl_get_zero_initialized_publisher()
@@ -103,6 +108,10 @@ rcl_publisher_init(
     sizeof(rcl_publisher_impl_t), allocator->state);
   RCL_CHECK_FOR_NULL_WITH_MSG(
     publisher->impl, "allocating memory failed", ret = RCL_RET_BAD_ALLOC; goto cleanup);
+  publisher->impl->traffic_counters = NULL;
+  publisher->impl->intra_context = NULL;
+  publisher->impl->loan_pool = NULL;
+  publisher->impl->throttle = NULL;
 
   // Fill out implementation struct.
   // rmw handle (create rmw publisher)
@@ -125,6 +134,39 @@ rcl_publisher_init(
   }
   publisher->impl->actual_qos.avoid_ros_namespace_conventions =
     options->qos.avoid_ros_namespace_conventions;
+#ifndef RCL_DISABLE_TRAFFIC_COUNTERS
+  // traffic counters
+  publisher->impl->traffic_counters = rcl_traffic_counters_create(allocator);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    publisher->impl->traffic_counters, "allocating memory failed",
+    fail_ret = RCL_RET_BAD_ALLOC; goto fail);
+#endif
+  // intra context delivery
+  if (options->intra_context) {
+    ret = rcl_intra_context_add_publisher(
+      node->context->impl->intra_context, publisher->impl->rmw_handle, type_support,
+      &publisher->impl->actual_qos, allocator, &publisher->impl->intra_context);
+    if (RCL_RET_OK != ret) {
+      fail_ret = ret;  // error already set
+      goto fail;
+    }
+  }
+  // loans the middleware cannot provide, delivering within the context already loans
+  if (NULL == publisher->impl->intra_context && !publisher->impl->rmw_handle->can_loan_messages) {
+    ret = rcl_loan_pool_init(&publisher->impl->loan_pool, type_support, allocator);
+    if (RCL_RET_OK != ret) {
+      fail_ret = ret;  // error already set
+      goto fail;
+    }
+  }
+  // throttling of rcl_publish()
+  ret = rcl_publisher_throttle_init(
+    &publisher->impl->throttle, type_support, options->throttle_period, options->conflate,
+    allocator);
+  if (RCL_RET_OK != ret) {
+    fail_ret = ret;  // error already set
+    goto fail;
+  }
   // options
   publisher->impl->options = *options;
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Publisher initialized");
@@ -140,6 +182,7 @@ rcl_publisher_init(
   goto cleanup;
 fail:
   if (publisher->impl) {
+    rcl_intra_context_remove_publisher(publisher->impl->intra_context);
     if (publisher->impl->rmw_handle) {
       rmw_ret_t rmw_fail_ret = rmw_destroy_publisher(
         rcl_node_get_rmw_handle(node), publisher->impl->rmw_handle);
@@ -149,6 +192,9 @@ fail:
       }
     }
 
+    rcl_publisher_throttle_fini(publisher->impl->throttle);
+    rcl_loan_pool_fini(publisher->impl->loan_pool);
+    rcl_traffic_counters_destroy(publisher->impl->traffic_counters, allocator);
     allocator->deallocate(publisher->impl, allocator->state);
     publisher->impl = NULL;
   }
@@ -181,12 +227,17 @@ rcl_publisher_fini(rcl_publisher_t * publisher, rcl_node_t * node)
     if (!rmw_node) {
       return RCL_RET_INVALID_ARGUMENT;
     }
+    // The endpoint refers to the topic name of the rmw handle.
+    rcl_intra_context_remove_publisher(publisher->impl->intra_context);
     rmw_ret_t ret =
       rmw_destroy_publisher(rmw_node, publisher->impl->rmw_handle);
     if (ret != RMW_RET_OK) {
       RCL_SET_ERROR_MSG(rmw_get_error_string().str);
       result = RCL_RET_ERROR;
     }
+    rcl_publisher_throttle_fini(publisher->impl->throttle);
+    rcl_loan_pool_fini(publisher->impl->loan_pool);
+    rcl_traffic_counters_destroy(publisher->impl->traffic_counters, &allocator);
     allocator.deallocate(publisher->impl, allocator.state);
     publisher->impl = NULL;
   }
@@ -203,9 +254,120 @@ rcl_publisher_get_default_options()
   default_options.qos = rmw_qos_profile_default;
   default_options.allocator = rcl_get_default_allocator();
   default_options.rmw_publisher_options = rmw_get_default_publisher_options();
+  default_options.intra_context = false;
+  default_options.throttle_period = 0;
+  default_options.conflate = false;
   return default_options;
 }
 
+// Queue a message borrowed from the intra context endpoint on the local
+// subscriptions, and tell whether the middleware has other subscriptions to serve.
+// During discovery the middleware may match a remote subscription before a local
+// one, so local subscriptions only make up for middleware matches once confirmed.
+static bool
+__publisher_deliver_locally(const rcl_publisher_t * publisher, void * message)
+{
+  rcl_intra_context_publisher_t * intra_context = publisher->impl->intra_context;
+  if (0u == rcl_intra_context_publisher_deliver(intra_context, message)) {
+    return true;
+  }
+  size_t matched = 0u;
+  if (
+    RMW_RET_OK !=
+    rmw_publisher_count_matched_subscriptions(publisher->impl->rmw_handle, &matched))
+  {
+    rmw_reset_error();
+    return true;  // Local subscriptions drop the second copy.
+  }
+  return matched > rcl_intra_context_publisher_count_confirmed(intra_context);
+}
+
+static rcl_ret_t
+__publisher_publish(
+  const rcl_publisher_t * publisher,
+  const void * ros_message,
+  rmw_publisher_allocation_t * allocation)
+{
+  rcl_intra_context_publisher_t * intra_context = publisher->impl->intra_context;
+  if (NULL != intra_context && rcl_intra_context_publisher_has_subscriptions(intra_context)) {
+    void * message = rcl_intra_context_publisher_borrow_copy(intra_context, ros_message);
+    if (NULL == message) {
+      return RCL_RET_ERROR;  // error already set
+    }
+    const bool publish_remotely = __publisher_deliver_locally(publisher, message);
+    rcl_intra_context_message_release(message);
+    if (!publish_remotely) {
+      return RCL_RET_OK;
+    }
+  }
+  if (rmw_publish(publisher->impl->rmw_handle, ros_message, allocation) != RMW_RET_OK) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
+  return RCL_RET_OK;
+}
+
+static rcl_ret_t
+__publisher_publish_serialized(
+  const rcl_publisher_t * publisher,
+  const rcl_serialized_message_t * serialized_message,
+  rmw_publisher_allocation_t * allocation)
+{
+  rcl_intra_context_publisher_t * intra_context = publisher->impl->intra_context;
+  if (NULL != intra_context && rcl_intra_context_publisher_has_subscriptions(intra_context)) {
+    void * message =
+      rcl_intra_context_publisher_borrow_deserialized(intra_context, serialized_message);
+    if (NULL == message) {
+      return RCL_RET_ERROR;  // error already set
+    }
+    const bool publish_remotely = __publisher_deliver_locally(publisher, message);
+    rcl_intra_context_message_release(message);
+    if (!publish_remotely) {
+      return RCL_RET_OK;
+    }
+  }
+  rmw_ret_t ret = rmw_publish_serialized_message(
+    publisher->impl->rmw_handle, serialized_message, allocation);
+  if (ret != RMW_RET_OK) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    if (ret == RMW_RET_BAD_ALLOC) {
+      return RCL_RET_BAD_ALLOC;
+    }
+    return RCL_RET_ERROR;
+  }
+  return RCL_RET_OK;
+}
+
+// Offer a message to the throttle of the publisher, if any, which tells whether to publish it now.
+static rcl_ret_t
+__publisher_throttle(
+  const rcl_publisher_t * publisher,
+  const void * ros_message,
+  bool * publish_now)
+{
+  *publish_now = true;
+  rcl_publisher_throttle_t * throttle = publisher->impl->throttle;
+  if (NULL == throttle) {
+    return RCL_RET_OK;
+  }
+  rcl_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    return RCL_RET_ERROR;  // error already set
+  }
+  return rcl_publisher_throttle_offer(throttle, ros_message, now, publish_now);
+}
+
+// Serialized messages are not typed for conflation, so throttled publishers reject them.
+static rcl_ret_t
+__publisher_check_not_throttled(const rcl_publisher_t * publisher)
+{
+  if (NULL != publisher->impl->throttle) {
+    RCL_SET_ERROR_MSG("throttled publishers cannot publish serialized messages");
+    return RCL_RET_UNSUPPORTED;
+  }
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_borrow_loaned_message(
   const rcl_publisher_t * publisher,
@@ -215,8 +377,24 @@ rcl_borrow_loaned_message(
   if (!rcl_publisher_is_valid(publisher)) {
     return RCL_RET_PUBLISHER_INVALID;  // error already set
   }
-  return rcl_convert_rmw_ret_to_rcl_ret(
-    rmw_borrow_loaned_message(publisher->impl->rmw_handle, type_support, ros_message));
+  rcl_ret_t ret;
+  if (NULL != publisher->impl->intra_context) {
+    // The loan is shared with the local subscriptions, so rcl owns it.
+    RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
+    *ros_message = rcl_intra_context_publisher_borrow(publisher->impl->intra_context);
+    ret = NULL == *ros_message ? RCL_RET_BAD_ALLOC : RCL_RET_OK;
+  } else if (NULL != publisher->impl->loan_pool) {
+    RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
+    *ros_message = rcl_loan_pool_borrow(publisher->impl->loan_pool);
+    ret = NULL == *ros_message ? RCL_RET_BAD_ALLOC : RCL_RET_OK;
+  } else {
+    ret = rcl_convert_rmw_ret_to_rcl_ret(
+      rmw_borrow_loaned_message(publisher->impl->rmw_handle, type_support, ros_message));
+  }
+  if (RCL_RET_OK == ret) {
+    RCL_TRAFFIC_COUNT_LOAN(publisher->impl);
+  }
+  return ret;
 }
 
 rcl_ret_t
@@ -228,6 +406,14 @@ rcl_return_loaned_message_from_publisher(
     return RCL_RET_PUBLISHER_INVALID;  // error already set
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(loaned_message, RCL_RET_INVALID_ARGUMENT);
+  if (NULL != publisher->impl->intra_context) {
+    rcl_intra_context_message_release(loaned_message);
+    return RCL_RET_OK;
+  }
+  if (NULL != publisher->impl->loan_pool) {
+    rcl_loan_pool_return(publisher->impl->loan_pool, loaned_message);
+    return RCL_RET_OK;
+  }
   return rcl_convert_rmw_ret_to_rcl_ret(
     rmw_return_loaned_message_from_publisher(publisher->impl->rmw_handle, loaned_message));
 }
@@ -246,10 +432,48 @@ rcl_publish(
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
   TRACEPOINT(rcl_publish, (const void *)publisher, (const void *)ros_message);
-  if (rmw_publish(publisher->impl->rmw_handle, ros_message, allocation) != RMW_RET_OK) {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    return RCL_RET_ERROR;
+  bool publish_now;
+  rcl_ret_t ret = __publisher_throttle(publisher, ros_message, &publish_now);
+  if (RCL_RET_OK == ret && !publish_now) {
+    return RCL_RET_OK;  // Kept for rcl_publisher_flush(), or dropped.
+  }
+  if (RCL_RET_OK == ret) {
+    ret = __publisher_publish(publisher, ros_message, allocation);
+  }
+  if (RCL_RET_OK != ret) {
+    RCL_TRAFFIC_COUNT_ERROR(publisher->impl);
+    return ret;
+  }
+  RCL_TRAFFIC_COUNT_MESSAGES(publisher->impl, 1u, 0u);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_publisher_flush(const rcl_publisher_t * publisher)
+{
+  if (!rcl_publisher_is_valid(publisher)) {
+    return RCL_RET_PUBLISHER_INVALID;  // error already set
+  }
+  rcl_publisher_throttle_t * throttle = publisher->impl->throttle;
+  if (NULL == throttle) {
+    return RCL_RET_OK;
+  }
+  rcl_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    return RCL_RET_ERROR;  // error already set
+  }
+  void * ros_message = rcl_publisher_throttle_begin_flush(throttle, now);
+  if (NULL == ros_message) {
+    return RCL_RET_OK;
+  }
+  TRACEPOINT(rcl_publish, (const void *)publisher, (const void *)ros_message);
+  rcl_ret_t ret = __publisher_publish(publisher, ros_message, NULL);
+  rcl_publisher_throttle_end_flush(throttle, ros_message);
+  if (RCL_RET_OK != ret) {
+    RCL_TRAFFIC_COUNT_ERROR(publisher->impl);
+    return ret;
   }
+  RCL_TRAFFIC_COUNT_MESSAGES(publisher->impl, 1u, 0u);
   return RCL_RET_OK;
 }
 
@@ -263,18 +487,117 @@ rcl_publish_serialized_message(
     return RCL_RET_PUBLISHER_INVALID;  // error already set
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(serialized_message, RCL_RET_INVALID_ARGUMENT);
-  rmw_ret_t ret = rmw_publish_serialized_message(
-    publisher->impl->rmw_handle, serialized_message, allocation);
-  if (ret != RMW_RET_OK) {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    if (ret == RMW_RET_BAD_ALLOC) {
-      return RCL_RET_BAD_ALLOC;
-    }
-    return RCL_RET_ERROR;
+  rcl_ret_t ret = __publisher_check_not_throttled(publisher);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+  ret = __publisher_publish_serialized(publisher, serialized_message, allocation);
+  if (RCL_RET_OK != ret) {
+    RCL_TRAFFIC_COUNT_ERROR(publisher->impl);
+    return ret;
   }
+  RCL_TRAFFIC_COUNT_MESSAGES(publisher->impl, 1u, serialized_message->buffer_length);
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_publish_sequence(
+  const rcl_publisher_t * publisher,
+  const rmw_message_sequence_t * message_sequence,
+  size_t * published_count,
+  rmw_publisher_allocation_t * allocation)
+{
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCL_RET_PUBLISHER_INVALID);
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCL_RET_ERROR);
+
+  if (NULL != published_count) {
+    *published_count = 0u;
+  }
+  if (!rcl_publisher_is_valid(publisher)) {
+    return RCL_RET_PUBLISHER_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(message_sequence, RCL_RET_INVALID_ARGUMENT);
+  if (message_sequence->size > message_sequence->capacity) {
+    RCL_SET_ERROR_MSG("message sequence size exceeds its capacity");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  // Validate the whole batch up front, so it is either rejected or handed to rmw.
+  for (size_t i = 0u; i < message_sequence->size; ++i) {
+    RCL_CHECK_FOR_NULL_WITH_MSG(
+      message_sequence->data[i], "message in sequence is null",
+      return RCL_RET_INVALID_ARGUMENT);
+  }
+  rcl_ret_t ret = RCL_RET_OK;
+  size_t published = 0u;
+  size_t i = 0u;
+  for (; i < message_sequence->size; ++i) {
+    const void * ros_message = message_sequence->data[i];
+    TRACEPOINT(rcl_publish, (const void *)publisher, ros_message);
+    bool publish_now;
+    ret = __publisher_throttle(publisher, ros_message, &publish_now);
+    if (RCL_RET_OK == ret && !publish_now) {
+      continue;
+    }
+    if (RCL_RET_OK == ret) {
+      ret = __publisher_publish(publisher, ros_message, allocation);
+    }
+    if (RCL_RET_OK != ret) {
+      RCL_TRAFFIC_COUNT_ERROR(publisher->impl);
+      break;
+    }
+    ++published;
+  }
+  // Count the batch once, rather than each message.
+  if (0u != published) {
+    RCL_TRAFFIC_COUNT_MESSAGES(publisher->impl, published, 0u);
+  }
+  if (NULL != published_count) {
+    *published_count = i;
+  }
+  return ret;
+}
+
+rcl_ret_t
+rcl_publish_serialized_message_sequence(
+  const rcl_publisher_t * publisher,
+  const rcl_serialized_message_t * serialized_messages,
+  size_t count,
+  size_t * published_count,
+  rmw_publisher_allocation_t * allocation)
+{
+  if (NULL != published_count) {
+    *published_count = 0u;
+  }
+  if (!rcl_publisher_is_valid(publisher)) {
+    return RCL_RET_PUBLISHER_INVALID;  // error already set
+  }
+  if (0u == count) {
+    return RCL_RET_OK;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(serialized_messages, RCL_RET_INVALID_ARGUMENT);
+  rcl_ret_t ret = __publisher_check_not_throttled(publisher);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+  size_t published_bytes = 0u;
+  size_t i = 0u;
+  for (; i < count; ++i) {
+    ret = __publisher_publish_serialized(publisher, &serialized_messages[i], allocation);
+    if (RCL_RET_OK != ret) {
+      RCL_TRAFFIC_COUNT_ERROR(publisher->impl);
+      break;
+    }
+    published_bytes += serialized_messages[i].buffer_length;
+  }
+  if (0u != i) {
+    RCL_TRAFFIC_COUNT_MESSAGES(publisher->impl, i, published_bytes);
+  }
+  if (NULL != published_count) {
+    *published_count = i;
+  }
+  return ret;
+}
+
 rcl_ret_t
 rcl_publish_loaned_message(
   const rcl_publisher_t * publisher,
@@ -285,11 +608,36 @@ rcl_publish_loaned_message(
     return RCL_RET_PUBLISHER_INVALID;  // error already set
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
-  rmw_ret_t ret = rmw_publish_loaned_message(publisher->impl->rmw_handle, ros_message, allocation);
+  bool publish_now;
+  rcl_ret_t throttle_ret = __publisher_throttle(publisher, ros_message, &publish_now);
+  if (RCL_RET_OK != throttle_ret || !publish_now) {
+    // The throttle kept a copy or dropped the message, the loan goes back where it came from.
+    rcl_ret_t return_ret = rcl_return_loaned_message_from_publisher(publisher, ros_message);
+    if (RCL_RET_OK != throttle_ret) {
+      RCL_TRAFFIC_COUNT_ERROR(publisher->impl);
+      return throttle_ret;
+    }
+    return return_ret;
+  }
+  rmw_ret_t ret;
+  if (NULL != publisher->impl->intra_context) {
+    // rcl owns the loan, the middleware only copies it for the subscriptions left to serve.
+    ret = __publisher_deliver_locally(publisher, ros_message) ?
+      rmw_publish(publisher->impl->rmw_handle, ros_message, allocation) : RMW_RET_OK;
+    rcl_intra_context_message_release(ros_message);
+  } else if (NULL != publisher->impl->loan_pool) {
+    // The middleware copies the message, which goes back to the pool right away.
+    ret = rmw_publish(publisher->impl->rmw_handle, ros_message, allocation);
+    rcl_loan_pool_return(publisher->impl->loan_pool, ros_message);
+  } else {
+    ret = rmw_publish_loaned_message(publisher->impl->rmw_handle, ros_message, allocation);
+  }
   if (ret != RMW_RET_OK) {
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    RCL_TRAFFIC_COUNT_ERROR(publisher->impl);
     return RCL_RET_ERROR;
   }
+  RCL_TRAFFIC_COUNT_MESSAGES(publisher->impl, 1u, 0u);
   return RCL_RET_OK;
 }
 
@@ -447,9 +795,35 @@ rcl_publisher_can_loan_messages(const rcl_publisher_t * publisher)
     return false;
   }
 
+  if (NULL != publisher->impl->intra_context || NULL != publisher->impl->loan_pool) {
+    return true;
+  }
   return publisher->impl->rmw_handle->can_loan_messages;
 }
 
+rcl_ret_t
+rcl_publisher_get_traffic_counters(
+  const rcl_publisher_t * publisher,
+  rcl_publisher_traffic_counters_t * counters)
+{
+  if (!rcl_publisher_is_valid_except_context(publisher)) {
+    return RCL_RET_PUBLISHER_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(counters, RCL_RET_INVALID_ARGUMENT);
+#ifdef RCL_DISABLE_TRAFFIC_COUNTERS
+  RCL_SET_ERROR_MSG("rcl was built without traffic counters");
+  return RCL_RET_UNSUPPORTED;
+#else
+  rcl_traffic_counters_t * traffic_counters = publisher->impl->traffic_counters;
+  counters->message_count = rcl_traffic_counters_load(&traffic_counters->message_count);
+  counters->serialized_byte_count = rcl_traffic_counters_load(&traffic_counters->byte_count);
+  counters->loaned_message_count = rcl_traffic_counters_load(&traffic_counters->loan_count);
+  counters->error_count = rcl_traffic_counters_load(&traffic_counters->error_count);
+  counters->last_publish_time = rcl_traffic_counters_load_last_activity_time(traffic_counters);
+  return RCL_RET_OK;
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
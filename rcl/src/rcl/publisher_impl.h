@@ -19,12 +19,25 @@
 
 #include "rcl/publisher.h"
 
+struct rcl_intra_context_publisher_s;
+struct rcl_loan_pool_s;
+struct rcl_publisher_throttle_s;
+struct rcl_traffic_counters_s;
+
 struct rcl_publisher_impl_s
 {
   rcl_publisher_options_t options;
   rmw_qos_profile_t actual_qos;
   rcl_context_t * context;
   rmw_publisher_t * rmw_handle;
+  // Behind a pointer to keep atomics out of this header, NULL if compiled out.
+  struct rcl_traffic_counters_s * traffic_counters;
+  // NULL unless delivering within the context, see intra_context.h.
+  struct rcl_intra_context_publisher_s * intra_context;
+  // NULL unless rcl loans the messages the middleware cannot, see loan_pool.h.
+  struct rcl_loan_pool_s * loan_pool;
+  // NULL unless rcl_publish() is throttled, see publisher_throttle.h.
+  struct rcl_publisher_throttle_s * throttle;
 };
 
 #endif  // RCL__PUBLISHER_IMPL_H_
@@ -0,0 +1,204 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./publisher_throttle.h"
+
+#include <stdint.h>
+
+#include "rcl/error_handling.h"
+#include "rcutils/stdatomic_helper.h"
+
+#include "./loan_pool.h"
+#include "./message_introspection.h"
+
+struct rcl_publisher_throttle_s
+{
+  // spinlock guarding the members below, held for a few instructions only
+  atomic_bool lock;
+  rcl_duration_value_t period;
+  // steady time from which the next message may be published
+  rcl_time_point_value_t next_publish_time;
+  // order of the offers, the slot only takes a copy newer than what went out or is kept
+  uint64_t offer_count;
+  uint64_t latest_sequence;
+  // latest message kept from the pool, or NULL
+  void * slot;
+  // messages to copy into, NULL without conflation
+  rcl_loan_pool_t * messages;
+  const rcl_message_members_t * members;
+  rcl_allocator_t allocator;
+};
+
+static void
+__lock(rcl_publisher_throttle_t * throttle)
+{
+  while (rcutils_atomic_exchange_bool(&throttle->lock, true)) {
+  }
+}
+
+static void
+__unlock(rcl_publisher_throttle_t * throttle)
+{
+  rcutils_atomic_store(&throttle->lock, false);
+}
+
+// Steady time a period after now, saturating rather than overflowing.
+static rcl_time_point_value_t
+__next_publish_time(const rcl_publisher_throttle_t * throttle, rcl_time_point_value_t now)
+{
+  if (now > INT64_MAX - throttle->period) {
+    return INT64_MAX;
+  }
+  return now + throttle->period;
+}
+
+rcl_ret_t
+rcl_publisher_throttle_init(
+  rcl_publisher_throttle_t ** throttle,
+  const rosidl_message_type_support_t * type_support,
+  rcl_duration_value_t period,
+  bool conflate,
+  const rcl_allocator_t * allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(throttle, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(type_support, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  *throttle = NULL;
+  if (period < 0) {
+    RCL_SET_ERROR_MSG("throttle period must not be negative");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (0 == period) {
+    return RCL_RET_OK;
+  }
+  const rcl_message_members_t * members = NULL;
+  if (conflate) {
+    members = rcl_message_introspection_get_members(type_support);
+    if (NULL == members) {
+      RCL_SET_ERROR_MSG("conflation needs the C introspection of the message type");
+      return RCL_RET_UNSUPPORTED;
+    }
+  }
+  rcl_publisher_throttle_t * new_throttle = (rcl_publisher_throttle_t *)allocator->zero_allocate(
+    1u, sizeof(rcl_publisher_throttle_t), allocator->state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(new_throttle, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  atomic_init(&new_throttle->lock, false);
+  new_throttle->period = period;
+  new_throttle->members = members;
+  new_throttle->allocator = *allocator;
+  if (conflate) {
+    rcl_ret_t ret = rcl_loan_pool_init(&new_throttle->messages, type_support, allocator);
+    if (RCL_RET_OK != ret) {
+      allocator->deallocate(new_throttle, allocator->state);
+      return ret;  // error already set
+    }
+  }
+  *throttle = new_throttle;
+  return RCL_RET_OK;
+}
+
+void
+rcl_publisher_throttle_fini(rcl_publisher_throttle_t * throttle)
+{
+  if (NULL == throttle) {
+    return;
+  }
+  if (NULL != throttle->slot) {
+    rcl_loan_pool_return(throttle->messages, throttle->slot);
+  }
+  rcl_loan_pool_fini(throttle->messages);
+  rcl_allocator_t allocator = throttle->allocator;
+  allocator.deallocate(throttle, allocator.state);
+}
+
+rcl_ret_t
+rcl_publisher_throttle_offer(
+  rcl_publisher_throttle_t * throttle,
+  const void * ros_message,
+  rcl_time_point_value_t now,
+  bool * publish_now)
+{
+  void * replaced = NULL;
+  __lock(throttle);
+  const uint64_t sequence = ++throttle->offer_count;
+  *publish_now = now >= throttle->next_publish_time;
+  if (*publish_now) {
+    // A kept message is older than this one, which replaces it.
+    throttle->next_publish_time = __next_publish_time(throttle, now);
+    throttle->latest_sequence = sequence;
+    replaced = throttle->slot;
+    throttle->slot = NULL;
+  }
+  __unlock(throttle);
+  if (NULL != replaced) {
+    rcl_loan_pool_return(throttle->messages, replaced);
+  }
+  if (*publish_now || NULL == throttle->messages) {
+    return RCL_RET_OK;
+  }
+
+  // Copy without the lock, which is only taken again to swap the copy in.
+  void * copy = rcl_loan_pool_borrow(throttle->messages);
+  if (NULL == copy) {
+    return RCL_RET_BAD_ALLOC;  // error already set
+  }
+  rcl_ret_t ret = rcl_message_introspection_copy(throttle->members, ros_message, copy);
+  if (RCL_RET_OK != ret) {
+    rcl_loan_pool_return(throttle->messages, copy);
+    return ret;  // error already set
+  }
+  __lock(throttle);
+  if (sequence > throttle->latest_sequence) {
+    replaced = throttle->slot;
+    throttle->slot = copy;
+    throttle->latest_sequence = sequence;
+  } else {
+    // A newer message was kept or published while copying.
+    replaced = copy;
+  }
+  __unlock(throttle);
+  if (NULL != replaced) {
+    rcl_loan_pool_return(throttle->messages, replaced);
+  }
+  return RCL_RET_OK;
+}
+
+void *
+rcl_publisher_throttle_begin_flush(rcl_publisher_throttle_t * throttle, rcl_time_point_value_t now)
+{
+  void * message = NULL;
+  __lock(throttle);
+  if (NULL != throttle->slot && now >= throttle->next_publish_time) {
+    message = throttle->slot;
+    throttle->slot = NULL;
+    throttle->next_publish_time = __next_publish_time(throttle, now);
+  }
+  __unlock(throttle);
+  return message;
+}
+
+void
+rcl_publisher_throttle_end_flush(rcl_publisher_throttle_t * throttle, void * ros_message)
+{
+  rcl_loan_pool_return(throttle->messages, ros_message);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,88 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__PUBLISHER_THROTTLE_H_
+#define RCL__PUBLISHER_THROTTLE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+
+#include "rcl/allocator.h"
+#include "rcl/time.h"
+#include "rcl/types.h"
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+// Rate limit of the messages given to rcl_publish().
+//
+// A message offered at least a period after the last one published goes out
+// right away. Until then messages are dropped or, with conflation, copied into
+// a slot so that only the latest one is kept, and a flush publishes it once the
+// period is over.
+//
+// Messages are copied into messages of a loan pool, see loan_pool.h, without
+// holding the spinlock of the throttle, which only guards swapping them in and
+// out of the slot. Copying only allocates while the pool and the strings and
+// sequences of its messages grow.
+typedef struct rcl_publisher_throttle_s rcl_publisher_throttle_t;
+
+/// Create a throttle, `*throttle` is left `NULL` without an error if the period is 0.
+/**
+ * Conflation needs the C introspection of the type to copy messages, without
+ * it RCL_RET_UNSUPPORTED is returned with the error set.
+ */
+rcl_ret_t
+rcl_publisher_throttle_init(
+  rcl_publisher_throttle_t ** throttle,
+  const rosidl_message_type_support_t * type_support,
+  rcl_duration_value_t period,
+  bool conflate,
+  const rcl_allocator_t * allocator);
+
+/// Destroy the throttle, dropping the message it holds, `NULL` is ignored.
+void
+rcl_publisher_throttle_fini(rcl_publisher_throttle_t * throttle);
+
+/// Offer a message at a steady time, `*publish_now` tells whether to publish it now.
+/**
+ * Otherwise the message was kept or dropped. Failing to copy it is reported
+ * with the error set and nothing kept.
+ */
+rcl_ret_t
+rcl_publisher_throttle_offer(
+  rcl_publisher_throttle_t * throttle,
+  const void * ros_message,
+  rcl_time_point_value_t now,
+  bool * publish_now);
+
+/// Get the kept message if the period is over, or `NULL` if there is nothing to publish.
+/**
+ * The message must be published and then handed back with
+ * rcl_publisher_throttle_end_flush(), until then the slot is empty.
+ */
+void *
+rcl_publisher_throttle_begin_flush(rcl_publisher_throttle_t * throttle, rcl_time_point_value_t now);
+
+/// Give back the message obtained from rcl_publisher_throttle_begin_flush().
+void
+rcl_publisher_throttle_end_flush(rcl_publisher_throttle_t * throttle, void * ros_message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__PUBLISHER_THROTTLE_H_
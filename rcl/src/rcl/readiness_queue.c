@@ -0,0 +1,484 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "rcl/readiness_queue.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rcl/error_handling.h"
+#include "rcl/guard_condition.h"
+#include "rcutils/logging_macros.h"
+#include "rcutils/stdatomic_helper.h"
+
+typedef struct rcl_readiness_queue_entity_s
+{
+  // queue the entity is registered with, used by the middleware callback
+  rcl_readiness_queue_impl_t * queue_impl;
+  // position of the entity in the entity storage of the queue
+  size_t index;
+  rcl_wait_set_entity_type_t entity_type;
+  const void * entity;
+  // number of items reported by the middleware since the entity was last taken
+  atomic_uint_least64_t pending;
+} rcl_readiness_queue_entity_t;
+
+struct rcl_readiness_queue_impl_s
+{
+  // storage for the registered entities, never reallocated after init
+  rcl_readiness_queue_entity_t * entities;
+  size_t entity_count;
+  size_t max_entities;
+  // bounded multi-producer single-consumer ring of entity indices, see
+  // __readiness_queue_push() and __readiness_queue_pop()
+  atomic_uint_least64_t * sequences;
+  size_t * ring;
+  uint64_t ring_mask;
+  atomic_uint_least64_t enqueue_position;
+  uint64_t dequeue_position;
+  // whether the guard condition was triggered since the consumer last looked
+  atomic_bool signaled;
+  // triggered by the middleware callbacks to wake up rcl_readiness_queue_wait()
+  rcl_guard_condition_t guard_condition;
+  // persistent wait set holding the guard condition and the timers
+  rcl_wait_set_t wait_set;
+  size_t timer_count;
+  rcl_allocator_t allocator;
+};
+
+rcl_readiness_queue_t
+rcl_get_zero_initialized_readiness_queue()
+{
+  static rcl_readiness_queue_t null_queue = {
+    .impl = NULL
+  };
+  return null_queue;
+}
+
+bool
+rcl_readiness_queue_is_valid(const rcl_readiness_queue_t * queue)
+{
+  return NULL != queue && NULL != queue->impl;
+}
+
+// Every entity has at most one index in the ring at any time: it is only
+// pushed when its pending count goes from zero to non-zero and its count is
+// only reset after it was popped. A ring with room for every entity can
+// therefore not overflow.
+static bool
+__readiness_queue_push(rcl_readiness_queue_impl_t * impl, size_t index)
+{
+  uint64_t position = rcutils_atomic_load_uint64_t(&impl->enqueue_position);
+  for (;; ) {
+    atomic_uint_least64_t * sequence = &impl->sequences[position & impl->ring_mask];
+    const uint64_t slot_sequence = rcutils_atomic_load_uint64_t(sequence);
+    const int64_t difference = (int64_t)(slot_sequence - position);
+    if (0 == difference) {
+      // The slot is free, try to claim it; on failure position holds the current value.
+      if (
+        rcutils_atomic_compare_exchange_strong_uint_least64_t(
+          &impl->enqueue_position, &position, position + 1u))
+      {
+        impl->ring[position & impl->ring_mask] = index;
+        rcutils_atomic_store(sequence, position + 1u);
+        return true;
+      }
+    } else if (difference < 0) {
+      return false;
+    } else {
+      position = rcutils_atomic_load_uint64_t(&impl->enqueue_position);
+    }
+  }
+}
+
+static bool
+__readiness_queue_pop(rcl_readiness_queue_impl_t * impl, size_t * index)
+{
+  const uint64_t position = impl->dequeue_position;
+  atomic_uint_least64_t * sequence = &impl->sequences[position & impl->ring_mask];
+  if (rcutils_atomic_load_uint64_t(sequence) != position + 1u) {
+    return false;
+  }
+  *index = impl->ring[position & impl->ring_mask];
+  rcutils_atomic_store(sequence, position + impl->ring_mask + 1u);
+  impl->dequeue_position = position + 1u;
+  return true;
+}
+
+static void
+__readiness_queue_on_new_items(const void * user_data, size_t number_of_items)
+{
+  // The middleware hands back the user data as given, which is a mutable entity.
+  rcl_readiness_queue_entity_t * entity = (rcl_readiness_queue_entity_t *)(uintptr_t)user_data;
+  if (0u == number_of_items) {
+    return;
+  }
+  rcl_readiness_queue_impl_t * impl = entity->queue_impl;
+  const uint64_t previous = rcutils_atomic_fetch_add_uint64_t(&entity->pending, number_of_items);
+  if (0u != previous) {
+    return;  // Already queued, the new items are coalesced into the pending record.
+  }
+  if (!__readiness_queue_push(impl, entity->index)) {
+    RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "readiness queue overflow, dropping notification");
+    return;
+  }
+  // Only the first notification after the consumer looked at the queue wakes it up.
+  if (!rcutils_atomic_exchange_bool(&impl->signaled, true)) {
+    if (RCL_RET_OK != rcl_trigger_guard_condition(&impl->guard_condition)) {
+      RCUTILS_LOG_ERROR_NAMED(
+        ROS_PACKAGE_NAME, "failed to wake up readiness queue: %s", rcl_get_error_string().str);
+      rcl_reset_error();
+    }
+  }
+}
+
+static rcl_ret_t
+__readiness_queue_unset_callback(rcl_readiness_queue_entity_t * entity)
+{
+  switch (entity->entity_type) {
+    case RCL_WAIT_SET_SUBSCRIPTION:
+      return rcl_subscription_set_on_new_message_callback(
+        (const rcl_subscription_t *)entity->entity, NULL, NULL);
+    case RCL_WAIT_SET_CLIENT:
+      return rcl_client_set_on_new_response_callback(
+        (const rcl_client_t *)entity->entity, NULL, NULL);
+    case RCL_WAIT_SET_SERVICE:
+      return rcl_service_set_on_new_request_callback(
+        (const rcl_service_t *)entity->entity, NULL, NULL);
+    case RCL_WAIT_SET_EVENT:
+      return rcl_event_set_callback((const rcl_event_t *)entity->entity, NULL, NULL);
+    default:
+      RCL_SET_ERROR_MSG("unexpected readiness queue entity type");
+      return RCL_RET_ERROR;
+  }
+}
+
+rcl_ret_t
+rcl_readiness_queue_init(
+  rcl_readiness_queue_t * queue,
+  size_t max_entities,
+  size_t max_timers,
+  rcl_context_t * context,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(queue, RCL_RET_INVALID_ARGUMENT);
+  if (rcl_readiness_queue_is_valid(queue)) {
+    RCL_SET_ERROR_MSG("readiness queue already initialized, or memory was uninitialized.");
+    return RCL_RET_ALREADY_INIT;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(context, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+
+  rcl_readiness_queue_impl_t * impl = (rcl_readiness_queue_impl_t *)allocator.zero_allocate(
+    1, sizeof(rcl_readiness_queue_impl_t), allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(impl, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  impl->allocator = allocator;
+  impl->max_entities = max_entities;
+  impl->guard_condition = rcl_get_zero_initialized_guard_condition();
+  impl->wait_set = rcl_get_zero_initialized_wait_set();
+  atomic_init(&impl->enqueue_position, 0u);
+  atomic_init(&impl->signaled, false);
+
+  rcl_ret_t ret = RCL_RET_OK;
+  size_t ring_size = 1u;
+  while (ring_size < max_entities) {
+    ring_size <<= 1u;
+  }
+  impl->ring_mask = ring_size - 1u;
+  impl->sequences = (atomic_uint_least64_t *)allocator.allocate(
+    sizeof(atomic_uint_least64_t) * ring_size, allocator.state);
+  impl->ring = (size_t *)allocator.allocate(sizeof(size_t) * ring_size, allocator.state);
+  if (max_entities > 0u) {
+    impl->entities = (rcl_readiness_queue_entity_t *)allocator.allocate(
+      sizeof(rcl_readiness_queue_entity_t) * max_entities, allocator.state);
+  }
+  if (!impl->sequences || !impl->ring || (max_entities > 0u && !impl->entities)) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    ret = RCL_RET_BAD_ALLOC;
+    goto fail;
+  }
+  for (size_t i = 0u; i < ring_size; ++i) {
+    atomic_init(&impl->sequences[i], i);
+  }
+
+  rcl_guard_condition_options_t guard_condition_options = rcl_guard_condition_get_default_options();
+  guard_condition_options.allocator = allocator;
+  ret = rcl_guard_condition_init(&impl->guard_condition, context, guard_condition_options);
+  if (RCL_RET_OK != ret) {
+    goto fail;
+  }
+  ret = rcl_wait_set_init(&impl->wait_set, 0, 1, max_timers, 0, 0, 0, context, allocator);
+  if (RCL_RET_OK != ret) {
+    goto fail;
+  }
+  ret = rcl_wait_set_set_persistent(&impl->wait_set, true);
+  if (RCL_RET_OK != ret) {
+    goto fail;
+  }
+  ret = rcl_wait_set_add_guard_condition(&impl->wait_set, &impl->guard_condition, NULL);
+  if (RCL_RET_OK != ret) {
+    goto fail;
+  }
+  queue->impl = impl;
+  return RCL_RET_OK;
+fail:
+  if (rcl_wait_set_is_valid(&impl->wait_set)) {
+    if (RCL_RET_OK != rcl_wait_set_fini(&impl->wait_set)) {
+      RCUTILS_SAFE_FWRITE_TO_STDERR(rcl_get_error_string().str);
+      RCUTILS_SAFE_FWRITE_TO_STDERR("\n");
+      rcl_reset_error();
+    }
+  }
+  if (NULL != impl->guard_condition.impl) {
+    if (RCL_RET_OK != rcl_guard_condition_fini(&impl->guard_condition)) {
+      RCUTILS_SAFE_FWRITE_TO_STDERR(rcl_get_error_string().str);
+      RCUTILS_SAFE_FWRITE_TO_STDERR("\n");
+      rcl_reset_error();
+    }
+  }
+  allocator.deallocate(impl->entities, allocator.state);
+  allocator.deallocate(impl->ring, allocator.state);
+  allocator.deallocate(impl->sequences, allocator.state);
+  allocator.deallocate(impl, allocator.state);
+  return ret;
+}
+
+rcl_ret_t
+rcl_readiness_queue_fini(rcl_readiness_queue_t * queue)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(queue, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_readiness_queue_is_valid(queue)) {
+    return RCL_RET_OK;
+  }
+  rcl_readiness_queue_impl_t * impl = queue->impl;
+  rcl_ret_t result = RCL_RET_OK;
+  for (size_t i = 0u; i < impl->entity_count; ++i) {
+    if (RCL_RET_OK != __readiness_queue_unset_callback(&impl->entities[i])) {
+      result = RCL_RET_ERROR;
+    }
+  }
+  if (RCL_RET_OK != rcl_wait_set_fini(&impl->wait_set)) {
+    result = RCL_RET_ERROR;
+  }
+  if (RCL_RET_OK != rcl_guard_condition_fini(&impl->guard_condition)) {
+    result = RCL_RET_ERROR;
+  }
+  rcl_allocator_t allocator = impl->allocator;
+  allocator.deallocate(impl->entities, allocator.state);
+  allocator.deallocate(impl->ring, allocator.state);
+  allocator.deallocate(impl->sequences, allocator.state);
+  allocator.deallocate(impl, allocator.state);
+  queue->impl = NULL;
+  return result;
+}
+
+static rcl_ret_t
+__readiness_queue_add_entity(
+  rcl_readiness_queue_t * queue,
+  rcl_wait_set_entity_type_t entity_type,
+  const void * entity)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(queue, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_readiness_queue_is_valid(queue)) {
+    RCL_SET_ERROR_MSG("readiness queue is invalid");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(entity, RCL_RET_INVALID_ARGUMENT);
+  rcl_readiness_queue_impl_t * impl = queue->impl;
+  if (impl->entity_count >= impl->max_entities) {
+    RCL_SET_ERROR_MSG("readiness queue is full");
+    return RCL_RET_WAIT_SET_FULL;
+  }
+  rcl_readiness_queue_entity_t * queue_entity = &impl->entities[impl->entity_count];
+  queue_entity->queue_impl = impl;
+  queue_entity->index = impl->entity_count;
+  queue_entity->entity_type = entity_type;
+  queue_entity->entity = entity;
+  atomic_init(&queue_entity->pending, 0u);
+
+  // The middleware may invoke the callback from within the setter to report
+  // items which arrived earlier, so the entity must be complete by now.
+  rcl_ret_t ret;
+  switch (entity_type) {
+    case RCL_WAIT_SET_SUBSCRIPTION:
+      ret = rcl_subscription_set_on_new_message_callback(
+        (const rcl_subscription_t *)entity, __readiness_queue_on_new_items, queue_entity);
+      break;
+    case RCL_WAIT_SET_CLIENT:
+      ret = rcl_client_set_on_new_response_callback(
+        (const rcl_client_t *)entity, __readiness_queue_on_new_items, queue_entity);
+      break;
+    case RCL_WAIT_SET_SERVICE:
+      ret = rcl_service_set_on_new_request_callback(
+        (const rcl_service_t *)entity, __readiness_queue_on_new_items, queue_entity);
+      break;
+    case RCL_WAIT_SET_EVENT:
+      ret = rcl_event_set_callback(
+        (const rcl_event_t *)entity, __readiness_queue_on_new_items, queue_entity);
+      break;
+    default:
+      RCL_SET_ERROR_MSG("unexpected readiness queue entity type");
+      return RCL_RET_ERROR;
+  }
+  if (RCL_RET_OK != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  ++(impl->entity_count);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_readiness_queue_add_subscription(
+  rcl_readiness_queue_t * queue,
+  const rcl_subscription_t * subscription)
+{
+  return __readiness_queue_add_entity(queue, RCL_WAIT_SET_SUBSCRIPTION, subscription);
+}
+
+rcl_ret_t
+rcl_readiness_queue_add_client(
+  rcl_readiness_queue_t * queue,
+  const rcl_client_t * client)
+{
+  return __readiness_queue_add_entity(queue, RCL_WAIT_SET_CLIENT, client);
+}
+
+rcl_ret_t
+rcl_readiness_queue_add_service(
+  rcl_readiness_queue_t * queue,
+  const rcl_service_t * service)
+{
+  return __readiness_queue_add_entity(queue, RCL_WAIT_SET_SERVICE, service);
+}
+
+rcl_ret_t
+rcl_readiness_queue_add_event(
+  rcl_readiness_queue_t * queue,
+  const rcl_event_t * event)
+{
+  return __readiness_queue_add_entity(queue, RCL_WAIT_SET_EVENT, event);
+}
+
+rcl_ret_t
+rcl_readiness_queue_add_timer(
+  rcl_readiness_queue_t * queue,
+  const rcl_timer_t * timer)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(queue, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_readiness_queue_is_valid(queue)) {
+    RCL_SET_ERROR_MSG("readiness queue is invalid");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_ret_t ret = rcl_wait_set_add_timer(&queue->impl->wait_set, timer, NULL);
+  if (RCL_RET_OK != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  ++(queue->impl->timer_count);
+  return RCL_RET_OK;
+}
+
+static void
+__readiness_queue_take(
+  rcl_readiness_queue_impl_t * impl,
+  rcl_readiness_record_t * records,
+  size_t records_capacity,
+  size_t * records_count)
+{
+  size_t index;
+  while (*records_count < records_capacity && __readiness_queue_pop(impl, &index)) {
+    rcl_readiness_queue_entity_t * entity = &impl->entities[index];
+    rcl_readiness_record_t * record = &records[(*records_count)++];
+    record->entity_type = entity->entity_type;
+    record->entity = entity->entity;
+    record->count = (size_t)rcutils_atomic_exchange_uint64_t(&entity->pending, 0u);
+  }
+}
+
+// Report the timers found ready by the last wait, which only visits the due ones.
+static rcl_ret_t
+__readiness_queue_take_timers(
+  rcl_readiness_queue_impl_t * impl,
+  rcl_readiness_record_t * records,
+  size_t records_capacity,
+  size_t * records_count)
+{
+  const size_t * ready_indices = NULL;
+  size_t ready_count = 0u;
+  rcl_ret_t ret = rcl_wait_set_get_ready_indices(
+    &impl->wait_set, RCL_WAIT_SET_TIMER, &ready_indices, &ready_count);
+  if (RCL_RET_OK != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  for (size_t i = 0u; i < ready_count && *records_count < records_capacity; ++i) {
+    rcl_readiness_record_t * record = &records[(*records_count)++];
+    record->entity_type = RCL_WAIT_SET_TIMER;
+    record->entity = impl->wait_set.timers[ready_indices[i]];
+    record->count = 1u;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_readiness_queue_wait(
+  rcl_readiness_queue_t * queue,
+  int64_t timeout,
+  rcl_readiness_record_t * records,
+  size_t records_capacity,
+  size_t * records_count)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(queue, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_readiness_queue_is_valid(queue)) {
+    RCL_SET_ERROR_MSG("readiness queue is invalid");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(records, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(records_count, RCL_RET_INVALID_ARGUMENT);
+  rcl_readiness_queue_impl_t * impl = queue->impl;
+  *records_count = 0u;
+
+  // Reset the signal before looking at the ring so that items pushed after
+  // this point trigger the guard condition again.
+  rcutils_atomic_store(&impl->signaled, false);
+  __readiness_queue_take(impl, records, records_capacity, records_count);
+  const bool has_records = *records_count > 0u;
+  if ((has_records || 0 == timeout) && 0u == impl->timer_count) {
+    return has_records ? RCL_RET_OK : RCL_RET_TIMEOUT;
+  }
+
+  // Timers are only looked at by the wait, it does not block if there are records already.
+  rcl_ret_t wait_ret = rcl_wait(&impl->wait_set, has_records ? 0 : timeout);
+  if (RCL_RET_OK != wait_ret && RCL_RET_TIMEOUT != wait_ret) {
+    return wait_ret;  // The rcl error state should already be set.
+  }
+  rcutils_atomic_store(&impl->signaled, false);
+  __readiness_queue_take(impl, records, records_capacity, records_count);
+  rcl_ret_t ret = __readiness_queue_take_timers(impl, records, records_capacity, records_count);
+  if (RCL_RET_OK != ret) {
+    return ret;
+  }
+  if (RCL_RET_TIMEOUT == wait_ret && 0u == *records_count) {
+    return RCL_RET_TIMEOUT;
+  }
+  return RCL_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
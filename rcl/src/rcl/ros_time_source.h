@@ -0,0 +1,47 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__ROS_TIME_SOURCE_H_
+#define RCL__ROS_TIME_SOURCE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "rcl/allocator.h"
+#include "rcl/time.h"
+#include "rcl/types.h"
+
+/// Create a shared ROS time source with the override disabled and no clocks bound.
+rcl_ret_t
+rcl_ros_time_source_init(rcl_ros_time_source_t ** source, const rcl_allocator_t * allocator);
+
+/// Unbind all clocks from the source, without time jumps, and destroy it.
+void
+rcl_ros_time_source_fini(rcl_ros_time_source_t * source);
+
+/// Get the override time of the source, whether or not the override is enabled.
+rcl_time_point_value_t
+rcl_ros_time_source_get_time(rcl_ros_time_source_t * source);
+
+/// Get the source a clock is bound to, `NULL` if it is not a bound #RCL_ROS_TIME clock.
+rcl_ros_time_source_t *
+rcl_clock_get_ros_time_source(const rcl_clock_t * clock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__ROS_TIME_SOURCE_H_
@@ -0,0 +1,229 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./serialized_message_pool.h"
+
+#include <stdbool.h>
+
+#include "rcl/error_handling.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rmw/serialized_message.h"
+
+typedef struct rcl_serialized_message_pool_buffer_s
+{
+  // first member, so that the buffer is found back from the message handed out
+  rcl_serialized_message_t message;
+  // class the buffer is accounted in while in use
+  size_t size_class;
+} rcl_serialized_message_pool_buffer_t;
+
+typedef struct rcl_serialized_message_pool_class_s
+{
+  // room for high_water_mark buffers, so releasing never allocates
+  rcl_serialized_message_pool_buffer_t ** free_buffers;
+  size_t free_count;
+  size_t in_use_count;
+  size_t high_water_mark;
+} rcl_serialized_message_pool_class_t;
+
+struct rcl_serialized_message_pool_s
+{
+  // spinlock guarding the classes, held for a few instructions only
+  atomic_bool lock;
+  rcl_serialized_message_pool_class_t classes[RCL_SERIALIZED_MESSAGE_POOL_CLASS_COUNT];
+  // decaying maximum of the recent message sizes
+  size_t size_hint;
+  rcl_allocator_t allocator;
+};
+
+static void
+__lock(rcl_serialized_message_pool_t * pool)
+{
+  while (rcutils_atomic_exchange_bool(&pool->lock, true)) {
+  }
+}
+
+static void
+__unlock(rcl_serialized_message_pool_t * pool)
+{
+  rcutils_atomic_store(&pool->lock, false);
+}
+
+// Smallest class holding `size` bytes, the largest class for larger sizes.
+static size_t
+__class_of_size(size_t size)
+{
+  size_t size_class = 0u;
+  while (
+    size_class + 1u < RCL_SERIALIZED_MESSAGE_POOL_CLASS_COUNT &&
+    (RCL_SERIALIZED_MESSAGE_POOL_MIN_SIZE << size_class) < size)
+  {
+    ++size_class;
+  }
+  return size_class;
+}
+
+// Largest class a buffer of `capacity` bytes can serve, the class count if it is kept in none.
+static size_t
+__class_of_capacity(size_t capacity)
+{
+  if (
+    capacity < RCL_SERIALIZED_MESSAGE_POOL_MIN_SIZE ||
+    capacity / 2u >= RCL_SERIALIZED_MESSAGE_POOL_MAX_SIZE)
+  {
+    return RCL_SERIALIZED_MESSAGE_POOL_CLASS_COUNT;
+  }
+  size_t size_class = RCL_SERIALIZED_MESSAGE_POOL_CLASS_COUNT - 1u;
+  while ((RCL_SERIALIZED_MESSAGE_POOL_MIN_SIZE << size_class) > capacity) {
+    --size_class;
+  }
+  return size_class;
+}
+
+static void
+__buffer_destroy(
+  rcl_serialized_message_pool_buffer_t * buffer,
+  const rcl_allocator_t * allocator)
+{
+  if (RCUTILS_RET_OK != rmw_serialized_message_fini(&buffer->message)) {
+    rcl_reset_error();  // Nothing to do about it, the buffer is freed anyway.
+  }
+  allocator->deallocate(buffer, allocator->state);
+}
+
+rcl_ret_t
+rcl_serialized_message_pool_init(
+  rcl_serialized_message_pool_t ** pool,
+  const rcl_allocator_t * allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(pool, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  rcl_serialized_message_pool_t * new_pool = (rcl_serialized_message_pool_t *)
+    allocator->zero_allocate(1u, sizeof(rcl_serialized_message_pool_t), allocator->state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(new_pool, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  atomic_init(&new_pool->lock, false);
+  new_pool->allocator = *allocator;
+  *pool = new_pool;
+  return RCL_RET_OK;
+}
+
+void
+rcl_serialized_message_pool_fini(rcl_serialized_message_pool_t * pool)
+{
+  if (NULL == pool) {
+    return;
+  }
+  rcl_allocator_t allocator = pool->allocator;
+  for (size_t i = 0u; i < RCL_SERIALIZED_MESSAGE_POOL_CLASS_COUNT; ++i) {
+    rcl_serialized_message_pool_class_t * size_class = &pool->classes[i];
+    for (size_t j = 0u; j < size_class->free_count; ++j) {
+      __buffer_destroy(size_class->free_buffers[j], &allocator);
+    }
+    allocator.deallocate(size_class->free_buffers, allocator.state);
+  }
+  allocator.deallocate(pool, allocator.state);
+}
+
+rcl_serialized_message_t *
+rcl_serialized_message_pool_acquire(rcl_serialized_message_pool_t * pool)
+{
+  const size_t class_index = __class_of_size(pool->size_hint);
+  rcl_serialized_message_pool_class_t * size_class = &pool->classes[class_index];
+  __lock(pool);
+  if (0u != size_class->free_count) {
+    rcl_serialized_message_pool_buffer_t * buffer =
+      size_class->free_buffers[--size_class->free_count];
+    ++size_class->in_use_count;
+    __unlock(pool);
+    buffer->message.buffer_length = 0u;
+    return &buffer->message;
+  }
+  if (size_class->in_use_count >= size_class->high_water_mark) {
+    // Raise the mark, with room to keep every buffer in use once released.
+    const size_t high_water_mark = size_class->in_use_count + 1u;
+    rcl_serialized_message_pool_buffer_t ** free_buffers =
+      (rcl_serialized_message_pool_buffer_t **)pool->allocator.reallocate(
+      size_class->free_buffers,
+      high_water_mark * sizeof(rcl_serialized_message_pool_buffer_t *),
+      pool->allocator.state);
+    if (NULL == free_buffers) {
+      __unlock(pool);
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      return NULL;
+    }
+    size_class->free_buffers = free_buffers;
+    size_class->high_water_mark = high_water_mark;
+  }
+  ++size_class->in_use_count;
+  __unlock(pool);
+
+  rcl_serialized_message_pool_buffer_t * buffer = (rcl_serialized_message_pool_buffer_t *)
+    pool->allocator.allocate(sizeof(rcl_serialized_message_pool_buffer_t), pool->allocator.state);
+  if (NULL != buffer) {
+    buffer->message = rmw_get_zero_initialized_serialized_message();
+    buffer->size_class = class_index;
+    if (
+      RCUTILS_RET_OK == rmw_serialized_message_init(
+        &buffer->message, RCL_SERIALIZED_MESSAGE_POOL_MIN_SIZE << class_index, &pool->allocator))
+    {
+      return &buffer->message;
+    }
+    pool->allocator.deallocate(buffer, pool->allocator.state);
+  }
+  __lock(pool);
+  --size_class->in_use_count;
+  __unlock(pool);
+  RCL_SET_ERROR_MSG("allocating memory failed");
+  return NULL;
+}
+
+void
+rcl_serialized_message_pool_release(
+  rcl_serialized_message_pool_t * pool,
+  rcl_serialized_message_t * serialized_message)
+{
+  rcl_serialized_message_pool_buffer_t * buffer =
+    (rcl_serialized_message_pool_buffer_t *)serialized_message;
+  const size_t class_index = __class_of_capacity(serialized_message->buffer_capacity);
+  __lock(pool);
+  --pool->classes[buffer->size_class].in_use_count;
+  if (class_index < RCL_SERIALIZED_MESSAGE_POOL_CLASS_COUNT) {
+    rcl_serialized_message_pool_class_t * size_class = &pool->classes[class_index];
+    if (size_class->free_count < size_class->high_water_mark) {
+      size_class->free_buffers[size_class->free_count++] = buffer;
+      buffer->size_class = class_index;
+      __unlock(pool);
+      return;
+    }
+  }
+  __unlock(pool);
+  __buffer_destroy(buffer, &pool->allocator);
+}
+
+void
+rcl_serialized_message_pool_note_size(rcl_serialized_message_pool_t * pool, size_t size)
+{
+  // Follow larger messages right away, and smaller ones over a few takes.
+  const size_t decayed = pool->size_hint - pool->size_hint / 8u;
+  pool->size_hint = size > decayed ? size : decayed;
+}
+
+#ifdef __cplusplus
+}
+#endif
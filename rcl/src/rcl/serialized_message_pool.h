@@ -0,0 +1,75 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__SERIALIZED_MESSAGE_POOL_H_
+#define RCL__SERIALIZED_MESSAGE_POOL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "rcl/allocator.h"
+#include "rcl/types.h"
+
+// Buffers of serialized messages, recycled instead of being reallocated for every take.
+//
+// Buffers are sorted in size classes, powers of two from
+// RCL_SERIALIZED_MESSAGE_POOL_MIN_SIZE up to RCL_SERIALIZED_MESSAGE_POOL_MAX_SIZE.
+// A new buffer gets the class fitting the recent message sizes, and once
+// released it joins the class fitting its capacity, which the middleware may
+// have grown.
+// Each class keeps at most as many free buffers as it ever had in use at once,
+// its high-water mark, the others and the larger buffers are freed.
+typedef struct rcl_serialized_message_pool_s rcl_serialized_message_pool_t;
+
+#define RCL_SERIALIZED_MESSAGE_POOL_MIN_SIZE ((size_t)256u)
+#define RCL_SERIALIZED_MESSAGE_POOL_CLASS_COUNT 16u
+#define RCL_SERIALIZED_MESSAGE_POOL_MAX_SIZE \
+  (RCL_SERIALIZED_MESSAGE_POOL_MIN_SIZE << (RCL_SERIALIZED_MESSAGE_POOL_CLASS_COUNT - 1u))
+
+/// Create an empty pool, whose buffers use the given allocator.
+rcl_ret_t
+rcl_serialized_message_pool_init(
+  rcl_serialized_message_pool_t ** pool,
+  const rcl_allocator_t * allocator);
+
+/// Destroy the pool and its free buffers, all buffers must have been released.
+void
+rcl_serialized_message_pool_fini(rcl_serialized_message_pool_t * pool);
+
+/// Get an empty buffer, `NULL` with the error set on failure.
+rcl_serialized_message_t *
+rcl_serialized_message_pool_acquire(rcl_serialized_message_pool_t * pool);
+
+/// Give back a buffer obtained from rcl_serialized_message_pool_acquire(), from any thread.
+void
+rcl_serialized_message_pool_release(
+  rcl_serialized_message_pool_t * pool,
+  rcl_serialized_message_t * serialized_message);
+
+/// Account for the size of a message, to size the next buffers.
+/**
+ * Must not be called concurrently with rcl_serialized_message_pool_acquire().
+ */
+void
+rcl_serialized_message_pool_note_size(rcl_serialized_message_pool_t * pool, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__SERIALIZED_MESSAGE_POOL_H_
@@ -32,7 +32,13 @@ extern "C"
 #include "tracetools/tracetools.h"
 
 #include "./common.h"
+#include "./content_filter.h"
+#include "./context_impl.h"
+#include "./intra_context.h"
+#include "./loan_pool.h"
+#include "./serialized_message_pool.h"
 #include "./subscription_impl.h"
+#include "./traffic_counters.h"
 
 
 rcl_subscription_t
@@ -118,6 +124,64 @@ rcl_subscription_init(
   }
   subscription->impl->actual_qos.avoid_ros_namespace_conventions =
     options->qos.avoid_ros_namespace_conventions;
+#ifndef RCL_DISABLE_TRAFFIC_COUNTERS
+  // traffic counters
+  subscription->impl->traffic_counters = rcl_traffic_counters_create(allocator);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    subscription->impl->traffic_counters, "allocating memory failed",
+    fail_ret = RCL_RET_BAD_ALLOC; goto fail);
+#endif
+  subscription->impl->type_support = type_support;
+  // content filter evaluated by rcl, where the middleware does not filter
+  const rmw_subscription_content_filter_options_t * content_filter_options =
+    options->rmw_subscription_options.content_filter_options;
+  if (
+    NULL != content_filter_options &&
+    (options->intra_context || !subscription->impl->rmw_handle->is_cft_enabled))
+  {
+    ret = rcl_content_filter_init(
+      &subscription->impl->content_filter, type_support,
+      content_filter_options->filter_expression,
+      content_filter_options->expression_parameters.size,
+      (const char * const *)content_filter_options->expression_parameters.data, allocator);
+    if (RCL_RET_BAD_ALLOC == ret) {
+      fail_ret = ret;  // error already set
+      goto fail;
+    }
+    if (RCL_RET_OK != ret) {
+      // Like without rcl filtering, delivery within the context is given up and
+      // the middleware filters or the messages are left to the application.
+      RCUTILS_LOG_WARN_NAMED(
+        ROS_PACKAGE_NAME, "content filter of '%s' not evaluated by rcl: %s",
+        remapped_topic_name, rcl_get_error_string().str);
+      rcl_reset_error();
+    }
+  }
+  // intra context delivery, which bypasses the content filter of the middleware
+  if (
+    options->intra_context &&
+    (NULL == content_filter_options || NULL != subscription->impl->content_filter))
+  {
+    ret = rcl_intra_context_add_subscription(
+      node->context->impl->intra_context, node->context, subscription->impl->rmw_handle,
+      type_support, &subscription->impl->actual_qos, subscription->impl->content_filter,
+      allocator, &subscription->impl->intra_context);
+    if (RCL_RET_OK != ret) {
+      fail_ret = ret;  // error already set
+      goto fail;
+    }
+  }
+  // loans the middleware cannot provide, receiving within the context already loans
+  if (
+    NULL == subscription->impl->intra_context &&
+    !subscription->impl->rmw_handle->can_loan_messages)
+  {
+    ret = rcl_loan_pool_init(&subscription->impl->loan_pool, type_support, allocator);
+    if (RCL_RET_OK != ret) {
+      fail_ret = ret;  // error already set
+      goto fail;
+    }
+  }
   // options
   subscription->impl->options = *options;
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Subscription initialized");
@@ -132,6 +196,7 @@ rcl_subscription_init(
   goto cleanup;
 fail:
   if (subscription->impl) {
+    rcl_intra_context_remove_subscription(subscription->impl->intra_context);
     if (subscription->impl->rmw_handle) {
       rmw_ret_t rmw_fail_ret = rmw_destroy_subscription(
         rcl_node_get_rmw_handle(node), subscription->impl->rmw_handle);
@@ -147,6 +212,9 @@ fail:
       RCUTILS_SAFE_FWRITE_TO_STDERR("\n");
     }
 
+    rcl_loan_pool_fini(subscription->impl->loan_pool);
+    rcl_content_filter_fini(subscription->impl->content_filter);
+    rcl_traffic_counters_destroy(subscription->impl->traffic_counters, allocator);
     allocator->deallocate(subscription->impl, allocator->state);
     subscription->impl = NULL;
   }
@@ -177,6 +245,8 @@ rcl_subscription_fini(rcl_subscription_t * subscription, rcl_node_t * node)
     if (!rmw_node) {
       return RCL_RET_INVALID_ARGUMENT;
     }
+    // The endpoint refers to the topic name of the rmw handle.
+    rcl_intra_context_remove_subscription(subscription->impl->intra_context);
     rmw_ret_t ret =
       rmw_destroy_subscription(rmw_node, subscription->impl->rmw_handle);
     if (ret != RMW_RET_OK) {
@@ -190,6 +260,10 @@ rcl_subscription_fini(rcl_subscription_t * subscription, rcl_node_t * node)
       result = RCL_RET_ERROR;
     }
 
+    rcl_loan_pool_fini(subscription->impl->loan_pool);
+    rcl_serialized_message_pool_fini(subscription->impl->serialized_message_pool);
+    rcl_content_filter_fini(subscription->impl->content_filter);
+    rcl_traffic_counters_destroy(subscription->impl->traffic_counters, &allocator);
     allocator.deallocate(subscription->impl, allocator.state);
     subscription->impl = NULL;
   }
@@ -206,6 +280,7 @@ rcl_subscription_get_default_options()
   default_options.qos = rmw_qos_profile_default;
   default_options.allocator = rcl_get_default_allocator();
   default_options.rmw_subscription_options = rmw_get_default_subscription_options();
+  default_options.intra_context = false;
   return default_options;
 }
 
@@ -432,7 +507,22 @@ rcl_subscription_is_cft_enabled(const rcl_subscription_t * subscription)
   if (!rcl_subscription_is_valid(subscription)) {
     return false;
   }
-  return subscription->impl->rmw_handle->is_cft_enabled;
+  return
+    subscription->impl->rmw_handle->is_cft_enabled ||
+    NULL != subscription->impl->content_filter;
+}
+
+static rcl_ret_t
+__subscription_compile_content_filter(
+  const rcl_subscription_t * subscription,
+  const rmw_subscription_content_filter_options_t * options,
+  rcl_content_filter_t ** filter)
+{
+  return rcl_content_filter_init(
+    filter, subscription->impl->type_support, options->filter_expression,
+    options->expression_parameters.size,
+    (const char * const *)options->expression_parameters.data,
+    &subscription->impl->options.allocator);
 }
 
 rcl_ret_t
@@ -449,18 +539,48 @@ rcl_subscription_set_content_filter(
   }
 
   RCL_CHECK_ARGUMENT_FOR_NULL(options, RCL_RET_INVALID_ARGUMENT);
+  const rmw_subscription_content_filter_options_t * content_filter_options =
+    &options->rmw_subscription_content_filter_options;
+  rcl_intra_context_subscription_t * intra_context = subscription->impl->intra_context;
+  rcl_content_filter_t * filter = NULL;
+  rcl_ret_t rcl_ret;
+  if (NULL != intra_context) {
+    // Messages delivered within the context are filtered by rcl in any case.
+    rcl_ret = __subscription_compile_content_filter(subscription, content_filter_options, &filter);
+    if (RCL_RET_OK != rcl_ret) {
+      return rcl_ret;  // error already set
+    }
+  }
   rmw_ret_t ret = rmw_subscription_set_content_filter(
     subscription->impl->rmw_handle,
-    &options->rmw_subscription_content_filter_options);
-
-  if (ret != RMW_RET_OK) {
+    content_filter_options);
+
+  if (RMW_RET_UNSUPPORTED == ret) {
+    // Filter what rcl takes from the middleware instead.
+    rmw_reset_error();
+    if (NULL == intra_context) {
+      rcl_ret =
+        __subscription_compile_content_filter(subscription, content_filter_options, &filter);
+      if (RCL_RET_OK != rcl_ret) {
+        return rcl_ret;  // error already set
+      }
+    }
+    if (NULL == filter && '\0' != content_filter_options->filter_expression[0]) {
+      RCL_SET_ERROR_MSG("content filters need the middleware or a C introspection of the type");
+      return RCL_RET_UNSUPPORTED;
+    }
+  } else if (ret != RMW_RET_OK) {
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    rcl_content_filter_fini(filter);
     return rcl_convert_rmw_ret_to_rcl_ret(ret);
   }
+  if (NULL != intra_context) {
+    rcl_intra_context_subscription_set_content_filter(intra_context, filter);
+  }
+  rcl_content_filter_fini(subscription->impl->content_filter);
+  subscription->impl->content_filter = filter;
 
   // copy options into subscription_options
-  const rmw_subscription_content_filter_options_t * content_filter_options =
-    &options->rmw_subscription_content_filter_options;
   return rcl_subscription_options_set_content_filter_options(
     content_filter_options->filter_expression,
     content_filter_options->expression_parameters.size,
@@ -489,10 +609,63 @@ rcl_subscription_get_content_filter(
     subscription->impl->rmw_handle,
     allocator,
     &options->rmw_subscription_content_filter_options);
+  if (RMW_RET_UNSUPPORTED == rmw_ret && NULL != subscription->impl->content_filter) {
+    // The filter rcl evaluates is the one of the options.
+    rmw_reset_error();
+    rmw_ret = rmw_subscription_content_filter_options_copy(
+      subscription->impl->options.rmw_subscription_options.content_filter_options,
+      allocator,
+      &options->rmw_subscription_content_filter_options);
+  }
 
   return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
 }
 
+// Filter rcl evaluates on the messages of the middleware, NULL if the middleware filters.
+static const rcl_content_filter_t *
+__subscription_middleware_content_filter(const rcl_subscription_t * subscription)
+{
+  return subscription->impl->rmw_handle->is_cft_enabled ?
+         NULL : subscription->impl->content_filter;
+}
+
+// Whether a message taken from the middleware is skipped, because it was
+// delivered within the context too or does not match the content filter.
+static bool
+__subscription_skips(
+  const rcl_subscription_t * subscription,
+  const rcl_content_filter_t * content_filter,
+  const void * ros_message,
+  const rmw_message_info_t * message_info)
+{
+  rcl_intra_context_subscription_t * intra_context = subscription->impl->intra_context;
+  return
+    (NULL != intra_context &&
+    rcl_intra_context_subscription_is_duplicate(intra_context, message_info)) ||
+    (NULL != content_filter && !rcl_content_filter_evaluate(content_filter, ros_message));
+}
+
+// Take from the middleware, skipping the messages __subscription_skips().
+static rmw_ret_t
+__subscription_take_from_middleware(
+  const rcl_subscription_t * subscription,
+  void * ros_message,
+  bool * taken,
+  rmw_message_info_t * message_info,
+  rmw_subscription_allocation_t * allocation)
+{
+  const rcl_content_filter_t * content_filter =
+    __subscription_middleware_content_filter(subscription);
+  rmw_ret_t ret;
+  do {
+    ret = rmw_take_with_info(
+      subscription->impl->rmw_handle, ros_message, taken, message_info, allocation);
+  } while (
+    RMW_RET_OK == ret && *taken &&
+    __subscription_skips(subscription, content_filter, ros_message, message_info));
+  return ret;
+}
+
 rcl_ret_t
 rcl_take(
   const rcl_subscription_t * subscription,
@@ -511,20 +684,35 @@ rcl_take(
   rmw_message_info_t dummy_message_info;
   rmw_message_info_t * message_info_local = message_info ? message_info : &dummy_message_info;
   *message_info_local = rmw_get_zero_initialized_message_info();
-  // Call rmw_take_with_info.
   bool taken = false;
-  rmw_ret_t ret = rmw_take_with_info(
-    subscription->impl->rmw_handle, ros_message, &taken, message_info_local, allocation);
+  rcl_intra_context_subscription_t * intra_context = subscription->impl->intra_context;
+  if (NULL != intra_context) {
+    rcl_ret_t intra_ret = rcl_intra_context_subscription_take(
+      intra_context, ros_message, message_info_local, &taken);
+    if (RCL_RET_OK != intra_ret) {
+      RCL_TRAFFIC_COUNT_ERROR(subscription->impl);
+      return intra_ret;  // error already set
+    }
+  }
+  // Call rmw_take_with_info.
+  rmw_ret_t ret = RMW_RET_OK;
+  if (!taken) {
+    ret = __subscription_take_from_middleware(
+      subscription, ros_message, &taken, message_info_local, allocation);
+  }
   if (ret != RMW_RET_OK) {
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    RCL_TRAFFIC_COUNT_ERROR(subscription->impl);
     return rcl_convert_rmw_ret_to_rcl_ret(ret);
   }
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Subscription take succeeded: %s", taken ? "true" : "false");
   TRACEPOINT(rcl_take, (const void *)ros_message);
   if (!taken) {
+    RCL_TRAFFIC_COUNT_TAKE_FAILED(subscription->impl);
     return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
   }
+  RCL_TRAFFIC_COUNT_MESSAGES(subscription->impl, 1u, 0u);
   return RCL_RET_OK;
 }
 
@@ -559,21 +747,123 @@ rcl_take_sequence(
   message_info_sequence->size = 0u;
 
   size_t taken = 0u;
-  rmw_ret_t ret = rmw_take_sequence(
-    subscription->impl->rmw_handle, count, message_sequence, message_info_sequence, &taken,
-    allocation);
-  if (ret != RMW_RET_OK) {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    return rcl_convert_rmw_ret_to_rcl_ret(ret);
+  rcl_ret_t ret = __subscription_take_sequence(
+    subscription, count, message_sequence, message_info_sequence, &taken, allocation);
+  if (ret != RCL_RET_OK) {
+    RCL_TRAFFIC_COUNT_ERROR(subscription->impl);
+    return ret;  // error already set
   }
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Subscription took %zu messages", taken);
   if (0u == taken) {
+    RCL_TRAFFIC_COUNT_TAKE_FAILED(subscription->impl);
     return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
   }
+  RCL_TRAFFIC_COUNT_MESSAGES(subscription->impl, taken, 0u);
   return RCL_RET_OK;
 }
 
+// Keep the first `count` messages of the sequences which are not
+// __subscription_skips(), and return how many they are.
+static size_t
+__subscription_drop_skipped(
+  const rcl_subscription_t * subscription,
+  const rcl_content_filter_t * content_filter,
+  rmw_message_sequence_t * message_sequence,
+  rmw_message_info_sequence_t * message_info_sequence,
+  size_t count)
+{
+  size_t kept = 0u;
+  for (size_t i = 0u; i < count; ++i) {
+    if (
+      __subscription_skips(
+        subscription, content_filter, message_sequence->data[i],
+        &message_info_sequence->data[i]))
+    {
+      continue;
+    }
+    if (kept != i) {
+      // Swap rather than copy the messages, the caller owns all of them either way.
+      void * message = message_sequence->data[kept];
+      message_sequence->data[kept] = message_sequence->data[i];
+      message_sequence->data[i] = message;
+      message_info_sequence->data[kept] = message_info_sequence->data[i];
+    }
+    ++kept;
+  }
+  return kept;
+}
+
+rcl_ret_t
+__subscription_take_sequence(
+  const rcl_subscription_t * subscription,
+  size_t count,
+  rmw_message_sequence_t * message_sequence,
+  rmw_message_info_sequence_t * message_info_sequence,
+  size_t * taken,
+  rmw_subscription_allocation_t * allocation)
+{
+  rcl_intra_context_subscription_t * intra_context = subscription->impl->intra_context;
+  const rcl_content_filter_t * content_filter =
+    __subscription_middleware_content_filter(subscription);
+  rmw_ret_t rmw_ret;
+  if (NULL == intra_context) {
+    rmw_ret = rmw_take_sequence(
+      subscription->impl->rmw_handle, count, message_sequence, message_info_sequence, taken,
+      allocation);
+    if (RMW_RET_OK != rmw_ret) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+    }
+    if (NULL != content_filter) {
+      *taken = __subscription_drop_skipped(
+        subscription, content_filter, message_sequence, message_info_sequence, *taken);
+      message_sequence->size = *taken;
+      message_info_sequence->size = *taken;
+    }
+    return RCL_RET_OK;
+  }
+  rcl_ret_t ret = RCL_RET_OK;
+  size_t local_count = 0u;
+  for (; local_count < count; ++local_count) {
+    bool local_taken = false;
+    ret = rcl_intra_context_subscription_take(
+      intra_context, message_sequence->data[local_count],
+      &message_info_sequence->data[local_count], &local_taken);
+    if (RCL_RET_OK != ret || !local_taken) {
+      break;
+    }
+  }
+  size_t remote_count = 0u;
+  if (RCL_RET_OK == ret && local_count < count) {
+    // Let the middleware fill the rest of the sequences.
+    rmw_message_sequence_t remaining = *message_sequence;
+    remaining.data += local_count;
+    remaining.size = 0u;
+    remaining.capacity -= local_count;
+    rmw_message_info_sequence_t remaining_info = *message_info_sequence;
+    remaining_info.data += local_count;
+    remaining_info.size = 0u;
+    remaining_info.capacity -= local_count;
+    rmw_ret = rmw_take_sequence(
+      subscription->impl->rmw_handle, count - local_count, &remaining, &remaining_info,
+      &remote_count, allocation);
+    if (RMW_RET_OK != rmw_ret) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      ret = rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+      remote_count = 0u;
+    } else {
+      remote_count = __subscription_drop_skipped(
+        subscription, content_filter, &remaining, &remaining_info, remote_count);
+    }
+  }
+  // Messages taken before an error stay in the sequences.
+  *taken = local_count + remote_count;
+  message_sequence->size = *taken;
+  message_info_sequence->size = *taken;
+  return ret;
+}
+
 rcl_ret_t
 rcl_take_serialized_message(
   const rcl_subscription_t * subscription,
@@ -591,22 +881,192 @@ rcl_take_serialized_message(
   rmw_message_info_t dummy_message_info;
   rmw_message_info_t * message_info_local = message_info ? message_info : &dummy_message_info;
   *message_info_local = rmw_get_zero_initialized_message_info();
-  // Call rmw_take_with_info.
   bool taken = false;
-  rmw_ret_t ret = rmw_take_serialized_message_with_info(
-    subscription->impl->rmw_handle, serialized_message, &taken, message_info_local, allocation);
+  rcl_intra_context_subscription_t * intra_context = subscription->impl->intra_context;
+  if (NULL != intra_context) {
+    rcl_ret_t intra_ret = rcl_intra_context_subscription_take_serialized(
+      intra_context, serialized_message, message_info_local, &taken);
+    if (RCL_RET_OK != intra_ret) {
+      RCL_TRAFFIC_COUNT_ERROR(subscription->impl);
+      return intra_ret;  // error already set
+    }
+  }
+  // Call rmw_take_with_info, skipping the copies of messages delivered within the context.
+  rmw_ret_t ret = RMW_RET_OK;
+  while (!taken) {
+    ret = rmw_take_serialized_message_with_info(
+      subscription->impl->rmw_handle, serialized_message, &taken, message_info_local, allocation);
+    if (
+      RMW_RET_OK != ret || !taken || NULL == intra_context ||
+      !rcl_intra_context_subscription_is_duplicate(intra_context, message_info_local))
+    {
+      break;
+    }
+    taken = false;
+  }
   if (ret != RMW_RET_OK) {
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    RCL_TRAFFIC_COUNT_ERROR(subscription->impl);
     return rcl_convert_rmw_ret_to_rcl_ret(ret);
   }
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Subscription serialized take succeeded: %s", taken ? "true" : "false");
   if (!taken) {
+    RCL_TRAFFIC_COUNT_TAKE_FAILED(subscription->impl);
     return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
   }
+  RCL_TRAFFIC_COUNT_MESSAGES(subscription->impl, 1u, serialized_message->buffer_length);
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_take_pooled_serialized_message(
+  const rcl_subscription_t * subscription,
+  rcl_serialized_message_t ** serialized_message,
+  rmw_message_info_t * message_info,
+  rmw_subscription_allocation_t * allocation)
+{
+  if (!rcl_subscription_is_valid(subscription)) {
+    return RCL_RET_SUBSCRIPTION_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(serialized_message, RCL_RET_INVALID_ARGUMENT);
+  if (*serialized_message) {
+    RCL_SET_ERROR_MSG("serialized message is already initialized");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  // Created on first use, most subscriptions never take serialized messages.
+  if (NULL == subscription->impl->serialized_message_pool) {
+    rcl_ret_t ret = rcl_serialized_message_pool_init(
+      &subscription->impl->serialized_message_pool, &subscription->impl->options.allocator);
+    if (RCL_RET_OK != ret) {
+      return ret;  // error already set
+    }
+  }
+  rcl_serialized_message_pool_t * pool = subscription->impl->serialized_message_pool;
+  rcl_serialized_message_t * buffer = rcl_serialized_message_pool_acquire(pool);
+  if (NULL == buffer) {
+    return RCL_RET_BAD_ALLOC;  // error already set
+  }
+  rcl_ret_t ret = rcl_take_serialized_message(subscription, buffer, message_info, allocation);
+  if (RCL_RET_OK != ret) {
+    rcl_serialized_message_pool_release(pool, buffer);
+    return ret;  // error already set
+  }
+  rcl_serialized_message_pool_note_size(pool, buffer->buffer_length);
+  *serialized_message = buffer;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_return_pooled_serialized_message(
+  const rcl_subscription_t * subscription,
+  rcl_serialized_message_t * serialized_message)
+{
+  if (!rcl_subscription_is_valid(subscription)) {
+    return RCL_RET_SUBSCRIPTION_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(serialized_message, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    subscription->impl->serialized_message_pool,
+    "no serialized message was taken from the subscription pool",
+    return RCL_RET_INVALID_ARGUMENT);
+  rcl_serialized_message_pool_release(
+    subscription->impl->serialized_message_pool, serialized_message);
+  return RCL_RET_OK;
+}
+
+// Loans of subscriptions receiving within their context are all owned by rcl:
+// either a message delivered within the context, or a new one taken into from the middleware.
+static rcl_ret_t
+__subscription_take_loaned_within_context(
+  const rcl_subscription_t * subscription,
+  void ** loaned_message,
+  bool * taken,
+  rmw_message_info_t * message_info,
+  rmw_subscription_allocation_t * allocation)
+{
+  rcl_intra_context_subscription_t * intra_context = subscription->impl->intra_context;
+  *loaned_message = rcl_intra_context_subscription_pop(intra_context, message_info);
+  if (NULL != *loaned_message) {
+    *taken = true;
+    return RCL_RET_OK;
+  }
+  void * message = rcl_intra_context_subscription_borrow(intra_context);
+  if (NULL == message) {
+    return RCL_RET_BAD_ALLOC;  // error already set
+  }
+  rmw_ret_t ret = __subscription_take_from_middleware(
+    subscription, message, taken, message_info, allocation);
+  if (RMW_RET_OK != ret || !*taken) {
+    rcl_intra_context_message_release(message);
+    if (RMW_RET_OK != ret) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      return rcl_convert_rmw_ret_to_rcl_ret(ret);
+    }
+    return RCL_RET_OK;
+  }
+  *loaned_message = message;
+  return RCL_RET_OK;
+}
+
+// Take a copy from the middleware into a message of the loan pool.
+static rcl_ret_t
+__subscription_take_loaned_from_pool(
+  const rcl_subscription_t * subscription,
+  void ** loaned_message,
+  bool * taken,
+  rmw_message_info_t * message_info,
+  rmw_subscription_allocation_t * allocation)
+{
+  rcl_loan_pool_t * loan_pool = subscription->impl->loan_pool;
+  void * message = rcl_loan_pool_borrow(loan_pool);
+  if (NULL == message) {
+    return RCL_RET_BAD_ALLOC;  // error already set
+  }
+  rmw_ret_t ret = __subscription_take_from_middleware(
+    subscription, message, taken, message_info, allocation);
+  if (RMW_RET_OK != ret || !*taken) {
+    rcl_loan_pool_return(loan_pool, message);
+    if (RMW_RET_OK != ret) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      return rcl_convert_rmw_ret_to_rcl_ret(ret);
+    }
+    return RCL_RET_OK;
+  }
+  *loaned_message = message;
+  return RCL_RET_OK;
+}
+
+// Take a loan of the middleware, handing back the ones the content filter drops.
+static rmw_ret_t
+__subscription_take_loaned_from_middleware(
+  const rcl_subscription_t * subscription,
+  void ** loaned_message,
+  bool * taken,
+  rmw_message_info_t * message_info,
+  rmw_subscription_allocation_t * allocation)
+{
+  const rcl_content_filter_t * content_filter =
+    __subscription_middleware_content_filter(subscription);
+  rmw_subscription_t * rmw_handle = subscription->impl->rmw_handle;
+  for (;;) {
+    rmw_ret_t ret = rmw_take_loaned_message_with_info(
+      rmw_handle, loaned_message, taken, message_info, allocation);
+    if (
+      RMW_RET_OK != ret || !*taken || NULL == content_filter ||
+      rcl_content_filter_evaluate(content_filter, *loaned_message))
+    {
+      return ret;
+    }
+    ret = rmw_return_loaned_message_from_subscription(rmw_handle, *loaned_message);
+    *loaned_message = NULL;
+    *taken = false;
+    if (RMW_RET_OK != ret) {
+      return ret;
+    }
+  }
+}
+
 rcl_ret_t
 rcl_take_loaned_message(
   const rcl_subscription_t * subscription,
@@ -627,19 +1087,34 @@ rcl_take_loaned_message(
   rmw_message_info_t dummy_message_info;
   rmw_message_info_t * message_info_local = message_info ? message_info : &dummy_message_info;
   *message_info_local = rmw_get_zero_initialized_message_info();
-  // Call rmw_take_with_info.
   bool taken = false;
-  rmw_ret_t ret = rmw_take_loaned_message_with_info(
-    subscription->impl->rmw_handle, loaned_message, &taken, message_info_local, allocation);
-  if (ret != RMW_RET_OK) {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    return rcl_convert_rmw_ret_to_rcl_ret(ret);
+  rcl_ret_t ret = RCL_RET_OK;
+  if (NULL != subscription->impl->intra_context) {
+    ret = __subscription_take_loaned_within_context(
+      subscription, loaned_message, &taken, message_info_local, allocation);
+  } else if (NULL != subscription->impl->loan_pool) {
+    ret = __subscription_take_loaned_from_pool(
+      subscription, loaned_message, &taken, message_info_local, allocation);
+  } else {
+    rmw_ret_t rmw_ret = __subscription_take_loaned_from_middleware(
+      subscription, loaned_message, &taken, message_info_local, allocation);
+    if (rmw_ret != RMW_RET_OK) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      ret = rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+    }
+  }
+  if (RCL_RET_OK != ret) {
+    RCL_TRAFFIC_COUNT_ERROR(subscription->impl);
+    return ret;  // error already set
   }
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Subscription loaned take succeeded: %s", taken ? "true" : "false");
   if (!taken) {
+    RCL_TRAFFIC_COUNT_TAKE_FAILED(subscription->impl);
     return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
   }
+  RCL_TRAFFIC_COUNT_LOAN(subscription->impl);
+  RCL_TRAFFIC_COUNT_MESSAGES(subscription->impl, 1u, 0u);
   return RCL_RET_OK;
 }
 
@@ -653,6 +1128,14 @@ rcl_return_loaned_message_from_subscription(
     return RCL_RET_SUBSCRIPTION_INVALID;  // error already set
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(loaned_message, RCL_RET_INVALID_ARGUMENT);
+  if (NULL != subscription->impl->intra_context) {
+    rcl_intra_context_message_release(loaned_message);
+    return RCL_RET_OK;
+  }
+  if (NULL != subscription->impl->loan_pool) {
+    rcl_loan_pool_return(subscription->impl->loan_pool, loaned_message);
+    return RCL_RET_OK;
+  }
   return rcl_convert_rmw_ret_to_rcl_ret(
     rmw_return_loaned_message_from_subscription(
       subscription->impl->rmw_handle, loaned_message));
@@ -742,9 +1225,49 @@ rcl_subscription_can_loan_messages(const rcl_subscription_t * subscription)
     return false;
   }
 
+  if (NULL != subscription->impl->intra_context || NULL != subscription->impl->loan_pool) {
+    return true;
+  }
   return subscription->impl->rmw_handle->can_loan_messages;
 }
 
+rcl_ret_t
+rcl_subscription_get_traffic_counters(
+  const rcl_subscription_t * subscription,
+  rcl_subscription_traffic_counters_t * counters)
+{
+  if (!rcl_subscription_is_valid(subscription)) {
+    return RCL_RET_SUBSCRIPTION_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(counters, RCL_RET_INVALID_ARGUMENT);
+#ifdef RCL_DISABLE_TRAFFIC_COUNTERS
+  RCL_SET_ERROR_MSG("rcl was built without traffic counters");
+  return RCL_RET_UNSUPPORTED;
+#else
+  rcl_traffic_counters_t * traffic_counters = subscription->impl->traffic_counters;
+  counters->message_count = rcl_traffic_counters_load(&traffic_counters->message_count);
+  counters->serialized_byte_count = rcl_traffic_counters_load(&traffic_counters->byte_count);
+  counters->loaned_message_count = rcl_traffic_counters_load(&traffic_counters->loan_count);
+  counters->take_failed_count =
+    rcl_traffic_counters_load(&traffic_counters->take_failed_count);
+  counters->error_count = rcl_traffic_counters_load(&traffic_counters->error_count);
+  counters->last_take_time = rcl_traffic_counters_load_last_activity_time(traffic_counters);
+  return RCL_RET_OK;
+#endif
+}
+
+const rcl_guard_condition_t *
+rcl_subscription_get_intra_context_guard_condition(const rcl_subscription_t * subscription)
+{
+  if (!rcl_subscription_is_valid(subscription)) {
+    return NULL;  // error already set
+  }
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    subscription->impl->intra_context, "subscription does not receive within its context",
+    return NULL);
+  return rcl_intra_context_subscription_get_guard_condition(subscription->impl->intra_context);
+}
+
 rcl_ret_t
 rcl_subscription_set_on_new_message_callback(
   const rcl_subscription_t * subscription,
@@ -19,11 +19,45 @@
 
 #include "rcl/subscription.h"
 
+struct rcl_content_filter_s;
+struct rcl_intra_context_subscription_s;
+struct rcl_loan_pool_s;
+struct rcl_serialized_message_pool_s;
+struct rcl_traffic_counters_s;
+
 struct rcl_subscription_impl_s
 {
   rcl_subscription_options_t options;
   rmw_qos_profile_t actual_qos;
   rmw_subscription_t * rmw_handle;
+  const rosidl_message_type_support_t * type_support;
+  // Behind a pointer to keep atomics out of this header, NULL if compiled out.
+  struct rcl_traffic_counters_s * traffic_counters;
+  // NULL unless receiving within the context, see intra_context.h.
+  struct rcl_intra_context_subscription_s * intra_context;
+  // NULL unless rcl loans the messages the middleware cannot, see loan_pool.h.
+  struct rcl_loan_pool_s * loan_pool;
+  // NULL until a serialized message is taken into a buffer of the subscription.
+  struct rcl_serialized_message_pool_s * serialized_message_pool;
+  // NULL unless rcl evaluates the content filter, see content_filter.h.
+  struct rcl_content_filter_s * content_filter;
 };
 
+/// Take up to `count` messages, like rmw_take_sequence() but within the context first.
+/**
+ * The sequences are filled with the messages delivered within the context,
+ * then with the ones of the middleware which were not also delivered so and
+ * match the content filter rcl evaluates.
+ * Traffic is not counted, that is left to the caller.
+ */
+RCL_LOCAL
+rcl_ret_t
+__subscription_take_sequence(
+  const rcl_subscription_t * subscription,
+  size_t count,
+  rmw_message_sequence_t * message_sequence,
+  rmw_message_info_sequence_t * message_info_sequence,
+  size_t * taken,
+  rmw_subscription_allocation_t * allocation);
+
 #endif  // RCL__SUBSCRIPTION_IMPL_H_
@@ -18,6 +18,9 @@
 #include <stdlib.h>
 
 #include "./common.h"
+#include "./jump_callback_registry.h"
+#include "./ros_time_source.h"
+#include "./tsc_clock.h"
 #include "rcl/allocator.h"
 #include "rcl/error_handling.h"
 #include "rcutils/macros.h"
@@ -29,8 +32,39 @@ typedef struct rcl_ros_clock_storage_s
 {
   atomic_uint_least64_t current_time;
   bool active;
+  // Shared source whose storage is used instead of this one while bound.
+  atomic_uintptr_t source;
 } rcl_ros_clock_storage_t;
 
+struct rcl_ros_time_source_s
+{
+  // Time and override state of all bound clocks, never bound itself.
+  rcl_ros_clock_storage_t storage;
+  // Clocks bound to the source, in no particular order.
+  rcl_clock_t ** clocks;
+  size_t clock_count;
+  size_t clock_capacity;
+  rcl_allocator_t allocator;
+};
+
+// Get the storage holding the time of a ROS time clock, the one of its source while bound.
+static rcl_ros_clock_storage_t *
+rcl_ros_clock_get_storage(rcl_ros_clock_storage_t * storage)
+{
+  rcl_ros_time_source_t * source =
+    (rcl_ros_time_source_t *)rcutils_atomic_load_uintptr_t(&storage->source);
+  return NULL != source ? &source->storage : storage;
+}
+
+static void
+rcl_ros_clock_storage_init(rcl_ros_clock_storage_t * storage)
+{
+  // 0 is a special value meaning time has not been set
+  atomic_init(&(storage->current_time), 0);
+  storage->active = false;
+  atomic_init(&(storage->source), (uintptr_t)NULL);
+}
+
 // Implementation only
 static rcl_ret_t
 rcl_get_steady_time(void * data, rcl_time_point_value_t * current_time)
@@ -54,6 +88,7 @@ rcl_init_generic_clock(rcl_clock_t * clock, rcl_allocator_t * allocator)
   clock->type = RCL_CLOCK_UNINITIALIZED;
   clock->jump_callbacks = NULL;
   clock->num_jump_callbacks = 0u;
+  clock->jump_callback_registry = NULL;
   clock->get_now = NULL;
   clock->data = NULL;
   clock->allocator = *allocator;
@@ -64,7 +99,7 @@ rcl_init_generic_clock(rcl_clock_t * clock, rcl_allocator_t * allocator)
 static rcl_ret_t
 rcl_get_ros_time(void * data, rcl_time_point_value_t * current_time)
 {
-  rcl_ros_clock_storage_t * t = (rcl_ros_clock_storage_t *)data;
+  rcl_ros_clock_storage_t * t = rcl_ros_clock_get_storage((rcl_ros_clock_storage_t *)data);
   if (!t->active) {
     return rcl_get_system_time(data, current_time);
   }
@@ -126,11 +161,7 @@ rcl_clock_generic_fini(
   rcl_clock_t * clock)
 {
   // Internal function; assume caller has already checked that clock is valid.
-  if (clock->num_jump_callbacks > 0) {
-    clock->num_jump_callbacks = 0;
-    clock->allocator.deallocate(clock->jump_callbacks, clock->allocator.state);
-    clock->jump_callbacks = NULL;
-  }
+  rcl_jump_callback_registry_fini(clock);
 }
 
 rcl_ret_t
@@ -168,10 +199,7 @@ rcl_ros_clock_init(
     return RCL_RET_BAD_ALLOC;
   }
 
-  rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
-  // 0 is a special value meaning time has not been set
-  atomic_init(&(storage->current_time), 0);
-  storage->active = false;
+  rcl_ros_clock_storage_init((rcl_ros_clock_storage_t *)clock->data);
   clock->get_now = rcl_get_ros_time;
   clock->type = RCL_ROS_TIME;
   return RCL_RET_OK;
@@ -186,6 +214,9 @@ rcl_ros_clock_fini(
     RCL_SET_ERROR_MSG("clock not of type RCL_ROS_TIME");
     return RCL_RET_ERROR;
   }
+  if (NULL != clock->data) {
+    (void)rcl_clock_unbind_ros_time_source(clock);
+  }
   rcl_clock_generic_fini(clock);
   clock->allocator.deallocate(clock->data, clock->allocator.state);
   clock->data = NULL;
@@ -218,6 +249,27 @@ rcl_steady_clock_fini(
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_fast_steady_clock_init(
+  rcl_clock_t * clock,
+  rcl_allocator_t * allocator)
+{
+  rcl_ret_t ret = rcl_steady_clock_init(clock, allocator);
+  if (RCL_RET_OK != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  if (rcl_tsc_clock_is_supported()) {
+    clock->get_now = rcl_tsc_clock_get_now;
+  }
+  return RCL_RET_OK;
+}
+
+bool
+rcl_fast_steady_clock_is_supported(void)
+{
+  return rcl_tsc_clock_is_supported();
+}
+
 rcl_ret_t
 rcl_system_clock_init(
   rcl_clock_t * clock,
@@ -284,20 +336,55 @@ rcl_clock_call_callbacks(
   rcl_clock_t * clock, const rcl_time_jump_t * time_jump, bool before_jump)
 {
   // Internal function; assume parameters are valid.
-  bool is_clock_change = time_jump->clock_change == RCL_ROS_TIME_ACTIVATED ||
-    time_jump->clock_change == RCL_ROS_TIME_DEACTIVATED;
-  for (size_t cb_idx = 0; cb_idx < clock->num_jump_callbacks; ++cb_idx) {
-    rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
-    if (
-      (is_clock_change && info->threshold.on_clock_change) ||
-      (info->threshold.min_backward.nanoseconds < 0 &&
-      time_jump->delta.nanoseconds <= info->threshold.min_backward.nanoseconds) ||
-      (info->threshold.min_forward.nanoseconds > 0 &&
-      time_jump->delta.nanoseconds >= info->threshold.min_forward.nanoseconds))
-    {
-      info->callback(time_jump, before_jump, info->user_data);
+  rcl_jump_callback_registry_call(clock, time_jump, before_jump);
+}
+
+// Change the override state, calling the jump callbacks of the clocks reading the storage.
+static void
+rcl_ros_time_set_active(
+  rcl_ros_clock_storage_t * storage, rcl_clock_t ** clocks, size_t clock_count, bool active)
+{
+  if (storage->active == active) {
+    return;
+  }
+  rcl_time_jump_t time_jump;
+  time_jump.delta.nanoseconds = 0;
+  time_jump.clock_change = active ? RCL_ROS_TIME_ACTIVATED : RCL_ROS_TIME_DEACTIVATED;
+  for (size_t i = 0u; i < clock_count; ++i) {
+    rcl_clock_call_callbacks(clocks[i], &time_jump, true);
+  }
+  storage->active = active;
+  for (size_t i = 0u; i < clock_count; ++i) {
+    rcl_clock_call_callbacks(clocks[i], &time_jump, false);
+  }
+}
+
+// Set the time, calling the jump callbacks of the clocks reading the storage.
+static rcl_ret_t
+rcl_ros_time_set(
+  rcl_ros_clock_storage_t * storage, rcl_clock_t ** clocks, size_t clock_count,
+  rcl_time_point_value_t time_value)
+{
+  if (storage->active) {
+    rcl_time_jump_t time_jump;
+    time_jump.clock_change = RCL_ROS_TIME_NO_CHANGE;
+    rcl_time_point_value_t current_time;
+    rcl_ret_t ret = rcl_get_ros_time(storage, &current_time);
+    if (RCL_RET_OK != ret) {
+      return ret;
+    }
+    time_jump.delta.nanoseconds = time_value - current_time;
+    for (size_t i = 0u; i < clock_count; ++i) {
+      rcl_clock_call_callbacks(clocks[i], &time_jump, true);
+    }
+    rcutils_atomic_store(&(storage->current_time), time_value);
+    for (size_t i = 0u; i < clock_count; ++i) {
+      rcl_clock_call_callbacks(clocks[i], &time_jump, false);
     }
+  } else {
+    rcutils_atomic_store(&(storage->current_time), time_value);
   }
+  return RCL_RET_OK;
 }
 
 rcl_ret_t
@@ -311,14 +398,12 @@ rcl_enable_ros_time_override(rcl_clock_t * clock)
   rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
   RCL_CHECK_FOR_NULL_WITH_MSG(
     storage, "Clock storage is not initialized, cannot enable override.", return RCL_RET_ERROR);
-  if (!storage->active) {
-    rcl_time_jump_t time_jump;
-    time_jump.delta.nanoseconds = 0;
-    time_jump.clock_change = RCL_ROS_TIME_ACTIVATED;
-    rcl_clock_call_callbacks(clock, &time_jump, true);
-    storage->active = true;
-    rcl_clock_call_callbacks(clock, &time_jump, false);
+  rcl_ros_time_source_t * source =
+    (rcl_ros_time_source_t *)rcutils_atomic_load_uintptr_t(&storage->source);
+  if (NULL != source) {
+    return rcl_ros_time_source_enable_override(source);
   }
+  rcl_ros_time_set_active(storage, &clock, 1u, true);
   return RCL_RET_OK;
 }
 
@@ -333,14 +418,12 @@ rcl_disable_ros_time_override(rcl_clock_t * clock)
   rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
   RCL_CHECK_FOR_NULL_WITH_MSG(
     storage, "Clock storage is not initialized, cannot enable override.", return RCL_RET_ERROR);
-  if (storage->active) {
-    rcl_time_jump_t time_jump;
-    time_jump.delta.nanoseconds = 0;
-    time_jump.clock_change = RCL_ROS_TIME_DEACTIVATED;
-    rcl_clock_call_callbacks(clock, &time_jump, true);
-    storage->active = false;
-    rcl_clock_call_callbacks(clock, &time_jump, false);
+  rcl_ros_time_source_t * source =
+    (rcl_ros_time_source_t *)rcutils_atomic_load_uintptr_t(&storage->source);
+  if (NULL != source) {
+    return rcl_ros_time_source_disable_override(source);
   }
+  rcl_ros_time_set_active(storage, &clock, 1u, false);
   return RCL_RET_OK;
 }
 
@@ -358,7 +441,7 @@ rcl_is_enabled_ros_time_override(
   rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
   RCL_CHECK_FOR_NULL_WITH_MSG(
     storage, "Clock storage is not initialized, cannot enable override.", return RCL_RET_ERROR);
-  *is_enabled = storage->active;
+  *is_enabled = rcl_ros_clock_get_storage(storage)->active;
   return RCL_RET_OK;
 }
 
@@ -375,24 +458,170 @@ rcl_set_ros_time_override(
   rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
   RCL_CHECK_FOR_NULL_WITH_MSG(
     storage, "Clock storage is not initialized, cannot enable override.", return RCL_RET_ERROR);
+  rcl_ros_time_source_t * source =
+    (rcl_ros_time_source_t *)rcutils_atomic_load_uintptr_t(&storage->source);
+  if (NULL != source) {
+    return rcl_ros_time_source_set_override(source, time_value);
+  }
+  return rcl_ros_time_set(storage, &clock, 1u, time_value);
+}
+
+rcl_ret_t
+rcl_ros_time_source_init(rcl_ros_time_source_t ** source, const rcl_allocator_t * allocator)
+{
+  *source = allocator->allocate(sizeof(rcl_ros_time_source_t), allocator->state);
+  if (NULL == *source) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  rcl_ros_clock_storage_init(&(*source)->storage);
+  (*source)->clocks = NULL;
+  (*source)->clock_count = 0u;
+  (*source)->clock_capacity = 0u;
+  (*source)->allocator = *allocator;
+  return RCL_RET_OK;
+}
+
+// Detach the clock from its source, keeping the time of the source so it is not a jump.
+static void
+rcl_ros_time_source_release_clock(rcl_ros_time_source_t * source, rcl_clock_t * clock)
+{
+  rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
+  rcutils_atomic_store(
+    &(storage->current_time), rcutils_atomic_load_uint64_t(&(source->storage.current_time)));
+  storage->active = source->storage.active;
+  rcutils_atomic_store(&(storage->source), (uintptr_t)NULL);
+}
+
+void
+rcl_ros_time_source_fini(rcl_ros_time_source_t * source)
+{
+  for (size_t i = 0u; i < source->clock_count; ++i) {
+    rcl_ros_time_source_release_clock(source, source->clocks[i]);
+  }
+  source->allocator.deallocate(source->clocks, source->allocator.state);
+  source->allocator.deallocate(source, source->allocator.state);
+}
+
+rcl_time_point_value_t
+rcl_ros_time_source_get_time(rcl_ros_time_source_t * source)
+{
+  return (rcl_time_point_value_t)rcutils_atomic_load_uint64_t(&(source->storage.current_time));
+}
+
+rcl_ros_time_source_t *
+rcl_clock_get_ros_time_source(const rcl_clock_t * clock)
+{
+  if (RCL_ROS_TIME != clock->type || NULL == clock->data) {
+    return NULL;
+  }
+  rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
+  return (rcl_ros_time_source_t *)rcutils_atomic_load_uintptr_t(&storage->source);
+}
+
+rcl_ret_t
+rcl_clock_bind_ros_time_source(rcl_clock_t * clock, rcl_ros_time_source_t * source)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(clock, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(source, RCL_RET_INVALID_ARGUMENT);
+  if (clock->type != RCL_ROS_TIME) {
+    RCL_SET_ERROR_MSG("Clock is not of type RCL_ROS_TIME, cannot bind a ROS time source.");
+    return RCL_RET_ERROR;
+  }
+  rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    storage, "Clock storage is not initialized, cannot bind a ROS time source.",
+    return RCL_RET_ERROR);
+  rcl_ros_time_source_t * bound_source =
+    (rcl_ros_time_source_t *)rcutils_atomic_load_uintptr_t(&storage->source);
+  if (source == bound_source) {
+    return RCL_RET_OK;
+  }
+  if (NULL != bound_source) {
+    RCL_SET_ERROR_MSG("Clock is already bound to another ROS time source.");
+    return RCL_RET_ERROR;
+  }
+  if (source->clock_count == source->clock_capacity) {
+    size_t capacity = source->clock_capacity > 0u ? source->clock_capacity * 2u : 4u;
+    rcl_clock_t ** clocks = source->allocator.reallocate(
+      source->clocks, sizeof(rcl_clock_t *) * capacity, source->allocator.state);
+    if (NULL == clocks) {
+      RCL_SET_ERROR_MSG("Failed to realloc bound clocks");
+      return RCL_RET_BAD_ALLOC;
+    }
+    source->clocks = clocks;
+    source->clock_capacity = capacity;
+  }
+
+  // The clock starts reading the time of the source, which may be a jump.
   rcl_time_jump_t time_jump;
-  if (storage->active) {
-    time_jump.clock_change = RCL_ROS_TIME_NO_CHANGE;
-    rcl_time_point_value_t current_time;
-    rcl_ret_t ret = rcl_get_ros_time(storage, &current_time);
-    if (RCL_RET_OK != ret) {
-      return ret;
+  time_jump.delta.nanoseconds = 0;
+  time_jump.clock_change = RCL_ROS_TIME_NO_CHANGE;
+  if (storage->active != source->storage.active) {
+    time_jump.clock_change =
+      source->storage.active ? RCL_ROS_TIME_ACTIVATED : RCL_ROS_TIME_DEACTIVATED;
+  } else if (storage->active) {
+    time_jump.delta.nanoseconds =
+      (int64_t)(rcutils_atomic_load_uint64_t(&(source->storage.current_time)) -
+      rcutils_atomic_load_uint64_t(&(storage->current_time)));
+  }
+  rcl_clock_call_callbacks(clock, &time_jump, true);
+  rcutils_atomic_store(&(storage->source), (uintptr_t)source);
+  source->clocks[source->clock_count++] = clock;
+  rcl_clock_call_callbacks(clock, &time_jump, false);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_clock_unbind_ros_time_source(rcl_clock_t * clock)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(clock, RCL_RET_INVALID_ARGUMENT);
+  if (clock->type != RCL_ROS_TIME) {
+    RCL_SET_ERROR_MSG("Clock is not of type RCL_ROS_TIME, cannot unbind a ROS time source.");
+    return RCL_RET_ERROR;
+  }
+  rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    storage, "Clock storage is not initialized, cannot unbind a ROS time source.",
+    return RCL_RET_ERROR);
+  rcl_ros_time_source_t * source =
+    (rcl_ros_time_source_t *)rcutils_atomic_load_uintptr_t(&storage->source);
+  if (NULL == source) {
+    return RCL_RET_OK;
+  }
+  rcl_ros_time_source_release_clock(source, clock);
+  for (size_t i = 0u; i < source->clock_count; ++i) {
+    if (source->clocks[i] == clock) {
+      source->clocks[i] = source->clocks[--(source->clock_count)];
+      break;
     }
-    time_jump.delta.nanoseconds = time_value - current_time;
-    rcl_clock_call_callbacks(clock, &time_jump, true);
-    rcutils_atomic_store(&(storage->current_time), time_value);
-    rcl_clock_call_callbacks(clock, &time_jump, false);
-  } else {
-    rcutils_atomic_store(&(storage->current_time), time_value);
   }
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_ros_time_source_enable_override(rcl_ros_time_source_t * source)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(source, RCL_RET_INVALID_ARGUMENT);
+  rcl_ros_time_set_active(&source->storage, source->clocks, source->clock_count, true);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_ros_time_source_disable_override(rcl_ros_time_source_t * source)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(source, RCL_RET_INVALID_ARGUMENT);
+  rcl_ros_time_set_active(&source->storage, source->clocks, source->clock_count, false);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_ros_time_source_set_override(rcl_ros_time_source_t * source, rcl_time_point_value_t time_value)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(source, RCL_RET_INVALID_ARGUMENT);
+  return rcl_ros_time_set(&source->storage, source->clocks, source->clock_count, time_value);
+}
+
 rcl_ret_t
 rcl_clock_add_jump_callback(
   rcl_clock_t * clock, rcl_jump_threshold_t threshold, rcl_jump_callback_t callback,
@@ -412,29 +641,11 @@ rcl_clock_add_jump_callback(
     return RCL_RET_INVALID_ARGUMENT;
   }
 
-  // Callback/user_data pair must be unique
-  for (size_t cb_idx = 0; cb_idx < clock->num_jump_callbacks; ++cb_idx) {
-    const rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
-    if (info->callback == callback && info->user_data == user_data) {
-      RCL_SET_ERROR_MSG("callback/user_data are already added to this clock");
-      return RCL_RET_ERROR;
-    }
-  }
-
-  // Add the new callback, increasing the size of the callback list
-  rcl_jump_callback_info_t * callbacks = clock->allocator.reallocate(
-    clock->jump_callbacks, sizeof(rcl_jump_callback_info_t) * (clock->num_jump_callbacks + 1),
-    clock->allocator.state);
-  if (NULL == callbacks) {
-    RCL_SET_ERROR_MSG("Failed to realloc jump callbacks");
-    return RCL_RET_BAD_ALLOC;
-  }
-  clock->jump_callbacks = callbacks;
-  clock->jump_callbacks[clock->num_jump_callbacks].callback = callback;
-  clock->jump_callbacks[clock->num_jump_callbacks].threshold = threshold;
-  clock->jump_callbacks[clock->num_jump_callbacks].user_data = user_data;
-  ++(clock->num_jump_callbacks);
-  return RCL_RET_OK;
+  rcl_jump_callback_info_t info;
+  info.callback = callback;
+  info.threshold = threshold;
+  info.user_data = user_data;
+  return rcl_jump_callback_registry_add(clock, &info);
 }
 
 rcl_ret_t
@@ -447,34 +658,5 @@ rcl_clock_remove_jump_callback(
     &(clock->allocator), "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(callback, RCL_RET_INVALID_ARGUMENT);
 
-  // Delete callback if found, moving all callbacks after back one
-  bool found_callback = false;
-  for (size_t cb_idx = 0; cb_idx < clock->num_jump_callbacks; ++cb_idx) {
-    const rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
-    if (found_callback) {
-      clock->jump_callbacks[cb_idx - 1] = *info;
-    } else if (info->callback == callback && info->user_data == user_data) {
-      found_callback = true;
-    }
-  }
-  if (!found_callback) {
-    RCL_SET_ERROR_MSG("jump callback was not found");
-    return RCL_RET_ERROR;
-  }
-
-  // Shrink size of the callback array
-  if (--(clock->num_jump_callbacks) == 0) {
-    clock->allocator.deallocate(clock->jump_callbacks, clock->allocator.state);
-    clock->jump_callbacks = NULL;
-  } else {
-    rcl_jump_callback_info_t * callbacks = clock->allocator.reallocate(
-      clock->jump_callbacks, sizeof(rcl_jump_callback_info_t) * clock->num_jump_callbacks,
-      clock->allocator.state);
-    if (NULL == callbacks) {
-      RCL_SET_ERROR_MSG("Failed to shrink jump callbacks");
-      return RCL_RET_BAD_ALLOC;
-    }
-    clock->jump_callbacks = callbacks;
-  }
-  return RCL_RET_OK;
+  return rcl_jump_callback_registry_remove(clock, callback, user_data);
 }
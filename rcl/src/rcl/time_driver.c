@@ -0,0 +1,244 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "rcl/time_driver.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "rcl/error_handling.h"
+#include "rcutils/logging_macros.h"
+#include "rcutils/stdatomic_helper.h"
+
+#include "./common.h"
+#include "./ros_time_source.h"
+#include "./time_driver_impl.h"
+
+struct rcl_time_driver_slot_s
+{
+  // earliest deadline of the driven timers of the wait set while it is idle, else INT64_MAX
+  atomic_int_least64_t deadline;
+};
+
+struct rcl_time_driver_impl_s
+{
+  // ROS time source of the context, whose override the driver owns
+  rcl_ros_time_source_t * source;
+  // attached wait sets, in no particular order
+  rcl_time_driver_slot_t ** slots;
+  size_t slot_count;
+  size_t slot_capacity;
+  // number of attached wait sets blocked in rcl_wait
+  atomic_uint_least64_t idle_count;
+  // bumped whenever a wait set goes idle, so an advance which raced with it is retried
+  atomic_uint_least64_t idle_epoch;
+  // whether a thread is advancing the time
+  atomic_bool advancing;
+  // number of times the time was advanced
+  atomic_uint_least64_t advance_count;
+  rcl_allocator_t allocator;
+};
+
+rcl_time_driver_t
+rcl_get_zero_initialized_time_driver(void)
+{
+  static rcl_time_driver_t null_driver = {0};
+  return null_driver;
+}
+
+rcl_ret_t
+rcl_time_driver_init(
+  rcl_time_driver_t * driver,
+  rcl_context_t * context,
+  rcl_time_point_value_t start_time,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(driver, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(context, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(&allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  if (NULL != driver->impl) {
+    RCL_SET_ERROR_MSG("time driver already initialized, or memory was uninitialized");
+    return RCL_RET_ALREADY_INIT;
+  }
+  rcl_ros_time_source_t * source = rcl_context_get_ros_time_source(context);
+  if (NULL == source) {
+    return RCL_RET_INVALID_ARGUMENT;  // The rcl error state should already be set.
+  }
+  rcl_time_driver_impl_t * impl = (rcl_time_driver_impl_t *)allocator.allocate(
+    sizeof(rcl_time_driver_impl_t), allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(impl, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  impl->source = source;
+  impl->slots = NULL;
+  impl->slot_count = 0u;
+  impl->slot_capacity = 0u;
+  atomic_init(&impl->idle_count, 0u);
+  atomic_init(&impl->idle_epoch, 0u);
+  atomic_init(&impl->advancing, false);
+  atomic_init(&impl->advance_count, 0u);
+  impl->allocator = allocator;
+  rcl_ret_t ret = rcl_ros_time_source_set_override(source, start_time);
+  if (RCL_RET_OK == ret) {
+    ret = rcl_ros_time_source_enable_override(source);
+  }
+  if (RCL_RET_OK != ret) {
+    allocator.deallocate(impl, allocator.state);
+    return ret;  // The rcl error state should already be set.
+  }
+  driver->impl = impl;
+  RCUTILS_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Time driver starting at %" PRId64 "ns", start_time);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_time_driver_fini(rcl_time_driver_t * driver)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(driver, RCL_RET_INVALID_ARGUMENT);
+  rcl_time_driver_impl_t * impl = driver->impl;
+  if (NULL == impl) {
+    return RCL_RET_OK;
+  }
+  if (impl->slot_count > 0u) {
+    RCL_SET_ERROR_MSG("wait sets are still attached to the time driver");
+    return RCL_RET_ERROR;
+  }
+  rcl_ret_t ret = rcl_ros_time_source_disable_override(impl->source);
+  impl->allocator.deallocate(impl->slots, impl->allocator.state);
+  impl->allocator.deallocate(impl, impl->allocator.state);
+  driver->impl = NULL;
+  return ret;
+}
+
+bool
+rcl_time_driver_is_valid(const rcl_time_driver_t * driver)
+{
+  return NULL != driver && NULL != driver->impl;
+}
+
+rcl_ret_t
+rcl_time_driver_get_advance_count(const rcl_time_driver_t * driver, uint64_t * advance_count)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(driver, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    driver->impl, "time driver is invalid", return RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(advance_count, RCL_RET_INVALID_ARGUMENT);
+  *advance_count = rcutils_atomic_load_uint64_t(&driver->impl->advance_count);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_time_driver_attach(rcl_time_driver_t * driver, rcl_time_driver_slot_t ** slot)
+{
+  rcl_time_driver_impl_t * impl = driver->impl;
+  if (impl->slot_count == impl->slot_capacity) {
+    size_t capacity = impl->slot_capacity > 0u ? impl->slot_capacity * 2u : 4u;
+    rcl_time_driver_slot_t ** slots = (rcl_time_driver_slot_t **)impl->allocator.reallocate(
+      impl->slots, sizeof(rcl_time_driver_slot_t *) * capacity, impl->allocator.state);
+    RCL_CHECK_FOR_NULL_WITH_MSG(slots, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+    impl->slots = slots;
+    impl->slot_capacity = capacity;
+  }
+  *slot = (rcl_time_driver_slot_t *)impl->allocator.allocate(
+    sizeof(rcl_time_driver_slot_t), impl->allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(*slot, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  atomic_init(&(*slot)->deadline, INT64_MAX);
+  impl->slots[impl->slot_count++] = *slot;
+  return RCL_RET_OK;
+}
+
+void
+rcl_time_driver_detach(rcl_time_driver_t * driver, rcl_time_driver_slot_t * slot)
+{
+  rcl_time_driver_impl_t * impl = driver->impl;
+  for (size_t i = 0u; i < impl->slot_count; ++i) {
+    if (impl->slots[i] == slot) {
+      impl->slots[i] = impl->slots[--(impl->slot_count)];
+      break;
+    }
+  }
+  impl->allocator.deallocate(slot, impl->allocator.state);
+}
+
+rcl_ros_time_source_t *
+rcl_time_driver_get_source(const rcl_time_driver_t * driver)
+{
+  return driver->impl->source;
+}
+
+// Set the time to the earliest deadline of the idle wait sets, if all are idle and it is ahead.
+static bool
+__time_driver_advance(rcl_time_driver_impl_t * impl)
+{
+  if (rcutils_atomic_load_uint64_t(&impl->idle_count) != impl->slot_count) {
+    return false;
+  }
+  int64_t deadline = INT64_MAX;
+  for (size_t i = 0u; i < impl->slot_count; ++i) {
+    const int64_t slot_deadline = rcutils_atomic_load_int64_t(&impl->slots[i]->deadline);
+    if (slot_deadline < deadline) {
+      deadline = slot_deadline;
+    }
+  }
+  // The deadlines of wait sets which were woken up by the last advance are not ahead of
+  // the time until they go idle again, which keeps a single advance per round.
+  if (INT64_MAX == deadline || deadline <= rcl_ros_time_source_get_time(impl->source)) {
+    return false;
+  }
+  if (RCL_RET_OK != rcl_ros_time_source_set_override(impl->source, deadline)) {
+    RCUTILS_LOG_ERROR_NAMED(
+      ROS_PACKAGE_NAME, "Failed to advance the time driver: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+    return false;
+  }
+  (void)rcutils_atomic_fetch_add_uint64_t(&impl->advance_count, 1u);
+  return true;
+}
+
+void
+rcl_time_driver_enter_idle(
+  rcl_time_driver_t * driver, rcl_time_driver_slot_t * slot, int64_t deadline)
+{
+  rcl_time_driver_impl_t * impl = driver->impl;
+  rcutils_atomic_store(&slot->deadline, deadline);
+  (void)rcutils_atomic_fetch_add_uint64_t(&impl->idle_count, 1u);
+  (void)rcutils_atomic_fetch_add_uint64_t(&impl->idle_epoch, 1u);
+  // A single thread advances, a wait set going idle meanwhile makes it look again.
+  uint64_t epoch;
+  do {
+    if (rcutils_atomic_exchange_bool(&impl->advancing, true)) {
+      return;
+    }
+    epoch = rcutils_atomic_load_uint64_t(&impl->idle_epoch);
+    (void)__time_driver_advance(impl);
+    rcutils_atomic_store(&impl->advancing, false);
+  } while (rcutils_atomic_load_uint64_t(&impl->idle_epoch) != epoch);
+}
+
+void
+rcl_time_driver_leave_idle(rcl_time_driver_t * driver, rcl_time_driver_slot_t * slot)
+{
+  rcl_time_driver_impl_t * impl = driver->impl;
+  // Adding UINT64_MAX wraps around to subtracting one.
+  (void)rcutils_atomic_fetch_add_uint64_t(&impl->idle_count, UINT64_MAX);
+  rcutils_atomic_store(&slot->deadline, INT64_MAX);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__TIME_DRIVER_IMPL_H_
+#define RCL__TIME_DRIVER_IMPL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#include "rcl/time.h"
+#include "rcl/time_driver.h"
+#include "rcl/types.h"
+
+/// State of one wait set attached to a time driver, at a stable address.
+typedef struct rcl_time_driver_slot_s rcl_time_driver_slot_t;
+
+/// Attach a wait set, which starts out busy.
+rcl_ret_t
+rcl_time_driver_attach(rcl_time_driver_t * driver, rcl_time_driver_slot_t ** slot);
+
+/// Detach a wait set, which must not be in rcl_wait().
+void
+rcl_time_driver_detach(rcl_time_driver_t * driver, rcl_time_driver_slot_t * slot);
+
+/// Get the ROS time source driven by the driver.
+rcl_ros_time_source_t *
+rcl_time_driver_get_source(const rcl_time_driver_t * driver);
+
+/// Mark a wait set idle until `deadline`, INT64_MAX if it has no driven timer.
+/**
+ * If every attached wait set is idle, the time is advanced to the earliest
+ * of their deadlines, which wakes up the timers due at that time.
+ */
+void
+rcl_time_driver_enter_idle(
+  rcl_time_driver_t * driver, rcl_time_driver_slot_t * slot, int64_t deadline);
+
+/// Mark a wait set busy again.
+void
+rcl_time_driver_leave_idle(rcl_time_driver_t * driver, rcl_time_driver_slot_t * slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__TIME_DRIVER_IMPL_H_
@@ -19,6 +19,7 @@ extern "C"
 
 #include "rcl/timer.h"
 
+#include <assert.h>
 #include <inttypes.h>
 
 #include "rcl/error_handling.h"
@@ -27,6 +28,26 @@ extern "C"
 #include "rcutils/time.h"
 #include "tracetools/tracetools.h"
 
+#include "./wait_statistics.h"
+
+// The histogram uses the buckets of the wait set statistics.
+static_assert(
+  RCL_TIMER_STATISTICS_HISTOGRAM_SIZE == RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE,
+  "timer and wait set histograms must have the same buckets");
+
+// Counters of a timer, updated by rcl_timer_call() from any thread.
+typedef struct rcl_timer_statistics_impl_s
+{
+  atomic_uint_least64_t call_count;
+  atomic_uint_least64_t missed_period_count;
+  atomic_uint_least64_t total_lateness;
+  atomic_uint_least64_t max_lateness;
+  atomic_uint_least64_t total_callback_duration;
+  atomic_uint_least64_t max_callback_duration;
+  atomic_uint_least64_t max_jitter;
+  atomic_uint_least64_t lateness_histogram[RCL_TIMER_STATISTICS_HISTOGRAM_SIZE];
+} rcl_timer_statistics_impl_t;
+
 struct rcl_timer_impl_s
 {
   // The clock providing time.
@@ -47,8 +68,16 @@ struct rcl_timer_impl_s
   atomic_int_least64_t next_call_time;
   // Credit for time elapsed before ROS time is activated or deactivated.
   atomic_int_least64_t time_credit;
+  // How long in nanoseconds a call may be delayed past next_call_time to share a wake-up.
+  atomic_int_least64_t slack;
+  // What rcl_timer_call() does when it is called more than one period late.
+  atomic_int_least64_t catch_up_policy;
+  // How many missed calls are kept pending with RCL_TIMER_CATCH_UP_BOUNDED.
+  atomic_int_least64_t max_backlog;
   // A flag which indicates if the timer is canceled.
   atomic_bool canceled;
+  // Counters about calls of the timer, NULL unless enabled.
+  atomic_uintptr_t statistics;
   // The user supplied allocator.
   rcl_allocator_t allocator;
 };
@@ -60,6 +89,14 @@ rcl_get_zero_initialized_timer()
   return null_timer;
 }
 
+static void _rcl_timer_wake_waiters(rcl_timer_t * timer)
+{
+  if (RCL_RET_OK != rcl_trigger_guard_condition(&timer->impl->guard_condition)) {
+    RCUTILS_LOG_ERROR_NAMED(
+      ROS_PACKAGE_NAME, "Failed to get trigger guard condition in jump callback");
+  }
+}
+
 void _rcl_timer_time_jump(
   const rcl_time_jump_t * time_jump,
   bool before_jump,
@@ -107,18 +144,19 @@ void _rcl_timer_time_jump(
         // set times in new epoch so timer only waits the remainder of the period
         rcutils_atomic_store(&timer->impl->next_call_time, now - time_credit + period);
         rcutils_atomic_store(&timer->impl->last_call_time, now - time_credit);
+        // Wake up waiters which may have scheduled the timer at its old deadline
+        _rcl_timer_wake_waiters(timer);
       }
     } else if (next_call_time <= now) {
       // Post Forward jump and timer is ready
-      if (RCL_RET_OK != rcl_trigger_guard_condition(&timer->impl->guard_condition)) {
-        RCUTILS_LOG_ERROR_NAMED(
-          ROS_PACKAGE_NAME, "Failed to get trigger guard condition in jump callback");
-      }
+      _rcl_timer_wake_waiters(timer);
     } else if (now < last_call_time) {
       // Post backwards time jump that went further back than 1 period
       // next callback should happen after 1 period
       rcutils_atomic_store(&timer->impl->next_call_time, now + period);
       rcutils_atomic_store(&timer->impl->last_call_time, now);
+      // The deadline moved earlier, wake up waiters so they reschedule the timer
+      _rcl_timer_wake_waiters(timer);
       return;
     }
   }
@@ -178,6 +216,10 @@ rcl_timer_init(
   atomic_init(&impl.callback, (uintptr_t)callback);
   atomic_init(&impl.period, period);
   atomic_init(&impl.time_credit, 0);
+  atomic_init(&impl.slack, 0);
+  atomic_init(&impl.catch_up_policy, RCL_TIMER_CATCH_UP_SKIP);
+  atomic_init(&impl.max_backlog, 0);
+  atomic_init(&impl.statistics, (uintptr_t)NULL);
   atomic_init(&impl.last_call_time, now);
   atomic_init(&impl.next_call_time, now + period);
   atomic_init(&impl.canceled, false);
@@ -223,6 +265,10 @@ rcl_timer_fini(rcl_timer_t * timer)
   if (RCL_RET_OK != fail_ret) {
     RCL_SET_ERROR_MSG("Failure to fini guard condition");
   }
+  void * statistics = (void *)rcutils_atomic_load_uintptr_t(&timer->impl->statistics);
+  if (statistics) {
+    allocator.deallocate(statistics, allocator.state);
+  }
   allocator.deallocate(timer->impl, allocator.state);
   timer->impl = NULL;
   return result;
@@ -240,10 +286,54 @@ rcl_timer_clock(rcl_timer_t * timer, rcl_clock_t ** clock)
   return RCL_RET_OK;
 }
 
+static rcl_timer_catch_up_policy_t
+__timer_load_catch_up_policy(const rcl_timer_t * timer)
+{
+  return (rcl_timer_catch_up_policy_t)rcutils_atomic_load_int64_t(&timer->impl->catch_up_policy);
+}
+
+static void
+__timer_statistics_max(atomic_uint_least64_t * max, uint64_t value)
+{
+  uint64_t current = rcutils_atomic_load_uint64_t(max);
+  // On failure current holds the value stored by the other thread.
+  while (
+    value > current &&
+    !rcutils_atomic_compare_exchange_strong_uint_least64_t(max, &current, value))
+  {
+  }
+}
+
+static void
+__timer_statistics_record_call(
+  rcl_timer_statistics_impl_t * statistics,
+  int64_t lateness,
+  uint64_t missed_periods,
+  int64_t jitter)
+{
+  // Calls made before the timer was due count as on time.
+  const uint64_t late = lateness > 0 ? (uint64_t)lateness : 0u;
+  const uint64_t abs_jitter = jitter < 0 ? (uint64_t)0 - (uint64_t)jitter : (uint64_t)jitter;
+  (void)rcutils_atomic_fetch_add_uint64_t(&statistics->call_count, 1u);
+  (void)rcutils_atomic_fetch_add_uint64_t(&statistics->missed_period_count, missed_periods);
+  (void)rcutils_atomic_fetch_add_uint64_t(&statistics->total_lateness, late);
+  (void)rcutils_atomic_fetch_add_uint64_t(
+    &statistics->lateness_histogram[rcl_wait_statistics_bucket(late)], 1u);
+  __timer_statistics_max(&statistics->max_lateness, late);
+  __timer_statistics_max(&statistics->max_jitter, abs_jitter);
+}
+
+static void
+__timer_statistics_record_callback(rcl_timer_statistics_impl_t * statistics, int64_t duration)
+{
+  const uint64_t elapsed = duration > 0 ? (uint64_t)duration : 0u;
+  (void)rcutils_atomic_fetch_add_uint64_t(&statistics->total_callback_duration, elapsed);
+  __timer_statistics_max(&statistics->max_callback_duration, elapsed);
+}
+
 rcl_ret_t
 rcl_timer_call(rcl_timer_t * timer)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Calling timer");
   RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
   if (rcutils_atomic_load_bool(&timer->impl->canceled)) {
@@ -255,6 +345,19 @@ rcl_timer_call(rcl_timer_t * timer)
   if (now_ret != RCL_RET_OK) {
     return now_ret;  // rcl error state should already be set.
   }
+  return rcl_timer_call_with_now(timer, now);
+}
+
+rcl_ret_t
+rcl_timer_call_with_now(rcl_timer_t * timer, rcl_time_point_value_t now)
+{
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Calling timer");
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
+  if (rcutils_atomic_load_bool(&timer->impl->canceled)) {
+    RCL_SET_ERROR_MSG("timer is canceled");
+    return RCL_RET_TIMER_CANCELED;
+  }
   if (now < 0) {
     RCL_SET_ERROR_MSG("clock now returned negative time point value");
     return RCL_RET_ERROR;
@@ -265,7 +368,9 @@ rcl_timer_call(rcl_timer_t * timer)
     (rcl_timer_callback_t)rcutils_atomic_load_uintptr_t(&timer->impl->callback);
 
   int64_t next_call_time = rcutils_atomic_load_int64_t(&timer->impl->next_call_time);
+  const int64_t scheduled_call_time = next_call_time;
   int64_t period = rcutils_atomic_load_int64_t(&timer->impl->period);
+  int64_t periods_ahead = 0;
   // always move the next call time by exactly period forward
   // don't use now as the base to avoid extending each cycle by the time
   // between the timer being ready and the callback being triggered
@@ -276,18 +381,59 @@ rcl_timer_call(rcl_timer_t * timer)
       // a timer with a period of zero is considered always ready
       next_call_time = now;
     } else {
-      // move the next call time forward by as many periods as necessary
+      // count the periods between the next call time and now, rounding up without overflow
       int64_t now_ahead = now - next_call_time;
-      // rounding up without overflow
-      int64_t periods_ahead = 1 + (now_ahead - 1) / period;
-      next_call_time += periods_ahead * period;
+      periods_ahead = 1 + (now_ahead - 1) / period;
+      switch (__timer_load_catch_up_policy(timer)) {
+        case RCL_TIMER_CATCH_UP_BURST:
+          // keep every missed call pending, the timer stays ready until it caught up
+          periods_ahead = 0;
+          break;
+        case RCL_TIMER_CATCH_UP_DRIFT:
+          next_call_time = now + period;
+          break;
+        case RCL_TIMER_CATCH_UP_BOUNDED:
+          {
+            // keep at most max_backlog of the missed calls pending, dropping the oldest
+            int64_t max_backlog = rcutils_atomic_load_int64_t(&timer->impl->max_backlog);
+            periods_ahead = periods_ahead > max_backlog ? periods_ahead - max_backlog : 0;
+            next_call_time += periods_ahead * period;
+          }
+          break;
+        case RCL_TIMER_CATCH_UP_SKIP:
+        default:
+          // move the next call time forward by as many periods as necessary
+          next_call_time += periods_ahead * period;
+          break;
+      }
     }
   }
   rcutils_atomic_store(&timer->impl->next_call_time, next_call_time);
 
+  rcl_timer_statistics_impl_t * statistics =
+    (rcl_timer_statistics_impl_t *)rcutils_atomic_load_uintptr_t(&timer->impl->statistics);
+  rcutils_time_point_value_t callback_start = 0;
+  if (statistics) {
+    __timer_statistics_record_call(
+      statistics, now - scheduled_call_time, (uint64_t)periods_ahead,
+      now - previous_ns - period);
+    if (typed_callback != NULL && RCUTILS_RET_OK != rcutils_steady_time_now(&callback_start)) {
+      rcutils_reset_error();
+      statistics = NULL;
+    }
+  }
+
   if (typed_callback != NULL) {
     int64_t since_last_call = now - previous_ns;
     typed_callback(timer, since_last_call);
+    rcutils_time_point_value_t callback_end = 0;
+    if (statistics) {
+      if (RCUTILS_RET_OK == rcutils_steady_time_now(&callback_end)) {
+        __timer_statistics_record_callback(statistics, callback_end - callback_start);
+      } else {
+        rcutils_reset_error();
+      }
+    }
   }
   return RCL_RET_OK;
 }
@@ -310,6 +456,28 @@ rcl_timer_is_ready(const rcl_timer_t * timer, bool * is_ready)
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_timer_is_ready_with_now(
+  const rcl_timer_t * timer,
+  rcl_time_point_value_t now,
+  bool * is_ready)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
+  RCL_CHECK_ARGUMENT_FOR_NULL(is_ready, RCL_RET_INVALID_ARGUMENT);
+  int64_t time_until_next_call;
+  rcl_ret_t ret =
+    rcl_timer_get_time_until_next_call_with_now(timer, now, &time_until_next_call);
+  if (ret == RCL_RET_TIMER_CANCELED) {
+    *is_ready = false;
+    return RCL_RET_OK;
+  } else if (ret != RCL_RET_OK) {
+    return ret;  // rcl error state should already be set.
+  }
+  *is_ready = (time_until_next_call <= 0);
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_timer_get_time_until_next_call(const rcl_timer_t * timer, int64_t * time_until_next_call)
 {
@@ -329,6 +497,36 @@ rcl_timer_get_time_until_next_call(const rcl_timer_t * timer, int64_t * time_unt
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_timer_get_time_until_next_call_with_now(
+  const rcl_timer_t * timer,
+  rcl_time_point_value_t now,
+  int64_t * time_until_next_call)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
+  RCL_CHECK_ARGUMENT_FOR_NULL(time_until_next_call, RCL_RET_INVALID_ARGUMENT);
+  if (rcutils_atomic_load_bool(&timer->impl->canceled)) {
+    return RCL_RET_TIMER_CANCELED;
+  }
+  *time_until_next_call =
+    rcutils_atomic_load_int64_t(&timer->impl->next_call_time) - now;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_timer_get_next_call_time(const rcl_timer_t * timer, int64_t * next_call_time)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
+  RCL_CHECK_ARGUMENT_FOR_NULL(next_call_time, RCL_RET_INVALID_ARGUMENT);
+  if (rcutils_atomic_load_bool(&timer->impl->canceled)) {
+    return RCL_RET_TIMER_CANCELED;
+  }
+  *next_call_time = rcutils_atomic_load_int64_t(&timer->impl->next_call_time);
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_timer_get_time_since_last_call(
   const rcl_timer_t * timer,
@@ -372,6 +570,144 @@ rcl_timer_exchange_period(const rcl_timer_t * timer, int64_t new_period, int64_t
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_timer_get_slack(const rcl_timer_t * timer, int64_t * slack)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
+  RCL_CHECK_ARGUMENT_FOR_NULL(slack, RCL_RET_INVALID_ARGUMENT);
+  *slack = rcutils_atomic_load_int64_t(&timer->impl->slack);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_timer_set_slack(rcl_timer_t * timer, int64_t slack)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
+  if (slack < 0) {
+    RCL_SET_ERROR_MSG("timer slack must be non-negative");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  int64_t old_slack = rcutils_atomic_exchange_int64_t(&timer->impl->slack, slack);
+  RCUTILS_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Updated timer slack from '%" PRId64 "ns' to '%" PRId64 "ns'",
+    old_slack, slack);
+  if (slack < old_slack) {
+    // A waiting rcl_wait may now sleep past the latest time the timer accepts.
+    _rcl_timer_wake_waiters(timer);
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_timer_get_catch_up_policy(
+  const rcl_timer_t * timer,
+  rcl_timer_catch_up_policy_t * policy,
+  int64_t * max_backlog)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
+  RCL_CHECK_ARGUMENT_FOR_NULL(policy, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(max_backlog, RCL_RET_INVALID_ARGUMENT);
+  *policy = __timer_load_catch_up_policy(timer);
+  *max_backlog = rcutils_atomic_load_int64_t(&timer->impl->max_backlog);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_timer_set_catch_up_policy(
+  rcl_timer_t * timer,
+  rcl_timer_catch_up_policy_t policy,
+  int64_t max_backlog)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
+  switch (policy) {
+    case RCL_TIMER_CATCH_UP_SKIP:
+    case RCL_TIMER_CATCH_UP_BURST:
+    case RCL_TIMER_CATCH_UP_DRIFT:
+    case RCL_TIMER_CATCH_UP_BOUNDED:
+      break;
+    default:
+      RCL_SET_ERROR_MSG("unknown timer catch-up policy");
+      return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (max_backlog < 0) {
+    RCL_SET_ERROR_MSG("max_backlog must be non-negative");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Setting timer catch-up policy %d with backlog %" PRId64,
+    (int)policy, max_backlog);
+  // Store the backlog first, so a concurrent call which sees the new policy also sees its backlog.
+  rcutils_atomic_store(&timer->impl->max_backlog, max_backlog);
+  rcutils_atomic_store(&timer->impl->catch_up_policy, (int64_t)policy);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_timer_set_statistics(rcl_timer_t * timer, bool enable)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
+  rcl_allocator_t * allocator = &timer->impl->allocator;
+  rcl_timer_statistics_impl_t * statistics =
+    (rcl_timer_statistics_impl_t *)rcutils_atomic_load_uintptr_t(&timer->impl->statistics);
+  if (!enable) {
+    rcutils_atomic_store(&timer->impl->statistics, (uintptr_t)NULL);
+    if (statistics) {
+      allocator->deallocate(statistics, allocator->state);
+    }
+    return RCL_RET_OK;
+  }
+  if (!statistics) {
+    statistics = (rcl_timer_statistics_impl_t *)allocator->allocate(
+      sizeof(rcl_timer_statistics_impl_t), allocator->state);
+    RCL_CHECK_FOR_NULL_WITH_MSG(statistics, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  }
+  atomic_init(&statistics->call_count, 0u);
+  atomic_init(&statistics->missed_period_count, 0u);
+  atomic_init(&statistics->total_lateness, 0u);
+  atomic_init(&statistics->max_lateness, 0u);
+  atomic_init(&statistics->total_callback_duration, 0u);
+  atomic_init(&statistics->max_callback_duration, 0u);
+  atomic_init(&statistics->max_jitter, 0u);
+  for (size_t i = 0u; i < RCL_TIMER_STATISTICS_HISTOGRAM_SIZE; ++i) {
+    atomic_init(&statistics->lateness_histogram[i], 0u);
+  }
+  rcutils_atomic_store(&timer->impl->statistics, (uintptr_t)statistics);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_timer_get_statistics(const rcl_timer_t * timer, rcl_timer_statistics_t * statistics)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer->impl, RCL_RET_TIMER_INVALID);
+  RCL_CHECK_ARGUMENT_FOR_NULL(statistics, RCL_RET_INVALID_ARGUMENT);
+  rcl_timer_statistics_impl_t * counters =
+    (rcl_timer_statistics_impl_t *)rcutils_atomic_load_uintptr_t(&timer->impl->statistics);
+  if (!counters) {
+    RCL_SET_ERROR_MSG("timer statistics are not enabled");
+    return RCL_RET_ERROR;
+  }
+  statistics->call_count = rcutils_atomic_load_uint64_t(&counters->call_count);
+  statistics->missed_period_count = rcutils_atomic_load_uint64_t(&counters->missed_period_count);
+  statistics->total_lateness = rcutils_atomic_load_uint64_t(&counters->total_lateness);
+  statistics->max_lateness = rcutils_atomic_load_uint64_t(&counters->max_lateness);
+  statistics->total_callback_duration =
+    rcutils_atomic_load_uint64_t(&counters->total_callback_duration);
+  statistics->max_callback_duration =
+    rcutils_atomic_load_uint64_t(&counters->max_callback_duration);
+  statistics->max_jitter = rcutils_atomic_load_uint64_t(&counters->max_jitter);
+  for (size_t i = 0u; i < RCL_TIMER_STATISTICS_HISTOGRAM_SIZE; ++i) {
+    statistics->lateness_histogram[i] =
+      rcutils_atomic_load_uint64_t(&counters->lateness_histogram[i]);
+  }
+  return RCL_RET_OK;
+}
+
 rcl_timer_callback_t
 rcl_timer_get_callback(const rcl_timer_t * timer)
 {
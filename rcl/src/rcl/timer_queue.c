@@ -0,0 +1,360 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./timer_queue.h"
+
+#include <string.h>
+
+#include "rcl/error_handling.h"
+
+rcl_timer_queue_t
+rcl_get_zero_initialized_timer_queue()
+{
+  static rcl_timer_queue_t null_timer_queue = {
+    .timers = NULL,
+    .deadlines = NULL,
+    .groups = NULL,
+    .positions = NULL,
+    .stack = NULL,
+    .capacity = 0,
+    .clock_groups = NULL,
+    .group_count = 0,
+  };
+  return null_timer_queue;
+}
+
+static int64_t
+__timer_queue_read_deadline(const rcl_timer_t * timer)
+{
+  int64_t next_call_time;
+  rcl_ret_t ret = rcl_timer_get_next_call_time(timer, &next_call_time);
+  if (RCL_RET_OK != ret) {
+    if (RCL_RET_TIMER_CANCELED != ret) {
+      rcl_reset_error();
+    }
+    // Canceled and invalid timers are never due.
+    return INT64_MAX;
+  }
+  return next_call_time;
+}
+
+// Latest time the timer accepts to be woken up at, given its deadline.
+static int64_t
+__timer_queue_add_slack(int64_t deadline, const rcl_timer_t * timer)
+{
+  int64_t slack = 0;
+  if (RCL_RET_OK != rcl_timer_get_slack(timer, &slack)) {
+    rcl_reset_error();
+  }
+  return deadline > INT64_MAX - slack ? INT64_MAX : deadline + slack;
+}
+
+static void
+__timer_queue_swap(rcl_timer_queue_t * queue, rcl_timer_queue_group_t * group, size_t a, size_t b)
+{
+  const size_t slot = group->heap[a];
+  group->heap[a] = group->heap[b];
+  group->heap[b] = slot;
+  queue->positions[group->heap[a]] = a;
+  queue->positions[group->heap[b]] = b;
+}
+
+static void
+__timer_queue_sift_up(rcl_timer_queue_t * queue, rcl_timer_queue_group_t * group, size_t position)
+{
+  while (position > 0u) {
+    const size_t parent = (position - 1u) / 2u;
+    if (queue->deadlines[group->heap[parent]] <= queue->deadlines[group->heap[position]]) {
+      break;
+    }
+    __timer_queue_swap(queue, group, parent, position);
+    position = parent;
+  }
+}
+
+static void
+__timer_queue_sift_down(
+  rcl_timer_queue_t * queue,
+  rcl_timer_queue_group_t * group,
+  size_t position)
+{
+  for (;; ) {
+    const size_t left = 2u * position + 1u;
+    const size_t right = left + 1u;
+    size_t smallest = position;
+    if (
+      left < group->size &&
+      queue->deadlines[group->heap[left]] < queue->deadlines[group->heap[smallest]])
+    {
+      smallest = left;
+    }
+    if (
+      right < group->size &&
+      queue->deadlines[group->heap[right]] < queue->deadlines[group->heap[smallest]])
+    {
+      smallest = right;
+    }
+    if (smallest == position) {
+      return;
+    }
+    __timer_queue_swap(queue, group, smallest, position);
+    position = smallest;
+  }
+}
+
+// Correct the deadlines which moved later until the top of the heap is exact.
+static void
+__timer_queue_refresh_top(rcl_timer_queue_t * queue, rcl_timer_queue_group_t * group)
+{
+  while (group->size > 0u) {
+    const size_t slot = group->heap[0];
+    const int64_t deadline = __timer_queue_read_deadline(queue->timers[slot]);
+    if (deadline == queue->deadlines[slot]) {
+      return;
+    }
+    queue->deadlines[slot] = deadline;
+    __timer_queue_sift_down(queue, group, 0u);
+  }
+}
+
+static void
+__timer_queue_release_groups(rcl_timer_queue_t * queue)
+{
+  for (size_t i = 0u; i < queue->group_count; ++i) {
+    queue->allocator.deallocate(queue->clock_groups[i].heap, queue->allocator.state);
+  }
+  queue->group_count = 0u;
+}
+
+rcl_ret_t
+rcl_timer_queue_resize(
+  rcl_timer_queue_t * queue,
+  size_t capacity,
+  rcl_allocator_t * allocator)
+{
+  if (queue->capacity > 0u) {
+    __timer_queue_release_groups(queue);
+    queue->allocator.deallocate(queue->deadlines, queue->allocator.state);
+  }
+  *queue = rcl_get_zero_initialized_timer_queue();
+  queue->allocator = *allocator;
+  if (0u == capacity) {
+    return RCL_RET_OK;
+  }
+  // All per slot arrays share a single block, the stack takes two entries per slot.
+  const size_t block_size = capacity *
+    (sizeof(int64_t) + sizeof(rcl_timer_queue_group_t) + sizeof(const rcl_timer_t *) +
+    4u * sizeof(size_t));
+  int64_t * block = (int64_t *)allocator->allocate(block_size, allocator->state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(block, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  queue->deadlines = block;
+  queue->clock_groups = (rcl_timer_queue_group_t *)(queue->deadlines + capacity);
+  queue->timers = (const rcl_timer_t **)(queue->clock_groups + capacity);
+  queue->groups = (size_t *)(queue->timers + capacity);
+  queue->positions = queue->groups + capacity;
+  queue->stack = queue->positions + capacity;
+  queue->capacity = capacity;
+  return RCL_RET_OK;
+}
+
+void
+rcl_timer_queue_clear(rcl_timer_queue_t * queue)
+{
+  __timer_queue_release_groups(queue);
+}
+
+rcl_ret_t
+rcl_timer_queue_add(rcl_timer_queue_t * queue, size_t index, const rcl_timer_t * timer)
+{
+  rcl_clock_t * clock = NULL;
+  // rcl_timer_clock() does not modify the timer.
+  rcl_ret_t ret = rcl_timer_clock((rcl_timer_t *)(uintptr_t)timer, &clock);
+  if (RCL_RET_OK != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  size_t group_index = queue->group_count;
+  size_t empty_group_index = queue->group_count;
+  for (size_t i = 0u; i < queue->group_count; ++i) {
+    if (queue->clock_groups[i].clock == clock) {
+      group_index = i;
+      break;
+    }
+    if (0u == queue->clock_groups[i].size) {
+      empty_group_index = i;
+    }
+  }
+  if (group_index == queue->group_count) {
+    if (empty_group_index < queue->group_count) {
+      // Every group holds at least one timer otherwise, so this happens before running out.
+      group_index = empty_group_index;
+    } else {
+      memset(&queue->clock_groups[group_index], 0, sizeof(rcl_timer_queue_group_t));
+      ++(queue->group_count);
+    }
+    queue->clock_groups[group_index].clock = clock;
+  }
+  rcl_timer_queue_group_t * group = &queue->clock_groups[group_index];
+  if (group->size == group->capacity) {
+    size_t new_capacity = group->capacity > 0u ? 2u * group->capacity : 4u;
+    if (new_capacity > queue->capacity) {
+      new_capacity = queue->capacity;
+    }
+    size_t * heap = (size_t *)queue->allocator.reallocate(
+      group->heap, sizeof(size_t) * new_capacity, queue->allocator.state);
+    RCL_CHECK_FOR_NULL_WITH_MSG(heap, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+    group->heap = heap;
+    group->capacity = new_capacity;
+  }
+  queue->timers[index] = timer;
+  queue->deadlines[index] = __timer_queue_read_deadline(timer);
+  queue->groups[index] = group_index;
+  queue->positions[index] = group->size;
+  group->heap[group->size++] = index;
+  __timer_queue_sift_up(queue, group, queue->positions[index]);
+  return RCL_RET_OK;
+}
+
+void
+rcl_timer_queue_remove(rcl_timer_queue_t * queue, size_t index)
+{
+  rcl_timer_queue_group_t * group = &queue->clock_groups[queue->groups[index]];
+  const size_t position = queue->positions[index];
+  const size_t last = --(group->size);
+  if (position != last) {
+    __timer_queue_swap(queue, group, position, last);
+    __timer_queue_sift_down(queue, group, position);
+    __timer_queue_sift_up(queue, group, position);
+  }
+  queue->timers[index] = NULL;
+}
+
+void
+rcl_timer_queue_update(rcl_timer_queue_t * queue, size_t index)
+{
+  rcl_timer_queue_group_t * group = &queue->clock_groups[queue->groups[index]];
+  queue->deadlines[index] = __timer_queue_read_deadline(queue->timers[index]);
+  __timer_queue_sift_down(queue, group, queue->positions[index]);
+  __timer_queue_sift_up(queue, group, queue->positions[index]);
+}
+
+rcl_ret_t
+rcl_timer_queue_get_time_until_next_call(
+  rcl_timer_queue_t * queue,
+  int64_t * time_until_next_call,
+  const rcl_timer_t ** earliest_timer)
+{
+  *earliest_timer = NULL;
+  *time_until_next_call = INT64_MAX;
+  for (size_t i = 0u; i < queue->group_count; ++i) {
+    rcl_timer_queue_group_t * group = &queue->clock_groups[i];
+    __timer_queue_refresh_top(queue, group);
+    if (0u == group->size || INT64_MAX == queue->deadlines[group->heap[0]]) {
+      continue;
+    }
+    rcl_time_point_value_t now;
+    rcl_ret_t ret = rcl_clock_get_now(group->clock, &now);
+    if (RCL_RET_OK != ret) {
+      return ret;  // The rcl error state should already be set.
+    }
+    // Wake up when the first window of a timer, from its deadline to its
+    // deadline plus slack, ends. Only timers due before the end of the best
+    // window so far can end theirs earlier, so other subtrees are skipped.
+    size_t best = group->heap[0];
+    int64_t wake_time = INT64_MAX;
+    size_t stack_size = 0u;
+    queue->stack[stack_size++] = 0u;
+    while (stack_size > 0u) {
+      const size_t position = queue->stack[--stack_size];
+      const size_t slot = group->heap[position];
+      const int64_t window_end =
+        __timer_queue_add_slack(queue->deadlines[slot], queue->timers[slot]);
+      if (window_end < wake_time) {
+        wake_time = window_end;
+        best = slot;
+      }
+      const size_t left = 2u * position + 1u;
+      for (size_t child = left; child <= left + 1u && child < group->size; ++child) {
+        if (queue->deadlines[group->heap[child]] < wake_time) {
+          queue->stack[stack_size++] = child;
+        }
+      }
+    }
+    const int64_t time_until = wake_time - now;
+    if (NULL == *earliest_timer || time_until < *time_until_next_call) {
+      *time_until_next_call = time_until;
+      *earliest_timer = queue->timers[best];
+    }
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_timer_queue_get_ready(
+  rcl_timer_queue_t * queue,
+  size_t * ready_indices,
+  size_t * ready_count)
+{
+  *ready_count = 0u;
+  // The first half of the scratch space is the traversal stack, the second
+  // half collects slots whose deadline turned out to have moved.
+  size_t * stale = queue->stack + queue->capacity;
+  for (size_t i = 0u; i < queue->group_count; ++i) {
+    rcl_timer_queue_group_t * group = &queue->clock_groups[i];
+    __timer_queue_refresh_top(queue, group);
+    if (0u == group->size || INT64_MAX == queue->deadlines[group->heap[0]]) {
+      continue;
+    }
+    rcl_time_point_value_t now;
+    rcl_ret_t ret = rcl_clock_get_now(group->clock, &now);
+    if (RCL_RET_OK != ret) {
+      return ret;  // The rcl error state should already be set.
+    }
+    size_t stack_size = 0u;
+    size_t stale_count = 0u;
+    if (queue->deadlines[group->heap[0]] <= now) {
+      queue->stack[stack_size++] = 0u;
+    }
+    // Deadlines only go stale by moving later, so subtrees whose root is not
+    // due according to its recorded deadline cannot hold a due timer.
+    while (stack_size > 0u) {
+      const size_t position = queue->stack[--stack_size];
+      const size_t slot = group->heap[position];
+      const int64_t deadline = __timer_queue_read_deadline(queue->timers[slot]);
+      if (deadline <= now) {
+        ready_indices[(*ready_count)++] = slot;
+      } else {
+        stale[stale_count++] = slot;
+      }
+      const size_t left = 2u * position + 1u;
+      for (size_t child = left; child <= left + 1u && child < group->size; ++child) {
+        if (queue->deadlines[group->heap[child]] <= now) {
+          queue->stack[stack_size++] = child;
+        }
+      }
+    }
+    for (size_t j = 0u; j < stale_count; ++j) {
+      rcl_timer_queue_update(queue, stale[j]);
+    }
+  }
+  return RCL_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
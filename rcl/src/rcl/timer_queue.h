@@ -0,0 +1,122 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__TIMER_QUEUE_H_
+#define RCL__TIMER_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcl/allocator.h"
+#include "rcl/time.h"
+#include "rcl/timer.h"
+#include "rcl/types.h"
+
+/// Timers which share a clock, ordered by deadline in a binary min-heap.
+typedef struct rcl_timer_queue_group_s
+{
+  rcl_clock_t * clock;
+  /// Slot indices, the slot with the earliest deadline first.
+  size_t * heap;
+  size_t size;
+  size_t capacity;
+} rcl_timer_queue_group_t;
+
+/// Scheduler for the timers of a persistent wait set.
+/**
+ * Timers are stored in slots, addressed by their index in the wait set, and
+ * ordered per clock by the deadline they had when last looked at.
+ * A timer's deadline only moves earlier when it is reset or the clock jumps,
+ * and both trigger the timer's guard condition; callers then refresh the
+ * timer with rcl_timer_queue_update().
+ * Deadlines which moved later, because the timer was called, are corrected
+ * lazily once they reach the top of their heap.
+ */
+typedef struct rcl_timer_queue_s
+{
+  const rcl_timer_t ** timers;
+  /// Deadline of each slot, INT64_MAX for canceled timers.
+  int64_t * deadlines;
+  /// Group of each slot.
+  size_t * groups;
+  /// Position in the group heap of each slot.
+  size_t * positions;
+  /// Scratch space for rcl_timer_queue_get_ready().
+  size_t * stack;
+  size_t capacity;
+  rcl_timer_queue_group_t * clock_groups;
+  size_t group_count;
+  rcl_allocator_t allocator;
+} rcl_timer_queue_t;
+
+/// Return a rcl_timer_queue_t struct with members set to `NULL`.
+rcl_timer_queue_t
+rcl_get_zero_initialized_timer_queue(void);
+
+/// Remove all timers and make room for `capacity` slots, 0 releases all memory.
+rcl_ret_t
+rcl_timer_queue_resize(
+  rcl_timer_queue_t * queue,
+  size_t capacity,
+  rcl_allocator_t * allocator);
+
+/// Remove all timers.
+void
+rcl_timer_queue_clear(rcl_timer_queue_t * queue);
+
+/// Schedule `timer` in the free slot `index`.
+rcl_ret_t
+rcl_timer_queue_add(rcl_timer_queue_t * queue, size_t index, const rcl_timer_t * timer);
+
+/// Unschedule the timer in slot `index`.
+void
+rcl_timer_queue_remove(rcl_timer_queue_t * queue, size_t index);
+
+/// Reschedule the timer in slot `index` after its deadline changed.
+void
+rcl_timer_queue_update(rcl_timer_queue_t * queue, size_t index);
+
+/// Get the time until the earliest deadline plus slack, reading each clock once.
+/**
+ * `earliest_timer` is set to the timer whose deadline plus slack, see
+ * rcl_timer_set_slack(), comes first, or `NULL` if no timer is scheduled.
+ */
+rcl_ret_t
+rcl_timer_queue_get_time_until_next_call(
+  rcl_timer_queue_t * queue,
+  int64_t * time_until_next_call,
+  const rcl_timer_t ** earliest_timer);
+
+/// Get the slot indices of the timers which are ready, reading each clock once.
+/**
+ * `ready_indices` must have room for the capacity of the queue.
+ * Only heap nodes which are due are visited.
+ */
+rcl_ret_t
+rcl_timer_queue_get_ready(
+  rcl_timer_queue_t * queue,
+  size_t * ready_indices,
+  size_t * ready_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__TIMER_QUEUE_H_
@@ -0,0 +1,158 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __linux__
+// Needed for timerfd_create() and friends with strict C11.
+# define _GNU_SOURCE
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./timer_wakeup.h"
+
+#ifdef __linux__
+# include <errno.h>
+# include <sys/timerfd.h>
+# include <time.h>
+# include <unistd.h>
+#endif
+
+#include "rcl/error_handling.h"
+
+rcl_ret_t
+rcl_timer_wakeup_init(rcl_timer_wakeup_t * wakeup)
+{
+  wakeup->valid = false;
+  wakeup->steady_fd = -1;
+  wakeup->system_fd = -1;
+#ifdef __linux__
+  // A timerfd is bound to one clock, so each supported clock type gets its own.
+  wakeup->steady_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+  if (wakeup->steady_fd < 0) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("timerfd_create() failed: errno %d", errno);
+    return RCL_RET_ERROR;
+  }
+  wakeup->system_fd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC);
+  if (wakeup->system_fd < 0) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("timerfd_create() failed: errno %d", errno);
+    close(wakeup->steady_fd);
+    wakeup->steady_fd = -1;
+    return RCL_RET_ERROR;
+  }
+  wakeup->valid = true;
+  return RCL_RET_OK;
+#else
+  RCL_SET_ERROR_MSG("timerfd wake-ups are only supported on Linux");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
+
+void
+rcl_timer_wakeup_fini(rcl_timer_wakeup_t * wakeup)
+{
+#ifdef __linux__
+  if (wakeup->valid) {
+    close(wakeup->steady_fd);
+    close(wakeup->system_fd);
+  }
+#endif
+  wakeup->valid = false;
+  wakeup->steady_fd = -1;
+  wakeup->system_fd = -1;
+}
+
+bool
+rcl_timer_wakeup_supports_clock(rcl_clock_type_t clock_type)
+{
+#ifdef __linux__
+  // rcutils reads steady time from CLOCK_MONOTONIC and system time from CLOCK_REALTIME.
+  return RCL_STEADY_TIME == clock_type || RCL_SYSTEM_TIME == clock_type;
+#else
+  (void)clock_type;
+  return false;
+#endif
+}
+
+rcl_ret_t
+rcl_timer_wakeup_sleep_until(
+  rcl_timer_wakeup_t * wakeup,
+  rcl_clock_type_t clock_type,
+  int64_t deadline,
+  int64_t max_sleep)
+{
+#ifdef __linux__
+  if (!wakeup->valid || !rcl_timer_wakeup_supports_clock(clock_type)) {
+    RCL_SET_ERROR_MSG("timer wake-up is invalid or does not support the clock");
+    return RCL_RET_ERROR;
+  }
+  if (deadline <= 0 || max_sleep <= 0) {
+    // A zero deadline would disarm the timer, and it is in the past anyway.
+    return RCL_RET_OK;
+  }
+  const bool system_time = RCL_SYSTEM_TIME == clock_type;
+  int fd = system_time ? wakeup->system_fd : wakeup->steady_fd;
+  // Setting the system clock cancels the timer, rather than leaving it armed at a
+  // deadline which may now be far away.
+  int flags = system_time ? TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET : TFD_TIMER_ABSTIME;
+  struct timespec now;
+  if (0 != clock_gettime(system_time ? CLOCK_REALTIME : CLOCK_MONOTONIC, &now)) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("clock_gettime() failed: errno %d", errno);
+    return RCL_RET_ERROR;
+  }
+  const int64_t now_ns = (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+  if (deadline > now_ns && deadline - now_ns > max_sleep) {
+    // Whatever the deadline, the sleep is bounded on the steady clock.
+    fd = wakeup->steady_fd;
+    flags = 0;
+    deadline = max_sleep;
+  }
+  struct itimerspec spec = {
+    .it_interval = {.tv_sec = 0, .tv_nsec = 0},
+    .it_value = {
+      .tv_sec = (time_t)(deadline / 1000000000),
+      .tv_nsec = (long)(deadline % 1000000000)
+    }
+  };
+  if (0 != timerfd_settime(fd, flags, &spec, NULL)) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("timerfd_settime() failed: errno %d", errno);
+    return RCL_RET_ERROR;
+  }
+  // Deadlines in the past expire immediately, so the read never blocks for them.
+  uint64_t expirations = 0;
+  while (read(fd, &expirations, sizeof(expirations)) < 0) {
+    if (ECANCELED == errno) {
+      break;  // The system clock was set, the caller compares the deadline with it again.
+    }
+    if (EINTR != errno) {
+      RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("reading timerfd failed: errno %d", errno);
+      return RCL_RET_ERROR;
+    }
+  }
+  return RCL_RET_OK;
+#else
+  (void)wakeup;
+  (void)clock_type;
+  (void)deadline;
+  (void)max_sleep;
+  RCL_SET_ERROR_MSG("timerfd wake-ups are only supported on Linux");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,73 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__TIMER_WAKEUP_H_
+#define RCL__TIMER_WAKEUP_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rcl/time.h"
+#include "rcl/types.h"
+
+/// Kernel timer used to sleep until an absolute deadline of a steady or system clock.
+/**
+ * On Linux this is a timerfd armed with `TFD_TIMER_ABSTIME`, which wakes up
+ * at the deadline itself instead of after a relative timeout computed from a
+ * clock reading taken earlier.
+ * Other platforms do not support it.
+ */
+typedef struct rcl_timer_wakeup_s
+{
+  bool valid;
+  /// timerfd bound to the clock of RCL_STEADY_TIME.
+  int steady_fd;
+  /// timerfd bound to the clock of RCL_SYSTEM_TIME.
+  int system_fd;
+} rcl_timer_wakeup_t;
+
+/// Create the kernel timers, returns #RCL_RET_UNSUPPORTED if the platform has none.
+rcl_ret_t
+rcl_timer_wakeup_init(rcl_timer_wakeup_t * wakeup);
+
+/// Release the kernel timers, does nothing if it is not valid.
+void
+rcl_timer_wakeup_fini(rcl_timer_wakeup_t * wakeup);
+
+/// Return `true` if deadlines of clocks of the given type can be waited for.
+bool
+rcl_timer_wakeup_supports_clock(rcl_clock_type_t clock_type);
+
+/// Block until `deadline`, in nanoseconds of a clock of the given type, has passed.
+/**
+ * The sleep lasts at most `max_sleep` nanoseconds of the steady clock, and
+ * ends early when the system clock is set while waiting for a system deadline.
+ */
+rcl_ret_t
+rcl_timer_wakeup_sleep_until(
+  rcl_timer_wakeup_t * wakeup,
+  rcl_clock_type_t clock_type,
+  int64_t deadline,
+  int64_t max_sleep);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__TIMER_WAKEUP_H_
@@ -0,0 +1,136 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__TRAFFIC_COUNTERS_H_
+#define RCL__TRAFFIC_COUNTERS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcl/allocator.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/time.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Counters of the messages going through a publisher or a subscription.
+//
+// Counters are updated with relaxed atomics: nothing is ordered against them,
+// so a reader may see a message counted before its bytes, but never a torn value.
+//
+// Defining RCL_DISABLE_TRAFFIC_COUNTERS when building rcl removes the counters,
+// the traffic_counters pointer of publishers and subscriptions stays NULL and
+// the RCL_TRAFFIC_* macros expand to nothing.
+//
+// The steady time of the last message is only read when RCL_ENABLE_TRAFFIC_TIMESTAMPS
+// is defined, a clock read costs more than the counters themselves.
+typedef struct rcl_traffic_counters_s rcl_traffic_counters_t;
+
+static inline void
+rcl_traffic_counters_destroy(rcl_traffic_counters_t * counters, const rcl_allocator_t * allocator)
+{
+  if (NULL != counters) {
+    allocator->deallocate(counters, allocator->state);
+  }
+}
+
+#ifndef RCL_DISABLE_TRAFFIC_COUNTERS
+
+struct rcl_traffic_counters_s
+{
+  atomic_uint_least64_t message_count;
+  atomic_uint_least64_t byte_count;
+  atomic_uint_least64_t loan_count;
+  atomic_uint_least64_t take_failed_count;
+  atomic_uint_least64_t error_count;
+  // Steady time of the last message counted, 0 until then or without RCL_ENABLE_TRAFFIC_TIMESTAMPS.
+  atomic_int_least64_t last_activity_time;
+};
+
+// Return counters set to zero, or NULL if allocating them failed.
+static inline rcl_traffic_counters_t *
+rcl_traffic_counters_create(const rcl_allocator_t * allocator)
+{
+  rcl_traffic_counters_t * counters = (rcl_traffic_counters_t *)allocator->allocate(
+    sizeof(rcl_traffic_counters_t), allocator->state);
+  if (NULL != counters) {
+    atomic_init(&counters->message_count, 0u);
+    atomic_init(&counters->byte_count, 0u);
+    atomic_init(&counters->loan_count, 0u);
+    atomic_init(&counters->take_failed_count, 0u);
+    atomic_init(&counters->error_count, 0u);
+    atomic_init(&counters->last_activity_time, 0);
+  }
+  return counters;
+}
+
+static inline void
+rcl_traffic_counters_add(atomic_uint_least64_t * counter, uint64_t value)
+{
+  atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+}
+
+static inline uint64_t
+rcl_traffic_counters_load(atomic_uint_least64_t * counter)
+{
+  return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+static inline int64_t
+rcl_traffic_counters_load_last_activity_time(rcl_traffic_counters_t * counters)
+{
+  return atomic_load_explicit(&counters->last_activity_time, memory_order_relaxed);
+}
+
+static inline void
+rcl_traffic_counters_count_messages(rcl_traffic_counters_t * counters, size_t count, size_t bytes)
+{
+  rcl_traffic_counters_add(&counters->message_count, count);
+  if (0u != bytes) {
+    rcl_traffic_counters_add(&counters->byte_count, bytes);
+  }
+#ifdef RCL_ENABLE_TRAFFIC_TIMESTAMPS
+  rcutils_time_point_value_t now;
+  if (RCUTILS_RET_OK == rcutils_steady_time_now(&now)) {
+    atomic_store_explicit(&counters->last_activity_time, now, memory_order_relaxed);
+  }
+#endif
+}
+
+# define RCL_TRAFFIC_COUNT_MESSAGES(impl, count, bytes) \
+  rcl_traffic_counters_count_messages((impl)->traffic_counters, (count), (bytes))
+# define RCL_TRAFFIC_COUNT_LOAN(impl) \
+  rcl_traffic_counters_add(&(impl)->traffic_counters->loan_count, 1u)
+# define RCL_TRAFFIC_COUNT_TAKE_FAILED(impl) \
+  rcl_traffic_counters_add(&(impl)->traffic_counters->take_failed_count, 1u)
+# define RCL_TRAFFIC_COUNT_ERROR(impl) \
+  rcl_traffic_counters_add(&(impl)->traffic_counters->error_count, 1u)
+
+#else  // RCL_DISABLE_TRAFFIC_COUNTERS
+
+# define RCL_TRAFFIC_COUNT_MESSAGES(impl, count, bytes) ((void)0)
+# define RCL_TRAFFIC_COUNT_LOAN(impl) ((void)0)
+# define RCL_TRAFFIC_COUNT_TAKE_FAILED(impl) ((void)0)
+# define RCL_TRAFFIC_COUNT_ERROR(impl) ((void)0)
+
+#endif  // RCL_DISABLE_TRAFFIC_COUNTERS
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__TRAFFIC_COUNTERS_H_
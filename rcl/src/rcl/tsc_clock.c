@@ -0,0 +1,432 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./tsc_clock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/time.h"
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+# define RCL_TSC_CLOCK_X86
+# ifdef _MSC_VER
+#  include <intrin.h>
+# else
+#  include <cpuid.h>
+#  include <x86intrin.h>
+# endif
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+# define RCL_TSC_CLOCK_AARCH64
+#endif
+
+// How long the counter is compared against the steady clock to measure its rate.
+#define RCL_TSC_CLOCK_CALIBRATION_NS RCUTILS_MS_TO_NS(20)
+// Number of counter reads around a steady clock read when calibrating, the tightest pair is kept.
+#define RCL_TSC_CLOCK_SAMPLE_TRIES 8
+// How often the counter is re-anchored to the steady clock, which bounds the drift.
+#define RCL_TSC_CLOCK_RESYNC_NS RCUTILS_MS_TO_NS(500)
+// Largest offset from the steady clock caught up with by adjusting the rate until the
+// next re-anchoring, i.e. by 0.1 percent at most; a larger lag is stepped over, while
+// a larger lead is caught up with at that rate over several re-anchorings.
+#define RCL_TSC_CLOCK_MAX_SLEW_NS (RCL_TSC_CLOCK_RESYNC_NS / 1000)
+// Widest steady clock read a re-anchoring measures the rate with, wider ones were
+// likely preempted.
+#define RCL_TSC_CLOCK_MAX_SAMPLE_NS RCUTILS_US_TO_NS(10)
+
+#define RCL_TSC_CLOCK_UNCALIBRATED 0u
+#define RCL_TSC_CLOCK_CALIBRATING 1u
+#define RCL_TSC_CLOCK_SUPPORTED 2u
+#define RCL_TSC_CLOCK_UNSUPPORTED 3u
+
+// Steady time = base_ns + (ticks - base_ticks) * mult / 2^shift
+typedef struct rcl_tsc_calibration_s
+{
+  uint64_t base_ticks;
+  rcl_time_point_value_t base_ns;
+  uint64_t mult;
+  unsigned int shift;
+  // last reading of the counter and the steady clock at the same instant
+  uint64_t sample_ticks;
+  rcl_time_point_value_t sample_ns;
+} rcl_tsc_calibration_t;
+
+static atomic_uint_least64_t __rcl_tsc_state = ATOMIC_VAR_INIT(RCL_TSC_CLOCK_UNCALIBRATED);
+// Only touched by the thread holding __rcl_tsc_resyncing, or calibrating.
+static rcl_tsc_calibration_t __rcl_tsc_calibration;
+static atomic_bool __rcl_tsc_resyncing = ATOMIC_VAR_INIT(false);
+// Written once by the calibrating thread, before the state is published.
+static unsigned int __rcl_tsc_shift;
+static uint64_t __rcl_tsc_resync_ticks;
+static uint64_t __rcl_tsc_max_sample_ticks;
+// Calibration read by rcl_tsc_clock_now(), under a sequence lock which is odd while the
+// calibration is being re-anchored.
+static atomic_uint_least64_t __rcl_tsc_sequence = ATOMIC_VAR_INIT(0u);
+static atomic_uint_least64_t __rcl_tsc_base_ticks = ATOMIC_VAR_INIT(0u);
+static atomic_uint_least64_t __rcl_tsc_base_ns = ATOMIC_VAR_INIT(0u);
+static atomic_uint_least64_t __rcl_tsc_mult = ATOMIC_VAR_INIT(0u);
+
+#if defined(RCL_TSC_CLOCK_X86) || defined(RCL_TSC_CLOCK_AARCH64)
+static inline uint64_t
+__tsc_read(void)
+{
+#ifdef RCL_TSC_CLOCK_X86
+  return __rdtsc();
+#else
+  uint64_t ticks;
+  // The barrier keeps the read from being executed ahead of earlier instructions.
+  __asm__ __volatile__ ("isb\n\tmrs %0, cntvct_el0" : "=r" (ticks) : : "memory");
+  return ticks;
+#endif
+}
+
+// Whether the counter ticks at a constant rate, regardless of power states.
+static bool
+__tsc_is_invariant(void)
+{
+#ifdef __linux__
+  // The kernel switches away from the TSC when it finds it unstable or unsynchronized.
+  FILE * file = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+  if (NULL != file) {
+    char name[32] = {0};
+    const bool read = NULL != fgets(name, sizeof(name), file);
+    fclose(file);
+#ifdef RCL_TSC_CLOCK_X86
+    if (read && 0 != strncmp(name, "tsc", 3)) {
+      return false;
+    }
+#else
+    if (read && 0 != strncmp(name, "arch_sys_counter", 16)) {
+      return false;
+    }
+#endif
+  }
+#endif
+#ifdef RCL_TSC_CLOCK_X86
+  // CPUID.80000007H:EDX[8] is the invariant TSC flag.
+# ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0x80000000);
+  if ((unsigned int)info[0] < 0x80000007u) {
+    return false;
+  }
+  __cpuid(info, 0x80000007);
+  return 0 != ((unsigned int)info[3] & (1u << 8));
+# else
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx)) {
+    return false;
+  }
+  return 0 != (edx & (1u << 8));
+# endif
+#else
+  // The generic timer of the architecture always runs at a constant rate.
+  return true;
+#endif
+}
+
+// Read the counter and the steady clock at the same instant, as closely as `tries` allow.
+static bool
+__tsc_sample(uint64_t * ticks, rcl_time_point_value_t * ns, int tries, uint64_t * width)
+{
+  uint64_t best_width = UINT64_MAX;
+  for (int i = 0; i < tries; ++i) {
+    rcutils_time_point_value_t now;
+    const uint64_t before = __tsc_read();
+    if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+      rcutils_reset_error();
+      return false;
+    }
+    const uint64_t after = __tsc_read();
+    if (after >= before && after - before < best_width) {
+      best_width = after - before;
+      *ticks = before + best_width / 2u;
+      *ns = now;
+    }
+  }
+  if (NULL != width) {
+    *width = best_width;
+  }
+  return UINT64_MAX != best_width;
+}
+
+static bool
+__tsc_calibrate(rcl_tsc_calibration_t * calibration)
+{
+  if (!__tsc_is_invariant()) {
+    return false;
+  }
+  uint64_t start_ticks;
+  rcl_time_point_value_t start_ns;
+  if (!__tsc_sample(&start_ticks, &start_ns, RCL_TSC_CLOCK_SAMPLE_TRIES, NULL)) {
+    return false;
+  }
+  double ns_per_tick;
+#ifdef RCL_TSC_CLOCK_X86
+  // The rate of the TSC is not reliably reported, so it is measured.
+  uint64_t end_ticks;
+  rcl_time_point_value_t end_ns;
+  do {
+    if (!__tsc_sample(&end_ticks, &end_ns, RCL_TSC_CLOCK_SAMPLE_TRIES, NULL)) {
+      return false;
+    }
+  } while (end_ns - start_ns < RCL_TSC_CLOCK_CALIBRATION_NS);
+  if (end_ticks <= start_ticks) {
+    return false;
+  }
+  ns_per_tick = (double)(end_ns - start_ns) / (double)(end_ticks - start_ticks);
+  start_ticks = end_ticks;
+  start_ns = end_ns;
+#else
+  uint64_t frequency;
+  __asm__ __volatile__ ("mrs %0, cntfrq_el0" : "=r" (frequency));
+  if (0u == frequency) {
+    return false;
+  }
+  ns_per_tick = 1e9 / (double)frequency;
+#endif
+  // The largest shift keeping the multiplier within 31 bits, so the conversion cannot
+  // overflow even with the rate adjusted: see __tsc_convert() and __tsc_resync().
+  unsigned int shift = 32u;
+  uint64_t mult = (uint64_t)(ns_per_tick * (double)(1ull << shift) + 0.5);
+  while (shift > 0u && mult > UINT32_MAX / 2u) {
+    --shift;
+    mult = (uint64_t)(ns_per_tick * (double)(1ull << shift) + 0.5);
+  }
+  if (0u == mult || mult > UINT32_MAX / 2u) {
+    return false;
+  }
+  calibration->base_ticks = start_ticks;
+  calibration->base_ns = start_ns;
+  calibration->mult = mult;
+  calibration->shift = shift;
+  calibration->sample_ticks = start_ticks;
+  calibration->sample_ns = start_ns;
+  __rcl_tsc_shift = shift;
+  __rcl_tsc_resync_ticks = (uint64_t)((double)RCL_TSC_CLOCK_RESYNC_NS / ns_per_tick);
+  __rcl_tsc_max_sample_ticks = (uint64_t)((double)RCL_TSC_CLOCK_MAX_SAMPLE_NS / ns_per_tick);
+  return true;
+}
+
+static rcl_time_point_value_t
+__tsc_convert(const rcl_tsc_calibration_t * calibration, uint64_t ticks)
+{
+  uint64_t delta = ticks - calibration->base_ticks;
+  if ((int64_t)delta < 0) {
+    // A core whose counter lags slightly behind the one which anchored.
+    delta = 0u;
+  }
+  // Split the product so neither part exceeds 64 bits, the low part has `shift` bits
+  // and the multiplier at most 32.
+  const uint64_t high = delta >> calibration->shift;
+  const uint64_t low = delta & ((1ull << calibration->shift) - 1u);
+  return calibration->base_ns +
+         (rcl_time_point_value_t)(high * calibration->mult +
+         ((low * calibration->mult) >> calibration->shift));
+}
+
+// Publish a calibration re-anchored at the current counter value.
+// The new anchor is never below what `previous` reads there: readers read the counter
+// under the sequence lock, so any reading of the previous calibration was taken before.
+static void
+__tsc_publish(rcl_tsc_calibration_t * calibration, const rcl_tsc_calibration_t * previous)
+{
+  (void)rcutils_atomic_fetch_add_uint64_t(&__rcl_tsc_sequence, 1u);
+  const uint64_t ticks = __tsc_read();
+  rcl_time_point_value_t base_ns = __tsc_convert(calibration, ticks);
+  if (NULL != previous) {
+    const rcl_time_point_value_t previous_ns = __tsc_convert(previous, ticks);
+    base_ns = base_ns < previous_ns ? previous_ns : base_ns;
+  }
+  calibration->base_ticks = ticks;
+  calibration->base_ns = base_ns;
+  rcutils_atomic_store(&__rcl_tsc_base_ticks, calibration->base_ticks);
+  rcutils_atomic_store(&__rcl_tsc_base_ns, (uint64_t)calibration->base_ns);
+  rcutils_atomic_store(&__rcl_tsc_mult, calibration->mult);
+  (void)rcutils_atomic_fetch_add_uint64_t(&__rcl_tsc_sequence, 1u);
+}
+
+// Load the calibration and read the counter, both under the sequence lock.
+static uint64_t
+__tsc_load(rcl_tsc_calibration_t * calibration)
+{
+  uint64_t sequence;
+  uint64_t ticks;
+  do {
+    sequence = rcutils_atomic_load_uint64_t(&__rcl_tsc_sequence);
+    calibration->base_ticks = rcutils_atomic_load_uint64_t(&__rcl_tsc_base_ticks);
+    calibration->base_ns = (rcl_time_point_value_t)rcutils_atomic_load_uint64_t(&__rcl_tsc_base_ns);
+    calibration->mult = rcutils_atomic_load_uint64_t(&__rcl_tsc_mult);
+    ticks = __tsc_read();
+  } while (0u != (sequence & 1u) || sequence != rcutils_atomic_load_uint64_t(&__rcl_tsc_sequence));
+  calibration->shift = __rcl_tsc_shift;
+  return ticks;
+}
+
+// Re-anchor the counter to the steady clock, from a single steady clock read.
+// Readings stay continuous: the rate is adjusted so that the offset from the steady clock
+// is caught up with by the next re-anchoring. A lag too large for that, e.g. because the
+// counter went unread for long, is stepped over, but readings are never stepped back.
+static void
+__tsc_resync(void)
+{
+  rcl_tsc_calibration_t * calibration = &__rcl_tsc_calibration;
+  const rcl_tsc_calibration_t previous = *calibration;
+  uint64_t ticks;
+  rcl_time_point_value_t steady_ns;
+  uint64_t width;
+  if (
+    !__tsc_sample(&ticks, &steady_ns, 1, &width) || width > __rcl_tsc_max_sample_ticks ||
+    ticks <= calibration->sample_ticks || steady_ns <= calibration->sample_ns)
+  {
+    // Keep the rate, but move the anchor so that this is only retried an interval later.
+    __tsc_publish(calibration, &previous);
+    return;
+  }
+  // Rate of the counter since the previous sample, in the fixed point of the multiplier.
+  uint64_t elapsed_ns = (uint64_t)(steady_ns - calibration->sample_ns);
+  uint64_t elapsed_ticks = ticks - calibration->sample_ticks;
+  while (elapsed_ns > (UINT64_MAX >> calibration->shift)) {
+    elapsed_ns >>= 1u;
+    elapsed_ticks >>= 1u;
+  }
+  const uint64_t rate =
+    0u == elapsed_ticks ? 0u : (elapsed_ns << calibration->shift) / elapsed_ticks;
+  const rcl_time_point_value_t tsc_ns = __tsc_convert(calibration, ticks);
+  rcl_time_point_value_t offset = steady_ns - tsc_ns;
+  calibration->base_ticks = ticks;
+  calibration->base_ns = tsc_ns;
+  calibration->sample_ticks = ticks;
+  calibration->sample_ns = steady_ns;
+  if (offset > RCL_TSC_CLOCK_MAX_SLEW_NS) {
+    calibration->base_ns = steady_ns;
+    offset = 0;
+  } else if (offset < -RCL_TSC_CLOCK_MAX_SLEW_NS) {
+    offset = -RCL_TSC_CLOCK_MAX_SLEW_NS;
+  }
+  if (0u != rate && rate <= UINT32_MAX) {
+    const int64_t mult = (int64_t)rate + (int64_t)rate * offset / RCL_TSC_CLOCK_RESYNC_NS;
+    if (0 < mult && mult <= (int64_t)UINT32_MAX) {
+      calibration->mult = (uint64_t)mult;
+    }
+  }
+  __tsc_publish(calibration, &previous);
+}
+
+// Let the thread calibrating the counter run.
+static void
+__tsc_yield(void)
+{
+#ifdef _WIN32
+  (void)SwitchToThread();
+#else
+  (void)sched_yield();
+#endif
+}
+#endif
+
+bool
+rcl_tsc_clock_is_supported(void)
+{
+  uint64_t state = rcutils_atomic_load_uint64_t(&__rcl_tsc_state);
+  if (
+    RCL_TSC_CLOCK_UNCALIBRATED == state &&
+    rcutils_atomic_compare_exchange_strong_uint_least64_t(
+      &__rcl_tsc_state, &state, RCL_TSC_CLOCK_CALIBRATING))
+  {
+#if defined(RCL_TSC_CLOCK_X86) || defined(RCL_TSC_CLOCK_AARCH64)
+    const bool supported = __tsc_calibrate(&__rcl_tsc_calibration);
+    if (supported) {
+      __tsc_publish(&__rcl_tsc_calibration, NULL);
+    }
+#else
+    const bool supported = false;
+#endif
+    state = supported ? RCL_TSC_CLOCK_SUPPORTED : RCL_TSC_CLOCK_UNSUPPORTED;
+    rcutils_atomic_store(&__rcl_tsc_state, state);
+  }
+  // Another thread is calibrating, which only happens once per process.
+  while (RCL_TSC_CLOCK_CALIBRATING == state) {
+#if defined(RCL_TSC_CLOCK_X86) || defined(RCL_TSC_CLOCK_AARCH64)
+    __tsc_yield();
+#endif
+    state = rcutils_atomic_load_uint64_t(&__rcl_tsc_state);
+  }
+  return RCL_TSC_CLOCK_SUPPORTED == state;
+}
+
+rcl_time_point_value_t
+rcl_tsc_clock_now(void)
+{
+#if defined(RCL_TSC_CLOCK_X86) || defined(RCL_TSC_CLOCK_AARCH64)
+  rcl_tsc_calibration_t calibration;
+  uint64_t ticks = __tsc_load(&calibration);
+  if (
+    ticks - calibration.base_ticks >= __rcl_tsc_resync_ticks &&
+    !rcutils_atomic_exchange_bool(&__rcl_tsc_resyncing, true))
+  {
+    __tsc_resync();
+    rcutils_atomic_store(&__rcl_tsc_resyncing, false);
+    ticks = __tsc_load(&calibration);
+  }
+  return __tsc_convert(&calibration, ticks);
+#else
+  return 0;
+#endif
+}
+
+rcl_ret_t
+rcl_tsc_clock_get_now(void * data, rcl_time_point_value_t * current_time)
+{
+  (void)data;  // unused
+  *current_time = rcl_tsc_clock_now();
+  return RCL_RET_OK;
+}
+
+rcl_time_point_value_t
+rcl_tsc_clock_to_steady_time(rcl_time_point_value_t time_point)
+{
+  const rcl_time_point_value_t tsc_now = rcl_tsc_clock_now();
+  rcutils_time_point_value_t steady_now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&steady_now)) {
+    rcutils_reset_error();
+    return time_point;
+  }
+  const rcl_time_point_value_t offset = steady_now - tsc_now;
+  if (offset > 0 && time_point > INT64_MAX - offset) {
+    return INT64_MAX;
+  }
+  if (offset < 0 && time_point < INT64_MIN - offset) {
+    return INT64_MIN;
+  }
+  return time_point + offset;
+}
+
+#ifdef __cplusplus
+}
+#endif
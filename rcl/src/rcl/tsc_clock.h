@@ -0,0 +1,70 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__TSC_CLOCK_H_
+#define RCL__TSC_CLOCK_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+
+#include "rcl/time.h"
+#include "rcl/types.h"
+
+/// Check whether the CPU timestamp counter can be read as steady time.
+/**
+ * The counter has to run at a constant rate, which is checked on x86 with
+ * the invariant TSC flag, and on Linux the kernel must not have dismissed
+ * it as a clock source.
+ * The first call calibrates the counter against the steady clock, which
+ * takes about 20 milliseconds on x86, concurrent calls wait for it.
+ */
+bool
+rcl_tsc_clock_is_supported(void);
+
+/// Read the timestamp counter as nanoseconds of the steady clock.
+/**
+ * Only valid once rcl_tsc_clock_is_supported() returned `true`.
+ *
+ * The counter is re-anchored to the steady clock by the first read every
+ * 500 milliseconds, from a single steady clock read, adjusting its rate so
+ * that it catches up with the offset it drifted by, which keeps it within a
+ * few microseconds of the steady clock.
+ * Re-anchoring never steps readings back, and a thread never reads the clock
+ * going backwards as long as the counters of the cores are in step, which
+ * the kernel checks before using them as its clock source.
+ */
+rcl_time_point_value_t
+rcl_tsc_clock_now(void);
+
+/// The get_now function of clocks reading the timestamp counter.
+rcl_ret_t
+rcl_tsc_clock_get_now(void * data, rcl_time_point_value_t * current_time);
+
+/// Translate a time read from the timestamp counter to the steady clock.
+/**
+ * E.g. to arm a kernel timer of the steady clock with a deadline of a clock
+ * reading the counter, which may be a few microseconds apart.
+ */
+rcl_time_point_value_t
+rcl_tsc_clock_to_steady_time(rcl_time_point_value_t time_point);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__TSC_CLOCK_H_
@@ -22,22 +22,77 @@ extern "C"
 #include <assert.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "rcl/error_handling.h"
 #include "rcl/time.h"
 #include "rcutils/logging_macros.h"
+#include "rcutils/time.h"
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
 #include "rmw/event.h"
 
+#include "./clock_snapshot.h"
+#include "./common.h"
 #include "./context_impl.h"
+#include "./intra_context.h"
+#include "./ros_time_source.h"
+#include "./subscription_impl.h"
+#include "./time_driver_impl.h"
+#include "./timer_queue.h"
+#include "./timer_wakeup.h"
+#include "./traffic_counters.h"
+#include "./tsc_clock.h"
+#include "./wait_statistics.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+# include <immintrin.h>
+# define RCL_WAIT_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+# define RCL_WAIT_CPU_RELAX() __asm__ __volatile__ ("yield")
+#else
+# define RCL_WAIT_CPU_RELAX()
+#endif
+
+// Fixed point one of the adaptive spin success rate.
+#define RCL_WAIT_SPIN_RATE_ONE 1024
+// Weight of the newest poll in the success rate, as a power of two.
+#define RCL_WAIT_SPIN_RATE_SHIFT 3
+// The spin budget never drops below this fraction of the maximum, so success is still noticed.
+#define RCL_WAIT_SPIN_MIN_BUDGET_DIVISOR 16
+// Upper bound of the number of pause instructions between two polls.
+#define RCL_WAIT_SPIN_MAX_PAUSES 64
+
+// Membership bookkeeping for one entity type of a persistent wait set.
+typedef struct rcl_wait_set_persistent_entities_s
+{
+  // rmw handles of the registered entities, packed at the front of the array
+  void ** rmw_handles;
+  // index into the rcl storage array of each packed rmw handle
+  size_t * rcl_indices;
+  // position in the packed arrays of each rcl storage index
+  size_t * packed_positions;
+  // number of packed (registered) entities
+  size_t count;
+  // rcl storage indices released by removals, reused by later additions
+  size_t * free_indices;
+  // number of released rcl storage indices
+  size_t free_count;
+  // rcl storage indices of the entities found ready by the last rcl_wait
+  size_t * ready_indices;
+  // number of ready entities found by the last rcl_wait
+  size_t ready_count;
+} rcl_wait_set_persistent_entities_t;
 
 struct rcl_wait_set_impl_s
 {
   // number of subscriptions that have been added to the wait set
   size_t subscription_index;
   rmw_subscriptions_t rmw_subscriptions;
+  // rmw guard condition of each subscription receiving within its context, or NULL,
+  // appended to the rmw guard conditions after those of the timers
+  void ** subscription_guard_conditions;
   // number of guard_conditions that have been added to the wait set
   size_t guard_condition_index;
   rmw_guard_conditions_t rmw_guard_conditions;
@@ -58,8 +113,158 @@ struct rcl_wait_set_impl_s
   rcl_context_t * context;
   // allocator used in the wait set
   rcl_allocator_t allocator;
+  // whether entities stay registered across calls to rcl_wait
+  bool persistent;
+  // per type membership, only allocated when the wait set is persistent
+  rcl_wait_set_persistent_entities_t subscription_persistent;
+  rcl_wait_set_persistent_entities_t guard_condition_persistent;
+  rcl_wait_set_persistent_entities_t timer_persistent;
+  rcl_wait_set_persistent_entities_t client_persistent;
+  rcl_wait_set_persistent_entities_t service_persistent;
+  rcl_wait_set_persistent_entities_t event_persistent;
+  // deadline ordered timers, only allocated when the wait set is persistent
+  rcl_timer_queue_t timer_queue;
+  // kernel timer finishing waits for steady and system timer deadlines, opt-in
+  rcl_timer_wakeup_t timer_wakeup;
+  // how long before such a deadline rmw_wait() hands over to the kernel timer
+  int64_t timer_wakeup_margin;
+  // counters about calls to rcl_wait, opt-in
+  rcl_wait_statistics_t * statistics;
+  // longest time rcl_wait polls before blocking, 0 if it always blocks
+  int64_t spin_max_budget;
+  // whether to back off with pause instructions between polls
+  bool spin_use_pause;
+  // recent rate at which polling found something ready, out of RCL_WAIT_SPIN_RATE_ONE
+  int32_t spin_success_rate;
+  // copy of the rmw storage, restored after each poll which found nothing ready
+  void ** spin_backup;
+  // driver advancing ROS time while the wait set is blocked, opt-in
+  rcl_time_driver_t * time_driver;
+  // state of the wait set in the time driver
+  rcl_time_driver_slot_t * time_driver_slot;
+  // single block holding the rcl and rmw storage of every entity type and the spin backup
+  void * arena;
+  // number of entities of each type the arena has room for
+  size_t subscription_capacity;
+  size_t guard_condition_capacity;
+  size_t timer_capacity;
+  size_t client_capacity;
+  size_t service_capacity;
+  size_t event_capacity;
+  // wait set this one is a child of, NULL for the root of a hierarchy
+  rcl_wait_set_t * parent;
+  // slot of this wait set among the children of its parent
+  size_t parent_slot;
+  // whether the parent lists this wait set among its ready children after the last rcl_wait
+  bool ready_in_parent;
+  // child wait sets, NULL in the slots released by removals
+  rcl_wait_set_t ** children;
+  // number of child slots in use, including released ones
+  size_t child_slot_count;
+  // number of child slots allocated
+  size_t child_slot_capacity;
+  // number of children
+  size_t child_count;
+  // slots of the children which had ready entities in the last rcl_wait
+  size_t * ready_children;
+  // number of children which had ready entities in the last rcl_wait
+  size_t ready_child_count;
+  // persistent wait set mirroring the entities of the whole hierarchy, only kept by its root
+  rcl_wait_set_t * flattened;
+  // whether entities are missing from the flattened wait set, which is rebuilt by rcl_wait
+  bool flattened_stale;
+  // wait set and storage index of each entity of the flattened wait set, by its key offsets
+  rcl_wait_set_t ** flattened_owners;
+  size_t * flattened_owner_indices;
+  // index + 1 in the flattened wait set of the root of each storage slot, or 0 if it is
+  // not mirrored, by key offset; see __wait_set_hierarchy_track()
+  size_t * hierarchy_positions;
+  // whether rcl_wait sorts the ready entities by key, opt-in
+  bool ready_list_enabled;
+  // key of each storage slot, in the order of rcl_wait_set_entity_type_t, by capacity
+  int64_t * entity_keys;
+  // ready entities found by the last rcl_wait, by ascending key
+  rcl_wait_set_ready_entry_t * ready_list;
+  // number of entries in the ready list
+  size_t ready_list_count;
 };
 
+static void
+__wait_set_persistent_reset(rcl_wait_set_persistent_entities_t * entities)
+{
+  entities->count = 0u;
+  entities->free_count = 0u;
+  entities->ready_count = 0u;
+}
+
+static bool
+__wait_set_persistent_resize(
+  rcl_wait_set_persistent_entities_t * entities,
+  size_t size,
+  rcl_allocator_t * allocator)
+{
+  __wait_set_persistent_reset(entities);
+  if (0u == size) {
+    if (entities->rmw_handles) {
+      allocator->deallocate(entities->rmw_handles, allocator->state);
+    }
+    memset(entities, 0, sizeof(rcl_wait_set_persistent_entities_t));
+    return true;
+  }
+  // All arrays share a single block: the rmw handles followed by four index arrays.
+  void ** block = (void **)allocator->reallocate(
+    entities->rmw_handles, (sizeof(void *) + 4u * sizeof(size_t)) * size, allocator->state);
+  if (NULL == block) {
+    return false;
+  }
+  entities->rmw_handles = block;
+  entities->rcl_indices = (size_t *)(block + size);
+  entities->packed_positions = entities->rcl_indices + size;
+  entities->free_indices = entities->packed_positions + size;
+  entities->ready_indices = entities->free_indices + size;
+  return true;
+}
+
+static void
+__wait_set_persistent_insert(
+  rcl_wait_set_persistent_entities_t * entities,
+  size_t rcl_index,
+  void * rmw_handle)
+{
+  entities->rmw_handles[entities->count] = rmw_handle;
+  entities->rcl_indices[entities->count] = rcl_index;
+  entities->packed_positions[rcl_index] = entities->count;
+  ++(entities->count);
+}
+
+static void
+__wait_set_persistent_remove(
+  rcl_wait_set_persistent_entities_t * entities,
+  size_t rcl_index)
+{
+  // Move the last packed entry into the vacated position to keep the arrays packed.
+  const size_t position = entities->packed_positions[rcl_index];
+  const size_t last = --(entities->count);
+  entities->rmw_handles[position] = entities->rmw_handles[last];
+  entities->rcl_indices[position] = entities->rcl_indices[last];
+  entities->packed_positions[entities->rcl_indices[position]] = position;
+  entities->free_indices[(entities->free_count)++] = rcl_index;
+}
+
+static void
+__wait_set_persistent_collect(
+  rcl_wait_set_persistent_entities_t * entities,
+  void ** rmw_storage)
+{
+  // rmw_wait() set the handles of entities that are not ready to NULL.
+  entities->ready_count = 0u;
+  for (size_t i = 0u; i < entities->count; ++i) {
+    if (NULL != rmw_storage[i]) {
+      entities->ready_indices[(entities->ready_count)++] = entities->rcl_indices[i];
+    }
+  }
+}
+
 rcl_wait_set_t
 rcl_get_zero_initialized_wait_set()
 {
@@ -90,10 +295,37 @@ rcl_wait_set_is_valid(const rcl_wait_set_t * wait_set)
 static void
 __wait_set_clean_up(rcl_wait_set_t * wait_set)
 {
+  if (wait_set->impl) {
+    // Leave the hierarchy, children become roots of their own.
+    if (wait_set->impl->parent) {
+      (void)rcl_wait_set_remove_wait_set(wait_set->impl->parent, wait_set->impl->parent_slot);
+    }
+    for (size_t i = 0u; i < wait_set->impl->child_slot_count; ++i) {
+      if (wait_set->impl->children[i]) {
+        (void)rcl_wait_set_remove_wait_set(wait_set, i);
+      }
+    }
+    wait_set->impl->persistent = false;
+  }
   rcl_ret_t ret = rcl_wait_set_resize(wait_set, 0, 0, 0, 0, 0, 0);
   (void)ret;  // NO LINT
   assert(RCL_RET_OK == ret);  // Defensive, shouldn't fail with size 0.
   if (wait_set->impl) {
+    ret = rcl_wait_set_shrink_to_fit(wait_set);
+    assert(RCL_RET_OK == ret);  // Defensive, releasing memory shouldn't fail.
+    rcl_timer_wakeup_fini(&wait_set->impl->timer_wakeup);
+    if (wait_set->impl->time_driver) {
+      rcl_time_driver_detach(wait_set->impl->time_driver, wait_set->impl->time_driver_slot);
+    }
+    if (wait_set->impl->statistics) {
+      wait_set->impl->allocator.deallocate(
+        wait_set->impl->statistics, wait_set->impl->allocator.state);
+    }
+    // Detaching the children above already destroyed the flattened wait set.
+    if (wait_set->impl->children) {
+      wait_set->impl->allocator.deallocate(
+        wait_set->impl->children, wait_set->impl->allocator.state);
+    }
     wait_set->impl->allocator.deallocate(wait_set->impl, wait_set->impl->allocator.state);
     wait_set->impl = NULL;
   }
@@ -215,6 +447,328 @@ rcl_wait_set_get_allocator(const rcl_wait_set_t * wait_set, rcl_allocator_t * al
   return RCL_RET_OK;
 }
 
+static size_t
+__wait_set_total_capacity(const rcl_wait_set_impl_t * impl)
+{
+  return impl->subscription_capacity + impl->guard_condition_capacity + impl->timer_capacity +
+         impl->client_capacity + impl->service_capacity + impl->event_capacity;
+}
+
+// Position of the first key of an entity type, keys follow the order of the enum.
+static size_t
+__wait_set_key_offset(const rcl_wait_set_impl_t * impl, rcl_wait_set_entity_type_t entity_type)
+{
+  const size_t capacities[] = {
+    impl->subscription_capacity, impl->guard_condition_capacity, impl->timer_capacity,
+    impl->client_capacity, impl->service_capacity, impl->event_capacity};
+  size_t offset = 0u;
+  for (size_t i = 0u; i < (size_t)entity_type; ++i) {
+    offset += capacities[i];
+  }
+  return offset;
+}
+
+// Persistent bookkeeping of an entity type, or NULL for an unknown type.
+static rcl_wait_set_persistent_entities_t *
+__wait_set_persistent_entities(
+  rcl_wait_set_impl_t * impl, rcl_wait_set_entity_type_t entity_type)
+{
+  switch (entity_type) {
+    case RCL_WAIT_SET_SUBSCRIPTION:
+      return &impl->subscription_persistent;
+    case RCL_WAIT_SET_GUARD_CONDITION:
+      return &impl->guard_condition_persistent;
+    case RCL_WAIT_SET_TIMER:
+      return &impl->timer_persistent;
+    case RCL_WAIT_SET_CLIENT:
+      return &impl->client_persistent;
+    case RCL_WAIT_SET_SERVICE:
+      return &impl->service_persistent;
+    case RCL_WAIT_SET_EVENT:
+      return &impl->event_persistent;
+    default:
+      return NULL;
+  }
+}
+
+/* Wait set hierarchies:
+ *
+ * The root of a hierarchy waits on a persistent wait set, the flattened wait
+ * set, which mirrors the entities of the root and all its descendants. Adding
+ * or removing an entity or a child wait set updates it right away, so waiting
+ * does not depend on the size of the hierarchy beyond the ready entities.
+ * Each storage slot records where it is mirrored in hierarchy_positions, and
+ * the root records in flattened_owners which slot each entity mirrors.
+ *
+ * When the flattened wait set is missing or full it is marked stale, and the
+ * next wait of the root rebuilds it with room to grow.
+ */
+
+// Number of entity types, following the order of the enum.
+#define RCL_WAIT_SET_ENTITY_TYPE_COUNT ((size_t)RCL_WAIT_SET_EVENT + 1u)
+// Marks the hierarchy positions of the slots found ready while scattering a wait.
+#define RCL_WAIT_SET_HIERARCHY_READY ((size_t)1u << (sizeof(size_t) * 8u - 1u))
+
+// Number of storage slots in use for an entity type, removed entities leave NULL slots.
+static size_t
+__wait_set_used_slots(const rcl_wait_set_t * wait_set, rcl_wait_set_entity_type_t entity_type)
+{
+  const rcl_wait_set_impl_t * impl = wait_set->impl;
+  const size_t used[] = {
+    impl->subscription_index, impl->guard_condition_index, impl->timer_index,
+    impl->client_index, impl->service_index, impl->event_index};
+  return used[entity_type];
+}
+
+static const void *
+__wait_set_get_entity(
+  const rcl_wait_set_t * wait_set, rcl_wait_set_entity_type_t entity_type, size_t index)
+{
+  switch (entity_type) {
+    case RCL_WAIT_SET_SUBSCRIPTION:
+      return wait_set->subscriptions[index];
+    case RCL_WAIT_SET_GUARD_CONDITION:
+      return wait_set->guard_conditions[index];
+    case RCL_WAIT_SET_TIMER:
+      return wait_set->timers[index];
+    case RCL_WAIT_SET_CLIENT:
+      return wait_set->clients[index];
+    case RCL_WAIT_SET_SERVICE:
+      return wait_set->services[index];
+    case RCL_WAIT_SET_EVENT:
+      return wait_set->events[index];
+    default:
+      return NULL;
+  }
+}
+
+static void
+__wait_set_set_entity(
+  rcl_wait_set_t * wait_set, rcl_wait_set_entity_type_t entity_type, size_t index,
+  const void * entity)
+{
+  switch (entity_type) {
+    case RCL_WAIT_SET_SUBSCRIPTION:
+      wait_set->subscriptions[index] = (const rcl_subscription_t *)entity;
+      break;
+    case RCL_WAIT_SET_GUARD_CONDITION:
+      wait_set->guard_conditions[index] = (const rcl_guard_condition_t *)entity;
+      break;
+    case RCL_WAIT_SET_TIMER:
+      wait_set->timers[index] = (const rcl_timer_t *)entity;
+      break;
+    case RCL_WAIT_SET_CLIENT:
+      wait_set->clients[index] = (const rcl_client_t *)entity;
+      break;
+    case RCL_WAIT_SET_SERVICE:
+      wait_set->services[index] = (const rcl_service_t *)entity;
+      break;
+    case RCL_WAIT_SET_EVENT:
+      wait_set->events[index] = (const rcl_event_t *)entity;
+      break;
+    default:
+      break;
+  }
+}
+
+static rcl_ret_t
+__wait_set_add_entity(
+  rcl_wait_set_t * wait_set, rcl_wait_set_entity_type_t entity_type, const void * entity,
+  size_t * index)
+{
+  switch (entity_type) {
+    case RCL_WAIT_SET_SUBSCRIPTION:
+      return rcl_wait_set_add_subscription(wait_set, (const rcl_subscription_t *)entity, index);
+    case RCL_WAIT_SET_GUARD_CONDITION:
+      return rcl_wait_set_add_guard_condition(
+        wait_set, (const rcl_guard_condition_t *)entity, index);
+    case RCL_WAIT_SET_TIMER:
+      return rcl_wait_set_add_timer(wait_set, (const rcl_timer_t *)entity, index);
+    case RCL_WAIT_SET_CLIENT:
+      return rcl_wait_set_add_client(wait_set, (const rcl_client_t *)entity, index);
+    case RCL_WAIT_SET_SERVICE:
+      return rcl_wait_set_add_service(wait_set, (const rcl_service_t *)entity, index);
+    case RCL_WAIT_SET_EVENT:
+      return rcl_wait_set_add_event(wait_set, (const rcl_event_t *)entity, index);
+    default:
+      RCL_SET_ERROR_MSG("unknown wait set entity type");
+      return RCL_RET_INVALID_ARGUMENT;
+  }
+}
+
+static rcl_ret_t
+__wait_set_remove_entity(
+  rcl_wait_set_t * wait_set, rcl_wait_set_entity_type_t entity_type, size_t index)
+{
+  switch (entity_type) {
+    case RCL_WAIT_SET_SUBSCRIPTION:
+      return rcl_wait_set_remove_subscription(wait_set, index);
+    case RCL_WAIT_SET_GUARD_CONDITION:
+      return rcl_wait_set_remove_guard_condition(wait_set, index);
+    case RCL_WAIT_SET_TIMER:
+      return rcl_wait_set_remove_timer(wait_set, index);
+    case RCL_WAIT_SET_CLIENT:
+      return rcl_wait_set_remove_client(wait_set, index);
+    case RCL_WAIT_SET_SERVICE:
+      return rcl_wait_set_remove_service(wait_set, index);
+    case RCL_WAIT_SET_EVENT:
+      return rcl_wait_set_remove_event(wait_set, index);
+    default:
+      RCL_SET_ERROR_MSG("unknown wait set entity type");
+      return RCL_RET_INVALID_ARGUMENT;
+  }
+}
+
+static rcl_wait_set_t *
+__wait_set_hierarchy_root(rcl_wait_set_t * wait_set)
+{
+  while (NULL != wait_set->impl->parent) {
+    wait_set = wait_set->impl->parent;
+  }
+  return wait_set;
+}
+
+// Mirror an entity of a wait set of the hierarchy into the flattened wait set of its root.
+// Failing to do so marks the flattened wait set stale rather than failing the caller.
+static void
+__wait_set_hierarchy_mirror(
+  rcl_wait_set_t * root, rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t entity_type, size_t index)
+{
+  rcl_wait_set_impl_t * root_impl = root->impl;
+  if (NULL == root_impl->flattened || root_impl->flattened_stale) {
+    root_impl->flattened_stale = true;
+    return;
+  }
+  size_t position = 0u;
+  rcl_ret_t ret = __wait_set_add_entity(
+    root_impl->flattened, entity_type, __wait_set_get_entity(wait_set, entity_type, index),
+    &position);
+  if (RCL_RET_OK != ret) {
+    // Most likely full, the rebuild makes room.
+    rcl_reset_error();
+    root_impl->flattened_stale = true;
+    return;
+  }
+  const size_t owner = __wait_set_key_offset(root_impl->flattened->impl, entity_type) + position;
+  root_impl->flattened_owners[owner] = wait_set;
+  root_impl->flattened_owner_indices[owner] = index;
+  wait_set->impl->hierarchy_positions[__wait_set_key_offset(wait_set->impl, entity_type) + index] =
+    position + 1u;
+}
+
+// Mirror an entity just added to a wait set, if the wait set is part of a hierarchy.
+static void
+__wait_set_hierarchy_track(
+  rcl_wait_set_t * wait_set, rcl_wait_set_entity_type_t entity_type, size_t index)
+{
+  rcl_wait_set_t * root = __wait_set_hierarchy_root(wait_set);
+  if (root->impl->child_count > 0u) {
+    __wait_set_hierarchy_mirror(root, wait_set, entity_type, index);
+  }
+}
+
+// Mirror the entities of a wait set and its descendants, depth first.
+static void
+__wait_set_hierarchy_track_all(rcl_wait_set_t * root, rcl_wait_set_t * wait_set)
+{
+  for (size_t type = 0u; type < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++type) {
+    const rcl_wait_set_entity_type_t entity_type = (rcl_wait_set_entity_type_t)type;
+    const size_t used = __wait_set_used_slots(wait_set, entity_type);
+    for (size_t i = 0u; i < used && !root->impl->flattened_stale; ++i) {
+      if (NULL != __wait_set_get_entity(wait_set, entity_type, i)) {
+        __wait_set_hierarchy_mirror(root, wait_set, entity_type, i);
+      }
+    }
+  }
+  for (size_t i = 0u; i < wait_set->impl->child_slot_count; ++i) {
+    if (wait_set->impl->children[i]) {
+      __wait_set_hierarchy_track_all(root, wait_set->impl->children[i]);
+    }
+  }
+}
+
+// Forget where the entities of a wait set, and of its descendants if asked, are mirrored,
+// removing them from the flattened wait set unless it is NULL.
+static void
+__wait_set_hierarchy_release(
+  rcl_wait_set_t * wait_set, rcl_wait_set_t * flattened, bool descendants)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  for (size_t type = 0u; type < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++type) {
+    const rcl_wait_set_entity_type_t entity_type = (rcl_wait_set_entity_type_t)type;
+    size_t * positions = impl->hierarchy_positions + __wait_set_key_offset(impl, entity_type);
+    const size_t used = __wait_set_used_slots(wait_set, entity_type);
+    for (size_t i = 0u; i < used; ++i) {
+      if (0u == positions[i]) {
+        continue;
+      }
+      if (
+        NULL != flattened &&
+        RCL_RET_OK != __wait_set_remove_entity(
+          flattened, entity_type, (positions[i] & ~RCL_WAIT_SET_HIERARCHY_READY) - 1u))
+      {
+        rcl_reset_error();
+      }
+      positions[i] = 0u;
+    }
+  }
+  for (size_t i = 0u; descendants && i < impl->child_slot_count; ++i) {
+    if (impl->children[i]) {
+      __wait_set_hierarchy_release(impl->children[i], flattened, true);
+    }
+  }
+}
+
+// Stop mirroring an entity about to be removed from a wait set.
+static void
+__wait_set_hierarchy_untrack(
+  rcl_wait_set_t * wait_set, rcl_wait_set_entity_type_t entity_type, size_t index)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  size_t * position =
+    &impl->hierarchy_positions[__wait_set_key_offset(impl, entity_type) + index];
+  if (0u == *position) {
+    return;
+  }
+  rcl_wait_set_t * flattened = __wait_set_hierarchy_root(wait_set)->impl->flattened;
+  if (
+    RCL_RET_OK != __wait_set_remove_entity(
+      flattened, entity_type, (*position & ~RCL_WAIT_SET_HIERARCHY_READY) - 1u))
+  {
+    rcl_reset_error();
+  }
+  *position = 0u;
+}
+
+// Stop mirroring the entities of a wait set about to be cleared or resized.
+static void
+__wait_set_hierarchy_untrack_all(rcl_wait_set_t * wait_set)
+{
+  if (NULL == wait_set->impl->parent && 0u == wait_set->impl->child_count) {
+    return;  // Not part of a hierarchy, nothing is mirrored.
+  }
+  __wait_set_hierarchy_release(
+    wait_set, __wait_set_hierarchy_root(wait_set)->impl->flattened, false);
+}
+
+// Destroy the flattened wait set of a wait set, its storage slots must not refer to it.
+static void
+__wait_set_hierarchy_drop_flattened(rcl_wait_set_impl_t * impl)
+{
+  if (impl->flattened) {
+    (void)rcl_wait_set_fini(impl->flattened);
+    impl->allocator.deallocate(impl->flattened, impl->allocator.state);
+    impl->flattened = NULL;
+  }
+  if (impl->flattened_owners) {
+    impl->allocator.deallocate(impl->flattened_owners, impl->allocator.state);
+    impl->flattened_owners = NULL;
+    impl->flattened_owner_indices = NULL;
+  }
+  impl->flattened_stale = false;
+}
+
 #define SET_ADD(Type) \
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT); \
   if (!wait_set->impl) { \
@@ -222,11 +776,18 @@ rcl_wait_set_get_allocator(const rcl_wait_set_t * wait_set, rcl_allocator_t * al
     return RCL_RET_WAIT_SET_INVALID; \
   } \
   RCL_CHECK_ARGUMENT_FOR_NULL(Type, RCL_RET_INVALID_ARGUMENT); \
-  if (!(wait_set->impl->Type ## _index < wait_set->size_of_ ## Type ## s)) { \
+  rcl_wait_set_persistent_entities_t * persistent_entities = \
+    wait_set->impl->persistent ? &wait_set->impl->Type ## _persistent : NULL; \
+  size_t current_index; \
+  if (persistent_entities && persistent_entities->free_count > 0u) { \
+    /* Reuse a slot released by a previous removal. */ \
+    current_index = persistent_entities->free_indices[--(persistent_entities->free_count)]; \
+  } else if (wait_set->impl->Type ## _index < wait_set->size_of_ ## Type ## s) { \
+    current_index = wait_set->impl->Type ## _index++; \
+  } else { \
     RCL_SET_ERROR_MSG(#Type "s set is full"); \
     return RCL_RET_WAIT_SET_FULL; \
   } \
-  size_t current_index = wait_set->impl->Type ## _index++; \
   wait_set->Type ## s[current_index] = Type; \
   /* Set optional output argument */ \
   if (NULL != index) { \
@@ -238,8 +799,34 @@ rcl_wait_set_get_allocator(const rcl_wait_set_t * wait_set, rcl_allocator_t * al
   rmw_ ## Type ## _t * rmw_handle = rcl_ ## Type ## _get_rmw_handle(Type); \
   RCL_CHECK_FOR_NULL_WITH_MSG( \
     rmw_handle, rcl_get_error_string().str, return RCL_RET_ERROR); \
-  wait_set->impl->RMWStorage[current_index] = rmw_handle->data; \
-  wait_set->impl->RMWCount++;
+  SET_ADD_RMW_HANDLE(RMWStorage, RMWCount, rmw_handle->data)
+
+#define SET_ADD_RMW_HANDLE(RMWStorage, RMWCount, Handle) \
+  if (persistent_entities) { \
+    /* Persistent wait sets copy their packed handles into rmw storage in rcl_wait. */ \
+    __wait_set_persistent_insert(persistent_entities, current_index, Handle); \
+  } else { \
+    wait_set->impl->RMWStorage[current_index] = Handle; \
+    wait_set->impl->RMWCount++; \
+  }
+
+#define SET_REMOVE(Type, EntityType) \
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT); \
+  if (!wait_set->impl) { \
+    RCL_SET_ERROR_MSG("wait set is invalid"); \
+    return RCL_RET_WAIT_SET_INVALID; \
+  } \
+  if (!wait_set->impl->persistent) { \
+    RCL_SET_ERROR_MSG("entities can only be removed from a persistent wait set"); \
+    return RCL_RET_ERROR; \
+  } \
+  if (index >= wait_set->size_of_ ## Type ## s || NULL == wait_set->Type ## s[index]) { \
+    RCL_SET_ERROR_MSG("index does not refer to a " #Type " in the wait set"); \
+    return RCL_RET_INVALID_ARGUMENT; \
+  } \
+  __wait_set_hierarchy_untrack(wait_set, EntityType, index); \
+  wait_set->Type ## s[index] = NULL; \
+  __wait_set_persistent_remove(&wait_set->impl->Type ## _persistent, index);
 
 #define SET_CLEAR(Type) \
   do { \
@@ -250,6 +837,7 @@ rcl_wait_set_get_allocator(const rcl_wait_set_t * wait_set, rcl_allocator_t * al
         sizeof(rcl_ ## Type ## _t *) * wait_set->size_of_ ## Type ## s); \
       wait_set->impl->Type ## _index = 0; \
     } \
+    __wait_set_persistent_reset(&wait_set->impl->Type ## _persistent); \
   } while (false)
 
 #define SET_CLEAR_RMW(Type, RMWStorage, RMWCount) \
@@ -264,50 +852,24 @@ rcl_wait_set_get_allocator(const rcl_wait_set_t * wait_set, rcl_allocator_t * al
     } \
   } while (false)
 
-#define SET_RESIZE(Type, ExtraDealloc, ExtraRealloc) \
+#define SET_RESIZE(Type) \
   do { \
-    rcl_allocator_t allocator = wait_set->impl->allocator; \
-    wait_set->size_of_ ## Type ## s = 0; \
+    wait_set->size_of_ ## Type ## s = Type ## s_size; \
     wait_set->impl->Type ## _index = 0; \
-    if (0 == Type ## s_size) { \
-      if (wait_set->Type ## s) { \
-        allocator.deallocate((void *)wait_set->Type ## s, allocator.state); \
-        wait_set->Type ## s = NULL; \
-      } \
-      ExtraDealloc \
-    } else { \
-      wait_set->Type ## s = (const rcl_ ## Type ## _t **)allocator.reallocate( \
-        (void *)wait_set->Type ## s, sizeof(rcl_ ## Type ## _t *) * Type ## s_size, \
-        allocator.state); \
-      RCL_CHECK_FOR_NULL_WITH_MSG( \
-        wait_set->Type ## s, "allocating memory failed", return RCL_RET_BAD_ALLOC); \
+    __wait_set_persistent_reset(&wait_set->impl->Type ## _persistent); \
+    if (0u != Type ## s_size) { \
       memset((void *)wait_set->Type ## s, 0, sizeof(rcl_ ## Type ## _t *) * Type ## s_size); \
-      wait_set->size_of_ ## Type ## s = Type ## s_size; \
-      ExtraRealloc \
     } \
   } while (false)
 
-#define SET_RESIZE_RMW_DEALLOC(RMWStorage, RMWCount) \
-  /* Also deallocate the rmw storage. */ \
-  if (wait_set->impl->RMWStorage) { \
-    allocator.deallocate((void *)wait_set->impl->RMWStorage, allocator.state); \
-    wait_set->impl->RMWStorage = NULL; \
+#define SET_RESIZE_RMW(RMWStorage, RMWCount, Size) \
+  do { \
+    /* Also reset the rmw storage. */ \
     wait_set->impl->RMWCount = 0; \
-  }
-
-#define SET_RESIZE_RMW_REALLOC(Type, RMWStorage, RMWCount) \
-  /* Also resize the rmw storage. */ \
-  wait_set->impl->RMWCount = 0; \
-  wait_set->impl->RMWStorage = (void **)allocator.reallocate( \
-    wait_set->impl->RMWStorage, sizeof(void *) * Type ## s_size, allocator.state); \
-  if (!wait_set->impl->RMWStorage) { \
-    allocator.deallocate((void *)wait_set->Type ## s, allocator.state); \
-    wait_set->Type ## s = NULL; \
-    wait_set->size_of_ ## Type ## s = 0; \
-    RCL_SET_ERROR_MSG("allocating memory failed"); \
-    return RCL_RET_BAD_ALLOC; \
-  } \
-  memset(wait_set->impl->RMWStorage, 0, sizeof(void *) * Type ## s_size);
+    if (0u != (Size)) { \
+      memset(wait_set->impl->RMWStorage, 0, sizeof(void *) * (Size)); \
+    } \
+  } while (false)
 
 /* Implementation-specific notes:
  *
@@ -322,6 +884,63 @@ rcl_wait_set_add_subscription(
 {
   SET_ADD(subscription)
   SET_ADD_RMW(subscription, rmw_subscriptions.subscribers, rmw_subscriptions.subscriber_count)
+  // Messages delivered within the context only trigger this guard condition.
+  void * rmw_gc_handle = NULL;
+  if (NULL != subscription->impl->intra_context) {
+    rmw_guard_condition_t * rmw_gc = rcl_guard_condition_get_rmw_handle(
+      rcl_intra_context_subscription_get_guard_condition(subscription->impl->intra_context));
+    RCL_CHECK_FOR_NULL_WITH_MSG(
+      rmw_gc, rcl_get_error_string().str, return RCL_RET_ERROR);
+    rmw_gc_handle = rmw_gc->data;
+  }
+  wait_set->impl->subscription_guard_conditions[current_index] = rmw_gc_handle;
+  __wait_set_hierarchy_track(wait_set, RCL_WAIT_SET_SUBSCRIPTION, current_index);
+  return RCL_RET_OK;
+}
+
+// Whether a subscription of the wait set has messages queued within its context.
+static bool
+__wait_set_subscription_has_local_messages(const rcl_wait_set_t * wait_set, size_t index)
+{
+  const rcl_subscription_t * subscription = wait_set->subscriptions[index];
+  return NULL != subscription &&
+         NULL != wait_set->impl->subscription_guard_conditions[index] &&
+         rcl_intra_context_subscription_has_messages(subscription->impl->intra_context);
+}
+
+// Set every key to 0 and empty the ready list.
+static void
+__wait_set_ready_list_reset(rcl_wait_set_impl_t * impl)
+{
+  impl->ready_list_count = 0u;
+  if (impl->entity_keys) {
+    memset(impl->entity_keys, 0, sizeof(int64_t) * __wait_set_total_capacity(impl));
+  }
+}
+
+// Size the keys and the ready list by the capacities, or release them when disabled.
+static rcl_ret_t
+__wait_set_ready_list_resize(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  const size_t capacity = impl->ready_list_enabled ? __wait_set_total_capacity(impl) : 0u;
+  impl->ready_list_count = 0u;
+  if (0u == capacity) {
+    if (impl->entity_keys) {
+      impl->allocator.deallocate(impl->entity_keys, impl->allocator.state);
+    }
+    impl->entity_keys = NULL;
+    impl->ready_list = NULL;
+    return RCL_RET_OK;
+  }
+  // Both arrays share a single block: the keys followed by the ready list.
+  int64_t * block = (int64_t *)impl->allocator.reallocate(
+    impl->entity_keys,
+    (sizeof(int64_t) + sizeof(rcl_wait_set_ready_entry_t)) * capacity, impl->allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(block, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  impl->entity_keys = block;
+  impl->ready_list = (rcl_wait_set_ready_entry_t *)(block + capacity);
+  __wait_set_ready_list_reset(impl);
   return RCL_RET_OK;
 }
 
@@ -335,6 +954,7 @@ rcl_wait_set_clear(rcl_wait_set_t * wait_set)
 {
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set->impl, RCL_RET_WAIT_SET_INVALID);
+  __wait_set_hierarchy_untrack_all(wait_set);
 
   SET_CLEAR(subscription);
   SET_CLEAR(guard_condition);
@@ -342,6 +962,8 @@ rcl_wait_set_clear(rcl_wait_set_t * wait_set)
   SET_CLEAR(service);
   SET_CLEAR(event);
   SET_CLEAR(timer);
+  rcl_timer_queue_clear(&wait_set->impl->timer_queue);
+  __wait_set_ready_list_reset(wait_set->impl);
 
   SET_CLEAR_RMW(
     subscription,
@@ -367,10 +989,144 @@ rcl_wait_set_clear(rcl_wait_set_t * wait_set)
   return RCL_RET_OK;
 }
 
+static rcl_ret_t
+__wait_set_persistent_resize_all(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  // A wait set that is not persistent only ever releases this storage.
+  const bool persistent = impl->persistent;
+  if (
+    !__wait_set_persistent_resize(
+      &impl->subscription_persistent,
+      persistent ? impl->subscription_capacity : 0u, &impl->allocator) ||
+    !__wait_set_persistent_resize(
+      &impl->guard_condition_persistent,
+      persistent ? impl->guard_condition_capacity : 0u, &impl->allocator) ||
+    !__wait_set_persistent_resize(
+      &impl->timer_persistent,
+      persistent ? impl->timer_capacity : 0u, &impl->allocator) ||
+    !__wait_set_persistent_resize(
+      &impl->client_persistent,
+      persistent ? impl->client_capacity : 0u, &impl->allocator) ||
+    !__wait_set_persistent_resize(
+      &impl->service_persistent,
+      persistent ? impl->service_capacity : 0u, &impl->allocator) ||
+    !__wait_set_persistent_resize(
+      &impl->event_persistent,
+      persistent ? impl->event_capacity : 0u, &impl->allocator))
+  {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  return rcl_timer_queue_resize(
+    &impl->timer_queue, persistent ? impl->timer_capacity : 0u, &impl->allocator);
+}
+
+// Grow a capacity geometrically until it holds at least size entities.
+static size_t
+__wait_set_grow_capacity(size_t capacity, size_t size)
+{
+  if (size <= capacity) {
+    return capacity;
+  }
+  return size > 2u * capacity ? size : 2u * capacity;
+}
+
+// Hand out the next count elements of the arena, or NULL if there are none.
+static void *
+__wait_set_arena_take(char ** cursor, size_t count, size_t element_size)
+{
+  if (0u == count) {
+    return NULL;
+  }
+  void * storage = *cursor;
+  *cursor += count * element_size;
+  return storage;
+}
+
+// Replace the arena with one of the given capacities, in which every entry is NULL.
+// On failure the previous arena is kept.
+static rcl_ret_t
+__wait_set_arena_reserve(
+  rcl_wait_set_t * wait_set,
+  size_t subscription_capacity,
+  size_t guard_condition_capacity,
+  size_t timer_capacity,
+  size_t client_capacity,
+  size_t service_capacity,
+  size_t event_capacity)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  const size_t total_capacity = subscription_capacity + guard_condition_capacity +
+    timer_capacity + client_capacity + service_capacity + event_capacity;
+  // The rcl arrays, then the rmw arrays, where timers and subscriptions receiving
+  // within their context have guard conditions appended to the guard condition
+  // array, then the guard conditions of those subscriptions, the spin backup and the
+  // hierarchy positions.
+  const size_t rmw_capacity = total_capacity + subscription_capacity;
+  const size_t arena_size =
+    subscription_capacity * sizeof(rcl_subscription_t *) +
+    guard_condition_capacity * sizeof(rcl_guard_condition_t *) +
+    timer_capacity * sizeof(rcl_timer_t *) +
+    client_capacity * sizeof(rcl_client_t *) +
+    service_capacity * sizeof(rcl_service_t *) +
+    event_capacity * sizeof(rcl_event_t *) +
+    (2u * rmw_capacity + subscription_capacity) * sizeof(void *) +
+    total_capacity * sizeof(size_t);
+  char * arena = NULL;
+  if (0u != arena_size) {
+    arena = (char *)impl->allocator.allocate(arena_size, impl->allocator.state);
+    RCL_CHECK_FOR_NULL_WITH_MSG(arena, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+    memset(arena, 0, arena_size);
+  }
+  if (NULL != impl->arena) {
+    impl->allocator.deallocate(impl->arena, impl->allocator.state);
+  }
+  impl->arena = arena;
+
+  char * cursor = arena;
+  wait_set->subscriptions = (const rcl_subscription_t **)__wait_set_arena_take(
+    &cursor, subscription_capacity, sizeof(rcl_subscription_t *));
+  wait_set->guard_conditions = (const rcl_guard_condition_t **)__wait_set_arena_take(
+    &cursor, guard_condition_capacity, sizeof(rcl_guard_condition_t *));
+  wait_set->timers = (const rcl_timer_t **)__wait_set_arena_take(
+    &cursor, timer_capacity, sizeof(rcl_timer_t *));
+  wait_set->clients = (const rcl_client_t **)__wait_set_arena_take(
+    &cursor, client_capacity, sizeof(rcl_client_t *));
+  wait_set->services = (const rcl_service_t **)__wait_set_arena_take(
+    &cursor, service_capacity, sizeof(rcl_service_t *));
+  wait_set->events = (const rcl_event_t **)__wait_set_arena_take(
+    &cursor, event_capacity, sizeof(rcl_event_t *));
+  impl->rmw_subscriptions.subscribers = (void **)__wait_set_arena_take(
+    &cursor, subscription_capacity, sizeof(void *));
+  impl->rmw_guard_conditions.guard_conditions = (void **)__wait_set_arena_take(
+    &cursor, guard_condition_capacity + timer_capacity + subscription_capacity, sizeof(void *));
+  impl->rmw_clients.clients = (void **)__wait_set_arena_take(
+    &cursor, client_capacity, sizeof(void *));
+  impl->rmw_services.services = (void **)__wait_set_arena_take(
+    &cursor, service_capacity, sizeof(void *));
+  impl->rmw_events.events = (void **)__wait_set_arena_take(
+    &cursor, event_capacity, sizeof(void *));
+  impl->subscription_guard_conditions = (void **)__wait_set_arena_take(
+    &cursor, subscription_capacity, sizeof(void *));
+  impl->spin_backup = (void **)__wait_set_arena_take(&cursor, rmw_capacity, sizeof(void *));
+  impl->hierarchy_positions = (size_t *)__wait_set_arena_take(
+    &cursor, total_capacity, sizeof(size_t));
+
+  impl->subscription_capacity = subscription_capacity;
+  impl->guard_condition_capacity = guard_condition_capacity;
+  impl->timer_capacity = timer_capacity;
+  impl->client_capacity = client_capacity;
+  impl->service_capacity = service_capacity;
+  impl->event_capacity = event_capacity;
+  return RCL_RET_OK;
+}
+
 /* Implementation-specific notes:
  *
- * Similarly, the underlying rmw representation is reallocated and reset:
+ * Similarly, the underlying rmw representation is reset:
  * all entries are set to null and the count is set to zero.
+ * The storage only ever grows here, see rcl_wait_set_shrink_to_fit().
  */
 rcl_ret_t
 rcl_wait_set_resize(
@@ -384,70 +1140,99 @@ rcl_wait_set_resize(
 {
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set->impl, RCL_RET_WAIT_SET_INVALID);
-  SET_RESIZE(
-    subscription,
-    SET_RESIZE_RMW_DEALLOC(
-      rmw_subscriptions.subscribers, rmw_subscriptions.subscriber_count),
-    SET_RESIZE_RMW_REALLOC(
-      subscription, rmw_subscriptions.subscribers, rmw_subscriptions.subscriber_count)
-  );
-  // Guard condition RCL size is the resize amount given
-  SET_RESIZE(guard_condition,;,;);  // NOLINT
-
-  // Guard condition RMW size needs to be guard conditions + timers
-  rmw_guard_conditions_t * rmw_gcs = &(wait_set->impl->rmw_guard_conditions);
-  const size_t num_rmw_gc = guard_conditions_size + timers_size;
-  // Clear added guard conditions
-  rmw_gcs->guard_condition_count = 0u;
-  if (0u == num_rmw_gc) {
-    if (rmw_gcs->guard_conditions) {
-      wait_set->impl->allocator.deallocate(
-        (void *)rmw_gcs->guard_conditions, wait_set->impl->allocator.state);
-      rmw_gcs->guard_conditions = NULL;
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  rcl_timer_queue_clear(&impl->timer_queue);
+  __wait_set_hierarchy_untrack_all(wait_set);
+
+  rcl_ret_t ret = RCL_RET_OK;
+  if (
+    subscriptions_size > impl->subscription_capacity ||
+    guard_conditions_size > impl->guard_condition_capacity ||
+    timers_size > impl->timer_capacity ||
+    clients_size > impl->client_capacity ||
+    services_size > impl->service_capacity ||
+    events_size > impl->event_capacity)
+  {
+    ret = __wait_set_arena_reserve(
+      wait_set,
+      __wait_set_grow_capacity(impl->subscription_capacity, subscriptions_size),
+      __wait_set_grow_capacity(impl->guard_condition_capacity, guard_conditions_size),
+      __wait_set_grow_capacity(impl->timer_capacity, timers_size),
+      __wait_set_grow_capacity(impl->client_capacity, clients_size),
+      __wait_set_grow_capacity(impl->service_capacity, services_size),
+      __wait_set_grow_capacity(impl->event_capacity, events_size));
+    if (RCL_RET_OK == ret && impl->persistent) {
+      ret = __wait_set_persistent_resize_all(wait_set);
     }
-  } else {
-    rmw_gcs->guard_conditions = (void **)wait_set->impl->allocator.reallocate(
-      rmw_gcs->guard_conditions, sizeof(void *) * num_rmw_gc, wait_set->impl->allocator.state);
-    if (!rmw_gcs->guard_conditions) {
-      // Deallocate rcl arrays to match unallocated rmw guard conditions
-      wait_set->impl->allocator.deallocate(
-        (void *)wait_set->guard_conditions, wait_set->impl->allocator.state);
-      wait_set->size_of_guard_conditions = 0u;
-      wait_set->guard_conditions = NULL;
-      wait_set->impl->allocator.deallocate(
-        (void *)wait_set->timers, wait_set->impl->allocator.state);
-      wait_set->size_of_timers = 0u;
-      wait_set->timers = NULL;
-      RCL_SET_ERROR_MSG("allocating memory failed");
-      return RCL_RET_BAD_ALLOC;
+    if (RCL_RET_OK == ret && impl->ready_list_enabled) {
+      ret = __wait_set_ready_list_resize(wait_set);
+    }
+    if (RCL_RET_OK != ret) {
+      // Leave the wait set empty rather than sized beyond its storage.
+      subscriptions_size = 0u;
+      guard_conditions_size = 0u;
+      timers_size = 0u;
+      clients_size = 0u;
+      services_size = 0u;
+      events_size = 0u;
     }
-    memset(rmw_gcs->guard_conditions, 0, sizeof(void *) * num_rmw_gc);
   }
 
-  SET_RESIZE(timer,;,;);  // NOLINT
-  SET_RESIZE(
-    client,
-    SET_RESIZE_RMW_DEALLOC(
-      rmw_clients.clients, rmw_clients.client_count),
-    SET_RESIZE_RMW_REALLOC(
-      client, rmw_clients.clients, rmw_clients.client_count)
-  );
-  SET_RESIZE(
-    service,
-    SET_RESIZE_RMW_DEALLOC(
-      rmw_services.services, rmw_services.service_count),
-    SET_RESIZE_RMW_REALLOC(
-      service, rmw_services.services, rmw_services.service_count)
-  );
-  SET_RESIZE(
-    event,
-    SET_RESIZE_RMW_DEALLOC(
-      rmw_events.events, rmw_events.event_count),
-    SET_RESIZE_RMW_REALLOC(
-      event, rmw_events.events, rmw_events.event_count)
-  );
+  SET_RESIZE(subscription);
+  SET_RESIZE_RMW(rmw_subscriptions.subscribers, rmw_subscriptions.subscriber_count,
+    subscriptions_size);
+  SET_RESIZE(guard_condition);
+  // Guard condition RMW size needs to be guard conditions + timers + subscriptions
+  SET_RESIZE_RMW(rmw_guard_conditions.guard_conditions, rmw_guard_conditions.guard_condition_count,
+    guard_conditions_size + timers_size + subscriptions_size);
+  SET_RESIZE(timer);
+  SET_RESIZE(client);
+  SET_RESIZE_RMW(rmw_clients.clients, rmw_clients.client_count, clients_size);
+  SET_RESIZE(service);
+  SET_RESIZE_RMW(rmw_services.services, rmw_services.service_count, services_size);
+  SET_RESIZE(event);
+  SET_RESIZE_RMW(rmw_events.events, rmw_events.event_count, events_size);
+  __wait_set_ready_list_reset(impl);
+  return ret;
+}
 
-  return RCL_RET_OK;
+rcl_ret_t
+rcl_wait_set_shrink_to_fit(rcl_wait_set_t * wait_set)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  rcl_timer_queue_clear(&impl->timer_queue);
+  __wait_set_hierarchy_untrack_all(wait_set);
+  rcl_ret_t ret = __wait_set_arena_reserve(
+    wait_set,
+    wait_set->size_of_subscriptions,
+    wait_set->size_of_guard_conditions,
+    wait_set->size_of_timers,
+    wait_set->size_of_clients,
+    wait_set->size_of_services,
+    wait_set->size_of_events);
+  if (RCL_RET_OK == ret) {
+    // Also releases the persistent storage of wait sets that are not persistent.
+    ret = __wait_set_persistent_resize_all(wait_set);
+  }
+  if (RCL_RET_OK == ret) {
+    ret = __wait_set_ready_list_resize(wait_set);
+  }
+  if (RCL_RET_OK != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  return rcl_wait_set_resize(
+    wait_set,
+    wait_set->size_of_subscriptions,
+    wait_set->size_of_guard_conditions,
+    wait_set->size_of_timers,
+    wait_set->size_of_clients,
+    wait_set->size_of_services,
+    wait_set->size_of_events);
 }
 
 rcl_ret_t
@@ -460,7 +1245,7 @@ rcl_wait_set_add_guard_condition(
   SET_ADD_RMW(
     guard_condition, rmw_guard_conditions.guard_conditions,
     rmw_guard_conditions.guard_condition_count)
-
+  __wait_set_hierarchy_track(wait_set, RCL_WAIT_SET_GUARD_CONDITION, current_index);
   return RCL_RET_OK;
 }
 
@@ -473,7 +1258,22 @@ rcl_wait_set_add_timer(
   SET_ADD(timer)
   // Add timer guard conditions to end of rmw guard condtion set.
   rcl_guard_condition_t * guard_condition = rcl_timer_get_guard_condition(timer);
-  if (NULL != guard_condition) {
+  if (persistent_entities) {
+    void * rmw_gc_handle = NULL;
+    if (NULL != guard_condition) {
+      rmw_guard_condition_t * rmw_handle = rcl_guard_condition_get_rmw_handle(guard_condition);
+      RCL_CHECK_FOR_NULL_WITH_MSG(
+        rmw_handle, rcl_get_error_string().str, return RCL_RET_ERROR);
+      rmw_gc_handle = rmw_handle->data;
+    }
+    __wait_set_persistent_insert(persistent_entities, current_index, rmw_gc_handle);
+    rcl_ret_t ret = rcl_timer_queue_add(&wait_set->impl->timer_queue, current_index, timer);
+    if (RCL_RET_OK != ret) {
+      wait_set->timers[current_index] = NULL;
+      __wait_set_persistent_remove(persistent_entities, current_index);
+      return ret;  // The rcl error state should already be set.
+    }
+  } else if (NULL != guard_condition) {
     // rcl_wait() will take care of moving these backwards and setting guard_condition_count.
     const size_t index = wait_set->size_of_guard_conditions + (wait_set->impl->timer_index - 1);
     rmw_guard_condition_t * rmw_handle = rcl_guard_condition_get_rmw_handle(guard_condition);
@@ -481,6 +1281,7 @@ rcl_wait_set_add_timer(
       rmw_handle, rcl_get_error_string().str, return RCL_RET_ERROR);
     wait_set->impl->rmw_guard_conditions.guard_conditions[index] = rmw_handle->data;
   }
+  __wait_set_hierarchy_track(wait_set, RCL_WAIT_SET_TIMER, current_index);
   return RCL_RET_OK;
 }
 
@@ -492,6 +1293,7 @@ rcl_wait_set_add_client(
 {
   SET_ADD(client)
   SET_ADD_RMW(client, rmw_clients.clients, rmw_clients.client_count)
+  __wait_set_hierarchy_track(wait_set, RCL_WAIT_SET_CLIENT, current_index);
   return RCL_RET_OK;
 }
 
@@ -503,6 +1305,7 @@ rcl_wait_set_add_service(
 {
   SET_ADD(service)
   SET_ADD_RMW(service, rmw_services.services, rmw_services.service_count)
+  __wait_set_hierarchy_track(wait_set, RCL_WAIT_SET_SERVICE, current_index);
   return RCL_RET_OK;
 }
 
@@ -513,28 +1316,977 @@ rcl_wait_set_add_event(
   size_t * index)
 {
   SET_ADD(event)
-  SET_ADD_RMW(event, rmw_events.events, rmw_events.event_count)
-  wait_set->impl->rmw_events.events[current_index] = rmw_handle;
+  // Unlike other entities, rmw_wait() expects the rmw event handle itself.
+  rmw_event_t * rmw_handle = rcl_event_get_rmw_handle(event);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    rmw_handle, rcl_get_error_string().str, return RCL_RET_ERROR);
+  SET_ADD_RMW_HANDLE(rmw_events.events, rmw_events.event_count, rmw_handle)
+  __wait_set_hierarchy_track(wait_set, RCL_WAIT_SET_EVENT, current_index);
   return RCL_RET_OK;
 }
 
 rcl_ret_t
-rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
+rcl_wait_set_remove_subscription(rcl_wait_set_t * wait_set, size_t index)
+{
+  SET_REMOVE(subscription, RCL_WAIT_SET_SUBSCRIPTION)
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_remove_guard_condition(rcl_wait_set_t * wait_set, size_t index)
+{
+  SET_REMOVE(guard_condition, RCL_WAIT_SET_GUARD_CONDITION)
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_remove_timer(rcl_wait_set_t * wait_set, size_t index)
+{
+  SET_REMOVE(timer, RCL_WAIT_SET_TIMER)
+  rcl_timer_queue_remove(&wait_set->impl->timer_queue, index);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_remove_client(rcl_wait_set_t * wait_set, size_t index)
+{
+  SET_REMOVE(client, RCL_WAIT_SET_CLIENT)
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_remove_service(rcl_wait_set_t * wait_set, size_t index)
+{
+  SET_REMOVE(service, RCL_WAIT_SET_SERVICE)
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_remove_event(rcl_wait_set_t * wait_set, size_t index)
+{
+  SET_REMOVE(event, RCL_WAIT_SET_EVENT)
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_set_persistent(rcl_wait_set_t * wait_set, bool persistent)
 {
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
   if (!rcl_wait_set_is_valid(wait_set)) {
     RCL_SET_ERROR_MSG("wait set is invalid");
     return RCL_RET_WAIT_SET_INVALID;
   }
-  if (
-    wait_set->size_of_subscriptions == 0 &&
-    wait_set->size_of_guard_conditions == 0 &&
-    wait_set->size_of_timers == 0 &&
-    wait_set->size_of_clients == 0 &&
-    wait_set->size_of_services == 0 &&
-    wait_set->size_of_events == 0)
-  {
-    RCL_SET_ERROR_MSG("wait set is empty");
+  rcl_ret_t ret = rcl_wait_set_clear(wait_set);
+  if (RCL_RET_OK != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  wait_set->impl->persistent = persistent;
+  ret = __wait_set_persistent_resize_all(wait_set);
+  if (RCL_RET_OK != ret) {
+    wait_set->impl->persistent = false;
+    (void)__wait_set_persistent_resize_all(wait_set);
+  }
+  return ret;
+}
+
+bool
+rcl_wait_set_is_persistent(const rcl_wait_set_t * wait_set)
+{
+  return rcl_wait_set_is_valid(wait_set) && wait_set->impl->persistent;
+}
+
+rcl_ret_t
+rcl_wait_set_get_ready_indices(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t entity_type,
+  const size_t ** ready_indices,
+  size_t * ready_count)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(ready_indices, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ready_count, RCL_RET_INVALID_ARGUMENT);
+  if (!wait_set->impl->persistent) {
+    RCL_SET_ERROR_MSG("ready indices are only tracked by persistent wait sets");
+    return RCL_RET_ERROR;
+  }
+  const rcl_wait_set_persistent_entities_t * entities =
+    __wait_set_persistent_entities(wait_set->impl, entity_type);
+  if (NULL == entities) {
+    RCL_SET_ERROR_MSG("unknown wait set entity type");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  *ready_indices = entities->ready_indices;
+  *ready_count = entities->ready_count;
+  return RCL_RET_OK;
+}
+
+// Return true if `wait_set` is `ancestor` or one of its descendants is.
+static bool
+__wait_set_is_in_hierarchy(const rcl_wait_set_t * wait_set, const rcl_wait_set_t * ancestor)
+{
+  if (wait_set == ancestor) {
+    return true;
+  }
+  for (size_t i = 0u; i < wait_set->impl->child_slot_count; ++i) {
+    const rcl_wait_set_t * child = wait_set->impl->children[i];
+    if (child && __wait_set_is_in_hierarchy(child, ancestor)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+rcl_ret_t
+rcl_wait_set_add_wait_set(
+  rcl_wait_set_t * wait_set,
+  rcl_wait_set_t * child,
+  size_t * index)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(child, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(child)) {
+    RCL_SET_ERROR_MSG("child wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  if (child->impl->context != impl->context) {
+    RCL_SET_ERROR_MSG("child wait set belongs to another context");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (NULL != child->impl->parent) {
+    RCL_SET_ERROR_MSG("child wait set already has a parent");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (__wait_set_is_in_hierarchy(child, wait_set)) {
+    RCL_SET_ERROR_MSG("adding the child wait set would create a cycle");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  // Reuse the first released slot, so indices of the other children stay valid.
+  size_t slot = 0u;
+  while (slot < impl->child_slot_count && NULL != impl->children[slot]) {
+    ++slot;
+  }
+  if (slot == impl->child_slot_capacity) {
+    const size_t capacity = __wait_set_grow_capacity(slot, slot + 1u);
+    // Both arrays share a single block: the children followed by the ready slots.
+    rcl_wait_set_t ** block = (rcl_wait_set_t **)impl->allocator.reallocate(
+      impl->children, (sizeof(rcl_wait_set_t *) + sizeof(size_t)) * capacity,
+      impl->allocator.state);
+    RCL_CHECK_FOR_NULL_WITH_MSG(block, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+    impl->children = block;
+    impl->ready_children = (size_t *)(block + capacity);
+    impl->child_slot_capacity = capacity;
+    impl->ready_child_count = 0u;
+  }
+  if (slot == impl->child_slot_count) {
+    ++(impl->child_slot_count);
+  }
+  impl->children[slot] = child;
+  ++(impl->child_count);
+  // The root of the hierarchy now waits on behalf of the child and its descendants.
+  rcl_wait_set_impl_t * child_impl = child->impl;
+  __wait_set_hierarchy_release(child, NULL, true);
+  __wait_set_hierarchy_drop_flattened(child_impl);
+  child_impl->parent = wait_set;
+  child_impl->parent_slot = slot;
+  child_impl->ready_in_parent = false;
+  __wait_set_hierarchy_track_all(__wait_set_hierarchy_root(wait_set), child);
+  if (index) {
+    *index = slot;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_remove_wait_set(rcl_wait_set_t * wait_set, size_t index)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  if (index >= impl->child_slot_count || NULL == impl->children[index]) {
+    RCL_SET_ERROR_MSG("no child wait set at the given index");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_wait_set_t * child = impl->children[index];
+  rcl_wait_set_t * root = __wait_set_hierarchy_root(wait_set);
+  __wait_set_hierarchy_release(child, root->impl->flattened, true);
+  child->impl->parent = NULL;
+  child->impl->ready_in_parent = false;
+  impl->children[index] = NULL;
+  --(impl->child_count);
+  while (impl->child_slot_count > 0u && NULL == impl->children[impl->child_slot_count - 1u]) {
+    --(impl->child_slot_count);
+  }
+  if (0u == root->impl->child_count) {
+    // Without children the root waits on its own entities again.
+    __wait_set_hierarchy_release(root, NULL, false);
+    __wait_set_hierarchy_drop_flattened(root->impl);
+  }
+  // Slots are reused, so a stale ready slot could name another child.
+  impl->ready_child_count = 0u;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_get_ready_wait_sets(
+  const rcl_wait_set_t * wait_set,
+  const size_t ** ready_indices,
+  size_t * ready_count)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(ready_indices, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ready_count, RCL_RET_INVALID_ARGUMENT);
+  *ready_indices = wait_set->impl->ready_children;
+  *ready_count = wait_set->impl->ready_child_count;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_set_ready_list(rcl_wait_set_t * wait_set, bool enable)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  wait_set->impl->ready_list_enabled = enable;
+  rcl_ret_t ret = __wait_set_ready_list_resize(wait_set);
+  if (RCL_RET_OK != ret) {
+    wait_set->impl->ready_list_enabled = false;
+  }
+  return ret;
+}
+
+rcl_ret_t
+rcl_wait_set_set_entity_key(
+  rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t entity_type,
+  size_t index,
+  int64_t key)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  const rcl_wait_set_impl_t * impl = wait_set->impl;
+  if (!impl->ready_list_enabled) {
+    RCL_SET_ERROR_MSG("entity keys are only kept by wait sets with a ready list");
+    return RCL_RET_ERROR;
+  }
+  const size_t sizes[] = {
+    wait_set->size_of_subscriptions, wait_set->size_of_guard_conditions,
+    wait_set->size_of_timers, wait_set->size_of_clients, wait_set->size_of_services,
+    wait_set->size_of_events};
+  if ((size_t)entity_type > RCL_WAIT_SET_EVENT) {
+    RCL_SET_ERROR_MSG("unknown wait set entity type");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (index >= sizes[entity_type]) {
+    RCL_SET_ERROR_MSG("index does not refer to a slot of the wait set");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  const size_t offset = __wait_set_key_offset(impl, entity_type);
+  impl->entity_keys[offset + index] = key;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_get_ready_list(
+  const rcl_wait_set_t * wait_set,
+  const rcl_wait_set_ready_entry_t ** ready_list,
+  size_t * ready_count)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(ready_list, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ready_count, RCL_RET_INVALID_ARGUMENT);
+  if (!wait_set->impl->ready_list_enabled) {
+    RCL_SET_ERROR_MSG("wait set ready list is not enabled");
+    return RCL_RET_ERROR;
+  }
+  *ready_list = wait_set->impl->ready_list;
+  *ready_count = wait_set->impl->ready_list_count;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_set_timerfd_wakeup(rcl_wait_set_t * wait_set, bool enable, int64_t margin)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  if (margin < 0) {
+    RCL_SET_ERROR_MSG("timer wake-up margin must be non-negative");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  if (!enable) {
+    rcl_timer_wakeup_fini(&impl->timer_wakeup);
+    return RCL_RET_OK;
+  }
+  if (!impl->timer_wakeup.valid) {
+    rcl_ret_t ret = rcl_timer_wakeup_init(&impl->timer_wakeup);
+    if (RCL_RET_OK != ret) {
+      return ret;  // The rcl error state should already be set.
+    }
+  }
+  impl->timer_wakeup_margin = margin;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_set_statistics(rcl_wait_set_t * wait_set, bool enable)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  if (!enable) {
+    if (impl->statistics) {
+      impl->allocator.deallocate(impl->statistics, impl->allocator.state);
+      impl->statistics = NULL;
+    }
+    return RCL_RET_OK;
+  }
+  if (!impl->statistics) {
+    impl->statistics = (rcl_wait_statistics_t *)impl->allocator.allocate(
+      sizeof(rcl_wait_statistics_t), impl->allocator.state);
+    RCL_CHECK_FOR_NULL_WITH_MSG(
+      impl->statistics, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  }
+  rcl_wait_statistics_init(impl->statistics);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_get_statistics(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_statistics_t * statistics)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(statistics, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  if (!wait_set->impl->statistics) {
+    RCL_SET_ERROR_MSG("wait set statistics are not enabled");
+    return RCL_RET_ERROR;
+  }
+  rcl_wait_statistics_snapshot(wait_set->impl->statistics, statistics);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_set_adaptive_spin(rcl_wait_set_t * wait_set, int64_t max_spin_budget, bool use_pause)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  if (max_spin_budget < 0) {
+    RCL_SET_ERROR_MSG("spin budget must be non-negative");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  impl->spin_max_budget = max_spin_budget;
+  impl->spin_use_pause = use_pause;
+  // Start optimistic, polling that keeps failing shrinks the budget quickly.
+  impl->spin_success_rate = RCL_WAIT_SPIN_RATE_ONE;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_set_time_driver(rcl_wait_set_t * wait_set, rcl_time_driver_t * driver)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  if (NULL != driver && !rcl_time_driver_is_valid(driver)) {
+    RCL_SET_ERROR_MSG("time driver is invalid");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  if (impl->time_driver == driver) {
+    return RCL_RET_OK;
+  }
+  rcl_time_driver_slot_t * slot = NULL;
+  if (NULL != driver) {
+    rcl_ret_t ret = rcl_time_driver_attach(driver, &slot);
+    if (RCL_RET_OK != ret) {
+      return ret;  // The rcl error state should already be set.
+    }
+  }
+  if (NULL != impl->time_driver) {
+    rcl_time_driver_detach(impl->time_driver, impl->time_driver_slot);
+  }
+  impl->time_driver = driver;
+  impl->time_driver_slot = slot;
+  return RCL_RET_OK;
+}
+
+// Get the earliest next call time of the timers driven by the time driver of the wait set.
+static int64_t
+__wait_set_time_driver_deadline(const rcl_wait_set_t * wait_set)
+{
+  rcl_ros_time_source_t * source = rcl_time_driver_get_source(wait_set->impl->time_driver);
+  int64_t deadline = INT64_MAX;
+  for (size_t i = 0u; i < wait_set->impl->timer_index; ++i) {
+    const rcl_timer_t * timer = wait_set->timers[i];
+    if (!timer) {
+      continue;
+    }
+    rcl_clock_t * clock = NULL;
+    bool is_canceled = true;
+    int64_t next_call_time = INT64_MAX;
+    // rcl_timer_clock() does not modify the timer.
+    if (
+      RCL_RET_OK != rcl_timer_clock((rcl_timer_t *)(uintptr_t)timer, &clock) ||
+      RCL_RET_OK != rcl_timer_is_canceled(timer, &is_canceled) ||
+      RCL_RET_OK != rcl_timer_get_next_call_time(timer, &next_call_time))
+    {
+      rcl_reset_error();
+      continue;
+    }
+    if (!is_canceled && rcl_clock_get_ros_time_source(clock) == source &&
+      next_call_time < deadline)
+    {
+      deadline = next_call_time;
+    }
+  }
+  return deadline;
+}
+
+// Poll the rmw storage without blocking until something is ready or the spin budget is spent.
+// Returns RMW_RET_TIMEOUT if the caller still has to block, in which case the rmw storage
+// is intact and timeout_argument, if any, is reduced by the time spent polling.
+static rmw_ret_t
+__wait_set_spin(rcl_wait_set_t * wait_set, rmw_time_t * timeout_argument)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  int64_t budget = (int64_t)(
+    (double)impl->spin_max_budget * impl->spin_success_rate / RCL_WAIT_SPIN_RATE_ONE);
+  if (budget < impl->spin_max_budget / RCL_WAIT_SPIN_MIN_BUDGET_DIVISOR) {
+    budget = impl->spin_max_budget / RCL_WAIT_SPIN_MIN_BUDGET_DIVISOR;
+  }
+  int64_t remaining = INT64_MAX;
+  if (timeout_argument) {
+    remaining = RCL_S_TO_NS((int64_t)timeout_argument->sec) + (int64_t)timeout_argument->nsec;
+    if (budget > remaining) {
+      budget = remaining;
+    }
+  }
+  rcutils_time_point_value_t start;
+  if (budget <= 0 || RCUTILS_RET_OK != rcutils_steady_time_now(&start)) {
+    rcutils_reset_error();
+    return RMW_RET_TIMEOUT;
+  }
+
+  // rmw_wait() sets what is not ready to NULL, so each poll starts from a copy.
+  void ** rmw_storage[] = {
+    impl->rmw_subscriptions.subscribers,
+    impl->rmw_guard_conditions.guard_conditions,
+    impl->rmw_clients.clients,
+    impl->rmw_services.services,
+    impl->rmw_events.events,
+  };
+  const size_t rmw_counts[] = {
+    impl->rmw_subscriptions.subscriber_count,
+    impl->rmw_guard_conditions.guard_condition_count,
+    impl->rmw_clients.client_count,
+    impl->rmw_services.service_count,
+    impl->rmw_events.event_count,
+  };
+  const size_t storage_count = sizeof(rmw_counts) / sizeof(rmw_counts[0]);
+  void ** backup = impl->spin_backup;
+  for (size_t i = 0u; i < storage_count; ++i) {
+    if (rmw_counts[i] > 0u) {
+      memcpy(backup, rmw_storage[i], sizeof(void *) * rmw_counts[i]);
+      backup += rmw_counts[i];
+    }
+  }
+
+  rmw_time_t zero_timeout = {0, 0};
+  rmw_ret_t ret = RMW_RET_TIMEOUT;
+  int64_t elapsed = 0;
+  size_t pauses = 1u;
+  for (;; ) {
+    ret = rmw_wait(
+      &impl->rmw_subscriptions,
+      &impl->rmw_guard_conditions,
+      &impl->rmw_services,
+      &impl->rmw_clients,
+      &impl->rmw_events,
+      impl->rmw_wait_set,
+      &zero_timeout);
+    if (RMW_RET_TIMEOUT != ret) {
+      break;
+    }
+    backup = impl->spin_backup;
+    for (size_t i = 0u; i < storage_count; ++i) {
+      if (rmw_counts[i] > 0u) {
+        memcpy(rmw_storage[i], backup, sizeof(void *) * rmw_counts[i]);
+        backup += rmw_counts[i];
+      }
+    }
+    rcutils_time_point_value_t now;
+    if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+      rcutils_reset_error();
+      break;
+    }
+    elapsed = now - start;
+    if (elapsed >= budget) {
+      break;
+    }
+    if (impl->spin_use_pause) {
+      for (size_t i = 0u; i < pauses; ++i) {
+        RCL_WAIT_CPU_RELAX();
+      }
+      if (pauses < RCL_WAIT_SPIN_MAX_PAUSES) {
+        pauses *= 2u;
+      }
+    }
+  }
+
+  // Exponential moving average of whether polling avoided blocking.
+  const int32_t sample = RMW_RET_OK == ret ? RCL_WAIT_SPIN_RATE_ONE : 0;
+  impl->spin_success_rate += (sample - impl->spin_success_rate) >> RCL_WAIT_SPIN_RATE_SHIFT;
+
+  if (timeout_argument && RMW_RET_TIMEOUT == ret) {
+    remaining = elapsed < remaining ? remaining - elapsed : 0;
+    timeout_argument->sec = (uint64_t)RCL_NS_TO_S(remaining);
+    timeout_argument->nsec = (uint64_t)(remaining % 1000000000);
+  }
+  return ret;
+}
+
+// Attribute a call to rcl_wait() which did not fail, if statistics are enabled.
+static void
+__wait_set_record_statistics(
+  rcl_wait_set_t * wait_set,
+  bool is_timeout,
+  rcutils_time_point_value_t wait_start,
+  size_t ready_entities,
+  size_t ready_timers)
+{
+  rcutils_time_point_value_t wait_end = wait_start;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&wait_end)) {
+    rcutils_reset_error();
+  }
+  rcl_wait_wake_reason_t reason = RCL_WAIT_WAKE_SPURIOUS;
+  if (ready_entities > 0u) {
+    reason = RCL_WAIT_WAKE_ENTITY;
+  } else if (ready_timers > 0u) {
+    reason = RCL_WAIT_WAKE_TIMER;
+  } else if (is_timeout) {
+    reason = RCL_WAIT_WAKE_TIMEOUT;
+  }
+  rcl_wait_statistics_record(
+    wait_set->impl->statistics, reason, wait_end - wait_start, ready_entities, ready_timers);
+}
+
+// Copy the packed handles of a persistent wait set into the rmw storage, which
+// rmw_wait() overwrites on every call.
+static void
+__wait_set_persistent_prepare(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+#define PERSISTENT_PREPARE(Type, RMWStorage, RMWCount) \
+  if (impl->Type ## _persistent.count > 0u) { \
+    memcpy( \
+      impl->RMWStorage, impl->Type ## _persistent.rmw_handles, \
+      sizeof(void *) * impl->Type ## _persistent.count); \
+  } \
+  impl->RMWCount = impl->Type ## _persistent.count;
+
+  PERSISTENT_PREPARE(
+    subscription, rmw_subscriptions.subscribers, rmw_subscriptions.subscriber_count)
+  PERSISTENT_PREPARE(
+    guard_condition, rmw_guard_conditions.guard_conditions,
+    rmw_guard_conditions.guard_condition_count)
+  PERSISTENT_PREPARE(client, rmw_clients.clients, rmw_clients.client_count)
+  PERSISTENT_PREPARE(service, rmw_services.services, rmw_services.service_count)
+  PERSISTENT_PREPARE(event, rmw_events.events, rmw_events.event_count)
+#undef PERSISTENT_PREPARE
+
+  // Timer guard conditions follow the regular guard conditions.
+  rmw_guard_conditions_t * rmw_gcs = &impl->rmw_guard_conditions;
+  for (size_t i = 0u; i < impl->timer_persistent.count; ++i) {
+    void * rmw_gc_handle = impl->timer_persistent.rmw_handles[i];
+    if (NULL != rmw_gc_handle) {
+      rmw_gcs->guard_conditions[(rmw_gcs->guard_condition_count)++] = rmw_gc_handle;
+    }
+  }
+}
+
+// Append the guard conditions of the subscriptions receiving within their context to
+// the rmw storage, after those of the timers.
+// Returns true if one of them already has messages queued, the wait must not block then.
+static bool
+__wait_set_prepare_local_messages(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  rmw_guard_conditions_t * rmw_gcs = &impl->rmw_guard_conditions;
+  const bool persistent = impl->persistent;
+  const size_t count = persistent ? impl->subscription_persistent.count : impl->subscription_index;
+  bool has_messages = false;
+  for (size_t i = 0u; i < count; ++i) {
+    const size_t index = persistent ? impl->subscription_persistent.rcl_indices[i] : i;
+    void * rmw_gc_handle = impl->subscription_guard_conditions[index];
+    if (NULL == rmw_gc_handle || NULL == wait_set->subscriptions[index]) {
+      continue;
+    }
+    rmw_gcs->guard_conditions[(rmw_gcs->guard_condition_count)++] = rmw_gc_handle;
+    // The guard condition only tells about new messages, not about those left in the ring.
+    has_messages = has_messages || __wait_set_subscription_has_local_messages(wait_set, index);
+  }
+  return has_messages;
+}
+
+// Count the entities of a wait set and its descendants.
+static void
+__wait_set_hierarchy_count(const rcl_wait_set_t * wait_set, size_t sizes[])
+{
+  for (size_t type = 0u; type < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++type) {
+    const rcl_wait_set_entity_type_t entity_type = (rcl_wait_set_entity_type_t)type;
+    const size_t used = __wait_set_used_slots(wait_set, entity_type);
+    for (size_t i = 0u; i < used; ++i) {
+      if (NULL != __wait_set_get_entity(wait_set, entity_type, i)) {
+        ++sizes[type];
+      }
+    }
+  }
+  for (size_t i = 0u; i < wait_set->impl->child_slot_count; ++i) {
+    if (wait_set->impl->children[i]) {
+      __wait_set_hierarchy_count(wait_set->impl->children[i], sizes);
+    }
+  }
+}
+
+// Replace the flattened wait set of the root of a hierarchy by one mirroring all its entities,
+// with room for more so that the following additions are mirrored right away.
+static rcl_ret_t
+__wait_set_hierarchy_rebuild(rcl_wait_set_t * root)
+{
+  rcl_wait_set_impl_t * impl = root->impl;
+  size_t sizes[RCL_WAIT_SET_ENTITY_TYPE_COUNT] = {0u, 0u, 0u, 0u, 0u, 0u};
+  __wait_set_hierarchy_count(root, sizes);
+  if (NULL != impl->flattened) {
+    const rcl_wait_set_t * old = impl->flattened;
+    const size_t old_sizes[RCL_WAIT_SET_ENTITY_TYPE_COUNT] = {
+      old->size_of_subscriptions, old->size_of_guard_conditions, old->size_of_timers,
+      old->size_of_clients, old->size_of_services, old->size_of_events};
+    for (size_t type = 0u; type < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++type) {
+      sizes[type] = __wait_set_grow_capacity(old_sizes[type], sizes[type]);
+    }
+  }
+  rcl_wait_set_t * flattened = (rcl_wait_set_t *)impl->allocator.allocate(
+    sizeof(rcl_wait_set_t), impl->allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(flattened, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  *flattened = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret = rcl_wait_set_init(
+    flattened, sizes[0], sizes[1], sizes[2], sizes[3], sizes[4], sizes[5],
+    impl->context, impl->allocator);
+  if (RCL_RET_OK == ret) {
+    ret = rcl_wait_set_set_persistent(flattened, true);
+  }
+  const size_t total_capacity =
+    RCL_RET_OK == ret ? __wait_set_total_capacity(flattened->impl) : 0u;
+  if (RCL_RET_OK == ret && total_capacity > 0u) {
+    // Both arrays share a single block: the owners followed by their indices.
+    rcl_wait_set_t ** owners = (rcl_wait_set_t **)impl->allocator.reallocate(
+      impl->flattened_owners, (sizeof(rcl_wait_set_t *) + sizeof(size_t)) * total_capacity,
+      impl->allocator.state);
+    if (NULL == owners) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      ret = RCL_RET_BAD_ALLOC;
+    } else {
+      impl->flattened_owners = owners;
+      impl->flattened_owner_indices = (size_t *)(owners + total_capacity);
+    }
+  }
+  if (RCL_RET_OK != ret) {
+    (void)rcl_wait_set_fini(flattened);
+    impl->allocator.deallocate(flattened, impl->allocator.state);
+    return ret;  // The rcl error state should already be set.
+  }
+  // Entities are mirrored anew, the old flattened wait set is destroyed as a whole.
+  __wait_set_hierarchy_release(root, NULL, true);
+  rcl_wait_set_t * old = impl->flattened;
+  impl->flattened = flattened;
+  impl->flattened_stale = false;
+  __wait_set_hierarchy_track_all(root, root);
+  if (NULL != old) {
+    (void)rcl_wait_set_fini(old);
+    impl->allocator.deallocate(old, impl->allocator.state);
+  }
+  if (impl->flattened_stale) {
+    RCL_SET_ERROR_MSG("failed to mirror the entities of the hierarchy");
+    return RCL_RET_ERROR;
+  }
+  return RCL_RET_OK;
+}
+
+// Forget what the previous wait reported in a wait set and its descendants.
+static void
+__wait_set_hierarchy_reset_ready(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  impl->ready_child_count = 0u;
+  impl->ready_in_parent = false;
+  if (impl->persistent) {
+    for (size_t type = 0u; type < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++type) {
+      __wait_set_persistent_entities(impl, (rcl_wait_set_entity_type_t)type)->ready_count = 0u;
+    }
+  }
+  for (size_t i = 0u; i < impl->child_slot_count; ++i) {
+    if (impl->children[i]) {
+      __wait_set_hierarchy_reset_ready(impl->children[i]);
+    }
+  }
+}
+
+// List a wait set with a ready entity among the ready children of its ancestors.
+static void
+__wait_set_hierarchy_mark_ready(rcl_wait_set_t * wait_set)
+{
+  while (NULL != wait_set->impl->parent && !wait_set->impl->ready_in_parent) {
+    rcl_wait_set_impl_t * parent_impl = wait_set->impl->parent->impl;
+    parent_impl->ready_children[(parent_impl->ready_child_count)++] = wait_set->impl->parent_slot;
+    wait_set->impl->ready_in_parent = true;
+    wait_set = wait_set->impl->parent;
+  }
+}
+
+// Leave only the ready entities in the wait sets of a hierarchy which are not persistent,
+// as rcl_wait() does, and stop mirroring the others until they are added again.
+static void
+__wait_set_hierarchy_settle(rcl_wait_set_t * wait_set, rcl_wait_set_t * flattened)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  for (size_t type = 0u; !impl->persistent && type < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++type) {
+    const rcl_wait_set_entity_type_t entity_type = (rcl_wait_set_entity_type_t)type;
+    size_t * positions = impl->hierarchy_positions + __wait_set_key_offset(impl, entity_type);
+    const size_t used = __wait_set_used_slots(wait_set, entity_type);
+    for (size_t i = 0u; i < used; ++i) {
+      if (0u != (positions[i] & RCL_WAIT_SET_HIERARCHY_READY)) {
+        positions[i] &= ~RCL_WAIT_SET_HIERARCHY_READY;
+        continue;
+      }
+      if (0u != positions[i]) {
+        if (RCL_RET_OK != __wait_set_remove_entity(flattened, entity_type, positions[i] - 1u)) {
+          rcl_reset_error();
+        }
+        positions[i] = 0u;
+      }
+      __wait_set_set_entity(wait_set, entity_type, i, NULL);
+    }
+  }
+  for (size_t i = 0u; i < impl->child_slot_count; ++i) {
+    if (impl->children[i]) {
+      __wait_set_hierarchy_settle(impl->children[i], flattened);
+    }
+  }
+}
+
+// Report the ready entities of the flattened wait set to the wait sets they belong to.
+// Only the ready entities are visited, besides the storage of wait sets which are not
+// persistent, which rcl_wait() goes through anyway.
+static void
+__wait_set_hierarchy_scatter(rcl_wait_set_t * root)
+{
+  rcl_wait_set_impl_t * impl = root->impl;
+  rcl_wait_set_t * flattened = impl->flattened;
+  __wait_set_hierarchy_reset_ready(root);
+  for (size_t type = 0u; type < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++type) {
+    const rcl_wait_set_entity_type_t entity_type = (rcl_wait_set_entity_type_t)type;
+    const rcl_wait_set_persistent_entities_t * ready =
+      __wait_set_persistent_entities(flattened->impl, entity_type);
+    const size_t owner_offset = __wait_set_key_offset(flattened->impl, entity_type);
+    for (size_t j = 0u; j < ready->ready_count; ++j) {
+      const size_t owner = owner_offset + ready->ready_indices[j];
+      rcl_wait_set_t * wait_set = impl->flattened_owners[owner];
+      const size_t index = impl->flattened_owner_indices[owner];
+      rcl_wait_set_impl_t * owner_impl = wait_set->impl;
+      if (owner_impl->persistent) {
+        rcl_wait_set_persistent_entities_t * entities =
+          __wait_set_persistent_entities(owner_impl, entity_type);
+        entities->ready_indices[(entities->ready_count)++] = index;
+      } else {
+        owner_impl->hierarchy_positions[__wait_set_key_offset(owner_impl, entity_type) + index] |=
+          RCL_WAIT_SET_HIERARCHY_READY;
+      }
+      __wait_set_hierarchy_mark_ready(wait_set);
+    }
+  }
+  __wait_set_hierarchy_settle(root, flattened);
+}
+
+// Exchange the settings which shape how rcl_wait waits, so the flattened wait set can
+// wait on behalf of the root of a hierarchy.
+static void
+__wait_set_swap_wait_settings(rcl_wait_set_impl_t * a, rcl_wait_set_impl_t * b)
+{
+  rcl_timer_wakeup_t timer_wakeup = a->timer_wakeup;
+  a->timer_wakeup = b->timer_wakeup;
+  b->timer_wakeup = timer_wakeup;
+  int64_t timer_wakeup_margin = a->timer_wakeup_margin;
+  a->timer_wakeup_margin = b->timer_wakeup_margin;
+  b->timer_wakeup_margin = timer_wakeup_margin;
+  rcl_wait_statistics_t * statistics = a->statistics;
+  a->statistics = b->statistics;
+  b->statistics = statistics;
+  int64_t spin_max_budget = a->spin_max_budget;
+  a->spin_max_budget = b->spin_max_budget;
+  b->spin_max_budget = spin_max_budget;
+  bool spin_use_pause = a->spin_use_pause;
+  a->spin_use_pause = b->spin_use_pause;
+  b->spin_use_pause = spin_use_pause;
+  int32_t spin_success_rate = a->spin_success_rate;
+  a->spin_success_rate = b->spin_success_rate;
+  b->spin_success_rate = spin_success_rate;
+  rcl_time_driver_t * time_driver = a->time_driver;
+  a->time_driver = b->time_driver;
+  b->time_driver = time_driver;
+  rcl_time_driver_slot_t * time_driver_slot = a->time_driver_slot;
+  a->time_driver_slot = b->time_driver_slot;
+  b->time_driver_slot = time_driver_slot;
+}
+
+// Wait on a wait set with children by waiting once on the flattened wait set.
+static rcl_ret_t
+__wait_set_hierarchy_wait(rcl_wait_set_t * wait_set, int64_t timeout)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  if (NULL != impl->parent) {
+    RCL_SET_ERROR_MSG("only the root of a wait set hierarchy can wait on its children");
+    return RCL_RET_ERROR;
+  }
+  rcl_ret_t ret = RCL_RET_OK;
+  if (NULL == impl->flattened || impl->flattened_stale) {
+    ret = __wait_set_hierarchy_rebuild(wait_set);
+    if (RCL_RET_OK != ret) {
+      return ret;  // The rcl error state should already be set.
+    }
+  }
+  rcl_wait_set_t * flattened = impl->flattened;
+  __wait_set_swap_wait_settings(impl, flattened->impl);
+  ret = rcl_wait(flattened, timeout);
+  __wait_set_swap_wait_settings(impl, flattened->impl);
+  if (RCL_RET_OK != ret && RCL_RET_TIMEOUT != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  __wait_set_hierarchy_scatter(wait_set);
+  return ret;
+}
+
+static int
+__wait_set_ready_entry_compare(const void * lhs, const void * rhs)
+{
+  const rcl_wait_set_ready_entry_t * a = (const rcl_wait_set_ready_entry_t *)lhs;
+  const rcl_wait_set_ready_entry_t * b = (const rcl_wait_set_ready_entry_t *)rhs;
+  // Ties are broken by entity type and index, so the order does not depend on qsort.
+  if (a->key != b->key) {
+    return a->key < b->key ? -1 : 1;
+  }
+  if (a->entity_type != b->entity_type) {
+    return a->entity_type < b->entity_type ? -1 : 1;
+  }
+  return (a->index > b->index) - (a->index < b->index);
+}
+
+// Gather the entities found ready by the last wait into the ready list, ordered by key.
+static void
+__wait_set_build_ready_list(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  impl->ready_list_count = 0u;
+#define READY_LIST_PUSH(EntityType, Keys, Index) \
+  do { \
+    rcl_wait_set_ready_entry_t * entry = &impl->ready_list[(impl->ready_list_count)++]; \
+    entry->entity_type = EntityType; \
+    entry->index = Index; \
+    entry->key = Keys[Index]; \
+  } while (false)
+#define READY_LIST_APPEND(Type, EntityType) \
+  do { \
+    const int64_t * keys = impl->entity_keys + __wait_set_key_offset(impl, EntityType); \
+    if (impl->persistent) { \
+      /* Persistent wait sets already know which entities are ready. */ \
+      const rcl_wait_set_persistent_entities_t * entities = &impl->Type ## _persistent; \
+      for (size_t i = 0u; i < entities->ready_count; ++i) { \
+        READY_LIST_PUSH(EntityType, keys, entities->ready_indices[i]); \
+      } \
+    } else { \
+      for (size_t i = 0u; i < wait_set->size_of_ ## Type ## s; ++i) { \
+        if (wait_set->Type ## s[i]) { \
+          READY_LIST_PUSH(EntityType, keys, i); \
+        } \
+      } \
+    } \
+  } while (false)
+
+  READY_LIST_APPEND(subscription, RCL_WAIT_SET_SUBSCRIPTION);
+  READY_LIST_APPEND(guard_condition, RCL_WAIT_SET_GUARD_CONDITION);
+  READY_LIST_APPEND(timer, RCL_WAIT_SET_TIMER);
+  READY_LIST_APPEND(client, RCL_WAIT_SET_CLIENT);
+  READY_LIST_APPEND(service, RCL_WAIT_SET_SERVICE);
+  READY_LIST_APPEND(event, RCL_WAIT_SET_EVENT);
+#undef READY_LIST_APPEND
+#undef READY_LIST_PUSH
+  if (impl->ready_list_count > 1u) {
+    qsort(
+      impl->ready_list, impl->ready_list_count, sizeof(rcl_wait_set_ready_entry_t),
+      __wait_set_ready_entry_compare);
+  }
+}
+
+static rcl_ret_t
+__wait_set_wait(rcl_wait_set_t * wait_set, int64_t timeout)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  if (wait_set->impl->child_count > 0u) {
+    return __wait_set_hierarchy_wait(wait_set, timeout);
+  }
+  if (
+    wait_set->size_of_subscriptions == 0 &&
+    wait_set->size_of_guard_conditions == 0 &&
+    wait_set->size_of_timers == 0 &&
+    wait_set->size_of_clients == 0 &&
+    wait_set->size_of_services == 0 &&
+    wait_set->size_of_events == 0)
+  {
+    RCL_SET_ERROR_MSG("wait set is empty");
     return RCL_RET_WAIT_SET_EMPTY;
   }
   // Calculate the timeout argument.
@@ -544,7 +2296,27 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
 
   bool is_timer_timeout = false;
   int64_t min_timeout = timeout > 0 ? timeout : INT64_MAX;
-  {  // scope to prevent i from colliding below
+  const rcl_timer_t * earliest_timer = NULL;
+  // Timers sharing a time source are compared against a single reading of it.
+  rcl_clock_snapshot_t clock_snapshot;
+  rcl_clock_snapshot_reset(&clock_snapshot);
+  const bool persistent = wait_set->impl->persistent;
+  if (persistent) {
+    __wait_set_persistent_prepare(wait_set);
+    // The timer queue yields the earliest deadline, reading each clock once.
+    int64_t timer_timeout = INT64_MAX;
+    const rcl_timer_t * queue_timer = NULL;
+    rcl_ret_t ret = rcl_timer_queue_get_time_until_next_call(
+      &wait_set->impl->timer_queue, &timer_timeout, &queue_timer);
+    if (ret != RCL_RET_OK) {
+      return ret;  // The rcl error state should already be set.
+    }
+    if (NULL != queue_timer && timer_timeout < min_timeout) {
+      is_timer_timeout = true;
+      min_timeout = timer_timeout;
+      earliest_timer = queue_timer;
+    }
+  } else {  // scope to prevent i from colliding below
     uint64_t i = 0;
     for (i = 0; i < wait_set->impl->timer_index; ++i) {
       if (!wait_set->timers[i]) {
@@ -560,8 +2332,14 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
       }
       // use timer time to to set the rmw_wait timeout
       // TODO(sloretz) fix spurious wake-ups on ROS_TIME timers with ROS_TIME enabled
+      // These are counted as spurious wakes when statistics are enabled.
       int64_t timer_timeout = INT64_MAX;
-      rcl_ret_t ret = rcl_timer_get_time_until_next_call(wait_set->timers[i], &timer_timeout);
+      rcl_time_point_value_t now;
+      rcl_ret_t ret = rcl_clock_snapshot_get_timer_now(&clock_snapshot, wait_set->timers[i], &now);
+      if (ret != RCL_RET_OK) {
+        return ret;  // The rcl error state should already be set.
+      }
+      ret = rcl_timer_get_time_until_next_call_with_now(wait_set->timers[i], now, &timer_timeout);
       if (ret == RCL_RET_TIMER_CANCELED) {
         wait_set->timers[i] = NULL;
         continue;
@@ -569,14 +2347,57 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
       if (ret != RCL_RET_OK) {
         return ret;  // The rcl error state should already be set.
       }
+      // Wake up at the end of the timer's window, other timers may become due until then.
+      int64_t slack = 0;
+      ret = rcl_timer_get_slack(wait_set->timers[i], &slack);
+      if (ret != RCL_RET_OK) {
+        return ret;  // The rcl error state should already be set.
+      }
+      timer_timeout = timer_timeout > INT64_MAX - slack ? INT64_MAX : timer_timeout + slack;
       if (timer_timeout < min_timeout) {
         is_timer_timeout = true;
         min_timeout = timer_timeout;
+        earliest_timer = wait_set->timers[i];
+      }
+    }
+  }
+
+  const bool has_local_messages = __wait_set_prepare_local_messages(wait_set);
+
+  // Let the kernel timer wait out the last stretch before a steady or system
+  // timer deadline, it wakes up at the absolute deadline.
+  bool use_timer_wakeup = false;
+  rcl_clock_type_t wakeup_clock_type = RCL_CLOCK_UNINITIALIZED;
+  int64_t wakeup_deadline = 0;
+  int64_t wakeup_slack = 0;
+  if (
+    wait_set->impl->timer_wakeup.valid && is_timer_timeout && timeout != 0 && min_timeout > 0 &&
+    !has_local_messages)
+  {
+    rcl_clock_t * clock = NULL;
+    // rcl_timer_clock() does not modify the timer.
+    if (
+      RCL_RET_OK == rcl_timer_clock((rcl_timer_t *)(uintptr_t)earliest_timer, &clock) &&
+      rcl_timer_wakeup_supports_clock(clock->type) &&
+      RCL_RET_OK == rcl_timer_get_next_call_time(earliest_timer, &wakeup_deadline) &&
+      RCL_RET_OK == rcl_timer_get_slack(earliest_timer, &wakeup_slack))
+    {
+      wakeup_deadline = wakeup_deadline > INT64_MAX - wakeup_slack ?
+        INT64_MAX : wakeup_deadline + wakeup_slack;
+      if (rcl_tsc_clock_get_now == clock->get_now) {
+        // The kernel timer runs on the steady clock, which the counter is not exactly on.
+        wakeup_deadline = rcl_tsc_clock_to_steady_time(wakeup_deadline);
       }
+      use_timer_wakeup = true;
+      wakeup_clock_type = clock->type;
+      const int64_t margin = wait_set->impl->timer_wakeup_margin;
+      min_timeout = min_timeout > margin ? min_timeout - margin : 0;
+    } else {
+      rcl_reset_error();
     }
   }
 
-  if (timeout == 0) {
+  if (timeout == 0 || has_local_messages) {
     // Then it is non-blocking, so set the temporary storage to 0, 0 and pass it.
     temporary_timeout_storage.sec = 0;
     temporary_timeout_storage.nsec = 0;
@@ -591,33 +2412,144 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
     timeout_argument = &temporary_timeout_storage;
   }
 
+  rcutils_time_point_value_t wait_start = 0;
+  if (wait_set->impl->statistics && RCUTILS_RET_OK != rcutils_steady_time_now(&wait_start)) {
+    rcutils_reset_error();
+  }
+
+  const bool may_block =
+    NULL == timeout_argument || timeout_argument->sec > 0 || timeout_argument->nsec > 0;
+
+  // Poll first if adaptive spinning is enabled and the wait may block.
+  rmw_ret_t ret = RMW_RET_TIMEOUT;
+  if (wait_set->impl->spin_max_budget > 0 && may_block) {
+    ret = __wait_set_spin(wait_set, timeout_argument);
+  }
+
   // Wait.
-  rmw_ret_t ret = rmw_wait(
-    &wait_set->impl->rmw_subscriptions,
-    &wait_set->impl->rmw_guard_conditions,
-    &wait_set->impl->rmw_services,
-    &wait_set->impl->rmw_clients,
-    &wait_set->impl->rmw_events,
-    wait_set->impl->rmw_wait_set,
-    timeout_argument);
+  if (RMW_RET_TIMEOUT == ret) {
+    // The time driver may advance the time as soon as this wait set is idle, the
+    // jump callbacks of the timers then trigger their guard conditions.
+    rcl_time_driver_t * time_driver = may_block ? wait_set->impl->time_driver : NULL;
+    if (time_driver) {
+      rcl_time_driver_enter_idle(
+        time_driver, wait_set->impl->time_driver_slot, __wait_set_time_driver_deadline(wait_set));
+    }
+    ret = rmw_wait(
+      &wait_set->impl->rmw_subscriptions,
+      &wait_set->impl->rmw_guard_conditions,
+      &wait_set->impl->rmw_services,
+      &wait_set->impl->rmw_clients,
+      &wait_set->impl->rmw_events,
+      wait_set->impl->rmw_wait_set,
+      timeout_argument);
+    if (time_driver) {
+      rcl_time_driver_leave_idle(time_driver, wait_set->impl->time_driver_slot);
+    }
+  }
+
+  if (use_timer_wakeup && RMW_RET_TIMEOUT == ret) {
+    // Entities becoming ready during this last stretch are seen by the next wait.
+    rcl_ret_t wakeup_ret = rcl_timer_wakeup_sleep_until(
+      &wait_set->impl->timer_wakeup, wakeup_clock_type, wakeup_deadline,
+      wait_set->impl->timer_wakeup_margin);
+    if (RCL_RET_OK != wakeup_ret) {
+      return wakeup_ret;  // The rcl error state should already be set.
+    }
+  }
 
   // Items that are not ready will have been set to NULL by rmw_wait.
   // We now update our handles accordingly.
 
+  if (persistent) {
+    // Persistent wait sets keep their rcl storage intact and only record what is ready.
+    rcl_wait_set_persistent_entities_t * timers = &wait_set->impl->timer_persistent;
+    // A triggered timer guard condition means the timer was reset or its clock
+    // jumped, either of which may have moved its deadline earlier.
+    void ** timer_gcs = wait_set->impl->rmw_guard_conditions.guard_conditions +
+      wait_set->impl->guard_condition_persistent.count;
+    size_t timer_gc_index = 0u;
+    for (size_t i = 0u; RMW_RET_OK == ret && i < timers->count; ++i) {
+      if (NULL == timers->rmw_handles[i]) {
+        continue;
+      }
+      if (NULL != timer_gcs[timer_gc_index++]) {
+        rcl_timer_queue_update(&wait_set->impl->timer_queue, timers->rcl_indices[i]);
+      }
+    }
+    rcl_ret_t timer_ret = rcl_timer_queue_get_ready(
+      &wait_set->impl->timer_queue, timers->ready_indices, &timers->ready_count);
+    if (timer_ret != RCL_RET_OK) {
+      return timer_ret;  // The rcl error state should already be set.
+    }
+    if (ret != RMW_RET_OK && ret != RMW_RET_TIMEOUT) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      return RCL_RET_ERROR;
+    }
+    rcl_wait_set_persistent_entities_t * subscriptions = &wait_set->impl->subscription_persistent;
+    subscriptions->ready_count = 0u;
+    for (size_t i = 0u; i < subscriptions->count; ++i) {
+      const size_t index = subscriptions->rcl_indices[i];
+      if (
+        NULL != wait_set->impl->rmw_subscriptions.subscribers[i] ||
+        __wait_set_subscription_has_local_messages(wait_set, index))
+      {
+        subscriptions->ready_indices[(subscriptions->ready_count)++] = index;
+      }
+    }
+    __wait_set_persistent_collect(
+      &wait_set->impl->guard_condition_persistent,
+      wait_set->impl->rmw_guard_conditions.guard_conditions);
+    __wait_set_persistent_collect(
+      &wait_set->impl->client_persistent,
+      wait_set->impl->rmw_clients.clients);
+    __wait_set_persistent_collect(
+      &wait_set->impl->service_persistent,
+      wait_set->impl->rmw_services.services);
+    __wait_set_persistent_collect(
+      &wait_set->impl->event_persistent,
+      wait_set->impl->rmw_events.events);
+    if (wait_set->impl->statistics) {
+      const size_t ready_entities =
+        wait_set->impl->subscription_persistent.ready_count +
+        wait_set->impl->guard_condition_persistent.ready_count +
+        wait_set->impl->client_persistent.ready_count +
+        wait_set->impl->service_persistent.ready_count +
+        wait_set->impl->event_persistent.ready_count;
+      __wait_set_record_statistics(
+        wait_set, RMW_RET_TIMEOUT == ret && !is_timer_timeout && !has_local_messages, wait_start,
+        ready_entities, timers->ready_count);
+    }
+    if (RMW_RET_TIMEOUT == ret && !is_timer_timeout && !has_local_messages) {
+      return RCL_RET_TIMEOUT;
+    }
+    return RCL_RET_OK;
+  }
+
   // Check for ready timers
   // and set not ready timers (which includes canceled timers) to NULL.
+  // Time has passed while waiting, so each clock is read once more.
+  rcl_clock_snapshot_reset(&clock_snapshot);
   size_t i;
+  size_t ready_timers = 0u;
   for (i = 0; i < wait_set->impl->timer_index; ++i) {
     if (!wait_set->timers[i]) {
       continue;
     }
     bool is_ready = false;
-    rcl_ret_t ret = rcl_timer_is_ready(wait_set->timers[i], &is_ready);
+    rcl_time_point_value_t now;
+    rcl_ret_t ret = rcl_clock_snapshot_get_timer_now(&clock_snapshot, wait_set->timers[i], &now);
+    if (ret != RCL_RET_OK) {
+      return ret;  // The rcl error state should already be set.
+    }
+    ret = rcl_timer_is_ready_with_now(wait_set->timers[i], now, &is_ready);
     if (ret != RCL_RET_OK) {
       return ret;  // The rcl error state should already be set.
     }
     if (!is_ready) {
       wait_set->timers[i] = NULL;
+    } else {
+      ++ready_timers;
     }
   }
   // Check for timeout, return RCL_RET_TIMEOUT only if it wasn't a timer.
@@ -625,11 +2557,16 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
     return RCL_RET_ERROR;
   }
-  // Set corresponding rcl subscription handles NULL.
+  size_t ready_entities = 0u;
+  // Set corresponding rcl subscription handles NULL, unless messages are queued within the context.
   for (i = 0; i < wait_set->size_of_subscriptions; ++i) {
-    bool is_ready = wait_set->impl->rmw_subscriptions.subscribers[i] != NULL;
+    bool is_ready = wait_set->impl->rmw_subscriptions.subscribers[i] != NULL ||
+      (i < wait_set->impl->subscription_index &&
+      __wait_set_subscription_has_local_messages(wait_set, i));
     if (!is_ready) {
       wait_set->subscriptions[i] = NULL;
+    } else {
+      ++ready_entities;
     }
   }
   // Set corresponding rcl guard_condition handles NULL.
@@ -637,6 +2574,8 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
     bool is_ready = wait_set->impl->rmw_guard_conditions.guard_conditions[i] != NULL;
     if (!is_ready) {
       wait_set->guard_conditions[i] = NULL;
+    } else {
+      ++ready_entities;
     }
   }
   // Set corresponding rcl client handles NULL.
@@ -644,6 +2583,8 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
     bool is_ready = wait_set->impl->rmw_clients.clients[i] != NULL;
     if (!is_ready) {
       wait_set->clients[i] = NULL;
+    } else {
+      ++ready_entities;
     }
   }
   // Set corresponding rcl service handles NULL.
@@ -651,6 +2592,8 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
     bool is_ready = wait_set->impl->rmw_services.services[i] != NULL;
     if (!is_ready) {
       wait_set->services[i] = NULL;
+    } else {
+      ++ready_entities;
     }
   }
   // Set corresponding rcl event handles NULL.
@@ -658,15 +2601,118 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
     bool is_ready = wait_set->impl->rmw_events.events[i] != NULL;
     if (!is_ready) {
       wait_set->events[i] = NULL;
+    } else {
+      ++ready_entities;
     }
   }
 
-  if (RMW_RET_TIMEOUT == ret && !is_timer_timeout) {
+  if (wait_set->impl->statistics) {
+    __wait_set_record_statistics(
+      wait_set, RMW_RET_TIMEOUT == ret && !is_timer_timeout && !has_local_messages, wait_start,
+      ready_entities, ready_timers);
+  }
+  if (RMW_RET_TIMEOUT == ret && !is_timer_timeout && !has_local_messages) {
     return RCL_RET_TIMEOUT;
   }
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
+{
+  rcl_ret_t ret = __wait_set_wait(wait_set, timeout);
+  if ((RCL_RET_OK == ret || RCL_RET_TIMEOUT == ret) && wait_set->impl->ready_list_enabled) {
+    __wait_set_build_ready_list(wait_set);
+  }
+  return ret;
+}
+
+// Take up to count messages from a subscription which rcl_wait() found ready.
+static rcl_ret_t
+__wait_set_take_batch(
+  const rcl_subscription_t * subscription,
+  size_t count,
+  rmw_message_sequence_t * message_sequence,
+  rmw_message_info_sequence_t * message_info_sequence,
+  size_t * taken_count)
+{
+  if (!rcl_subscription_is_valid(subscription)) {
+    return RCL_RET_SUBSCRIPTION_INVALID;  // error message already set
+  }
+  if (count > message_sequence->capacity) {
+    count = message_sequence->capacity;
+  }
+  if (count > message_info_sequence->capacity) {
+    count = message_info_sequence->capacity;
+  }
+  if (0u == count) {
+    return RCL_RET_OK;
+  }
+  size_t taken = 0u;
+  rcl_ret_t ret = __subscription_take_sequence(
+    subscription, count, message_sequence, message_info_sequence, &taken, NULL);
+  if (ret != RCL_RET_OK) {
+    RCL_TRAFFIC_COUNT_ERROR(subscription->impl);
+    return ret;  // error already set
+  }
+  if (0u == taken) {
+    RCL_TRAFFIC_COUNT_TAKE_FAILED(subscription->impl);
+  } else {
+    RCL_TRAFFIC_COUNT_MESSAGES(subscription->impl, taken, 0u);
+  }
+  *taken_count += taken;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_and_take(
+  rcl_wait_set_t * wait_set,
+  int64_t timeout,
+  size_t max_messages_per_subscription,
+  rmw_message_sequence_t * message_sequences,
+  rmw_message_info_sequence_t * message_info_sequences,
+  size_t * taken_count)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(taken_count, RCL_RET_INVALID_ARGUMENT);
+  if (wait_set->size_of_subscriptions > 0u) {
+    RCL_CHECK_ARGUMENT_FOR_NULL(message_sequences, RCL_RET_INVALID_ARGUMENT);
+    RCL_CHECK_ARGUMENT_FOR_NULL(message_info_sequences, RCL_RET_INVALID_ARGUMENT);
+  }
+  *taken_count = 0u;
+  rcl_ret_t ret = rcl_wait(wait_set, timeout);
+  // rcl_wait() checked that the wait set is valid before the sequences are touched.
+  if (RCL_RET_OK != ret && RCL_RET_TIMEOUT != ret) {
+    return ret;  // The rcl error state should already be set.
+  }
+  for (size_t i = 0u; i < wait_set->size_of_subscriptions; ++i) {
+    message_sequences[i].size = 0u;
+    message_info_sequences[i].size = 0u;
+  }
+  if (RCL_RET_OK != ret) {
+    return ret;
+  }
+
+  // Persistent wait sets list their ready subscriptions, others keep only those in place.
+  const rcl_wait_set_persistent_entities_t * ready = &wait_set->impl->subscription_persistent;
+  const bool persistent = wait_set->impl->persistent;
+  const size_t candidate_count = persistent ? ready->ready_count : wait_set->size_of_subscriptions;
+  for (size_t i = 0u; i < candidate_count; ++i) {
+    const size_t index = persistent ? ready->ready_indices[i] : i;
+    if (NULL == wait_set->subscriptions[index]) {
+      continue;
+    }
+    rcl_ret_t take_ret = __wait_set_take_batch(
+      wait_set->subscriptions[index], max_messages_per_subscription,
+      &message_sequences[index], &message_info_sequences[index], taken_count);
+    if (RCL_RET_OK != take_ret) {
+      return take_ret;  // The rcl error state should already be set.
+    }
+  }
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Wait and take took %zu messages", *taken_count);
+  return RCL_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
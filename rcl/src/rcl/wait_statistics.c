@@ -0,0 +1,138 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./wait_statistics.h"
+
+#define SUB_BUCKET_COUNT (1u << RCL_WAIT_SET_STATISTICS_SUB_BUCKET_BITS)
+
+void
+rcl_wait_statistics_init(rcl_wait_statistics_t * statistics)
+{
+  atomic_init(&statistics->sequence, 0u);
+  atomic_init(&statistics->wait_count, 0u);
+  for (size_t i = 0u; i <= RCL_WAIT_WAKE_SPURIOUS; ++i) {
+    atomic_init(&statistics->wake_counts[i], 0u);
+  }
+  atomic_init(&statistics->ready_entity_count, 0u);
+  atomic_init(&statistics->ready_timer_count, 0u);
+  atomic_init(&statistics->blocked_time, 0u);
+  for (size_t i = 0u; i < RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE; ++i) {
+    atomic_init(&statistics->blocked_time_histogram[i], 0u);
+    atomic_init(&statistics->ready_count_histogram[i], 0u);
+  }
+}
+
+size_t
+rcl_wait_statistics_bucket(uint64_t value)
+{
+  if (value < SUB_BUCKET_COUNT) {
+    return (size_t)value;
+  }
+  // Buckets double in width with every power of two, each split into equal sub-buckets.
+  unsigned int msb = 0u;
+  for (unsigned int shift = 32u; shift > 0u; shift /= 2u) {
+    if (value >> (msb + shift)) {
+      msb += shift;
+    }
+  }
+  const uint64_t sub_bucket =
+    (value >> (msb - RCL_WAIT_SET_STATISTICS_SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1u);
+  return (size_t)(msb - RCL_WAIT_SET_STATISTICS_SUB_BUCKET_BITS + 1u) * SUB_BUCKET_COUNT +
+         (size_t)sub_bucket;
+}
+
+uint64_t
+rcl_wait_set_statistics_bucket_lower_bound(size_t bucket)
+{
+  if (bucket < SUB_BUCKET_COUNT) {
+    return (uint64_t)bucket;
+  }
+  if (bucket >= RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE) {
+    return UINT64_MAX;
+  }
+  const size_t shift = bucket / SUB_BUCKET_COUNT - 1u;
+  return ((uint64_t)SUB_BUCKET_COUNT + bucket % SUB_BUCKET_COUNT) << shift;
+}
+
+// Only the waiting thread writes, so a load and a store are enough to increment.
+static void
+__wait_statistics_add(atomic_uint_least64_t * counter, uint64_t value)
+{
+  rcutils_atomic_store(counter, rcutils_atomic_load_uint64_t(counter) + value);
+}
+
+void
+rcl_wait_statistics_record(
+  rcl_wait_statistics_t * statistics,
+  rcl_wait_wake_reason_t reason,
+  int64_t blocked_time,
+  size_t ready_entities,
+  size_t ready_timers)
+{
+  const uint64_t blocked = blocked_time > 0 ? (uint64_t)blocked_time : 0u;
+  const uint64_t sequence = rcutils_atomic_load_uint64_t(&statistics->sequence);
+  rcutils_atomic_store(&statistics->sequence, sequence + 1u);
+  __wait_statistics_add(&statistics->wait_count, 1u);
+  __wait_statistics_add(&statistics->wake_counts[reason], 1u);
+  __wait_statistics_add(&statistics->ready_entity_count, ready_entities);
+  __wait_statistics_add(&statistics->ready_timer_count, ready_timers);
+  __wait_statistics_add(&statistics->blocked_time, blocked);
+  __wait_statistics_add(
+    &statistics->blocked_time_histogram[rcl_wait_statistics_bucket(blocked)], 1u);
+  __wait_statistics_add(
+    &statistics->ready_count_histogram[rcl_wait_statistics_bucket(ready_entities + ready_timers)],
+    1u);
+  rcutils_atomic_store(&statistics->sequence, sequence + 2u);
+}
+
+void
+rcl_wait_statistics_snapshot(
+  rcl_wait_statistics_t * statistics,
+  rcl_wait_set_statistics_t * snapshot)
+{
+  uint64_t sequence;
+  do {
+    // The writer holds the sequence odd only for the few stores of one record.
+    do {
+      sequence = rcutils_atomic_load_uint64_t(&statistics->sequence);
+    } while (sequence & 1u);
+    snapshot->wait_count = rcutils_atomic_load_uint64_t(&statistics->wait_count);
+    snapshot->timeout_wake_count =
+      rcutils_atomic_load_uint64_t(&statistics->wake_counts[RCL_WAIT_WAKE_TIMEOUT]);
+    snapshot->entity_wake_count =
+      rcutils_atomic_load_uint64_t(&statistics->wake_counts[RCL_WAIT_WAKE_ENTITY]);
+    snapshot->timer_wake_count =
+      rcutils_atomic_load_uint64_t(&statistics->wake_counts[RCL_WAIT_WAKE_TIMER]);
+    snapshot->spurious_wake_count =
+      rcutils_atomic_load_uint64_t(&statistics->wake_counts[RCL_WAIT_WAKE_SPURIOUS]);
+    snapshot->ready_entity_count = rcutils_atomic_load_uint64_t(&statistics->ready_entity_count);
+    snapshot->ready_timer_count = rcutils_atomic_load_uint64_t(&statistics->ready_timer_count);
+    snapshot->blocked_time = rcutils_atomic_load_uint64_t(&statistics->blocked_time);
+    for (size_t i = 0u; i < RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE; ++i) {
+      snapshot->blocked_time_histogram[i] =
+        rcutils_atomic_load_uint64_t(&statistics->blocked_time_histogram[i]);
+      snapshot->ready_count_histogram[i] =
+        rcutils_atomic_load_uint64_t(&statistics->ready_count_histogram[i]);
+    }
+  } while (rcutils_atomic_load_uint64_t(&statistics->sequence) != sequence);
+}
+
+#ifdef __cplusplus
+}
+#endif
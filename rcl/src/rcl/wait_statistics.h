@@ -0,0 +1,87 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__WAIT_STATISTICS_H_
+#define RCL__WAIT_STATISTICS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcl/wait.h"
+#include "rcutils/stdatomic_helper.h"
+
+/// Why a call to rcl_wait() returned.
+typedef enum rcl_wait_wake_reason_e
+{
+  /// The timeout given by the caller expired with nothing ready.
+  RCL_WAIT_WAKE_TIMEOUT,
+  /// A subscription, guard condition, client, service or event was ready.
+  RCL_WAIT_WAKE_ENTITY,
+  /// Only timers were ready.
+  RCL_WAIT_WAKE_TIMER,
+  /// Woken up for a timer deadline or guard condition, but nothing was ready.
+  RCL_WAIT_WAKE_SPURIOUS,
+} rcl_wait_wake_reason_t;
+
+/// Counters of a wait set, written by the waiting thread only.
+/**
+ * Readers take snapshots concurrently: the writer makes the sequence odd
+ * while it updates the counters, and readers retry until they copied
+ * everything under the same even sequence.
+ */
+typedef struct rcl_wait_statistics_s
+{
+  atomic_uint_least64_t sequence;
+  atomic_uint_least64_t wait_count;
+  atomic_uint_least64_t wake_counts[RCL_WAIT_WAKE_SPURIOUS + 1];
+  atomic_uint_least64_t ready_entity_count;
+  atomic_uint_least64_t ready_timer_count;
+  atomic_uint_least64_t blocked_time;
+  atomic_uint_least64_t blocked_time_histogram[RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE];
+  atomic_uint_least64_t ready_count_histogram[RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE];
+} rcl_wait_statistics_t;
+
+/// Set all counters to zero.
+void
+rcl_wait_statistics_init(rcl_wait_statistics_t * statistics);
+
+/// Account for one call to rcl_wait().
+void
+rcl_wait_statistics_record(
+  rcl_wait_statistics_t * statistics,
+  rcl_wait_wake_reason_t reason,
+  int64_t blocked_time,
+  size_t ready_entities,
+  size_t ready_timers);
+
+/// Copy a consistent snapshot of the counters, safe to call from any thread.
+void
+rcl_wait_statistics_snapshot(
+  rcl_wait_statistics_t * statistics,
+  rcl_wait_set_statistics_t * snapshot);
+
+/// Get the histogram bucket holding `value`.
+size_t
+rcl_wait_statistics_bucket(uint64_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__WAIT_STATISTICS_H_
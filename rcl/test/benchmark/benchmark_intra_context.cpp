@@ -0,0 +1,224 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rcl/error_handling.h"
+#include "rcl/rcl.h"
+#include "rosidl_runtime_c/primitives_sequence_functions.h"
+#include "test_msgs/msg/unbounded_sequences.h"
+
+#include "../rcl/wait_for_entity_helpers.hpp"
+
+using performance_test_fixture::PerformanceTest;
+
+namespace
+{
+constexpr char kTopic[] = "/benchmark_intra_context";
+constexpr int64_t kMessageSizes[] = {1024, 64 * 1024, 1024 * 1024};
+
+// The first argument is the payload size in bytes, the second whether the
+// endpoints deliver within the context.
+void
+message_sizes(benchmark::internal::Benchmark * b)
+{
+  for (const int64_t size : kMessageSizes) {
+    b->Args({size, 0});
+    b->Args({size, 1});
+  }
+}
+
+void
+intra_context_message_sizes(benchmark::internal::Benchmark * b)
+{
+  for (const int64_t size : kMessageSizes) {
+    b->Args({size, 1});
+  }
+}
+}
+
+// Cost of handing a large message from rcl_publish() to rcl_take() within one
+// context, through the middleware or within the context, where the message is
+// copied once on each side, or with loaned messages, where it is not copied.
+class IntraContextTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & st) override
+  {
+    PerformanceTest::SetUp(st);
+    rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+    rcl_ret_t ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    context = rcl_get_zero_initialized_context();
+    ret = rcl_init(0, nullptr, &init_options, &context);
+    (void)rcl_init_options_fini(&init_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    node = rcl_get_zero_initialized_node();
+    rcl_node_options_t node_options = rcl_node_get_default_options();
+    ret = rcl_node_init(&node, "benchmark_intra_context_node", "", &context, &node_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    const bool intra_context = 0 != st.range(1);
+    publisher = rcl_get_zero_initialized_publisher();
+    rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+    publisher_options.intra_context = intra_context;
+    ret = rcl_publisher_init(&publisher, &node, ts, kTopic, &publisher_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    subscription = rcl_get_zero_initialized_subscription();
+    rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+    subscription_options.intra_context = intra_context;
+    ret = rcl_subscription_init(&subscription, &node, ts, kTopic, &subscription_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    if (
+      intra_context &&
+      nullptr == rcl_subscription_get_intra_context_guard_condition(&subscription))
+    {
+      st.SkipWithError("the subscription does not receive within its context");
+      return;
+    }
+    wait_set = rcl_get_zero_initialized_wait_set();
+    ret = rcl_wait_set_init(&wait_set, 1, 0, 0, 0, 0, 0, &context, rcl_get_default_allocator());
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    if (!wait_for_established_subscription(&publisher, 10, 100)) {
+      st.SkipWithError("subscription was not established");
+      return;
+    }
+    if (
+      !test_msgs__msg__UnboundedSequences__init(&message) ||
+      !rosidl_runtime_c__uint8__Sequence__init(
+        &message.uint8_values, static_cast<size_t>(st.range(0))))
+    {
+      st.SkipWithError("failed to allocate the message");
+      return;
+    }
+    memset(message.uint8_values.data, 0x5a, message.uint8_values.size);
+  }
+
+  void TearDown(benchmark::State & st) override
+  {
+    test_msgs__msg__UnboundedSequences__fini(&message);
+    (void)rcl_wait_set_fini(&wait_set);
+    (void)rcl_subscription_fini(&subscription, &node);
+    (void)rcl_publisher_fini(&publisher, &node);
+    (void)rcl_node_fini(&node);
+    (void)rcl_shutdown(&context);
+    (void)rcl_context_fini(&context);
+    rcl_reset_error();
+    PerformanceTest::TearDown(st);
+  }
+
+protected:
+  // Wait until the subscription is ready.
+  rcl_ret_t wait()
+  {
+    rcl_ret_t ret = RCL_RET_TIMEOUT;
+    while (RCL_RET_TIMEOUT == ret) {
+      ret = rcl_wait_set_clear(&wait_set);
+      if (RCL_RET_OK == ret) {
+        ret = rcl_wait_set_add_subscription(&wait_set, &subscription, nullptr);
+      }
+      if (RCL_RET_OK == ret) {
+        ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+      }
+    }
+    return ret;
+  }
+
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, UnboundedSequences);
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  test_msgs__msg__UnboundedSequences message{};
+};
+
+BENCHMARK_DEFINE_F(IntraContextTest, publish_and_take)(benchmark::State & st)
+{
+  test_msgs__msg__UnboundedSequences taken;
+  if (!test_msgs__msg__UnboundedSequences__init(&taken)) {
+    st.SkipWithError("failed to allocate the message");
+    return;
+  }
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcl_ret_t ret = rcl_publish(&publisher, &message, nullptr);
+    if (RCL_RET_OK == ret) {
+      ret = wait();
+    }
+    if (RCL_RET_OK == ret) {
+      ret = rcl_take(&subscription, &taken, nullptr, nullptr);
+    }
+    if (RCL_RET_OK != ret && RCL_RET_SUBSCRIPTION_TAKE_FAILED != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      break;
+    }
+  }
+  test_msgs__msg__UnboundedSequences__fini(&taken);
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(IntraContextTest, publish_and_take)->Apply(message_sizes);
+
+BENCHMARK_DEFINE_F(IntraContextTest, publish_and_take_loaned)(benchmark::State & st)
+{
+  reset_heap_counters();
+  for (auto _ : st) {
+    void * loaned_message = nullptr;
+    rcl_ret_t ret = rcl_borrow_loaned_message(&publisher, ts, &loaned_message);
+    if (RCL_RET_OK == ret) {
+      // The payload is filled in place, as a loaning publisher would.
+      auto msg = static_cast<test_msgs__msg__UnboundedSequences *>(loaned_message);
+      if (rosidl_runtime_c__uint8__Sequence__init(&msg->uint8_values, message.uint8_values.size)) {
+        memcpy(msg->uint8_values.data, message.uint8_values.data, message.uint8_values.size);
+      }
+      ret = rcl_publish_loaned_message(&publisher, loaned_message, nullptr);
+    }
+    if (RCL_RET_OK == ret) {
+      ret = wait();
+    }
+    void * taken_message = nullptr;
+    if (RCL_RET_OK == ret) {
+      ret = rcl_take_loaned_message(&subscription, &taken_message, nullptr, nullptr);
+    }
+    if (RCL_RET_OK == ret) {
+      ret = rcl_return_loaned_message_from_subscription(&subscription, taken_message);
+    }
+    if (RCL_RET_OK != ret && RCL_RET_SUBSCRIPTION_TAKE_FAILED != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      break;
+    }
+  }
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(IntraContextTest, publish_and_take_loaned)->Apply(intra_context_message_sizes);
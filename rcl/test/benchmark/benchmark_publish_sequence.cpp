@@ -0,0 +1,131 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rcl/error_handling.h"
+#include "rcl/rcl.h"
+#include "rmw/message_sequence.h"
+#include "test_msgs/msg/basic_types.h"
+
+using performance_test_fixture::PerformanceTest;
+
+namespace
+{
+constexpr char kTopic[] = "/benchmark_publish_sequence";
+constexpr size_t kBurstSize = 64u;
+}
+
+// Throughput of publishing bursts of messages, one call per message or one call per burst.
+class PublishSequenceTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & st) override
+  {
+    PerformanceTest::SetUp(st);
+    rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+    rcl_ret_t ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    context = rcl_get_zero_initialized_context();
+    ret = rcl_init(0, nullptr, &init_options, &context);
+    (void)rcl_init_options_fini(&init_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    node = rcl_get_zero_initialized_node();
+    rcl_node_options_t node_options = rcl_node_get_default_options();
+    ret = rcl_node_init(&node, "benchmark_publish_sequence_node", "", &context, &node_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    const rosidl_message_type_support_t * ts =
+      ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+    publisher = rcl_get_zero_initialized_publisher();
+    rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+    ret = rcl_publisher_init(&publisher, &node, ts, kTopic, &publisher_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    rcl_allocator_t allocator = rcl_get_default_allocator();
+    if (RMW_RET_OK != rmw_message_sequence_init(&messages, kBurstSize, &allocator)) {
+      st.SkipWithError("failed to allocate the message sequence");
+      return;
+    }
+    burst = test_msgs__msg__BasicTypes__Sequence__create(kBurstSize);
+    if (nullptr == burst) {
+      st.SkipWithError("failed to allocate the messages");
+      return;
+    }
+    for (size_t i = 0u; i < kBurstSize; ++i) {
+      burst->data[i].int64_value = static_cast<int64_t>(i);
+      messages.data[i] = &burst->data[i];
+    }
+    messages.size = kBurstSize;
+  }
+
+  void TearDown(benchmark::State & st) override
+  {
+    if (nullptr != burst) {
+      test_msgs__msg__BasicTypes__Sequence__destroy(burst);
+      burst = nullptr;
+    }
+    (void)rmw_message_sequence_fini(&messages);
+    (void)rcl_publisher_fini(&publisher, &node);
+    (void)rcl_node_fini(&node);
+    (void)rcl_shutdown(&context);
+    (void)rcl_context_fini(&context);
+    rcl_reset_error();
+    PerformanceTest::TearDown(st);
+  }
+
+protected:
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rmw_message_sequence_t messages = rmw_get_zero_initialized_message_sequence();
+  test_msgs__msg__BasicTypes__Sequence * burst = nullptr;
+};
+
+BENCHMARK_F(PublishSequenceTest, publish_loop)(benchmark::State & st)
+{
+  reset_heap_counters();
+  for (auto _ : st) {
+    for (size_t i = 0u; i < kBurstSize; ++i) {
+      if (RCL_RET_OK != rcl_publish(&publisher, &burst->data[i], nullptr)) {
+        st.SkipWithError(rcl_get_error_string().str);
+        return;
+      }
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * kBurstSize));
+}
+
+BENCHMARK_F(PublishSequenceTest, publish_sequence)(benchmark::State & st)
+{
+  reset_heap_counters();
+  for (auto _ : st) {
+    size_t published_count = 0u;
+    if (RCL_RET_OK != rcl_publish_sequence(&publisher, &messages, &published_count, nullptr)) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * kBurstSize));
+}
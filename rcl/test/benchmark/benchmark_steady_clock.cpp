@@ -0,0 +1,101 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rcl/error_handling.h"
+#include "rcl/time.h"
+
+using performance_test_fixture::PerformanceTest;
+
+// Cost of one rcl_clock_get_now() call on a steady clock, and whether it ever went backwards.
+class SteadyClockTest : public PerformanceTest
+{
+public:
+  void TearDown(benchmark::State & st) override
+  {
+    if (clock_initialized) {
+      (void)rcl_clock_fini(&clock);
+    }
+    rcl_reset_error();
+    PerformanceTest::TearDown(st);
+  }
+
+protected:
+  void measure(benchmark::State & st)
+  {
+    rcl_clock_t steady_clock;
+    rcl_allocator_t allocator = rcl_get_default_allocator();
+    if (RCL_RET_OK != rcl_steady_clock_init(&steady_clock, &allocator)) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    rcl_time_point_value_t previous = 0;
+    if (RCL_RET_OK != rcl_clock_get_now(&clock, &previous)) {
+      st.SkipWithError(rcl_get_error_string().str);
+      (void)rcl_clock_fini(&steady_clock);
+      return;
+    }
+    int64_t backward_steps = 0;
+    reset_heap_counters();
+
+    for (auto _ : st) {
+      rcl_time_point_value_t now;
+      (void)rcl_clock_get_now(&clock, &now);
+      backward_steps += now < previous;
+      previous = now;
+    }
+
+    // Distance to the steady clock, read right before and after.
+    int64_t max_offset = 0;
+    for (int i = 0; i < 1000; ++i) {
+      rcl_time_point_value_t before = 0, now = 0, after = 0;
+      (void)rcl_clock_get_now(&steady_clock, &before);
+      (void)rcl_clock_get_now(&clock, &now);
+      (void)rcl_clock_get_now(&steady_clock, &after);
+      max_offset = std::max(max_offset, std::max(before - now, now - after));
+    }
+    (void)rcl_clock_fini(&steady_clock);
+    st.counters["backward_steps"] = static_cast<double>(backward_steps);
+    st.counters["max_offset_ns"] = static_cast<double>(max_offset);
+  }
+
+  rcl_clock_t clock;
+  bool clock_initialized = false;
+};
+
+BENCHMARK_F(SteadyClockTest, steady_clock_get_now)(benchmark::State & st)
+{
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  if (RCL_RET_OK != rcl_steady_clock_init(&clock, &allocator)) {
+    st.SkipWithError(rcl_get_error_string().str);
+    return;
+  }
+  clock_initialized = true;
+  measure(st);
+}
+
+BENCHMARK_F(SteadyClockTest, fast_steady_clock_get_now)(benchmark::State & st)
+{
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  if (RCL_RET_OK != rcl_fast_steady_clock_init(&clock, &allocator)) {
+    st.SkipWithError(rcl_get_error_string().str);
+    return;
+  }
+  clock_initialized = true;
+  st.counters["uses_tsc"] = rcl_fast_steady_clock_is_supported() ? 1.0 : 0.0;
+  measure(st);
+}
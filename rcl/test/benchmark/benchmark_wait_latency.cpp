@@ -0,0 +1,182 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rcl/error_handling.h"
+#include "rcl/rcl.h"
+#include "rcutils/time.h"
+#include "test_msgs/msg/basic_types.h"
+
+#include "../rcl/wait_for_entity_helpers.hpp"
+
+using performance_test_fixture::PerformanceTest;
+
+namespace
+{
+constexpr char kTopic[] = "/benchmark_wait_latency";
+constexpr auto kPublishPeriod = std::chrono::microseconds(200);
+constexpr int64_t kMaxSpinBudget = RCL_MS_TO_NS(1);
+}
+
+// Latency from rcl_publish() to rcl_take() on a loopback publisher and subscription.
+class WaitLatencyTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & st) override
+  {
+    PerformanceTest::SetUp(st);
+    rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+    rcl_ret_t ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    context = rcl_get_zero_initialized_context();
+    ret = rcl_init(0, nullptr, &init_options, &context);
+    (void)rcl_init_options_fini(&init_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    node = rcl_get_zero_initialized_node();
+    rcl_node_options_t node_options = rcl_node_get_default_options();
+    ret = rcl_node_init(&node, "benchmark_wait_latency_node", "", &context, &node_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    const rosidl_message_type_support_t * ts =
+      ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+    publisher = rcl_get_zero_initialized_publisher();
+    rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+    ret = rcl_publisher_init(&publisher, &node, ts, kTopic, &publisher_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    subscription = rcl_get_zero_initialized_subscription();
+    rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+    ret = rcl_subscription_init(&subscription, &node, ts, kTopic, &subscription_options);
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    wait_set = rcl_get_zero_initialized_wait_set();
+    ret = rcl_wait_set_init(&wait_set, 1, 0, 0, 0, 0, 0, &context, rcl_get_default_allocator());
+    if (RCL_RET_OK != ret) {
+      st.SkipWithError(rcl_get_error_string().str);
+      return;
+    }
+    if (!wait_for_established_subscription(&publisher, 10, 100)) {
+      st.SkipWithError("subscription was not established");
+    }
+  }
+
+  void TearDown(benchmark::State & st) override
+  {
+    (void)rcl_wait_set_fini(&wait_set);
+    (void)rcl_subscription_fini(&subscription, &node);
+    (void)rcl_publisher_fini(&publisher, &node);
+    (void)rcl_node_fini(&node);
+    (void)rcl_shutdown(&context);
+    (void)rcl_context_fini(&context);
+    rcl_reset_error();
+    PerformanceTest::TearDown(st);
+  }
+
+protected:
+  void measure(benchmark::State & st)
+  {
+    std::atomic_bool running{true};
+    std::thread publisher_thread([this, &running]() {
+        test_msgs__msg__BasicTypes msg;
+        test_msgs__msg__BasicTypes__init(&msg);
+        while (running.load()) {
+          rcutils_time_point_value_t now;
+          if (RCUTILS_RET_OK == rcutils_steady_time_now(&now)) {
+            msg.int64_value = now;
+            (void)rcl_publish(&publisher, &msg, nullptr);
+          }
+          std::this_thread::sleep_for(kPublishPeriod);
+        }
+        test_msgs__msg__BasicTypes__fini(&msg);
+      });
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(1000000);
+    test_msgs__msg__BasicTypes msg;
+    test_msgs__msg__BasicTypes__init(&msg);
+    reset_heap_counters();
+
+    for (auto _ : st) {
+      rcl_ret_t ret = RCL_RET_TIMEOUT;
+      while (RCL_RET_TIMEOUT == ret) {
+        ret = rcl_wait_set_clear(&wait_set);
+        if (RCL_RET_OK == ret) {
+          ret = rcl_wait_set_add_subscription(&wait_set, &subscription, nullptr);
+        }
+        if (RCL_RET_OK == ret) {
+          ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+        }
+      }
+      if (RCL_RET_OK == ret) {
+        ret = rcl_take(&subscription, &msg, nullptr, nullptr);
+      }
+      rcutils_time_point_value_t now;
+      if (RCL_RET_OK == ret && RCUTILS_RET_OK == rcutils_steady_time_now(&now)) {
+        latencies.push_back(now - msg.int64_value);
+      } else if (RCL_RET_SUBSCRIPTION_TAKE_FAILED != ret) {
+        st.SkipWithError(rcl_get_error_string().str);
+        break;
+      }
+    }
+
+    running.store(false);
+    publisher_thread.join();
+    test_msgs__msg__BasicTypes__fini(&msg);
+
+    if (!latencies.empty()) {
+      std::sort(latencies.begin(), latencies.end());
+      st.counters["p50_ns"] = static_cast<double>(latencies[latencies.size() / 2]);
+      st.counters["p99_ns"] = static_cast<double>(latencies[latencies.size() * 99 / 100]);
+    }
+  }
+
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+};
+
+BENCHMARK_F(WaitLatencyTest, wait_latency_blocking)(benchmark::State & st)
+{
+  measure(st);
+}
+
+BENCHMARK_F(WaitLatencyTest, wait_latency_adaptive_spin)(benchmark::State & st)
+{
+  if (RCL_RET_OK != rcl_wait_set_set_adaptive_spin(&wait_set, kMaxSpinBudget, true)) {
+    st.SkipWithError(rcl_get_error_string().str);
+    return;
+  }
+  measure(st);
+}
@@ -0,0 +1,226 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "rcl/error_handling.h"
+#include "rosidl_runtime_c/primitives_sequence_functions.h"
+#include "rosidl_runtime_c/string_functions.h"
+#include "test_msgs/msg/arrays.h"
+#include "test_msgs/msg/basic_types.h"
+#include "test_msgs/msg/nested.h"
+#include "test_msgs/msg/strings.h"
+#include "test_msgs/msg/unbounded_sequences.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "./content_filter.h"
+
+class TestContentFilter : public ::testing::Test
+{
+public:
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+
+  void SetUp()
+  {
+    ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&basic_types));
+    basic_types.bool_value = true;
+    basic_types.char_value = 'x';
+    basic_types.float64_value = 2.5;
+    basic_types.int32_value = -3;
+    basic_types.uint64_value = UINT64_MAX;
+  }
+
+  void TearDown()
+  {
+    test_msgs__msg__BasicTypes__fini(&basic_types);
+    rcl_reset_error();
+  }
+
+  // Compile the expression for the type and evaluate it on the message.
+  ::testing::AssertionResult
+  matches(
+    const rosidl_message_type_support_t * type_support,
+    const char * expression,
+    const void * message,
+    size_t argc = 0u,
+    const char * const * argv = nullptr)
+  {
+    rcl_content_filter_t * filter = nullptr;
+    rcl_ret_t ret = rcl_content_filter_init(
+      &filter, type_support, expression, argc, argv, &allocator);
+    if (RCL_RET_OK != ret) {
+      return ::testing::AssertionFailure() << rcl_get_error_string().str;
+    }
+    if (nullptr == filter) {
+      return ::testing::AssertionFailure() << "no filter compiled";
+    }
+    bool result = rcl_content_filter_evaluate(filter, message);
+    rcl_content_filter_fini(filter);
+    if (!result) {
+      return ::testing::AssertionFailure() << "'" << expression << "' does not match";
+    }
+    return ::testing::AssertionSuccess();
+  }
+
+  rcl_ret_t
+  compile(const rosidl_message_type_support_t * type_support, const char * expression)
+  {
+    rcl_content_filter_t * filter = nullptr;
+    rcl_ret_t ret = rcl_content_filter_init(
+      &filter, type_support, expression, 0u, nullptr, &allocator);
+    rcl_content_filter_fini(filter);
+    rcl_reset_error();
+    return ret;
+  }
+
+  const rosidl_message_type_support_t * basic_types_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  test_msgs__msg__BasicTypes basic_types;
+};
+
+TEST_F(TestContentFilter, numbers) {
+  EXPECT_TRUE(matches(basic_types_ts, "int32_value = -3", &basic_types));
+  EXPECT_TRUE(matches(basic_types_ts, "int32_value < 0 AND uint64_value > 5", &basic_types));
+  EXPECT_TRUE(matches(basic_types_ts, "uint64_value = 18446744073709551615", &basic_types));
+  EXPECT_TRUE(matches(basic_types_ts, "uint64_value >= 0xffffffffffffffff", &basic_types));
+  // Signed and unsigned values compare by value.
+  EXPECT_FALSE(matches(basic_types_ts, "int32_value > uint64_value", &basic_types));
+  EXPECT_TRUE(matches(basic_types_ts, "float64_value BETWEEN 2 AND 3", &basic_types));
+  EXPECT_FALSE(matches(basic_types_ts, "float64_value NOT BETWEEN 2 AND 3", &basic_types));
+  EXPECT_TRUE(matches(basic_types_ts, "float64_value > 2.25e0", &basic_types));
+  EXPECT_TRUE(matches(basic_types_ts, "bool_value = TRUE AND NOT bool_value = 0", &basic_types));
+  EXPECT_TRUE(matches(basic_types_ts, "char_value = 'x'", &basic_types));
+}
+
+TEST_F(TestContentFilter, logic) {
+  EXPECT_TRUE(
+    matches(
+      basic_types_ts, "(int32_value = 1 OR int32_value = -3) and not (float64_value < 1)",
+      &basic_types));
+  EXPECT_TRUE(
+    matches(
+      basic_types_ts, "int32_value = 1 OR int32_value = 2 OR int32_value = -3", &basic_types));
+  EXPECT_FALSE(
+    matches(
+      basic_types_ts, "int32_value = -3 AND (int32_value = 2 OR float64_value <> 2.5)",
+      &basic_types));
+}
+
+TEST_F(TestContentFilter, parameters) {
+  const char * argv[] = {"-3", "'x'", "2.5"};
+  EXPECT_TRUE(matches(basic_types_ts, "%0 = int32_value", &basic_types, 3u, argv));
+  EXPECT_TRUE(
+    matches(
+      basic_types_ts, "char_value = %1 AND float64_value = %2", &basic_types, 3u, argv));
+  EXPECT_FALSE(matches(basic_types_ts, "int32_value <> %0", &basic_types, 3u, argv));
+}
+
+TEST_F(TestContentFilter, strings) {
+  const rosidl_message_type_support_t * ts = ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings);
+  test_msgs__msg__Strings msg;
+  ASSERT_TRUE(test_msgs__msg__Strings__init(&msg));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__Strings__fini(&msg);
+  });
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&msg.string_value, "hello world"));
+  EXPECT_TRUE(matches(ts, "string_value = 'hello world'", &msg));
+  EXPECT_TRUE(matches(ts, "string_value > 'hello'", &msg));
+  EXPECT_TRUE(matches(ts, "string_value LIKE 'h_llo%d'", &msg));
+  EXPECT_TRUE(matches(ts, "string_value NOT LIKE 'world%'", &msg));
+  const char * argv[] = {"'%world'"};
+  EXPECT_TRUE(matches(ts, "string_value LIKE %0", &msg, 1u, argv));
+}
+
+TEST_F(TestContentFilter, fields) {
+  const rosidl_message_type_support_t * arrays_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Arrays);
+  test_msgs__msg__Arrays arrays;
+  ASSERT_TRUE(test_msgs__msg__Arrays__init(&arrays));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__Arrays__fini(&arrays);
+  });
+  arrays.int32_values[2] = 7;
+  arrays.basic_types_values[1].int16_value = 5;
+  EXPECT_TRUE(matches(arrays_ts, "int32_values[2] = 7", &arrays));
+  EXPECT_TRUE(matches(arrays_ts, "basic_types_values[1].int16_value = 5", &arrays));
+  // Elements past the end satisfy no predicate.
+  EXPECT_FALSE(matches(arrays_ts, "int32_values[3] = 0", &arrays));
+
+  const rosidl_message_type_support_t * sequences_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, UnboundedSequences);
+  test_msgs__msg__UnboundedSequences sequences;
+  ASSERT_TRUE(test_msgs__msg__UnboundedSequences__init(&sequences));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__UnboundedSequences__fini(&sequences);
+  });
+  ASSERT_TRUE(rosidl_runtime_c__int32__Sequence__init(&sequences.int32_values, 2u));
+  sequences.int32_values.data[1] = 6;
+  EXPECT_TRUE(matches(sequences_ts, "int32_values[1] = 6", &sequences));
+  EXPECT_FALSE(matches(sequences_ts, "int32_values[2] = 6", &sequences));
+  EXPECT_TRUE(matches(sequences_ts, "NOT int32_values[2] = 6", &sequences));
+
+  const rosidl_message_type_support_t * nested_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Nested);
+  test_msgs__msg__Nested nested;
+  ASSERT_TRUE(test_msgs__msg__Nested__init(&nested));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__Nested__fini(&nested);
+  });
+  nested.basic_types_value.int64_value = 42;
+  EXPECT_TRUE(matches(nested_ts, "basic_types_value.int64_value = 42", &nested));
+}
+
+TEST_F(TestContentFilter, empty_expression) {
+  rcl_content_filter_t * filter = nullptr;
+  EXPECT_EQ(
+    RCL_RET_OK,
+    rcl_content_filter_init(&filter, basic_types_ts, "  ", 0u, nullptr, &allocator));
+  EXPECT_EQ(nullptr, filter);
+}
+
+TEST_F(TestContentFilter, invalid_expressions) {
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(basic_types_ts, "int32_value ="));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(basic_types_ts, "no_such_field = 1"));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(basic_types_ts, "int32_value = 'ab'"));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(basic_types_ts, "1 = 1"));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(basic_types_ts, "int32_value = 1 int8_value"));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(basic_types_ts, "int32_value @ 1"));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(basic_types_ts, "int32_value = %0"));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(basic_types_ts, "(int32_value = 1"));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(basic_types_ts, "int32_value LIKE '1%'"));
+  const rosidl_message_type_support_t * nested_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Nested);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(nested_ts, "basic_types_value = 1"));
+  const rosidl_message_type_support_t * arrays_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Arrays);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(arrays_ts, "int32_values = 1"));
+
+  // The boolean stack of the program is bounded.
+  std::string deep;
+  for (int i = 0; i < 100; ++i) {
+    deep += "(";
+  }
+  deep += "int32_value = 1";
+  for (int i = 0; i < 100; ++i) {
+    deep += ")";
+  }
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, compile(basic_types_ts, deep.c_str()));
+}
@@ -185,3 +185,106 @@ TEST_F(CLASSNAME(TestContextFixture, RMW_IMPLEMENTATION), bad_fini) {
     rcl_reset_error();
   }
 }
+
+static void count_jump_callback(const rcl_time_jump_t *, bool before_jump, void * user_data)
+{
+  if (!before_jump) {
+    ++*static_cast<int *>(user_data);
+  }
+}
+
+TEST_F(CLASSNAME(TestContextFixture, RMW_IMPLEMENTATION), ros_time_source) {
+  rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+  rcl_ret_t ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+  });
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  EXPECT_EQ(nullptr, rcl_context_get_ros_time_source(&context));
+  rcl_reset_error();
+  EXPECT_EQ(nullptr, rcl_context_get_ros_time_source(nullptr));
+  rcl_reset_error();
+  ret = rcl_init(0, nullptr, &init_options, &context);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_shutdown(&context)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_context_fini(&context)) << rcl_get_error_string().str;
+  });
+  rcl_ros_time_source_t * source = rcl_context_get_ros_time_source(&context);
+  ASSERT_NE(nullptr, source) << rcl_get_error_string().str;
+
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_clock_t clocks[2];
+  int jump_counts[2] = {0, 0};
+  rcl_jump_threshold_t threshold;
+  threshold.on_clock_change = false;
+  threshold.min_forward.nanoseconds = 1;
+  threshold.min_backward.nanoseconds = 0;
+  for (size_t i = 0; i < 2; ++i) {
+    ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_init(&clocks[i], &allocator));
+    ASSERT_EQ(
+      RCL_RET_OK,
+      rcl_clock_add_jump_callback(&clocks[i], threshold, count_jump_callback, &jump_counts[i]));
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&clocks[0])) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&clocks[1])) << rcl_get_error_string().str;
+  });
+
+  rcl_clock_t steady_clock;
+  ASSERT_EQ(RCL_RET_OK, rcl_steady_clock_init(&steady_clock, &allocator));
+  EXPECT_EQ(RCL_RET_ERROR, rcl_clock_bind_ros_time_source(&steady_clock, source));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_OK, rcl_steady_clock_fini(&steady_clock));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_clock_bind_ros_time_source(&clocks[0], nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_ros_time_source_set_override(nullptr, 1));
+  rcl_reset_error();
+
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_bind_ros_time_source(&clocks[0], source));
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_bind_ros_time_source(&clocks[1], source));
+  EXPECT_EQ(RCL_RET_OK, rcl_clock_bind_ros_time_source(&clocks[1], source));
+
+  // One update of the source advances every bound clock
+  const rcl_time_point_value_t sec_1 = RCL_S_TO_NS(1);
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_time_source_set_override(source, sec_1));
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_time_source_enable_override(source));
+  rcl_time_point_value_t now = 0;
+  bool is_enabled = false;
+  for (size_t i = 0; i < 2; ++i) {
+    ASSERT_EQ(RCL_RET_OK, rcl_is_enabled_ros_time_override(&clocks[i], &is_enabled));
+    EXPECT_TRUE(is_enabled);
+    ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clocks[i], &now));
+    EXPECT_EQ(sec_1, now);
+  }
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_time_source_set_override(source, 2 * sec_1));
+  for (size_t i = 0; i < 2; ++i) {
+    ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clocks[i], &now));
+    EXPECT_EQ(2 * sec_1, now);
+    EXPECT_EQ(1, jump_counts[i]);
+  }
+
+  // Setting the time of a bound clock sets the time of the source
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clocks[0], 3 * sec_1));
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clocks[1], &now));
+  EXPECT_EQ(3 * sec_1, now);
+  EXPECT_EQ(2, jump_counts[1]);
+
+  // An unbound clock keeps the time of the source
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_unbind_ros_time_source(&clocks[0]));
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_time_source_set_override(source, 4 * sec_1));
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clocks[0], &now));
+  EXPECT_EQ(3 * sec_1, now);
+  EXPECT_EQ(2, jump_counts[0]);
+  EXPECT_EQ(3, jump_counts[1]);
+
+  // Binding again jumps to the time of the source
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_bind_ros_time_source(&clocks[0], source));
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clocks[0], &now));
+  EXPECT_EQ(4 * sec_1, now);
+  EXPECT_EQ(3, jump_counts[0]);
+}
@@ -0,0 +1,629 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "rcl/error_handling.h"
+#include "rcl/publisher.h"
+#include "rcl/rcl.h"
+#include "rcl/subscription.h"
+#include "rcl/wait.h"
+
+#include "rosidl_runtime_c/string_functions.h"
+#include "test_msgs/msg/basic_types.h"
+#include "test_msgs/msg/strings.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "wait_for_entity_helpers.hpp"
+#include "../mocking_utils/patch.hpp"
+
+#ifdef RMW_IMPLEMENTATION
+# define CLASSNAME_(NAME, SUFFIX) NAME ## __ ## SUFFIX
+# define CLASSNAME(NAME, SUFFIX) CLASSNAME_(NAME, SUFFIX)
+#else
+# define CLASSNAME(NAME, SUFFIX) NAME
+#endif
+
+class CLASSNAME (TestIntraContextFixture, RMW_IMPLEMENTATION) : public ::testing::Test
+{
+public:
+  rcl_context_t * context_ptr;
+  rcl_node_t * node_ptr;
+  const rosidl_message_type_support_t * basic_types_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  const rosidl_message_type_support_t * strings_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings);
+
+  void SetUp()
+  {
+    rcl_ret_t ret;
+    {
+      rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+      ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+      {
+        EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+      });
+      this->context_ptr = new rcl_context_t;
+      *this->context_ptr = rcl_get_zero_initialized_context();
+      ret = rcl_init(0, nullptr, &init_options, this->context_ptr);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+    this->node_ptr = new rcl_node_t;
+    *this->node_ptr = rcl_get_zero_initialized_node();
+    constexpr char name[] = "test_intra_context_node";
+    rcl_node_options_t node_options = rcl_node_get_default_options();
+    ret = rcl_node_init(this->node_ptr, name, "", this->context_ptr, &node_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  void TearDown()
+  {
+    rcl_ret_t ret = rcl_node_fini(this->node_ptr);
+    delete this->node_ptr;
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_shutdown(this->context_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_context_fini(this->context_ptr);
+    delete this->context_ptr;
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  // Wait until the intra context guard condition of the subscription is triggered.
+  bool
+  wait_for_intra_context_message(const rcl_subscription_t * subscription)
+  {
+    const rcl_guard_condition_t * guard_condition =
+      rcl_subscription_get_intra_context_guard_condition(subscription);
+    if (nullptr == guard_condition) {
+      return false;
+    }
+    rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+    rcl_ret_t ret = rcl_wait_set_init(
+      &wait_set, 0, 1, 0, 0, 0, 0, this->context_ptr, rcl_get_default_allocator());
+    if (RCL_RET_OK != ret) {
+      return false;
+    }
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+    });
+    if (RCL_RET_OK != rcl_wait_set_add_guard_condition(&wait_set, guard_condition, NULL)) {
+      return false;
+    }
+    ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+    return RCL_RET_OK == ret && nullptr != wait_set.guard_conditions[0];
+  }
+};
+
+/* A loaned message reaches a subscription of the same context without a copy.
+ */
+TEST_F(CLASSNAME(TestIntraContextFixture, RMW_IMPLEMENTATION), test_loaned_message_is_shared) {
+  const char * topic = "intra_context_loaned";
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.intra_context = true;
+  rcl_ret_t ret = rcl_publisher_init(
+    &publisher, this->node_ptr, basic_types_ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr));
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  subscription_options.intra_context = true;
+  ret = rcl_subscription_init(
+    &subscription, this->node_ptr, basic_types_ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, this->node_ptr));
+  });
+  ASSERT_NE(nullptr, rcl_subscription_get_intra_context_guard_condition(&subscription));
+  EXPECT_TRUE(rcl_publisher_can_loan_messages(&publisher));
+  EXPECT_TRUE(rcl_subscription_can_loan_messages(&subscription));
+
+  void * loaned_message = nullptr;
+  ret = rcl_borrow_loaned_message(&publisher, basic_types_ts, &loaned_message);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_NE(nullptr, loaned_message);
+  static_cast<test_msgs__msg__BasicTypes *>(loaned_message)->int64_value = 42;
+  ret = rcl_publish_loaned_message(&publisher, loaned_message, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  ASSERT_TRUE(wait_for_intra_context_message(&subscription));
+  void * taken_message = nullptr;
+  rmw_message_info_t message_info = rmw_get_zero_initialized_message_info();
+  ret = rcl_take_loaned_message(&subscription, &taken_message, &message_info, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(loaned_message, taken_message);
+  EXPECT_EQ(42, static_cast<test_msgs__msg__BasicTypes *>(taken_message)->int64_value);
+  EXPECT_TRUE(message_info.from_intra_process);
+  ret = rcl_return_loaned_message_from_subscription(&subscription, taken_message);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+}
+
+/* A published message is taken once, the middleware copy is not taken again.
+ */
+TEST_F(CLASSNAME(TestIntraContextFixture, RMW_IMPLEMENTATION), test_publish_and_take) {
+  const char * topic = "intra_context_strings";
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.intra_context = true;
+  rcl_ret_t ret = rcl_publisher_init(
+    &publisher, this->node_ptr, strings_ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr));
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  subscription_options.intra_context = true;
+  ret = rcl_subscription_init(
+    &subscription, this->node_ptr, strings_ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, this->node_ptr));
+  });
+  ASSERT_TRUE(wait_for_established_subscription(&publisher, 10, 100));
+
+  constexpr char test_string[] = "delivered within the context";
+  {
+    test_msgs__msg__Strings msg;
+    test_msgs__msg__Strings__init(&msg);
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      test_msgs__msg__Strings__fini(&msg);
+    });
+    ASSERT_TRUE(rosidl_runtime_c__String__assign(&msg.string_value, test_string));
+    ret = rcl_publish(&publisher, &msg, nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  ASSERT_TRUE(wait_for_intra_context_message(&subscription));
+  {
+    test_msgs__msg__Strings msg;
+    test_msgs__msg__Strings__init(&msg);
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      test_msgs__msg__Strings__fini(&msg);
+    });
+    rmw_message_info_t message_info = rmw_get_zero_initialized_message_info();
+    ret = rcl_take(&subscription, &msg, &message_info, nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(std::string(test_string), std::string(msg.string_value.data, msg.string_value.size));
+    EXPECT_TRUE(message_info.from_intra_process);
+
+    // Give the middleware a chance to deliver a copy, it must not be taken.
+    (void)wait_for_subscription_to_be_ready(&subscription, this->context_ptr, 5, 100);
+    ret = rcl_take(&subscription, &msg, nullptr, nullptr);
+    EXPECT_EQ(RCL_RET_SUBSCRIPTION_TAKE_FAILED, ret) << rcl_get_error_string().str;
+    rcl_reset_error();
+  }
+}
+
+/* The queue of a subscription keeps the latest messages up to its depth.
+ */
+TEST_F(CLASSNAME(TestIntraContextFixture, RMW_IMPLEMENTATION), test_keep_last_depth) {
+  const char * topic = "intra_context_depth";
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.intra_context = true;
+  rcl_ret_t ret = rcl_publisher_init(
+    &publisher, this->node_ptr, basic_types_ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr));
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  subscription_options.intra_context = true;
+  subscription_options.qos.depth = 2;
+  ret = rcl_subscription_init(
+    &subscription, this->node_ptr, basic_types_ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, this->node_ptr));
+  });
+
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+  for (int32_t value = 1; value <= 3; ++value) {
+    msg.int32_value = value;
+    ret = rcl_publish(&publisher, &msg, nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  for (int32_t expected = 2; expected <= 3; ++expected) {
+    rmw_message_info_t message_info = rmw_get_zero_initialized_message_info();
+    ret = rcl_take(&subscription, &msg, &message_info, nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(expected, msg.int32_value);
+    EXPECT_TRUE(message_info.from_intra_process);
+  }
+}
+
+/* Wait sets see the messages queued within the context without adding the guard condition.
+ */
+TEST_F(CLASSNAME(TestIntraContextFixture, RMW_IMPLEMENTATION), test_wait_set_readiness) {
+  const char * topic = "intra_context_wait_set";
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.intra_context = true;
+  rcl_ret_t ret = rcl_publisher_init(
+    &publisher, this->node_ptr, basic_types_ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr));
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  subscription_options.intra_context = true;
+  ret = rcl_subscription_init(
+    &subscription, this->node_ptr, basic_types_ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, this->node_ptr));
+  });
+  ASSERT_NE(nullptr, rcl_subscription_get_intra_context_guard_condition(&subscription));
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(
+    &wait_set, 1, 0, 0, 0, 0, 0, this->context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+  for (int32_t value = 1; value <= 2; ++value) {
+    msg.int32_value = value;
+    ret = rcl_publish(&publisher, &msg, nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  // The subscription stays ready as long as messages are left in its queue.
+  for (int32_t expected = 1; expected <= 2; ++expected) {
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+    ret = rcl_wait_set_add_subscription(&wait_set, &subscription, nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_EQ(&subscription, wait_set.subscriptions[0]);
+    rmw_message_info_t message_info = rmw_get_zero_initialized_message_info();
+    ret = rcl_take(&subscription, &msg, &message_info, nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(expected, msg.int32_value);
+    EXPECT_TRUE(message_info.from_intra_process);
+  }
+
+  // Persistent wait sets report it among their ready indices and rcl_wait_and_take() takes it.
+  ret = rcl_wait_set_set_persistent(&wait_set, true);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_add_subscription(&wait_set, &subscription, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  msg.int32_value = 3;
+  ret = rcl_publish(&publisher, &msg, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  auto allocator = rcutils_get_default_allocator();
+  constexpr size_t size = 2;
+  rmw_message_info_sequence_t message_infos;
+  ASSERT_EQ(RMW_RET_OK, rmw_message_info_sequence_init(&message_infos, size, &allocator));
+  rmw_message_sequence_t messages;
+  ASSERT_EQ(RMW_RET_OK, rmw_message_sequence_init(&messages, size, &allocator));
+  auto seq = test_msgs__msg__BasicTypes__Sequence__create(size);
+  for (size_t ii = 0; ii < size; ++ii) {
+    messages.data[ii] = &seq->data[ii];
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rmw_message_info_sequence_fini(&message_infos);
+    rmw_message_sequence_fini(&messages);
+    test_msgs__msg__BasicTypes__Sequence__destroy(seq);
+  });
+  size_t taken = 0u;
+  ret = rcl_wait_and_take(&wait_set, RCL_S_TO_NS(1), size, &messages, &message_infos, &taken);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  const size_t * ready_indices = nullptr;
+  size_t ready_count = 0u;
+  ret = rcl_wait_set_get_ready_indices(
+    &wait_set, RCL_WAIT_SET_SUBSCRIPTION, &ready_indices, &ready_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(0u, ready_indices[0]);
+  ASSERT_EQ(1u, taken);
+  ASSERT_EQ(1u, messages.size);
+  EXPECT_EQ(3, seq->data[0].int32_value);
+  EXPECT_TRUE(message_infos.data[0].from_intra_process);
+}
+
+/* A subscription outside of the intra context path still gets messages through the middleware.
+ */
+TEST_F(CLASSNAME(TestIntraContextFixture, RMW_IMPLEMENTATION), test_middleware_subscription) {
+  const char * topic = "intra_context_middleware";
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.intra_context = true;
+  rcl_ret_t ret = rcl_publisher_init(
+    &publisher, this->node_ptr, basic_types_ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr));
+  });
+  rcl_subscription_t intra_subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  subscription_options.intra_context = true;
+  ret = rcl_subscription_init(
+    &intra_subscription, this->node_ptr, basic_types_ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&intra_subscription, this->node_ptr));
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  subscription_options.intra_context = false;
+  ret = rcl_subscription_init(
+    &subscription, this->node_ptr, basic_types_ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, this->node_ptr));
+  });
+  EXPECT_EQ(nullptr, rcl_subscription_get_intra_context_guard_condition(&subscription));
+  rcl_reset_error();
+  ASSERT_TRUE(wait_for_established_subscription(&publisher, 10, 100));
+
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+  msg.int64_value = 7;
+  ret = rcl_publish(&publisher, &msg, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscription, this->context_ptr, 10, 100));
+  msg.int64_value = 0;
+  rmw_message_info_t message_info = rmw_get_zero_initialized_message_info();
+  ret = rcl_take(&subscription, &msg, &message_info, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(7, msg.int64_value);
+  EXPECT_FALSE(message_info.from_intra_process);
+
+  ret = rcl_take(&intra_subscription, &msg, &message_info, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(7, msg.int64_value);
+  EXPECT_TRUE(message_info.from_intra_process);
+}
+
+/* The middleware is left out once every subscription it matches is served within the context.
+ */
+TEST_F(CLASSNAME(TestIntraContextFixture, RMW_IMPLEMENTATION), test_middleware_bypassed) {
+  const char * topic = "intra_context_bypass";
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.intra_context = true;
+  rcl_ret_t ret = rcl_publisher_init(
+    &publisher, this->node_ptr, basic_types_ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr));
+  });
+  rcl_subscription_t intra_subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  subscription_options.intra_context = true;
+  ret = rcl_subscription_init(
+    &intra_subscription, this->node_ptr, basic_types_ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&intra_subscription, this->node_ptr));
+  });
+  ASSERT_TRUE(wait_for_established_subscription(&publisher, 10, 100));
+
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+  size_t rmw_publish_calls = 0u;
+  auto publish_counted = [&]() {
+      auto mock = mocking_utils::patch(
+        "lib:rcl", rmw_publish, [&](auto, auto, auto) {
+          ++rmw_publish_calls;
+          return RMW_RET_OK;
+        });
+      rmw_publish_calls = 0u;
+      EXPECT_EQ(RCL_RET_OK, rcl_publish(&publisher, &msg, nullptr)) << rcl_get_error_string().str;
+      return rmw_publish_calls;
+    };
+  auto take_locally = [&]() {
+      ASSERT_TRUE(wait_for_intra_context_message(&intra_subscription));
+      rmw_message_info_t message_info = rmw_get_zero_initialized_message_info();
+      ret = rcl_take(&intra_subscription, &msg, &message_info, nullptr);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      EXPECT_TRUE(message_info.from_intra_process);
+    };
+
+  // Until a middleware copy reached the local subscription, its match may stand
+  // for a remote one, so the middleware is used.
+  bool bypassed = false;
+  for (size_t i = 0u; i < 10u && !bypassed; ++i) {
+    bypassed = 0u == publish_counted();
+    take_locally();
+    if (!bypassed) {
+      ret = rcl_publish(&publisher, &msg, nullptr);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      take_locally();
+      // The middleware copy is dropped as a duplicate, which confirms the subscription.
+      (void)wait_for_subscription_to_be_ready(&intra_subscription, this->context_ptr, 5, 100);
+      ret = rcl_take(&intra_subscription, &msg, nullptr, nullptr);
+      EXPECT_EQ(RCL_RET_SUBSCRIPTION_TAKE_FAILED, ret) << rcl_get_error_string().str;
+      rcl_reset_error();
+    }
+  }
+  EXPECT_TRUE(bypassed);
+  EXPECT_EQ(0u, publish_counted());
+  take_locally();
+
+  // A subscription only the middleware serves brings it back.
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  subscription_options.intra_context = false;
+  ret = rcl_subscription_init(
+    &subscription, this->node_ptr, basic_types_ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, this->node_ptr));
+  });
+  size_t subscription_count = 0u;
+  for (size_t i = 0u; i < 10u && subscription_count < 2u; ++i) {
+    ret = rcl_publisher_get_subscription_count(&publisher, &subscription_count);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    if (subscription_count < 2u) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+  }
+  ASSERT_EQ(2u, subscription_count);
+  EXPECT_EQ(1u, publish_counted());
+  take_locally();
+}
+
+/* Subscriptions whose QoS cannot be honored by the ring stay on the middleware path.
+ */
+TEST_F(CLASSNAME(TestIntraContextFixture, RMW_IMPLEMENTATION), test_not_eligible) {
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  subscription_options.intra_context = true;
+  subscription_options.qos.history = RMW_QOS_POLICY_HISTORY_KEEP_ALL;
+  rcl_ret_t ret = rcl_subscription_init(
+    &subscription, this->node_ptr, basic_types_ts, "intra_context_keep_all",
+    &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, this->node_ptr));
+  });
+  EXPECT_EQ(nullptr, rcl_subscription_get_intra_context_guard_condition(&subscription));
+  rcl_reset_error();
+}
+
+/* rcl filters the content of the messages delivered within the context.
+ */
+TEST_F(CLASSNAME(TestIntraContextFixture, RMW_IMPLEMENTATION), test_content_filter) {
+  const char * topic = "intra_context_filtered";
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.intra_context = true;
+  rcl_ret_t ret = rcl_publisher_init(
+    &publisher, this->node_ptr, basic_types_ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr));
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  subscription_options.intra_context = true;
+  const char * expression_parameters[] = {"2", "3"};
+  ret = rcl_subscription_options_set_content_filter_options(
+    "int32_value BETWEEN %0 AND %1", 2, expression_parameters, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_subscription_init(
+    &subscription, this->node_ptr, basic_types_ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, this->node_ptr));
+  });
+  ASSERT_NE(nullptr, rcl_subscription_get_intra_context_guard_condition(&subscription));
+  EXPECT_TRUE(rcl_subscription_is_cft_enabled(&subscription));
+
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+  auto publish_one_to_four = [&]() {
+      for (int32_t value = 1; value <= 4; ++value) {
+        msg.int32_value = value;
+        ASSERT_EQ(RCL_RET_OK, rcl_publish(&publisher, &msg, nullptr)) << rcl_get_error_string().str;
+      }
+    };
+  publish_one_to_four();
+  for (int32_t expected = 2; expected <= 3; ++expected) {
+    ret = rcl_take(&subscription, &msg, nullptr, nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(expected, msg.int32_value);
+  }
+  EXPECT_EQ(RCL_RET_SUBSCRIPTION_TAKE_FAILED, rcl_take(&subscription, &msg, nullptr, nullptr));
+  rcl_reset_error();
+
+  // A new filter is in effect for the next messages.
+  rcl_subscription_content_filter_options_t content_filter_options =
+    rcl_get_zero_initialized_subscription_content_filter_options();
+  ret = rcl_subscription_content_filter_options_init(
+    &subscription, "int32_value = 4 OR bool_value = TRUE", 0, nullptr, &content_filter_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(
+      RCL_RET_OK,
+      rcl_subscription_content_filter_options_fini(&subscription, &content_filter_options));
+  });
+  ret = rcl_subscription_set_content_filter(&subscription, &content_filter_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  publish_one_to_four();
+  ret = rcl_take(&subscription, &msg, nullptr, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(4, msg.int32_value);
+  EXPECT_EQ(RCL_RET_SUBSCRIPTION_TAKE_FAILED, rcl_take(&subscription, &msg, nullptr, nullptr));
+  rcl_reset_error();
+
+  // An expression rcl cannot compile leaves the current filter.
+  rcl_subscription_content_filter_options_t bad_options =
+    rcl_get_zero_initialized_subscription_content_filter_options();
+  ret = rcl_subscription_content_filter_options_init(
+    &subscription, "no_such_field = 1", 0, nullptr, &bad_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_subscription_set_content_filter(&subscription, &bad_options));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_OK, rcl_subscription_content_filter_options_fini(&subscription, &bad_options));
+  EXPECT_TRUE(rcl_subscription_is_cft_enabled(&subscription));
+}
@@ -14,6 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "rcl/publisher.h"
 
 #include "rcl/rcl.h"
@@ -372,6 +376,47 @@ TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_loan)
   }
 }
 
+/* Loans of rcl stand in for the ones of a middleware which cannot loan, and are reused.
+ */
+TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_loan_pool) {
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings);
+  constexpr char topic_name[] = "chatter";
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  rcl_ret_t ret =
+    rcl_publisher_init(&publisher, this->node_ptr, ts, topic_name, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  if (rcl_publisher_get_rmw_handle(&publisher)->can_loan_messages) {
+    EXPECT_EQ(nullptr, publisher.impl->loan_pool);
+    return;
+  }
+  ASSERT_NE(nullptr, publisher.impl->loan_pool);
+  EXPECT_TRUE(rcl_publisher_can_loan_messages(&publisher));
+
+  void * first = nullptr;
+  void * second = nullptr;
+  ASSERT_EQ(RCL_RET_OK, rcl_borrow_loaned_message(&publisher, ts, &first));
+  ASSERT_EQ(RCL_RET_OK, rcl_borrow_loaned_message(&publisher, ts, &second));
+  EXPECT_NE(first, second);
+  ASSERT_TRUE(
+    rosidl_runtime_c__String__assign(
+      &static_cast<test_msgs__msg__Strings *>(first)->string_value, "testing"));
+  EXPECT_EQ(RCL_RET_OK, rcl_publish_loaned_message(&publisher, first, nullptr));
+  EXPECT_EQ(RCL_RET_OK, rcl_return_loaned_message_from_publisher(&publisher, second));
+
+  // Both messages went back to the pool, which hands them out again.
+  void * again = nullptr;
+  ASSERT_EQ(RCL_RET_OK, rcl_borrow_loaned_message(&publisher, ts, &again));
+  EXPECT_TRUE(again == first || again == second);
+  EXPECT_EQ(RCL_RET_OK, rcl_return_loaned_message_from_publisher(&publisher, again));
+}
+
 TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_loan_disable) {
   rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
   const rosidl_message_type_support_t * ts =
@@ -620,6 +665,204 @@ TEST_F(CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION), test_mock_assert
   rcl_reset_error();
 }
 
+/* Publishes are counted by outcome.
+ */
+TEST_F(CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION), test_publisher_traffic_counters) {
+  rcl_publisher_traffic_counters_t counters;
+  rcl_ret_t ret = rcl_publisher_get_traffic_counters(&publisher, &counters);
+  if (RCL_RET_UNSUPPORTED == ret) {
+    rcl_reset_error();
+    GTEST_SKIP() << "rcl was built without traffic counters";
+  }
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, counters.message_count);
+  EXPECT_EQ(0u, counters.error_count);
+  EXPECT_EQ(0, counters.last_publish_time);
+
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  rcl_serialized_message_t serialized_msg = rmw_get_zero_initialized_serialized_message();
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_msg, 0u, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+    EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_msg));
+  });
+  ASSERT_EQ(RMW_RET_OK, rmw_serialize(&msg, ts, &serialized_msg));
+
+  EXPECT_EQ(RCL_RET_OK, rcl_publish(&publisher, &msg, nullptr)) << rcl_get_error_string().str;
+  EXPECT_EQ(
+    RCL_RET_OK,
+    rcl_publish_serialized_message(&publisher, &serialized_msg, nullptr)) <<
+    rcl_get_error_string().str;
+  {
+    auto mock = mocking_utils::patch_and_return("lib:rcl", rmw_publish, RMW_RET_ERROR);
+    EXPECT_EQ(RCL_RET_ERROR, rcl_publish(&publisher, &msg, nullptr));
+    rcl_reset_error();
+  }
+
+  ret = rcl_publisher_get_traffic_counters(&publisher, &counters);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(2u, counters.message_count);
+  EXPECT_EQ(serialized_msg.buffer_length, counters.serialized_byte_count);
+  EXPECT_EQ(0u, counters.loaned_message_count);
+  EXPECT_EQ(1u, counters.error_count);
+#ifdef RCL_ENABLE_TRAFFIC_TIMESTAMPS
+  EXPECT_NE(0, counters.last_publish_time);
+#else
+  EXPECT_EQ(0, counters.last_publish_time);
+#endif
+
+  EXPECT_EQ(RCL_RET_PUBLISHER_INVALID, rcl_publisher_get_traffic_counters(nullptr, &counters));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_publisher_get_traffic_counters(&publisher, nullptr));
+  rcl_reset_error();
+}
+
+/* Throttled messages are dropped or conflated to the latest one.
+ */
+TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_throttle) {
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  constexpr char topic_name[] = "chatter";
+  constexpr auto period = std::chrono::milliseconds(500);
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.throttle_period = -1;
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_publisher_init(&publisher, this->node_ptr, ts, topic_name, &publisher_options));
+  rcl_reset_error();
+  publisher_options.throttle_period = RCL_MS_TO_NS(period.count());
+
+  std::vector<int64_t> published;
+  auto mock = mocking_utils::patch(
+    "lib:rcl", rmw_publish, [&](auto, const void * ros_message, auto) {
+      published.push_back(
+        static_cast<const test_msgs__msg__BasicTypes *>(ros_message)->int64_value);
+      return RMW_RET_OK;
+    });
+  test_msgs__msg__BasicTypes msg;
+  ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+  auto publish = [&](rcl_publisher_t * publisher, int64_t value) {
+      msg.int64_value = value;
+      EXPECT_EQ(RCL_RET_OK, rcl_publish(publisher, &msg, nullptr)) << rcl_get_error_string().str;
+    };
+
+  for (bool conflate : {false, true}) {
+    SCOPED_TRACE(conflate ? "conflate" : "drop");
+    published.clear();
+    publisher_options.conflate = conflate;
+    publisher = rcl_get_zero_initialized_publisher();
+    rcl_ret_t ret =
+      rcl_publisher_init(&publisher, this->node_ptr, ts, topic_name, &publisher_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr)) <<
+        rcl_get_error_string().str;
+    });
+
+    publish(&publisher, 1);
+    publish(&publisher, 2);
+    publish(&publisher, 3);
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_flush(&publisher)) << rcl_get_error_string().str;
+    EXPECT_EQ(std::vector<int64_t>({1}), published);
+
+    std::this_thread::sleep_for(period);
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_flush(&publisher)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_flush(&publisher)) << rcl_get_error_string().str;
+    if (conflate) {
+      EXPECT_EQ(std::vector<int64_t>({1, 3}), published);
+    } else {
+      EXPECT_EQ(std::vector<int64_t>({1}), published);
+      publish(&publisher, 4);
+      EXPECT_EQ(std::vector<int64_t>({1, 4}), published);
+    }
+  }
+
+  // Sequences and loaned messages go through the throttle, serialized messages are rejected.
+  {
+    published.clear();
+    publisher_options.conflate = true;
+    publisher = rcl_get_zero_initialized_publisher();
+    rcl_ret_t ret =
+      rcl_publisher_init(&publisher, this->node_ptr, ts, topic_name, &publisher_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr)) <<
+        rcl_get_error_string().str;
+    });
+
+    test_msgs__msg__BasicTypes sequence_msgs[3];
+    rmw_message_sequence_t messages = rmw_get_zero_initialized_message_sequence();
+    rcl_allocator_t allocator = rcl_get_default_allocator();
+    ASSERT_EQ(RMW_RET_OK, rmw_message_sequence_init(&messages, 3u, &allocator));
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RMW_RET_OK, rmw_message_sequence_fini(&messages));
+    });
+    for (size_t i = 0u; i < 3u; ++i) {
+      ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&sequence_msgs[i]));
+      sequence_msgs[i].int64_value = static_cast<int64_t>(i + 1u);
+      messages.data[i] = &sequence_msgs[i];
+    }
+    messages.size = 3u;
+    size_t published_count = 0u;
+    EXPECT_EQ(
+      RCL_RET_OK, rcl_publish_sequence(&publisher, &messages, &published_count, nullptr)) <<
+      rcl_get_error_string().str;
+    EXPECT_EQ(3u, published_count);
+    EXPECT_EQ(std::vector<int64_t>({1}), published);
+
+    void * loaned_msg = nullptr;
+    ret = rcl_borrow_loaned_message(&publisher, ts, &loaned_msg);
+    if (RCL_RET_OK == ret) {
+      static_cast<test_msgs__msg__BasicTypes *>(loaned_msg)->int64_value = 4;
+      EXPECT_EQ(RCL_RET_OK, rcl_publish_loaned_message(&publisher, loaned_msg, nullptr)) <<
+        rcl_get_error_string().str;
+    }
+    rcl_reset_error();
+
+    rcl_serialized_message_t serialized_msg = rmw_get_zero_initialized_serialized_message();
+    EXPECT_EQ(
+      RCL_RET_UNSUPPORTED, rcl_publish_serialized_message(&publisher, &serialized_msg, nullptr));
+    rcl_reset_error();
+    EXPECT_EQ(
+      RCL_RET_UNSUPPORTED,
+      rcl_publish_serialized_message_sequence(&publisher, &serialized_msg, 1u, nullptr, nullptr));
+    rcl_reset_error();
+
+    std::this_thread::sleep_for(period);
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_flush(&publisher)) << rcl_get_error_string().str;
+    ASSERT_EQ(2u, published.size());
+    EXPECT_EQ(RCL_RET_OK == ret ? 4 : 3, published[1]);
+  }
+
+  // Flushing a publisher which is not throttled does nothing.
+  publisher_options.throttle_period = 0;
+  publisher = rcl_get_zero_initialized_publisher();
+  rcl_ret_t ret =
+    rcl_publisher_init(&publisher, this->node_ptr, ts, topic_name, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  published.clear();
+  publish(&publisher, 1);
+  publish(&publisher, 2);
+  EXPECT_EQ(RCL_RET_OK, rcl_publisher_flush(&publisher)) << rcl_get_error_string().str;
+  EXPECT_EQ(std::vector<int64_t>({1, 2}), published);
+  EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr)) <<
+    rcl_get_error_string().str;
+
+  EXPECT_EQ(RCL_RET_PUBLISHER_INVALID, rcl_publisher_flush(nullptr));
+  rcl_reset_error();
+}
+
 // Mocking rmw_publisher_wait_for_all_acked to make
 // rcl_publisher_wait_for_all_acked fail
 MOCKING_UTILS_BOOL_OPERATOR_RETURNS_FALSE(rmw_time_t, ==)
@@ -694,6 +937,144 @@ TEST_F(CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION), test_mock_publis
   rcl_reset_error();
 }
 
+/* Publish a batch of messages with a single call.
+ */
+TEST_F(CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION), test_publish_sequence) {
+  constexpr size_t size = 5u;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rmw_message_sequence_t messages = rmw_get_zero_initialized_message_sequence();
+  ASSERT_EQ(RMW_RET_OK, rmw_message_sequence_init(&messages, size, &allocator));
+  auto seq = test_msgs__msg__BasicTypes__Sequence__create(size);
+  ASSERT_NE(nullptr, seq);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__Sequence__destroy(seq);
+    EXPECT_EQ(RMW_RET_OK, rmw_message_sequence_fini(&messages));
+  });
+  for (size_t ii = 0; ii < size; ++ii) {
+    seq->data[ii].int64_value = static_cast<int64_t>(ii);
+    messages.data[ii] = &seq->data[ii];
+  }
+  messages.size = size;
+
+  size_t published_count = 42u;
+  rcl_ret_t ret = rcl_publish_sequence(&publisher, &messages, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(size, published_count);
+
+  // The count is optional.
+  ret = rcl_publish_sequence(&publisher, &messages, nullptr, nullptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  // An empty batch publishes nothing.
+  messages.size = 0u;
+  ret = rcl_publish_sequence(&publisher, &messages, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, published_count);
+
+  // A batch larger than its capacity is rejected.
+  messages.size = size + 1u;
+  ret = rcl_publish_sequence(&publisher, &messages, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  EXPECT_TRUE(rcl_error_is_set());
+  rcl_reset_error();
+
+  // A batch with a null message is rejected before anything is published.
+  messages.size = size;
+  messages.data[size - 1u] = nullptr;
+  {
+    auto mock = mocking_utils::patch_and_return("lib:rcl", rmw_publish, RMW_RET_ERROR);
+    ret = rcl_publish_sequence(&publisher, &messages, &published_count, nullptr);
+  }
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  EXPECT_EQ(0u, published_count);
+  EXPECT_TRUE(rcl_error_is_set());
+  rcl_reset_error();
+  messages.data[size - 1u] = &seq->data[size - 1u];
+
+  ret = rcl_publish_sequence(&publisher, nullptr, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+  ret = rcl_publish_sequence(nullptr, &messages, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_PUBLISHER_INVALID, ret);
+  rcl_reset_error();
+}
+
+// Mocking rmw_publish to make rcl_publish_sequence fail part way through
+TEST_F(CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION), test_mock_publish_sequence) {
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rmw_message_sequence_t messages = rmw_get_zero_initialized_message_sequence();
+  ASSERT_EQ(RMW_RET_OK, rmw_message_sequence_init(&messages, 2u, &allocator));
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+    EXPECT_EQ(RMW_RET_OK, rmw_message_sequence_fini(&messages));
+  });
+  messages.data[0] = &msg;
+  messages.data[1] = &msg;
+  messages.size = 2u;
+
+  auto mock = mocking_utils::patch_and_return("lib:rcl", rmw_publish, RMW_RET_ERROR);
+  size_t published_count = 42u;
+  rcl_ret_t ret = rcl_publish_sequence(&publisher, &messages, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_ERROR, ret);
+  EXPECT_EQ(0u, published_count);
+  EXPECT_TRUE(rcl_error_is_set());
+  rcl_reset_error();
+}
+
+// Publish serialized messages in a batch, and fail it through rmw_publish_serialized_message
+TEST_F(
+  CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION), test_publish_serialized_message_sequence)
+{
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_serialized_message_t serialized_msgs[2] = {
+    rmw_get_zero_initialized_serialized_message(),
+    rmw_get_zero_initialized_serialized_message(),
+  };
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  msg.int64_value = 42;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+    for (auto & serialized_msg : serialized_msgs) {
+      EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_msg));
+    }
+  });
+  for (auto & serialized_msg : serialized_msgs) {
+    ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_msg, 0u, &allocator));
+    ASSERT_EQ(RMW_RET_OK, rmw_serialize(&msg, ts, &serialized_msg));
+  }
+
+  size_t published_count = 0u;
+  rcl_ret_t ret = rcl_publish_serialized_message_sequence(
+    &publisher, serialized_msgs, 2u, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(2u, published_count);
+
+  ret = rcl_publish_serialized_message_sequence(
+    &publisher, nullptr, 0u, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, published_count);
+
+  ret = rcl_publish_serialized_message_sequence(
+    &publisher, nullptr, 2u, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+
+  auto mock = mocking_utils::patch_and_return(
+    "lib:rcl", rmw_publish_serialized_message, RMW_RET_BAD_ALLOC);
+  ret = rcl_publish_serialized_message_sequence(
+    &publisher, serialized_msgs, 2u, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_BAD_ALLOC, ret);
+  EXPECT_EQ(0u, published_count);
+  EXPECT_TRUE(rcl_error_is_set());
+  rcl_reset_error();
+}
+
 // Mocking rmw_publish_serialized_message to make rcl_publish_serialized_message fail
 TEST_F(
   CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION), test_mock_publish_serialized_message)
@@ -806,6 +1187,15 @@ TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_mock_loaned_fun
   void * msg_pointer = &msg;
   rmw_publisher_allocation_t * null_allocation_is_valid_arg = nullptr;
 
+  // The mocks stand for the loans of the middleware, which rcl only uses
+  // instead of its own loan pool when the middleware can loan.
+  struct rcl_loan_pool_s * loan_pool = publisher.impl->loan_pool;
+  publisher.impl->loan_pool = nullptr;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    publisher.impl->loan_pool = loan_pool;
+  });
+
   {
     // mocked, publish nominal usage
     auto mock = mocking_utils::patch_and_return("lib:rcl", rmw_publish_loaned_message, RMW_RET_OK);
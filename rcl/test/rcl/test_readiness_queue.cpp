@@ -0,0 +1,225 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "rcl/readiness_queue.h"
+#include "rcl/rcl.h"
+#include "test_msgs/msg/basic_types.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "rcl/error_handling.h"
+#include "wait_for_entity_helpers.hpp"
+
+#ifdef RMW_IMPLEMENTATION
+# define CLASSNAME_(NAME, SUFFIX) NAME ## __ ## SUFFIX
+# define CLASSNAME(NAME, SUFFIX) CLASSNAME_(NAME, SUFFIX)
+#else
+# define CLASSNAME(NAME, SUFFIX) NAME
+#endif
+
+class CLASSNAME (TestReadinessQueueFixture, RMW_IMPLEMENTATION) : public ::testing::Test
+{
+public:
+  rcl_context_t * context_ptr;
+  rcl_node_t * node_ptr;
+  void SetUp()
+  {
+    rcl_ret_t ret;
+    {
+      rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+      ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+      {
+        EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+      });
+      this->context_ptr = new rcl_context_t;
+      *this->context_ptr = rcl_get_zero_initialized_context();
+      ret = rcl_init(0, nullptr, &init_options, this->context_ptr);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+    this->node_ptr = new rcl_node_t;
+    *this->node_ptr = rcl_get_zero_initialized_node();
+    constexpr char name[] = "test_readiness_queue_node";
+    rcl_node_options_t node_options = rcl_node_get_default_options();
+    ret = rcl_node_init(this->node_ptr, name, "", this->context_ptr, &node_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  void TearDown()
+  {
+    rcl_ret_t ret = rcl_node_fini(this->node_ptr);
+    delete this->node_ptr;
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_shutdown(this->context_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_context_fini(this->context_ptr);
+    delete this->context_ptr;
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+};
+
+TEST_F(CLASSNAME(TestReadinessQueueFixture, RMW_IMPLEMENTATION), test_init_fini) {
+  rcl_readiness_queue_t queue = rcl_get_zero_initialized_readiness_queue();
+  EXPECT_FALSE(rcl_readiness_queue_is_valid(&queue));
+  EXPECT_FALSE(rcl_readiness_queue_is_valid(nullptr));
+
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_readiness_queue_init(nullptr, 1, 1, this->context_ptr, allocator));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_readiness_queue_init(&queue, 1, 1, nullptr, allocator));
+  rcl_reset_error();
+
+  rcl_ret_t ret = rcl_readiness_queue_init(&queue, 1, 1, this->context_ptr, allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(rcl_readiness_queue_is_valid(&queue));
+  EXPECT_EQ(
+    RCL_RET_ALREADY_INIT,
+    rcl_readiness_queue_init(&queue, 1, 1, this->context_ptr, allocator));
+  rcl_reset_error();
+
+  EXPECT_EQ(RCL_RET_OK, rcl_readiness_queue_fini(&queue)) << rcl_get_error_string().str;
+  EXPECT_FALSE(rcl_readiness_queue_is_valid(&queue));
+  // Finalizing twice is a no-op
+  EXPECT_EQ(RCL_RET_OK, rcl_readiness_queue_fini(&queue)) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_readiness_queue_fini(nullptr));
+  rcl_reset_error();
+}
+
+TEST_F(CLASSNAME(TestReadinessQueueFixture, RMW_IMPLEMENTATION), test_timer) {
+  rcl_readiness_queue_t queue = rcl_get_zero_initialized_readiness_queue();
+  rcl_ret_t ret = rcl_readiness_queue_init(
+    &queue, 0, 1, this->context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_readiness_queue_fini(&queue)) << rcl_get_error_string().str;
+  });
+
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(
+    &timer, &clock, this->context_ptr, RCL_MS_TO_NS(10), nullptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+
+  ret = rcl_readiness_queue_add_timer(&queue, &timer);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_WAIT_SET_FULL, rcl_readiness_queue_add_timer(&queue, &timer));
+  rcl_reset_error();
+
+  rcl_readiness_record_t records[2];
+  size_t records_count = 42u;
+  ret = rcl_readiness_queue_wait(&queue, 0, records, 2, &records_count);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, records_count);
+
+  // The wait wakes up at the timer deadline rather than at the given timeout
+  ret = rcl_readiness_queue_wait(&queue, RCL_S_TO_NS(10), records, 2, &records_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(1u, records_count);
+  EXPECT_EQ(RCL_WAIT_SET_TIMER, records[0].entity_type);
+  EXPECT_EQ(&timer, records[0].entity);
+  EXPECT_EQ(1u, records[0].count);
+
+  // A ready timer is reported without blocking until it is called
+  ret = rcl_readiness_queue_wait(&queue, 0, records, 2, &records_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(1u, records_count);
+  EXPECT_EQ(&timer, records[0].entity);
+}
+
+TEST_F(CLASSNAME(TestReadinessQueueFixture, RMW_IMPLEMENTATION), test_subscription) {
+  rcl_ret_t ret;
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  constexpr char topic[] = "/readiness_queue_chatter";
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(&publisher, this->node_ptr, ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, this->node_ptr));
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  ret = rcl_subscription_init(&subscription, this->node_ptr, ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, this->node_ptr));
+  });
+
+  rcl_readiness_queue_t queue = rcl_get_zero_initialized_readiness_queue();
+  ret = rcl_readiness_queue_init(&queue, 1, 0, this->context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_readiness_queue_fini(&queue)) << rcl_get_error_string().str;
+  });
+
+  ret = rcl_readiness_queue_add_subscription(&queue, &subscription);
+  if (RCL_RET_UNSUPPORTED == ret) {
+    rcl_reset_error();
+    GTEST_SKIP() << "rmw implementation does not support new message callbacks";
+  }
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_WAIT_SET_FULL, rcl_readiness_queue_add_subscription(&queue, &subscription));
+  rcl_reset_error();
+
+  ASSERT_TRUE(wait_for_established_subscription(&publisher, 10, 100));
+  constexpr size_t kNumMessages = 3u;
+  for (size_t i = 0u; i < kNumMessages; ++i) {
+    test_msgs__msg__BasicTypes msg;
+    test_msgs__msg__BasicTypes__init(&msg);
+    msg.int64_value = static_cast<int64_t>(i);
+    ret = rcl_publish(&publisher, &msg, nullptr);
+    test_msgs__msg__BasicTypes__fini(&msg);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  // Notifications of the same subscription are coalesced into a single record
+  size_t received = 0u;
+  rcl_readiness_record_t records[2];
+  for (size_t tries = 0u; tries < 10u && received < kNumMessages; ++tries) {
+    size_t records_count = 0u;
+    ret = rcl_readiness_queue_wait(&queue, RCL_MS_TO_NS(100), records, 2, &records_count);
+    if (RCL_RET_TIMEOUT == ret) {
+      continue;
+    }
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    for (size_t i = 0u; i < records_count; ++i) {
+      EXPECT_EQ(RCL_WAIT_SET_SUBSCRIPTION, records[i].entity_type);
+      EXPECT_EQ(&subscription, records[i].entity);
+      received += records[i].count;
+    }
+  }
+  EXPECT_EQ(kNumMessages, received);
+}
@@ -36,6 +36,7 @@
 #include "wait_for_entity_helpers.hpp"
 
 #include "./allocator_testing_utils.h"
+#include "./subscription_impl.h"
 #include "../mocking_utils/patch.hpp"
 
 #ifdef RMW_IMPLEMENTATION
@@ -558,6 +559,111 @@ TEST_F(
   }
 }
 
+/* Basic nominal test of waiting and taking batches of messages in one call.
+ */
+TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_wait_and_take) {
+  using namespace std::chrono_literals;
+  rcl_ret_t ret;
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings);
+  constexpr char topic[] = "rcl_test_subscription_wait_and_take_chatter";
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(&publisher, this->node_ptr, ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  ret = rcl_subscription_init(&subscription, this->node_ptr, ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_subscription_fini(&subscription, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(&wait_set, 1, 0, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  auto allocator = rcutils_get_default_allocator();
+  constexpr size_t size = 5;
+  rmw_message_info_sequence_t message_infos;
+  ASSERT_EQ(RMW_RET_OK, rmw_message_info_sequence_init(&message_infos, size, &allocator));
+  rmw_message_sequence_t messages;
+  ASSERT_EQ(RMW_RET_OK, rmw_message_sequence_init(&messages, size, &allocator));
+  auto seq = test_msgs__msg__Strings__Sequence__create(size);
+  for (size_t ii = 0; ii < size; ++ii) {
+    messages.data[ii] = &seq->data[ii];
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rmw_message_info_sequence_fini(&message_infos);
+    rmw_message_sequence_fini(&messages);
+    test_msgs__msg__Strings__Sequence__destroy(seq);
+  });
+
+  size_t taken = 42u;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_and_take(nullptr, 0, size, &messages, &message_infos, &taken));
+  rcl_reset_error();
+  ret = rcl_wait_set_add_subscription(&wait_set, &subscription, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_and_take(&wait_set, 0, size, nullptr, &message_infos, &taken));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_and_take(&wait_set, 0, size, &messages, &message_infos, nullptr));
+  rcl_reset_error();
+
+  ASSERT_TRUE(wait_for_established_subscription(&publisher, 10, 100));
+  constexpr char test_string[] = "testing";
+  {
+    test_msgs__msg__Strings msg;
+    test_msgs__msg__Strings__init(&msg);
+    ASSERT_TRUE(rosidl_runtime_c__String__assign(&msg.string_value, test_string));
+    for (size_t i = 0; i < 3; ++i) {
+      ret = rcl_publish(&publisher, &msg, nullptr);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+    test_msgs__msg__Strings__fini(&msg);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  size_t total_messages_taken = 0u;
+  do {
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+    ret = rcl_wait_set_add_subscription(&wait_set, &subscription, NULL);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait_and_take(&wait_set, RCL_MS_TO_NS(100), size, &messages, &message_infos, &taken);
+    if (RCL_RET_TIMEOUT == ret) {
+      EXPECT_EQ(0u, taken);
+      EXPECT_EQ(0u, messages.size);
+      continue;
+    }
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(taken, messages.size);
+    EXPECT_EQ(messages.size, message_infos.size);
+    total_messages_taken += taken;
+  } while (total_messages_taken < 3 && std::chrono::steady_clock::now() < start + 10s);
+
+  EXPECT_EQ(3u, total_messages_taken);
+  EXPECT_EQ(
+    std::string(test_string),
+    std::string(seq->data[0].string_value.data, seq->data[0].string_value.size));
+}
+
 /* Basic nominal test of a subscription with take_serialize msg
  */
 TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_serialized) {
@@ -634,6 +740,79 @@ TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription
   }
 }
 
+/* Serialized messages taken into buffers of the subscription, which are recycled.
+ */
+TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_pooled_serialized_message) {
+  rcl_ret_t ret;
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings);
+  constexpr char topic[] = "rcl_pooled_serialized";
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(&publisher, this->node_ptr, ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  ret = rcl_subscription_init(&subscription, this->node_ptr, ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_subscription_fini(&subscription, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  rcl_serialized_message_t * serialized_msg = nullptr;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_return_pooled_serialized_message(&subscription, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_SUBSCRIPTION_INVALID,
+    rcl_take_pooled_serialized_message(nullptr, &serialized_msg, nullptr, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_SUBSCRIPTION_TAKE_FAILED,
+    rcl_take_pooled_serialized_message(&subscription, &serialized_msg, nullptr, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(nullptr, serialized_msg);
+
+  ASSERT_TRUE(wait_for_established_subscription(&publisher, 10, 100));
+  rcl_serialized_message_t * previous_serialized_msg = nullptr;
+  for (const char * test_string : {"testing", "testing again"}) {
+    {
+      test_msgs__msg__Strings msg;
+      test_msgs__msg__Strings__init(&msg);
+      ASSERT_TRUE(rosidl_runtime_c__String__assign(&msg.string_value, test_string));
+      ret = rcl_publish(&publisher, &msg, nullptr);
+      test_msgs__msg__Strings__fini(&msg);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+    ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 100));
+    serialized_msg = nullptr;
+    ret = rcl_take_pooled_serialized_message(&subscription, &serialized_msg, nullptr, nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_NE(nullptr, serialized_msg);
+    // Only one buffer was ever in use at once, so it is the one handed out again.
+    if (nullptr != previous_serialized_msg) {
+      EXPECT_EQ(previous_serialized_msg, serialized_msg);
+    }
+    previous_serialized_msg = serialized_msg;
+
+    test_msgs__msg__Strings msg_rcv;
+    test_msgs__msg__Strings__init(&msg_rcv);
+    EXPECT_EQ(RMW_RET_OK, rmw_deserialize(serialized_msg, ts, &msg_rcv));
+    EXPECT_EQ(
+      std::string(test_string), std::string(msg_rcv.string_value.data, msg_rcv.string_value.size));
+    test_msgs__msg__Strings__fini(&msg_rcv);
+    EXPECT_EQ(RCL_RET_OK, rcl_return_pooled_serialized_message(&subscription, serialized_msg));
+  }
+}
+
 /* Basic test for subscription loan functions
  */
 TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_loaned) {
@@ -763,6 +942,10 @@ TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_bad_take_loa
     &subscription, this->node_ptr, ts, topic,
     &subscription_options);
   ASSERT_EQ(RMW_RET_OK, ret) << rcl_get_error_string().str;
+  // The mocks stand for the loans of the middleware, which rcl only uses
+  // instead of its own loan pool when the middleware can loan.
+  struct rcl_loan_pool_s * loan_pool = subscription.impl->loan_pool;
+  subscription.impl->loan_pool = nullptr;
 
   test_msgs__msg__Strings * loaned_message = nullptr;
   void ** type_erased_loaned_message_pointer = reinterpret_cast<void **>(&loaned_message);
@@ -819,6 +1002,7 @@ TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_bad_take_loa
     rcl_reset_error();
   }
 
+  subscription.impl->loan_pool = loan_pool;
   EXPECT_EQ(
     RCL_RET_OK,
     rcl_subscription_fini(&subscription, this->node_ptr)) << rcl_get_error_string().str;
@@ -853,6 +1037,9 @@ TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_bad_return_l
     &subscription, this->node_ptr, ts, topic,
     &subscription_options);
   ASSERT_EQ(RMW_RET_OK, ret) << rcl_get_error_string().str;
+  // The mocks stand for the loans of the middleware, see test_bad_take_loaned_message.
+  struct rcl_loan_pool_s * loan_pool = subscription.impl->loan_pool;
+  subscription.impl->loan_pool = nullptr;
 
   EXPECT_EQ(
     RCL_RET_INVALID_ARGUMENT, rcl_return_loaned_message_from_subscription(&subscription, nullptr));
@@ -881,11 +1068,28 @@ TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_bad_return_l
     rcl_reset_error();
   }
 
+  subscription.impl->loan_pool = loan_pool;
   EXPECT_EQ(
     RCL_RET_OK,
     rcl_subscription_fini(&subscription, this->node_ptr)) << rcl_get_error_string().str;
 }
 
+// A message the content filter drops does not wake up a subscription whose
+// middleware filters, rcl drops it when taking otherwise.
+static void
+expect_filtered_out(
+  const rcl_subscription_t * subscription, rcl_context_t * context, void * ros_message)
+{
+  if (subscription->impl->rmw_handle->is_cft_enabled) {
+    EXPECT_FALSE(wait_for_subscription_to_be_ready(subscription, context, 10, 1000));
+    return;
+  }
+  ASSERT_TRUE(wait_for_subscription_to_be_ready(subscription, context, 10, 1000));
+  EXPECT_EQ(
+    RCL_RET_SUBSCRIPTION_TAKE_FAILED, rcl_take(subscription, ros_message, nullptr, nullptr));
+  rcl_reset_error();
+}
+
 /* A subscription with a content filtered topic setting.
  */
 TEST_F(
@@ -937,7 +1141,10 @@ TEST_F(
   }
 
   if (is_cft_support) {
-    ASSERT_FALSE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 1000));
+    test_msgs__msg__Strings msg;
+    test_msgs__msg__Strings__init(&msg);
+    expect_filtered_out(&subscription, context_ptr, &msg);
+    test_msgs__msg__Strings__fini(&msg);
   } else {
     ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 1000));
 
@@ -1024,7 +1231,10 @@ TEST_F(
   }
 
   if (is_cft_support) {
-    ASSERT_FALSE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 1000));
+    test_msgs__msg__Strings msg;
+    test_msgs__msg__Strings__init(&msg);
+    expect_filtered_out(&subscription, context_ptr, &msg);
+    test_msgs__msg__Strings__fini(&msg);
   } else {
     ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 1000));
 
@@ -1228,9 +1438,6 @@ TEST_F(
   const char * filter_expression2 = "int32_value = %0";
   const char * expression_parameters2[] = {"4"};
   size_t expression_parameters2_count = sizeof(expression_parameters2) / sizeof(char *);
-  bool is_cft_support =
-    (std::string(rmw_get_implementation_identifier()).find("rmw_connextdds") == 0 ||
-    std::string(rmw_get_implementation_identifier()).find("rmw_fastrtps_cpp") == 0);
   {
     rcl_subscription_content_filter_options_t options =
       rcl_get_zero_initialized_subscription_content_filter_options();
@@ -1243,12 +1450,12 @@ TEST_F(
         &options)
     );
 
+    // Filtered by the middleware if it can, by rcl otherwise.
     ret = rcl_subscription_set_content_filter(
       &subscription, &options);
-    if (!is_cft_support) {
-      ASSERT_EQ(RCL_RET_UNSUPPORTED, ret);
-    } else {
-      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_TRUE(rcl_subscription_is_cft_enabled(&subscription));
+    if (subscription.impl->rmw_handle->is_cft_enabled) {
       // waiting to allow for filter propagation
       std::this_thread::sleep_for(std::chrono::seconds(10));
     }
@@ -1270,20 +1477,11 @@ TEST_F(
     ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
   }
 
-  if (is_cft_support) {
-    ASSERT_FALSE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 1000));
-  } else {
-    ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 1000));
-
+  {
     test_msgs__msg__BasicTypes msg;
     test_msgs__msg__BasicTypes__init(&msg);
-    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
-    {
-      test_msgs__msg__BasicTypes__fini(&msg);
-    });
-    ret = rcl_take(&subscription, &msg, nullptr, nullptr);
-    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
-    ASSERT_TRUE(test_value == msg.int32_value);
+    expect_filtered_out(&subscription, context_ptr, &msg);
+    test_msgs__msg__BasicTypes__fini(&msg);
   }
 
   // publish filtered data
@@ -1374,6 +1572,72 @@ TEST_F(CLASSNAME(TestSubscriptionFixtureInit, RMW_IMPLEMENTATION), test_subscrip
   rcl_reset_error();
 }
 
+/* Takes are counted by outcome.
+ */
+TEST_F(
+  CLASSNAME(TestSubscriptionFixtureInit, RMW_IMPLEMENTATION), test_subscription_traffic_counters)
+{
+  rcl_subscription_traffic_counters_t counters;
+  rcl_ret_t ret = rcl_subscription_get_traffic_counters(&subscription, &counters);
+  if (RCL_RET_UNSUPPORTED == ret) {
+    rcl_reset_error();
+    GTEST_SKIP() << "rcl was built without traffic counters";
+  }
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, counters.message_count);
+  EXPECT_EQ(0u, counters.take_failed_count);
+  EXPECT_EQ(0u, counters.error_count);
+  EXPECT_EQ(0, counters.last_take_time);
+
+  test_msgs__msg__BasicTypes msg;
+  ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+  bool rmw_take_with_info_takes = false;
+  rmw_ret_t rmw_take_with_info_returns = RMW_RET_OK;
+  auto mock = mocking_utils::patch(
+    "lib:rcl", rmw_take_with_info,
+    [&](auto, auto, bool * taken, auto...) {
+      *taken = rmw_take_with_info_takes;
+      return rmw_take_with_info_returns;
+    });
+
+  EXPECT_EQ(RCL_RET_SUBSCRIPTION_TAKE_FAILED, rcl_take(&subscription, &msg, nullptr, nullptr));
+  rmw_take_with_info_returns = RMW_RET_ERROR;
+  EXPECT_EQ(RCL_RET_ERROR, rcl_take(&subscription, &msg, nullptr, nullptr));
+  rcl_reset_error();
+  rmw_take_with_info_takes = true;
+  rmw_take_with_info_returns = RMW_RET_OK;
+  EXPECT_EQ(RCL_RET_OK, rcl_take(&subscription, &msg, nullptr, nullptr));
+  EXPECT_EQ(RCL_RET_OK, rcl_take(&subscription, &msg, nullptr, nullptr));
+
+  ret = rcl_subscription_get_traffic_counters(&subscription, &counters);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(2u, counters.message_count);
+  EXPECT_EQ(0u, counters.serialized_byte_count);
+  EXPECT_EQ(0u, counters.loaned_message_count);
+  EXPECT_EQ(1u, counters.take_failed_count);
+  EXPECT_EQ(1u, counters.error_count);
+#ifdef RCL_ENABLE_TRAFFIC_TIMESTAMPS
+  EXPECT_NE(0, counters.last_take_time);
+#else
+  EXPECT_EQ(0, counters.last_take_time);
+#endif
+
+  EXPECT_EQ(
+    RCL_RET_SUBSCRIPTION_INVALID, rcl_subscription_get_traffic_counters(nullptr, &counters));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_SUBSCRIPTION_INVALID,
+    rcl_subscription_get_traffic_counters(&subscription_zero_init, &counters));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_subscription_get_traffic_counters(&subscription, nullptr));
+  rcl_reset_error();
+}
+
 /* bad take_serialized
 */
 TEST_F(
@@ -1612,13 +1876,15 @@ TEST_F(
   });
 
   {
+    // rcl compiles the filter instead, and BasicTypes has no such field.
     auto mock = mocking_utils::patch_and_return(
       "lib:rcl", rmw_subscription_set_content_filter, RMW_RET_UNSUPPORTED);
     EXPECT_EQ(
-      RMW_RET_UNSUPPORTED,
+      RCL_RET_INVALID_ARGUMENT,
       rcl_subscription_set_content_filter(
         &subscription, &options));
     rcl_reset_error();
+    EXPECT_FALSE(rcl_subscription_is_cft_enabled(&subscription));
   }
 
   {
@@ -18,6 +18,7 @@
 
 #include <chrono>
 #include <thread>
+#include <vector>
 
 #include "osrf_testing_tools_cpp/memory_tools/memory_tools.hpp"
 #include "osrf_testing_tools_cpp/scope_exit.hpp"
@@ -341,6 +342,75 @@ TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), specific_clock_instantiation) {
   }
 }
 
+TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), fast_steady_clock) {
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_clock_t fast_clock;
+  rcl_ret_t ret = rcl_fast_steady_clock_init(&fast_clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&fast_clock)) << rcl_get_error_string().str;
+  });
+  EXPECT_EQ(RCL_STEADY_TIME, fast_clock.type);
+  EXPECT_TRUE(rcl_clock_valid(&fast_clock));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_fast_steady_clock_init(nullptr, &allocator));
+  rcl_reset_error();
+
+  rcl_clock_t steady_clock;
+  ret = rcl_steady_clock_init(&steady_clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&steady_clock)) << rcl_get_error_string().str;
+  });
+  // Both clocks share an epoch, and the fast one never goes backwards.
+  rcl_time_point_value_t previous = 0;
+  for (int i = 0; i < 1000; ++i) {
+    rcl_time_point_value_t before, fast_now, after;
+    ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&steady_clock, &before));
+    ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&fast_clock, &fast_now));
+    ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&steady_clock, &after));
+    EXPECT_GE(fast_now, previous);
+    EXPECT_GT(fast_now, before - RCL_MS_TO_NS(1));
+    EXPECT_LT(fast_now, after + RCL_MS_TO_NS(1));
+    previous = fast_now;
+  }
+
+  // Left unread for longer than it is re-anchored, it does not drift away.
+  std::this_thread::sleep_for(std::chrono::milliseconds(600));
+  rcl_time_point_value_t before, fast_now, after;
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&steady_clock, &before));
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&fast_clock, &fast_now));
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&steady_clock, &after));
+  EXPECT_GE(fast_now, previous);
+  EXPECT_GT(fast_now, before - RCL_US_TO_NS(100));
+  EXPECT_LT(fast_now, after + RCL_US_TO_NS(100));
+
+  // Readings of each thread keep going forward while other threads re-anchor the counter.
+  std::vector<std::thread> threads;
+  std::vector<int> backwards(4, 0);
+  for (size_t t = 0u; t < backwards.size(); ++t) {
+    threads.emplace_back(
+      [&fast_clock, &backwards, t]() {
+        rcl_time_point_value_t previous = 0;
+        for (int i = 0; i < 100000; ++i) {
+          rcl_time_point_value_t now = 0;
+          (void)rcl_clock_get_now(&fast_clock, &now);
+          if (now < previous) {
+            ++backwards[t];
+          }
+          previous = now;
+        }
+      });
+  }
+  for (std::thread & thread : threads) {
+    thread.join();
+  }
+  for (int count : backwards) {
+    EXPECT_EQ(0, count);
+  }
+}
+
 TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), rcl_time_difference) {
   rcl_ret_t ret;
   rcl_time_point_t a, b;
@@ -760,9 +830,8 @@ TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), add_remove_add_jump_callback) {
   EXPECT_EQ(RCL_RET_BAD_ALLOC, rcl_clock_add_jump_callback(&clock, threshold, cb, user_data3));
   rcl_reset_error();
 
-  // Remove callback but fail to shrink storage
-  EXPECT_EQ(RCL_RET_BAD_ALLOC, rcl_clock_remove_jump_callback(&clock, cb, user_data1));
-  rcl_reset_error();
+  // Removing a callback does not allocate
+  EXPECT_EQ(RCL_RET_OK, rcl_clock_remove_jump_callback(&clock, cb, user_data1));
 
   set_failing_allocator_is_failing(failing_allocator, false);
 
@@ -778,6 +847,192 @@ TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), add_remove_add_jump_callback) {
   EXPECT_EQ(1u, clock.num_jump_callbacks);
 }
 
+static void count_jump_callback(
+  const rcl_time_jump_t * time_jump,
+  bool before_jump,
+  void * user_data)
+{
+  (void)time_jump;
+  if (!before_jump) {
+    ++*static_cast<int *>(user_data);
+  }
+}
+
+TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), jump_callback_thresholds) {
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_ret_t ret = rcl_ros_clock_init(&clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&clock));
+  });
+  const rcl_time_point_value_t start = RCL_S_TO_NS(1);
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, start));
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clock));
+
+  struct
+  {
+    bool on_clock_change;
+    int64_t min_forward;
+    int64_t min_backward;
+  } thresholds[] = {
+    {false, 1, 0},
+    {false, 1000, 0},
+    {false, RCL_MS_TO_NS(1), 0},
+    {false, 0, -1},
+    {false, 0, -RCL_MS_TO_NS(1)},
+    {true, 1, -1},
+  };
+  int counts[6] = {0};
+  for (size_t i = 0; i < 6; ++i) {
+    rcl_jump_threshold_t threshold;
+    threshold.on_clock_change = thresholds[i].on_clock_change;
+    threshold.min_forward.nanoseconds = thresholds[i].min_forward;
+    threshold.min_backward.nanoseconds = thresholds[i].min_backward;
+    ret = rcl_clock_add_jump_callback(&clock, threshold, count_jump_callback, &counts[i]);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  EXPECT_EQ(6u, clock.num_jump_callbacks);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, start + 1500));
+  EXPECT_EQ(1, counts[0]);
+  EXPECT_EQ(1, counts[1]);
+  EXPECT_EQ(0, counts[2]);
+  EXPECT_EQ(0, counts[3]);
+  EXPECT_EQ(0, counts[4]);
+  EXPECT_EQ(1, counts[5]);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, start - RCL_MS_TO_NS(1)));
+  EXPECT_EQ(1, counts[0]);
+  EXPECT_EQ(1, counts[1]);
+  EXPECT_EQ(0, counts[2]);
+  EXPECT_EQ(1, counts[3]);
+  EXPECT_EQ(1, counts[4]);
+  EXPECT_EQ(2, counts[5]);
+
+  // A callback matching both the clock change and a threshold is called once
+  ASSERT_EQ(RCL_RET_OK, rcl_disable_ros_time_override(&clock));
+  EXPECT_EQ(1, counts[0]);
+  EXPECT_EQ(3, counts[5]);
+
+  // The callbacks moved by removals are still called
+  EXPECT_EQ(
+    RCL_RET_OK, rcl_clock_remove_jump_callback(&clock, count_jump_callback, &counts[0]));
+  EXPECT_EQ(
+    RCL_RET_OK, rcl_clock_remove_jump_callback(&clock, count_jump_callback, &counts[3]));
+  EXPECT_EQ(4u, clock.num_jump_callbacks);
+  EXPECT_EQ(
+    RCL_RET_ERROR, rcl_clock_remove_jump_callback(&clock, count_jump_callback, &counts[0]));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clock));
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, start + RCL_MS_TO_NS(1)));
+  EXPECT_EQ(1, counts[0]);
+  EXPECT_EQ(2, counts[1]);
+  EXPECT_EQ(1, counts[2]);
+  EXPECT_EQ(1, counts[3]);
+  EXPECT_EQ(1, counts[4]);
+  EXPECT_EQ(5, counts[5]);
+}
+
+TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), many_jump_callbacks) {
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_ret_t ret = rcl_ros_clock_init(&clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&clock));
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, RCL_S_TO_NS(1)));
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clock));
+
+  rcl_jump_threshold_t threshold;
+  threshold.on_clock_change = false;
+  threshold.min_forward.nanoseconds = 1;
+  threshold.min_backward.nanoseconds = 0;
+  std::vector<int> counts(1000, 0);
+  for (int & count : counts) {
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_clock_add_jump_callback(&clock, threshold, count_jump_callback, &count)) <<
+      rcl_get_error_string().str;
+  }
+  for (size_t i = 0; i < counts.size(); i += 2) {
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_clock_remove_jump_callback(&clock, count_jump_callback, &counts[i])) <<
+      rcl_get_error_string().str;
+  }
+  EXPECT_EQ(counts.size() / 2, clock.num_jump_callbacks);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, RCL_S_TO_NS(2)));
+  for (size_t i = 0; i < counts.size(); ++i) {
+    EXPECT_EQ(static_cast<int>(i % 2), counts[i]) << i;
+  }
+}
+
+struct removing_jump_callback_data
+{
+  rcl_clock_t * clock;
+  std::vector<int> * calls;
+  int id;
+  bool remove_self;
+};
+
+static void removing_jump_callback(
+  const rcl_time_jump_t * time_jump,
+  bool before_jump,
+  void * user_data)
+{
+  (void)time_jump;
+  auto data = static_cast<removing_jump_callback_data *>(user_data);
+  if (before_jump) {
+    return;
+  }
+  data->calls->push_back(data->id);
+  if (data->remove_self) {
+    EXPECT_EQ(
+      RCL_RET_OK,
+      rcl_clock_remove_jump_callback(data->clock, removing_jump_callback, user_data));
+  }
+}
+
+TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), jump_callback_removes_itself) {
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_ret_t ret = rcl_ros_clock_init(&clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&clock));
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, RCL_S_TO_NS(1)));
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clock));
+
+  rcl_jump_threshold_t threshold;
+  threshold.on_clock_change = false;
+  threshold.min_forward.nanoseconds = 1;
+  threshold.min_backward.nanoseconds = 0;
+  std::vector<int> calls;
+  std::vector<removing_jump_callback_data> data(4);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = {&clock, &calls, static_cast<int>(i), 0 == i};
+    ret = rcl_clock_add_jump_callback(&clock, threshold, removing_jump_callback, &data[i]);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  // The callbacks after the removed one are still called, in the order they were added
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, RCL_S_TO_NS(2)));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), calls);
+  EXPECT_EQ(3u, clock.num_jump_callbacks);
+
+  calls.clear();
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, RCL_S_TO_NS(3)));
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), calls);
+  EXPECT_EQ(
+    RCL_RET_ERROR, rcl_clock_remove_jump_callback(&clock, removing_jump_callback, &data[0]));
+  rcl_reset_error();
+}
+
 TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), failed_get_now) {
   rcl_allocator_t allocator = rcl_get_default_allocator();
   rcl_clock_t uninitialized_clock;
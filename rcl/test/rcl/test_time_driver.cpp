@@ -0,0 +1,236 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include "rcl/time_driver.h"
+
+#include "rcl/error_handling.h"
+#include "rcl/rcl.h"
+#include "rcl/timer.h"
+#include "rcl/wait.h"
+#include "rcutils/time.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+static constexpr rcl_time_point_value_t kStartTime = RCL_S_TO_NS(1);
+
+class TestTimeDriverFixture : public ::testing::Test
+{
+public:
+  rcl_context_t context;
+  rcl_time_driver_t driver;
+  rcl_clock_t clock;
+  rcl_allocator_t allocator;
+
+  void SetUp() override
+  {
+    allocator = rcl_get_default_allocator();
+    rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+    rcl_ret_t ret = rcl_init_options_init(&init_options, allocator);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+    });
+    context = rcl_get_zero_initialized_context();
+    ret = rcl_init(0, nullptr, &init_options, &context);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    driver = rcl_get_zero_initialized_time_driver();
+    ret = rcl_time_driver_init(&driver, &context, kStartTime, allocator);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_clock_init(RCL_ROS_TIME, &clock, &allocator);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_clock_bind_ros_time_source(&clock, rcl_context_get_ros_time_source(&context));
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_time_driver_fini(&driver)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_shutdown(&context)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_context_fini(&context)) << rcl_get_error_string().str;
+  }
+};
+
+static void
+count_call(rcl_timer_t * timer, int64_t last_call)
+{
+  (void)timer;
+  (void)last_call;
+}
+
+TEST_F(TestTimeDriverFixture, init_fini) {
+  rcl_time_point_value_t now = 0;
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clock, &now)) << rcl_get_error_string().str;
+  EXPECT_EQ(kStartTime, now);
+  uint64_t advance_count = 1u;
+  EXPECT_EQ(RCL_RET_OK, rcl_time_driver_get_advance_count(&driver, &advance_count));
+  EXPECT_EQ(0u, advance_count);
+  EXPECT_TRUE(rcl_time_driver_is_valid(&driver));
+
+  EXPECT_EQ(
+    RCL_RET_ALREADY_INIT, rcl_time_driver_init(&driver, &context, kStartTime, allocator));
+  rcl_reset_error();
+  rcl_time_driver_t other = rcl_get_zero_initialized_time_driver();
+  EXPECT_FALSE(rcl_time_driver_is_valid(&other));
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_time_driver_init(nullptr, &context, kStartTime, allocator));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_time_driver_init(&other, nullptr, kStartTime, allocator));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_time_driver_get_advance_count(&other, &advance_count));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_time_driver_get_advance_count(&driver, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_OK, rcl_time_driver_fini(&other));
+
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_init(&wait_set, 0, 1, 0, 0, 0, 0, &context, allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_set_time_driver(&wait_set, &other));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_time_driver(&wait_set, &driver));
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_set_time_driver(&wait_set, &driver));
+  // Wait sets have to be detached first.
+  EXPECT_EQ(RCL_RET_ERROR, rcl_time_driver_fini(&driver));
+  rcl_reset_error();
+  EXPECT_TRUE(rcl_time_driver_is_valid(&driver));
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_set_time_driver(&wait_set, nullptr));
+}
+
+TEST_F(TestTimeDriverFixture, advances_to_next_deadline) {
+  rcl_timer_t fast_timer = rcl_get_zero_initialized_timer();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_timer_init(
+      &fast_timer, &clock, &context, RCL_S_TO_NS(1), count_call, allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&fast_timer)) << rcl_get_error_string().str;
+  });
+  rcl_timer_t slow_timer = rcl_get_zero_initialized_timer();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_timer_init(
+      &slow_timer, &clock, &context, RCL_S_TO_NS(3), count_call, allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&slow_timer)) << rcl_get_error_string().str;
+  });
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_init(&wait_set, 0, 0, 2, 0, 0, 0, &context, allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_time_driver(&wait_set, &driver));
+
+  rcutils_time_point_value_t start = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_steady_time_now(&start));
+  // (time, number of ready timers) of each wake-up.
+  std::vector<std::pair<rcl_time_point_value_t, size_t>> wakes;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &fast_timer, nullptr));
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &slow_timer, nullptr));
+    ASSERT_EQ(RCL_RET_OK, rcl_wait(&wait_set, RCL_S_TO_NS(10))) << rcl_get_error_string().str;
+    rcl_time_point_value_t now = 0;
+    ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clock, &now));
+    size_t ready = 0u;
+    for (size_t j = 0u; j < wait_set.size_of_timers; ++j) {
+      if (wait_set.timers[j]) {
+        ++ready;
+        EXPECT_EQ(
+          RCL_RET_OK, rcl_timer_call(const_cast<rcl_timer_t *>(wait_set.timers[j]))) <<
+          rcl_get_error_string().str;
+      }
+    }
+    wakes.emplace_back(now, ready);
+  }
+  rcutils_time_point_value_t end = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_steady_time_now(&end));
+
+  const std::vector<std::pair<rcl_time_point_value_t, size_t>> expected = {
+    {kStartTime + RCL_S_TO_NS(1), 1u},
+    {kStartTime + RCL_S_TO_NS(2), 1u},
+    {kStartTime + RCL_S_TO_NS(3), 2u},
+    {kStartTime + RCL_S_TO_NS(4), 1u},
+  };
+  EXPECT_EQ(expected, wakes);
+  uint64_t advance_count = 0u;
+  EXPECT_EQ(RCL_RET_OK, rcl_time_driver_get_advance_count(&driver, &advance_count));
+  EXPECT_EQ(4u, advance_count);
+  // Four seconds of ROS time should take far less than that.
+  EXPECT_LT(end - start, RCL_S_TO_NS(2));
+}
+
+TEST_F(TestTimeDriverFixture, busy_wait_set_holds_time) {
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_timer_init(&timer, &clock, &context, RCL_S_TO_NS(1), count_call, allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_init(&wait_set, 0, 0, 1, 0, 0, 0, &context, allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+  rcl_wait_set_t busy_wait_set = rcl_get_zero_initialized_wait_set();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_init(&busy_wait_set, 0, 1, 0, 0, 0, 0, &context, allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&busy_wait_set)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_time_driver(&wait_set, &driver));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_time_driver(&busy_wait_set, &driver));
+
+  // The other wait set never waits, so the time does not move.
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &timer, nullptr));
+  EXPECT_EQ(RCL_RET_TIMEOUT, rcl_wait(&wait_set, RCL_MS_TO_NS(10)));
+  rcl_time_point_value_t now = 0;
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clock, &now));
+  EXPECT_EQ(kStartTime, now);
+
+  // Finalizing the other wait set detaches it.
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&busy_wait_set)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &timer, nullptr));
+  EXPECT_EQ(RCL_RET_OK, rcl_wait(&wait_set, RCL_S_TO_NS(10))) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clock, &now));
+  EXPECT_EQ(kStartTime + RCL_S_TO_NS(1), now);
+  EXPECT_NE(nullptr, wait_set.timers[0]);
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_set_time_driver(&wait_set, nullptr));
+}
@@ -574,6 +574,291 @@ TEST_F(TestTimerFixture, test_rostime_time_until_next_call) {
   EXPECT_EQ(-1, time_until);
 }
 
+TEST_F(TestTimerFixture, test_rostime_next_call_time) {
+  rcl_ret_t ret;
+  const int64_t sec_5 = RCL_S_TO_NS(5);
+  int64_t next_call_time = 0;
+
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_ROS_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clock)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, 1)) << rcl_get_error_string().str;
+
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(
+    &timer, &clock, this->context_ptr, sec_5, nullptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_get_next_call_time(nullptr, &next_call_time));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_get_next_call_time(&timer, nullptr));
+  rcl_reset_error();
+
+  // The next call time does not depend on the current time
+  ret = rcl_timer_get_next_call_time(&timer, &next_call_time);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(sec_5 + 1, next_call_time);
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, sec_5)) << rcl_get_error_string().str;
+  ret = rcl_timer_get_next_call_time(&timer, &next_call_time);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(sec_5 + 1, next_call_time);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_cancel(&timer)) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_TIMER_CANCELED, rcl_timer_get_next_call_time(&timer, &next_call_time));
+}
+
+TEST_F(TestTimerFixture, test_rostime_with_now) {
+  rcl_ret_t ret;
+  const int64_t sec_5 = RCL_S_TO_NS(5);
+  int64_t time_until = 0;
+  int64_t next_call_time = 0;
+  bool is_ready = true;
+
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_ROS_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clock)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, 1)) << rcl_get_error_string().str;
+
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(
+    &timer, &clock, this->context_ptr, sec_5, nullptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_timer_get_time_until_next_call_with_now(nullptr, 0, &time_until));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_timer_get_time_until_next_call_with_now(&timer, 0, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_is_ready_with_now(nullptr, 0, &is_ready));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_is_ready_with_now(&timer, 0, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_call_with_now(nullptr, sec_5));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_ERROR, rcl_timer_call_with_now(&timer, -1));
+  rcl_reset_error();
+
+  // The given time is used, the clock still reads 1ns
+  ret = rcl_timer_get_time_until_next_call_with_now(&timer, sec_5, &time_until);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(1, time_until);
+  ret = rcl_timer_is_ready_with_now(&timer, sec_5, &is_ready);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_FALSE(is_ready);
+  ret = rcl_timer_is_ready_with_now(&timer, sec_5 + 1, &is_ready);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(is_ready);
+
+  ret = rcl_timer_call_with_now(&timer, sec_5 + 1);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_timer_get_next_call_time(&timer, &next_call_time);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(2 * sec_5 + 1, next_call_time);
+  ret = rcl_timer_get_time_since_last_call(&timer, &time_until);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(-sec_5, time_until);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_cancel(&timer)) << rcl_get_error_string().str;
+  EXPECT_EQ(
+    RCL_RET_TIMER_CANCELED,
+    rcl_timer_get_time_until_next_call_with_now(&timer, 2 * sec_5 + 1, &time_until));
+  ret = rcl_timer_is_ready_with_now(&timer, 2 * sec_5 + 1, &is_ready);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_FALSE(is_ready);
+  EXPECT_EQ(RCL_RET_TIMER_CANCELED, rcl_timer_call_with_now(&timer, 2 * sec_5 + 1));
+  rcl_reset_error();
+}
+
+TEST_F(TestTimerFixture, test_timer_catch_up_policy) {
+  rcl_ret_t ret;
+  const int64_t sec_5 = RCL_S_TO_NS(5);
+  const int64_t late_now = 4 * sec_5 + RCL_S_TO_NS(2) + 1;
+  int64_t next_call_time = 0;
+  bool is_ready = false;
+
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_ROS_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clock)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, 1)) << rcl_get_error_string().str;
+
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(
+    &timer, &clock, this->context_ptr, sec_5, nullptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+
+  rcl_timer_catch_up_policy_t policy = RCL_TIMER_CATCH_UP_BURST;
+  int64_t max_backlog = -1;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_catch_up_policy(&timer, &policy, &max_backlog));
+  EXPECT_EQ(RCL_TIMER_CATCH_UP_SKIP, policy);
+  EXPECT_EQ(0, max_backlog);
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_timer_set_catch_up_policy(&timer, RCL_TIMER_CATCH_UP_BOUNDED, -1));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_timer_set_catch_up_policy(&timer, static_cast<rcl_timer_catch_up_policy_t>(42), 0));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_timer_set_catch_up_policy(nullptr, RCL_TIMER_CATCH_UP_SKIP, 0));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_timer_get_catch_up_policy(&timer, nullptr, &max_backlog));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_get_catch_up_policy(&timer, &policy, nullptr));
+  rcl_reset_error();
+
+  // Each case is scheduled at 5s + 1ns and called at 22s + 1ns, which misses
+  // the calls at 10s, 15s and 20s.
+
+  // Skip: the next call is at 25s
+  ret = rcl_timer_call_with_now(&timer, late_now);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time));
+  EXPECT_EQ(5 * sec_5 + 1, next_call_time);
+
+  // Burst: the timer is called for 10s, 15s and 20s before it waits for 25s
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_set_catch_up_policy(&timer, RCL_TIMER_CATCH_UP_BURST, 0));
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_reset(&timer)) << rcl_get_error_string().str;
+  for (int64_t i = 2; i <= 4; ++i) {
+    ret = rcl_timer_call_with_now(&timer, late_now);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time));
+    EXPECT_EQ(i * sec_5 + 1, next_call_time);
+    ASSERT_EQ(RCL_RET_OK, rcl_timer_is_ready_with_now(&timer, late_now, &is_ready));
+    EXPECT_TRUE(is_ready);
+  }
+  ret = rcl_timer_call_with_now(&timer, late_now);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time));
+  EXPECT_EQ(5 * sec_5 + 1, next_call_time);
+
+  // Drift: the next call is one period after the call
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_set_catch_up_policy(&timer, RCL_TIMER_CATCH_UP_DRIFT, 0));
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_reset(&timer)) << rcl_get_error_string().str;
+  ret = rcl_timer_call_with_now(&timer, late_now);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time));
+  EXPECT_EQ(late_now + sec_5, next_call_time);
+
+  // Bounded: the call for 20s is kept, the one for 10s and 15s are dropped
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_set_catch_up_policy(&timer, RCL_TIMER_CATCH_UP_BOUNDED, 1));
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_catch_up_policy(&timer, &policy, &max_backlog));
+  EXPECT_EQ(RCL_TIMER_CATCH_UP_BOUNDED, policy);
+  EXPECT_EQ(1, max_backlog);
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_reset(&timer)) << rcl_get_error_string().str;
+  ret = rcl_timer_call_with_now(&timer, late_now);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time));
+  EXPECT_EQ(4 * sec_5 + 1, next_call_time);
+  ret = rcl_timer_call_with_now(&timer, late_now);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time));
+  EXPECT_EQ(5 * sec_5 + 1, next_call_time);
+}
+
+TEST_F(TestTimerFixture, test_timer_statistics) {
+  rcl_ret_t ret;
+  const int64_t sec_5 = RCL_S_TO_NS(5);
+
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_ROS_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clock)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, 1)) << rcl_get_error_string().str;
+
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(
+    &timer, &clock, this->context_ptr, sec_5, nullptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+
+  rcl_timer_statistics_t statistics;
+  EXPECT_EQ(RCL_RET_ERROR, rcl_timer_get_statistics(&timer, &statistics));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_set_statistics(nullptr, true));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_set_statistics(&timer, true)) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_get_statistics(nullptr, &statistics));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_get_statistics(&timer, nullptr));
+  rcl_reset_error();
+
+  // Scheduled at 5s + 1ns, called 2ns late
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_call_with_now(&timer, sec_5 + 3)) << rcl_get_error_string().str;
+  // Scheduled at 10s + 1ns, called 12s late, which skips the calls at 15s and 20s
+  ret = rcl_timer_call_with_now(&timer, 4 * sec_5 + RCL_S_TO_NS(2) + 1);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  // Scheduled at 25s + 1ns, called early
+  ret = rcl_timer_call_with_now(&timer, 5 * sec_5 - RCL_S_TO_NS(1) + 1);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_statistics(&timer, &statistics));
+  EXPECT_EQ(3u, statistics.call_count);
+  EXPECT_EQ(2u, statistics.missed_period_count);
+  EXPECT_EQ(uint64_t(RCL_S_TO_NS(12) + 2), statistics.total_lateness);
+  EXPECT_EQ(uint64_t(RCL_S_TO_NS(12)), statistics.max_lateness);
+  EXPECT_EQ(uint64_t(RCL_S_TO_NS(12) - 2), statistics.max_jitter);
+  EXPECT_EQ(0u, statistics.total_callback_duration);
+  EXPECT_EQ(1u, statistics.lateness_histogram[0]);
+  EXPECT_EQ(1u, statistics.lateness_histogram[2]);
+  uint64_t histogram_count = 0u;
+  for (uint64_t count : statistics.lateness_histogram) {
+    histogram_count += count;
+  }
+  EXPECT_EQ(3u, histogram_count);
+
+  // Enabling again resets the statistics
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_set_statistics(&timer, true)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_statistics(&timer, &statistics));
+  EXPECT_EQ(0u, statistics.call_count);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_set_statistics(&timer, false)) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_ERROR, rcl_timer_get_statistics(&timer, &statistics));
+  rcl_reset_error();
+}
+
 TEST_F(TestTimerFixture, test_system_time_to_ros_time) {
   rcl_ret_t ret;
   const int64_t sec_5 = RCL_S_TO_NS(5);
@@ -894,6 +1179,31 @@ TEST_F(TestPreInitTimer, test_timer_get_period) {
   rcl_reset_error();
 }
 
+TEST_F(TestPreInitTimer, test_timer_slack) {
+  int64_t slack = -1;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_slack(&timer, &slack));
+  EXPECT_EQ(0, slack);
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_set_slack(&timer, RCL_MS_TO_NS(20)));
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_slack(&timer, &slack));
+  EXPECT_EQ(RCL_MS_TO_NS(20), slack);
+
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_set_slack(&timer, -1));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_set_slack(nullptr, 0));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_get_slack(nullptr, &slack));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_get_slack(&timer, nullptr));
+  rcl_reset_error();
+
+  // The slack does not delay readiness
+  bool is_ready = false;
+  int64_t next_call_time = 0;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time));
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_is_ready_with_now(&timer, next_call_time, &is_ready));
+  EXPECT_TRUE(is_ready);
+}
+
 TEST_F(TestPreInitTimer, test_time_since_last_call) {
   rcl_time_point_value_t time_sice_next_call_start = 0u;
   rcl_time_point_value_t time_sice_next_call_end = 0u;
@@ -103,15 +103,79 @@ TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), test_failed_resize) {
   EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
 
   set_failing_allocator_is_failing(allocator, true);
+  // Shrinking stays within the capacity, so it does not allocate
   ret = rcl_wait_set_resize(&wait_set, 0, 1, 0, 0, 0, 0);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_resize(&wait_set, 0, 1, 0, 2, 0, 0);
   EXPECT_EQ(RCL_RET_BAD_ALLOC, ret);
   rcl_reset_error();
+  EXPECT_EQ(0u, wait_set.size_of_guard_conditions);
+  EXPECT_EQ(0u, wait_set.size_of_clients);
 
   set_failing_allocator_is_failing(allocator, false);
   ret = rcl_wait_set_fini(&wait_set);
   ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
 }
 
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), test_resize_capacity) {
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret =
+    rcl_wait_set_init(&wait_set, 0, 4, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  // Resizing within the capacity keeps the storage
+  const rcl_guard_condition_t ** storage = wait_set.guard_conditions;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_resize(&wait_set, 0, 1, 0, 0, 0, 0));
+  EXPECT_EQ(1u, wait_set.size_of_guard_conditions);
+  EXPECT_EQ(storage, wait_set.guard_conditions);
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_resize(&wait_set, 0, 4, 0, 0, 0, 0));
+  EXPECT_EQ(4u, wait_set.size_of_guard_conditions);
+  EXPECT_EQ(storage, wait_set.guard_conditions);
+
+  // Growing at least doubles the capacity
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_resize(&wait_set, 0, 5, 0, 0, 0, 0));
+  EXPECT_EQ(5u, wait_set.size_of_guard_conditions);
+  storage = wait_set.guard_conditions;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_resize(&wait_set, 0, 8, 0, 0, 0, 0));
+  EXPECT_EQ(storage, wait_set.guard_conditions);
+  for (size_t i = 0u; i < wait_set.size_of_guard_conditions; ++i) {
+    EXPECT_EQ(nullptr, wait_set.guard_conditions[i]);
+  }
+
+  // Shrinking to fit releases the capacity, and the wait set keeps working
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_resize(&wait_set, 0, 1, 0, 0, 0, 0));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_shrink_to_fit(&wait_set));
+  EXPECT_EQ(1u, wait_set.size_of_guard_conditions);
+  rcl_guard_condition_t guard_cond = rcl_get_zero_initialized_guard_condition();
+  ret = rcl_guard_condition_init(
+    &guard_cond, this->context_ptr, rcl_guard_condition_get_default_options());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_guard_condition_fini(&guard_cond);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_guard_condition(&wait_set, &guard_cond, nullptr));
+  EXPECT_EQ(
+    RCL_RET_WAIT_SET_FULL, rcl_wait_set_add_guard_condition(&wait_set, &guard_cond, nullptr));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_cond));
+  ret = rcl_wait(&wait_set, RCL_MS_TO_NS(100));
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(&guard_cond, wait_set.guard_conditions[0]);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_resize(&wait_set, 0, 0, 0, 0, 0, 0));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_shrink_to_fit(&wait_set));
+  EXPECT_EQ(nullptr, wait_set.guard_conditions);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_shrink_to_fit(nullptr));
+  rcl_reset_error();
+}
+
 TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), test_resize_to_zero) {
   // Initialize a wait set with a subscription and then resize it to zero.
   rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
@@ -623,6 +687,835 @@ TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), add_with_index) {
   }
 }
 
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), persistent_add_remove) {
+  const size_t kNumEntities = 3u;
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret = rcl_wait_set_init(
+    &wait_set, 0, kNumEntities, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  rcl_guard_condition_t guard_conditions[kNumEntities + 1u];
+  for (size_t i = 0u; i < kNumEntities + 1u; ++i) {
+    guard_conditions[i] = rcl_get_zero_initialized_guard_condition();
+    ret = rcl_guard_condition_init(
+      &guard_conditions[i], this->context_ptr, rcl_guard_condition_get_default_options());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumEntities + 1u; ++i) {
+      ret = rcl_guard_condition_fini(&guard_conditions[i]);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+  });
+
+  // Removing only works on persistent wait sets
+  EXPECT_FALSE(rcl_wait_set_is_persistent(&wait_set));
+  EXPECT_EQ(RCL_RET_ERROR, rcl_wait_set_remove_guard_condition(&wait_set, 0u));
+  rcl_reset_error();
+
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_set_persistent(&wait_set, true));
+  EXPECT_TRUE(rcl_wait_set_is_persistent(&wait_set));
+
+  size_t index = 42u;
+  for (size_t i = 0u; i < kNumEntities; ++i) {
+    ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[i], &index);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(i, index);
+  }
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[kNumEntities], &index);
+  EXPECT_EQ(RCL_RET_WAIT_SET_FULL, ret);
+  rcl_reset_error();
+
+  // Removed slots are reused
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_remove_guard_condition(&wait_set, 1u));
+  EXPECT_EQ(nullptr, wait_set.guard_conditions[1]);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_remove_guard_condition(&wait_set, 1u));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_remove_guard_condition(&wait_set, kNumEntities));
+  rcl_reset_error();
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[kNumEntities], &index);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(1u, index);
+  EXPECT_EQ(&guard_conditions[kNumEntities], wait_set.guard_conditions[1]);
+
+  // Clearing removes every entity
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  EXPECT_TRUE(rcl_wait_set_is_persistent(&wait_set));
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[0], &index);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, index);
+
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_set_persistent(&wait_set, false));
+  EXPECT_FALSE(rcl_wait_set_is_persistent(&wait_set));
+  EXPECT_EQ(nullptr, wait_set.guard_conditions[0]);
+}
+
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), persistent_ready_indices) {
+  const size_t kNumEntities = 3u;
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret = rcl_wait_set_init(
+    &wait_set, 0, kNumEntities, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  const size_t * ready_indices = nullptr;
+  size_t ready_count = 0u;
+  EXPECT_EQ(
+    RCL_RET_ERROR,
+    rcl_wait_set_get_ready_indices(
+      &wait_set, RCL_WAIT_SET_GUARD_CONDITION, &ready_indices, &ready_count));
+  rcl_reset_error();
+
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_persistent(&wait_set, true));
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_set_get_ready_indices(
+      &wait_set, RCL_WAIT_SET_GUARD_CONDITION, nullptr, &ready_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_set_get_ready_indices(
+      &wait_set, RCL_WAIT_SET_GUARD_CONDITION, &ready_indices, nullptr));
+  rcl_reset_error();
+
+  rcl_guard_condition_t guard_conditions[kNumEntities];
+  for (size_t i = 0u; i < kNumEntities; ++i) {
+    guard_conditions[i] = rcl_get_zero_initialized_guard_condition();
+    ret = rcl_guard_condition_init(
+      &guard_conditions[i], this->context_ptr, rcl_guard_condition_get_default_options());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[i], nullptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumEntities; ++i) {
+      ret = rcl_guard_condition_fini(&guard_conditions[i]);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+  });
+
+  ret = rcl_wait(&wait_set, 0);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_get_ready_indices(
+    &wait_set, RCL_WAIT_SET_GUARD_CONDITION, &ready_indices, &ready_count);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, ready_count);
+
+  // Only the triggered guard condition is reported, and the storage stays untouched
+  EXPECT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[2]));
+  ret = rcl_wait(&wait_set, 0);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_get_ready_indices(
+    &wait_set, RCL_WAIT_SET_GUARD_CONDITION, &ready_indices, &ready_count);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(2u, ready_indices[0]);
+  for (size_t i = 0u; i < kNumEntities; ++i) {
+    EXPECT_EQ(&guard_conditions[i], wait_set.guard_conditions[i]);
+  }
+
+  // Removed entities are no longer waited on
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_remove_guard_condition(&wait_set, 2u));
+  EXPECT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[2]));
+  EXPECT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[0]));
+  ret = rcl_wait(&wait_set, 0);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_get_ready_indices(
+    &wait_set, RCL_WAIT_SET_GUARD_CONDITION, &ready_indices, &ready_count);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(0u, ready_indices[0]);
+}
+
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), persistent_timers) {
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret =
+    rcl_wait_set_init(&wait_set, 0, 0, 2, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_persistent(&wait_set, true));
+
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_clock_fini(&clock);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  // A fast timer which becomes due and a slow one which never does during this test
+  const int64_t periods[] = {RCL_MS_TO_NS(10), RCL_S_TO_NS(100)};
+  rcl_timer_t timers[2];
+  for (size_t i = 0u; i < 2u; ++i) {
+    timers[i] = rcl_get_zero_initialized_timer();
+    ret = rcl_timer_init(
+      &timers[i], &clock, this->context_ptr, periods[i], nullptr, rcl_get_default_allocator());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < 2u; ++i) {
+      ret = rcl_timer_fini(&timers[i]);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+  });
+  // Add the slow timer first so that the heap has to reorder them
+  ret = rcl_wait_set_add_timer(&wait_set, &timers[1], NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  size_t fast_index = 42u;
+  ret = rcl_wait_set_add_timer(&wait_set, &timers[0], &fast_index);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  const size_t * ready_indices = nullptr;
+  size_t ready_count = 0u;
+  for (size_t iteration = 0u; iteration < 2u; ++iteration) {
+    // The wait ends at the deadline of the fast timer, well before the given timeout
+    std::chrono::steady_clock::time_point before_sc = std::chrono::steady_clock::now();
+    ret = rcl_wait(&wait_set, RCL_S_TO_NS(10));
+    std::chrono::steady_clock::time_point after_sc = std::chrono::steady_clock::now();
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    int64_t diff =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(after_sc - before_sc).count();
+    EXPECT_LE(diff, RCL_MS_TO_NS(10) + TOLERANCE);
+    ret = rcl_wait_set_get_ready_indices(
+      &wait_set, RCL_WAIT_SET_TIMER, &ready_indices, &ready_count);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_EQ(1u, ready_count);
+    EXPECT_EQ(fast_index, ready_indices[0]);
+    // Calling the timer moves its deadline later
+    ret = rcl_timer_call(&timers[0]);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  // A canceled timer is not waited on, resetting it reschedules it
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_cancel(&timers[0])) << rcl_get_error_string().str;
+  ret = rcl_wait(&wait_set, RCL_MS_TO_NS(50));
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_reset(&timers[0])) << rcl_get_error_string().str;
+  ret = rcl_wait(&wait_set, RCL_S_TO_NS(10));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait(&wait_set, RCL_S_TO_NS(10));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_get_ready_indices(
+    &wait_set, RCL_WAIT_SET_TIMER, &ready_indices, &ready_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(fast_index, ready_indices[0]);
+
+  // Removed timers are no longer scheduled
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_remove_timer(&wait_set, fast_index));
+  ret = rcl_wait(&wait_set, 0);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+}
+
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), hierarchy) {
+  // The root, two children and a grandchild below the second child
+  const size_t kNumWaitSets = 4u;
+  rcl_wait_set_t wait_sets[kNumWaitSets];
+  rcl_guard_condition_t guard_conditions[kNumWaitSets];
+  for (size_t i = 0u; i < kNumWaitSets; ++i) {
+    wait_sets[i] = rcl_get_zero_initialized_wait_set();
+    rcl_ret_t ret = rcl_wait_set_init(
+      &wait_sets[i], 0, 1, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    guard_conditions[i] = rcl_get_zero_initialized_guard_condition();
+    ret = rcl_guard_condition_init(
+      &guard_conditions[i], this->context_ptr, rcl_guard_condition_get_default_options());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumWaitSets; ++i) {
+      EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_sets[i])) << rcl_get_error_string().str;
+      EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_conditions[i])) <<
+        rcl_get_error_string().str;
+    }
+  });
+  rcl_wait_set_t * root = &wait_sets[0];
+  rcl_wait_set_t * grandchild = &wait_sets[3];
+
+  size_t index = 42u;
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_add_wait_set(root, &wait_sets[1], &index));
+  EXPECT_EQ(0u, index);
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_add_wait_set(root, &wait_sets[2], &index));
+  EXPECT_EQ(1u, index);
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_add_wait_set(&wait_sets[2], grandchild, nullptr));
+
+  // Cycles and second parents are rejected
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_add_wait_set(grandchild, root, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_add_wait_set(root, root, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_add_wait_set(&wait_sets[1], grandchild, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_remove_wait_set(root, 2u));
+  rcl_reset_error();
+
+  for (size_t i = 0u; i < kNumWaitSets; ++i) {
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_sets[i])) << rcl_get_error_string().str;
+    rcl_ret_t ret = rcl_wait_set_add_guard_condition(&wait_sets[i], &guard_conditions[i], nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  // Only the root waits on its children
+  EXPECT_EQ(RCL_RET_ERROR, rcl_wait(&wait_sets[2], 0));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[3]));
+  rcl_ret_t ret = rcl_wait(root, RCL_MS_TO_NS(100));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  // Every wait set only holds its own ready entities
+  EXPECT_EQ(nullptr, wait_sets[0].guard_conditions[0]);
+  EXPECT_EQ(nullptr, wait_sets[1].guard_conditions[0]);
+  EXPECT_EQ(nullptr, wait_sets[2].guard_conditions[0]);
+  EXPECT_EQ(&guard_conditions[3], grandchild->guard_conditions[0]);
+  const size_t * ready_indices = nullptr;
+  size_t ready_count = 0u;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_ready_wait_sets(root, &ready_indices, &ready_count));
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(1u, ready_indices[0]);
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_get_ready_wait_sets(&wait_sets[2], &ready_indices, &ready_count));
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(0u, ready_indices[0]);
+
+  // Only the first child changes its membership, and nothing is ready
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_sets[1]));
+  ret = rcl_wait_set_add_guard_condition(&wait_sets[1], &guard_conditions[1], nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait(root, 0);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_ready_wait_sets(root, &ready_indices, &ready_count));
+  EXPECT_EQ(0u, ready_count);
+
+  // Removed slots are reused
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_remove_wait_set(root, 0u));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_remove_wait_set(root, 0u));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_add_wait_set(root, &wait_sets[1], &index));
+  EXPECT_EQ(0u, index);
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_remove_wait_set(root, 0u));
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_remove_wait_set(root, 1u));
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_set_persistent(root, true));
+}
+
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), hierarchy_persistent) {
+  const size_t kNumGuardConditions = 3u;
+  rcl_wait_set_t root = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret = rcl_wait_set_init(
+    &root, 0, 1, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcl_wait_set_t child = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(&child, 0, 2, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcl_guard_condition_t guard_conditions[kNumGuardConditions];
+  for (size_t i = 0u; i < kNumGuardConditions; ++i) {
+    guard_conditions[i] = rcl_get_zero_initialized_guard_condition();
+    ret = rcl_guard_condition_init(
+      &guard_conditions[i], this->context_ptr, rcl_guard_condition_get_default_options());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&root)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&child)) << rcl_get_error_string().str;
+    for (size_t i = 0u; i < kNumGuardConditions; ++i) {
+      EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_conditions[i])) <<
+        rcl_get_error_string().str;
+    }
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_persistent(&root, true));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_persistent(&child, true));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_wait_set(&root, &child, nullptr));
+  size_t index = 42u;
+  ret = rcl_wait_set_add_guard_condition(&root, &guard_conditions[0], &index);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_add_guard_condition(&child, &guard_conditions[1], &index);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  // The ready entity is only reported by the ready indices of the child
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[1]));
+  ret = rcl_wait(&root, RCL_MS_TO_NS(100));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  const size_t * ready_indices = nullptr;
+  size_t ready_count = 42u;
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_get_ready_indices(
+      &root, RCL_WAIT_SET_GUARD_CONDITION, &ready_indices, &ready_count));
+  EXPECT_EQ(0u, ready_count);
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_get_ready_indices(
+      &child, RCL_WAIT_SET_GUARD_CONDITION, &ready_indices, &ready_count));
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(index, ready_indices[0]);
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_ready_wait_sets(&root, &ready_indices, &ready_count));
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(0u, ready_indices[0]);
+
+  // Entities stay in persistent wait sets, and are only ready once
+  EXPECT_EQ(&guard_conditions[1], child.guard_conditions[index]);
+  ret = rcl_wait(&root, 0);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_ready_wait_sets(&root, &ready_indices, &ready_count));
+  EXPECT_EQ(0u, ready_count);
+
+  // Entities added between waits are waited on, even beyond the storage of the first wait
+  ret = rcl_wait_set_add_guard_condition(&child, &guard_conditions[2], &index);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[2]));
+  ret = rcl_wait(&root, RCL_MS_TO_NS(100));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_get_ready_indices(
+      &child, RCL_WAIT_SET_GUARD_CONDITION, &ready_indices, &ready_count));
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(index, ready_indices[0]);
+
+  // Removed entities are no longer waited on
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_remove_guard_condition(&child, index));
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[2]));
+  ret = rcl_wait(&root, 0);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+
+  // A removed child waits on its own entities again
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_remove_wait_set(&root, 0u));
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[1]));
+  ret = rcl_wait(&root, 0);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+  ret = rcl_wait(&child, RCL_MS_TO_NS(100));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_get_ready_indices(
+      &child, RCL_WAIT_SET_GUARD_CONDITION, &ready_indices, &ready_count));
+  EXPECT_EQ(1u, ready_count);
+}
+
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), ready_list) {
+  const size_t kNumGuardConditions = 3u;
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret = rcl_wait_set_init(
+    &wait_set, 0, kNumGuardConditions, 1, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_guard_condition_t guard_conditions[kNumGuardConditions];
+  for (size_t i = 0u; i < kNumGuardConditions; ++i) {
+    guard_conditions[i] = rcl_get_zero_initialized_guard_condition();
+    ret = rcl_guard_condition_init(
+      &guard_conditions[i], this->context_ptr, rcl_guard_condition_get_default_options());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumGuardConditions; ++i) {
+      ret = rcl_guard_condition_fini(&guard_conditions[i]);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+  });
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_clock_fini(&clock);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  // A timer with a period of zero is always ready
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(
+    &timer, &clock, this->context_ptr, 0, nullptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_timer_fini(&timer);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  const rcl_wait_set_ready_entry_t * ready_list = nullptr;
+  size_t ready_count = 0u;
+  EXPECT_EQ(RCL_RET_ERROR, rcl_wait_set_get_ready_list(&wait_set, &ready_list, &ready_count));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_ERROR, rcl_wait_set_set_entity_key(&wait_set, RCL_WAIT_SET_TIMER, 0u, 1));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_ready_list(&wait_set, true));
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_set_entity_key(&wait_set, RCL_WAIT_SET_TIMER, 1u, 1));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_set_entity_key(&wait_set, RCL_WAIT_SET_CLIENT, 0u, 1));
+  rcl_reset_error();
+
+  size_t index = 0u;
+  for (size_t i = 0u; i < kNumGuardConditions; ++i) {
+    ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[i], &index);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  ret = rcl_wait_set_add_timer(&wait_set, &timer, &index);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_set_entity_key(&wait_set, RCL_WAIT_SET_GUARD_CONDITION, 0u, 5));
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_set_entity_key(&wait_set, RCL_WAIT_SET_GUARD_CONDITION, 1u, -1));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_entity_key(&wait_set, RCL_WAIT_SET_TIMER, index, 2));
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[0]));
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[1]));
+
+  ret = rcl_wait(&wait_set, RCL_MS_TO_NS(100));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_ready_list(&wait_set, &ready_list, &ready_count));
+  // The guard condition which was not triggered is left out
+  ASSERT_EQ(3u, ready_count);
+  EXPECT_EQ(RCL_WAIT_SET_GUARD_CONDITION, ready_list[0].entity_type);
+  EXPECT_EQ(1u, ready_list[0].index);
+  EXPECT_EQ(-1, ready_list[0].key);
+  EXPECT_EQ(RCL_WAIT_SET_TIMER, ready_list[1].entity_type);
+  EXPECT_EQ(0u, ready_list[1].index);
+  EXPECT_EQ(2, ready_list[1].key);
+  EXPECT_EQ(RCL_WAIT_SET_GUARD_CONDITION, ready_list[2].entity_type);
+  EXPECT_EQ(0u, ready_list[2].index);
+  EXPECT_EQ(5, ready_list[2].key);
+
+  // Clearing resets the keys, equal keys are ordered by type
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  ret = rcl_wait_set_add_timer(&wait_set, &timer, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[2], nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[2]));
+  ret = rcl_wait(&wait_set, RCL_MS_TO_NS(100));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_ready_list(&wait_set, &ready_list, &ready_count));
+  ASSERT_EQ(2u, ready_count);
+  EXPECT_EQ(RCL_WAIT_SET_GUARD_CONDITION, ready_list[0].entity_type);
+  EXPECT_EQ(0, ready_list[0].key);
+  EXPECT_EQ(RCL_WAIT_SET_TIMER, ready_list[1].entity_type);
+  EXPECT_EQ(0, ready_list[1].key);
+
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_set_ready_list(&wait_set, false));
+  EXPECT_EQ(RCL_RET_ERROR, rcl_wait_set_get_ready_list(&wait_set, &ready_list, &ready_count));
+  rcl_reset_error();
+}
+
+// Check that timers with slack share a wake-up with a later timer
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), timer_slack) {
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret =
+    rcl_wait_set_init(&wait_set, 0, 0, 2, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_clock_fini(&clock);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  // The first timer tolerates being called late enough to be called with the second
+  const int64_t periods[] = {RCL_MS_TO_NS(50), RCL_MS_TO_NS(120)};
+  rcl_timer_t timers[2];
+  for (size_t i = 0u; i < 2u; ++i) {
+    timers[i] = rcl_get_zero_initialized_timer();
+    ret = rcl_timer_init(
+      &timers[i], &clock, this->context_ptr, periods[i], nullptr, rcl_get_default_allocator());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < 2u; ++i) {
+      ret = rcl_timer_fini(&timers[i]);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_set_slack(&timers[0], RCL_MS_TO_NS(100)));
+
+  for (bool persistent : {false, true}) {
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_persistent(&wait_set, persistent));
+    for (size_t i = 0u; i < 2u; ++i) {
+      ASSERT_EQ(RCL_RET_OK, rcl_timer_reset(&timers[i])) << rcl_get_error_string().str;
+    }
+    // Resetting triggers the guard conditions of the timers, consume that wake-up first
+    for (size_t i = 0u; i < 2u; ++i) {
+      ret = rcl_wait_set_add_timer(&wait_set, &timers[i], nullptr);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+    ret = rcl_wait(&wait_set, 0);
+    ASSERT_TRUE(RCL_RET_OK == ret || RCL_RET_TIMEOUT == ret) << rcl_get_error_string().str;
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+    for (size_t i = 0u; i < 2u; ++i) {
+      ret = rcl_wait_set_add_timer(&wait_set, &timers[i], nullptr);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+    std::chrono::steady_clock::time_point before_sc = std::chrono::steady_clock::now();
+    ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+    std::chrono::steady_clock::time_point after_sc = std::chrono::steady_clock::now();
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    int64_t diff = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      after_sc - before_sc).count();
+    // A single wake-up at the deadline of the second timer finds both ready
+    EXPECT_GE(diff, periods[1] - TOLERANCE);
+    EXPECT_LE(diff, periods[1] + RCL_MS_TO_NS(30) + TOLERANCE);
+    if (persistent) {
+      const size_t * ready_indices = nullptr;
+      size_t ready_count = 0u;
+      ret = rcl_wait_set_get_ready_indices(
+        &wait_set, RCL_WAIT_SET_TIMER, &ready_indices, &ready_count);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      EXPECT_EQ(2u, ready_count);
+    } else {
+      EXPECT_NE(nullptr, wait_set.timers[0]);
+      EXPECT_NE(nullptr, wait_set.timers[1]);
+    }
+  }
+}
+
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), timerfd_wakeup) {
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret =
+    rcl_wait_set_init(&wait_set, 0, 0, 1, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_set_timerfd_wakeup(nullptr, true, RCL_MS_TO_NS(1)));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_set_timerfd_wakeup(&wait_set, true, -1));
+  rcl_reset_error();
+  ret = rcl_wait_set_set_timerfd_wakeup(&wait_set, true, RCL_MS_TO_NS(5));
+  if (RCL_RET_UNSUPPORTED == ret) {
+    rcl_reset_error();
+    GTEST_SKIP() << "timerfd is not supported on this platform";
+  }
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_clock_fini(&clock);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(
+    &timer, &clock, this->context_ptr, RCL_MS_TO_NS(20), nullptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_timer_fini(&timer);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ret = rcl_wait_set_add_timer(&wait_set, &timer, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  // The wait never returns before the deadline and the timer is ready afterwards
+  ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_NE(nullptr, wait_set.timers[0]);
+  bool is_ready = false;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_is_ready(&timer, &is_ready)) << rcl_get_error_string().str;
+  EXPECT_TRUE(is_ready);
+
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_set_timerfd_wakeup(&wait_set, false, 0));
+}
+
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), adaptive_spin) {
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret =
+    rcl_wait_set_init(&wait_set, 0, 1, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_set_adaptive_spin(nullptr, RCL_MS_TO_NS(1), true));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_set_adaptive_spin(&wait_set, -1, true));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_adaptive_spin(&wait_set, RCL_MS_TO_NS(50), true));
+
+  rcl_guard_condition_t guard_cond = rcl_get_zero_initialized_guard_condition();
+  ret = rcl_guard_condition_init(
+    &guard_cond, this->context_ptr, rcl_guard_condition_get_default_options());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_guard_condition_fini(&guard_cond);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  // Polling keeps the set intact until the guard condition is triggered
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_cond, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  std::thread trigger_thread([&guard_cond]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      EXPECT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_cond));
+    });
+  ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+  trigger_thread.join();
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(&guard_cond, wait_set.guard_conditions[0]);
+
+  // The time spent polling counts towards the timeout
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_cond, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  std::chrono::steady_clock::time_point before = std::chrono::steady_clock::now();
+  ret = rcl_wait(&wait_set, RCL_MS_TO_NS(100));
+  std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - before;
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(nullptr, wait_set.guard_conditions[0]);
+  EXPECT_GE(elapsed.count(), RCL_MS_TO_NS(100));
+  EXPECT_LE(elapsed.count(), RCL_MS_TO_NS(100) + TOLERANCE);
+
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_set_adaptive_spin(&wait_set, 0, false));
+}
+
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), statistics) {
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret =
+    rcl_wait_set_init(&wait_set, 0, 1, 1, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  rcl_wait_set_statistics_t statistics;
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_set_statistics(nullptr, true));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_get_statistics(&wait_set, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_ERROR, rcl_wait_set_get_statistics(&wait_set, &statistics));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_statistics(&wait_set, true));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_statistics(&wait_set, &statistics));
+  EXPECT_EQ(0u, statistics.wait_count);
+
+  rcl_guard_condition_t guard_cond = rcl_get_zero_initialized_guard_condition();
+  ret = rcl_guard_condition_init(
+    &guard_cond, this->context_ptr, rcl_guard_condition_get_default_options());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_guard_condition_fini(&guard_cond);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_clock_fini(&clock);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(
+    &timer, &clock, this->context_ptr, RCL_MS_TO_NS(10), nullptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_timer_fini(&timer);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  // A non-blocking wait with nothing ready counts as a timeout
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_cond, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait(&wait_set, 0);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+
+  // A triggered guard condition is an entity wake
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_cond, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_cond));
+  ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  // A timer alone is a timer wake
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  ret = rcl_wait_set_add_timer(&wait_set, &timer, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_statistics(&wait_set, &statistics));
+  EXPECT_EQ(3u, statistics.wait_count);
+  EXPECT_EQ(1u, statistics.timeout_wake_count);
+  EXPECT_EQ(1u, statistics.entity_wake_count);
+  EXPECT_EQ(1u, statistics.timer_wake_count);
+  EXPECT_EQ(0u, statistics.spurious_wake_count);
+  EXPECT_EQ(1u, statistics.ready_entity_count);
+  EXPECT_EQ(1u, statistics.ready_timer_count);
+  uint64_t blocked_time_samples = 0u;
+  uint64_t ready_count_samples = 0u;
+  for (size_t i = 0u; i < RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE; ++i) {
+    blocked_time_samples += statistics.blocked_time_histogram[i];
+    ready_count_samples += statistics.ready_count_histogram[i];
+  }
+  EXPECT_EQ(3u, blocked_time_samples);
+  EXPECT_EQ(3u, ready_count_samples);
+  EXPECT_EQ(1u, statistics.ready_count_histogram[0]);
+  EXPECT_EQ(2u, statistics.ready_count_histogram[1]);
+  // The timer wait blocked until the deadline
+  EXPECT_GE(statistics.blocked_time, static_cast<uint64_t>(RCL_MS_TO_NS(5)));
+
+  // Histogram buckets are contiguous
+  EXPECT_EQ(0u, rcl_wait_set_statistics_bucket_lower_bound(0));
+  for (size_t i = 1u; i < RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE; ++i) {
+    EXPECT_LT(
+      rcl_wait_set_statistics_bucket_lower_bound(i - 1),
+      rcl_wait_set_statistics_bucket_lower_bound(i));
+  }
+  EXPECT_EQ(
+    UINT64_MAX, rcl_wait_set_statistics_bucket_lower_bound(RCL_WAIT_SET_STATISTICS_HISTOGRAM_SIZE));
+
+  // Enabling again resets the statistics
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_statistics(&wait_set, true));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_statistics(&wait_set, &statistics));
+  EXPECT_EQ(0u, statistics.wait_count);
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_statistics(&wait_set, false));
+  EXPECT_EQ(RCL_RET_ERROR, rcl_wait_set_get_statistics(&wait_set, &statistics));
+  rcl_reset_error();
+}
+
 // Extra invalid arguments not tested
 TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), wait_set_valid_arguments) {
   rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();